@@ -47,7 +47,9 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
 {
     LogUtils::init();
 
-    DependencyManager::set<tracing::Tracer>();
+    // always trace, into small buffers, so that the domain-server can fetch the last moments of an assignment
+    static const size_t ASSIGNMENT_TRACE_EVENTS_PER_THREAD = 1 << 15;
+    DependencyManager::set<tracing::Tracer>()->startTracing(ASSIGNMENT_TRACE_EVENTS_PER_THREAD);
     DependencyManager::set<StatTracker>();
     DependencyManager::set<AccountManager>();
     DependencyManager::set<ResourceRequestObserver>();
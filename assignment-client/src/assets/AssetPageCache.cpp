@@ -0,0 +1,119 @@
+//
+//  AssetPageCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetPageCache.h"
+
+#include <algorithm>
+
+// an asset has to fit in this fraction of the cache to be cached at all
+static const qint64 MAX_CACHED_ASSET_FRACTION = 8;
+
+uint qHash(const AssetPageCache::PageKey& key, uint seed) {
+    return qHash(key.assetHash, seed) ^ qHash(key.pageIndex, seed);
+}
+
+AssetPageCache::AssetPageCache(qint64 capacity) :
+    _capacity(capacity)
+{
+}
+
+void AssetPageCache::setCapacity(qint64 capacity) {
+    QMutexLocker locker(&_mutex);
+    _capacity = std::max(capacity, (qint64)0);
+    evict();
+}
+
+qint64 AssetPageCache::getCapacity() const {
+    QMutexLocker locker(&_mutex);
+    return _capacity;
+}
+
+bool AssetPageCache::isCacheable(qint64 assetSize) const {
+    QMutexLocker locker(&_mutex);
+    return assetSize > 0 && assetSize <= _capacity / MAX_CACHED_ASSET_FRACTION;
+}
+
+QByteArray AssetPageCache::getPage(const QString& assetHash, qint64 pageIndex) {
+    QMutexLocker locker(&_mutex);
+
+    auto it = _pages.find({ assetHash, pageIndex });
+    if (it == _pages.end()) {
+        ++_misses;
+        return QByteArray();
+    }
+
+    ++_hits;
+    _lru.splice(_lru.begin(), _lru, it->lruPosition);
+    return it->data;
+}
+
+void AssetPageCache::insertPage(const QString& assetHash, qint64 pageIndex, const QByteArray& page) {
+    QMutexLocker locker(&_mutex);
+
+    PageKey key { assetHash, pageIndex };
+    if (_pages.contains(key) || page.size() > _capacity) {
+        return;
+    }
+
+    _lru.push_front(key);
+    _pages.insert(key, { page, _lru.begin() });
+    _cachedBytes += page.size();
+    evict();
+}
+
+void AssetPageCache::removeAsset(const QString& assetHash) {
+    QMutexLocker locker(&_mutex);
+
+    auto it = _lru.begin();
+    while (it != _lru.end()) {
+        if (it->assetHash == assetHash) {
+            auto page = _pages.find(*it);
+            _cachedBytes -= page->data.size();
+            _pages.erase(page);
+            it = _lru.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AssetPageCache::recordBytesServed(qint64 fromCache, qint64 fromDisk) {
+    _bytesServedFromCache += fromCache;
+    _bytesServedFromDisk += fromDisk;
+}
+
+QJsonObject AssetPageCache::getStats() const {
+    QJsonObject stats;
+    {
+        QMutexLocker locker(&_mutex);
+        stats["capacity_bytes"] = (double)_capacity;
+        stats["cached_bytes"] = (double)_cachedBytes;
+        stats["cached_pages"] = _pages.size();
+    }
+
+    quint64 hits = _hits;
+    quint64 misses = _misses;
+    stats["page_hits"] = (double)hits;
+    stats["page_misses"] = (double)misses;
+    stats["hit_rate"] = (hits + misses) > 0 ? (double)hits / (double)(hits + misses) : 0.0;
+    stats["bytes_served_from_cache"] = (double)_bytesServedFromCache;
+    stats["bytes_served_from_disk"] = (double)_bytesServedFromDisk;
+    return stats;
+}
+
+void AssetPageCache::evict() {
+    // called with _mutex held
+    while (_cachedBytes > _capacity && !_lru.empty()) {
+        auto page = _pages.find(_lru.back());
+        _cachedBytes -= page->data.size();
+        _pages.erase(page);
+        _lru.pop_back();
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  AssetPageCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetPageCache_h
+#define hifi_AssetPageCache_h
+
+#include <atomic>
+#include <list>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+/// A bounded, least-recently-used cache of fixed-size pages of asset files, keyed by asset hash and page index.
+/// Asset files are content addressed and never change in place, so a cached page can only go stale by its
+/// asset being deleted. Assets larger than a fraction of the capacity are never cached so that a single large
+/// download cannot flush every hot asset.
+class AssetPageCache {
+public:
+    static const qint64 PAGE_SIZE = 64 * 1024;
+
+    AssetPageCache(qint64 capacity = 0);
+
+    void setCapacity(qint64 capacity);
+    qint64 getCapacity() const;
+
+    bool isCacheable(qint64 assetSize) const;
+
+    /// returns a null QByteArray on a miss
+    QByteArray getPage(const QString& assetHash, qint64 pageIndex);
+    void insertPage(const QString& assetHash, qint64 pageIndex, const QByteArray& page);
+    void removeAsset(const QString& assetHash);
+
+    void recordBytesServed(qint64 fromCache, qint64 fromDisk);
+
+    QJsonObject getStats() const;
+
+private:
+    struct PageKey {
+        QString assetHash;
+        qint64 pageIndex;
+
+        bool operator==(const PageKey& other) const {
+            return pageIndex == other.pageIndex && assetHash == other.assetHash;
+        }
+    };
+    friend uint qHash(const PageKey& key, uint seed);
+
+    struct Page {
+        QByteArray data;
+        std::list<PageKey>::iterator lruPosition;
+    };
+
+    void evict();
+
+    mutable QMutex _mutex;
+    qint64 _capacity;
+    qint64 _cachedBytes { 0 };
+    QHash<PageKey, Page> _pages;
+    std::list<PageKey> _lru; // most recently used at the front
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint64> _bytesServedFromCache { 0 };
+    std::atomic<quint64> _bytesServedFromDisk { 0 };
+};
+
+#endif // hifi_AssetPageCache_h
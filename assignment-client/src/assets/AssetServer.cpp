@@ -31,6 +31,7 @@
 
 #include <ClientServerUtils.h>
 #include <NodeType.h>
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <PathUtils.h>
 #include <image/TextureProcessing.h>
@@ -117,7 +118,17 @@ void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetU
     qDebug() << "Starting bake for: " << assetPath << assetHash;
     auto it = _pendingBakes.find(assetHash);
     if (it == _pendingBakes.end()) {
-        auto task = std::make_shared<BakeAssetTask>(assetHash, assetPath, filePath);
+        // the asset hash covers the whole content the oven is given, together with what kind of bake this is
+        // that is everything the baked output depends on
+        BakeCache::Key bakeCacheKey;
+        if (_bakeCache) {
+            auto type = assetTypeForFilename(assetPath);
+            QString extension = assetPath.mid(assetPath.lastIndexOf('.') + 1);
+            bakeCacheKey = BakeCache::computeKey("asset-server", (int)currentBakeVersionForAssetType(type),
+                                                 extension.toUtf8(), assetHash.toUtf8());
+        }
+
+        auto task = std::make_shared<BakeAssetTask>(assetHash, assetPath, filePath, _bakeCache, bakeCacheKey);
         task->setAutoDelete(false);
         _pendingBakes[assetHash] = task;
 
@@ -294,7 +305,10 @@ void updateConsumedCores() {
 AssetServer::AssetServer(ReceivedMessage& message) :
     ThreadedAssignment(message),
     _transferTaskPool(this),
+    _uploadTaskPool(this),
+    _pendingUploads(std::make_shared<std::atomic<int>>(0)),
     _bakingTaskPool(this),
+    _pageCache(std::make_shared<AssetPageCache>()),
     _filesizeLimit(AssetUtils::MAX_UPLOAD_SIZE)
 {
     BAKEABLE_TEXTURE_EXTENSIONS = image::getSupportedFormats();
@@ -304,6 +318,11 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     // so the ideal is greater than the number of cores on the system.
     static const int TASK_POOL_THREAD_COUNT = 50;
     _transferTaskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
+
+    // An upload holds its thread until the whole file has arrived, limit how many of them stream in at once
+    // (the others wait in the pool's queue) so that slow uploaders can't take every thread.
+    static const int UPLOAD_TASK_POOL_THREAD_COUNT = 8;
+    _uploadTaskPool.setMaxThreadCount(UPLOAD_TASK_POOL_THREAD_COUNT);
     _bakingTaskPool.setMaxThreadCount(1);
 
     // Queue all requests until the Asset Server is fully setup
@@ -329,6 +348,7 @@ void AssetServer::aboutToFinish() {
 
     // remove pending transfer tasks
     _transferTaskPool.clear();
+    _uploadTaskPool.clear();
 
     // abort each of our still running bake tasks, remove pending bakes that were never put on the thread pool
     auto it = _pendingBakes.begin();
@@ -424,6 +444,19 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    // get the size of the on-disk cache of previous bakes, this has to be ready before the first bakes are queued
+    static const QString BAKE_CACHE_SIZE_OPTION = "bake_cache_size";
+    static const QString BAKE_CACHE_SUBDIR = "bake_cache";
+    static const int DEFAULT_BAKE_CACHE_SIZE_MB = 2048;
+    auto bakeCacheSizeMB = assetServerObject[BAKE_CACHE_SIZE_OPTION].toInt(DEFAULT_BAKE_CACHE_SIZE_MB);
+    if (bakeCacheSizeMB > 0) {
+        _bakeCache = std::make_shared<BakeCache>(_resourcesDirectory.absoluteFilePath(BAKE_CACHE_SUBDIR).toStdString());
+        _bakeCache->initialize();
+        _bakeCache->setMaxSize(MB_TO_BYTES(bakeCacheSizeMB));
+        qCInfo(asset_server) << "Keeping up to" << bakeCacheSizeMB << "MB of previous bakes in"
+                             << _resourcesDirectory.absoluteFilePath(BAKE_CACHE_SUBDIR);
+    }
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qCInfo(asset_server) << "Serving files from: " << _filesDirectory.path();
@@ -458,6 +491,16 @@ void AssetServer::completeSetup() {
         _filesizeLimit = assetsFilesizeLimit * BITS_PER_MEGABITS;
     }
 
+    // get the size of the in-memory cache for frequently requested asset pages
+    static const QString HOT_CACHE_SIZE_OPTION = "hot_cache_size";
+    static const int DEFAULT_HOT_CACHE_SIZE_MB = 256;
+    static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+    auto hotCacheSizeMB = assetServerObject[HOT_CACHE_SIZE_OPTION].toInt(DEFAULT_HOT_CACHE_SIZE_MB);
+    _pageCache->setCapacity(std::max(hotCacheSizeMB, 0) * BYTES_PER_MEGABYTE);
+    qCInfo(asset_server) << "Caching up to" << hotCacheSizeMB << "MB of frequently requested asset data in memory.";
+
+    UploadAssetTask::removeAbandonedUploads(_filesDirectory);
+
     PathUtils::removeTemporaryApplicationDirs();
     PathUtils::removeTemporaryApplicationDirs("Oven");
 
@@ -466,7 +509,8 @@ void AssetServer::completeSetup() {
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
-    packetReceiver.registerListener(PacketType::AssetUpload, this, "handleAssetUpload");
+    // uploads are delivered on their first packet and streamed to disk by UploadAssetTask as they arrive
+    packetReceiver.registerListener(PacketType::AssetUpload, this, "handleAssetUpload", true);
     packetReceiver.registerListener(PacketType::AssetMappingOperation, this, "handleAssetMappingOperation");
 
     replayRequests();
@@ -541,6 +585,8 @@ void AssetServer::cleanupUnmappedFiles() {
                 if (removeableFile.remove()) {
                     qCDebug(asset_server) << "\tDeleted" << filename << "from asset files directory since it is unmapped.";
 
+                    _pageCache->removeAsset(filename);
+
                     removeBakedPathsForDeletedAsset(filename);
                 } else {
                     qCDebug(asset_server) << "\tAttempt to delete unmapped file" << filename << "failed";
@@ -867,42 +913,53 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _pageCache);
     _transferTaskPool.start(task);
 }
 
 void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    // an upload waiting for a thread keeps receiving its data into memory, so only so many are accepted at once
+    static const int MAX_PENDING_UPLOADS = 32;
+
     bool canWriteToAssetServer = true;
     if (senderNode) {
         canWriteToAssetServer = senderNode->getCanWriteToAssetServer();
     }
 
+    AssetUtils::AssetServerError error = AssetUtils::AssetServerError::NoError;
+    if (!canWriteToAssetServer) {
+        // this is a node the domain told us is not allowed to rez entities
+        // for now this also means it isn't allowed to add assets
+        error = AssetUtils::AssetServerError::PermissionDenied;
+    } else if (++(*_pendingUploads) > MAX_PENDING_UPLOADS) {
+        --(*_pendingUploads);
+        qCDebug(asset_server) << "Rejecting upload from" << message->getSourceID() << "with" << MAX_PENDING_UPLOADS
+                              << "uploads already pending";
+        error = AssetUtils::AssetServerError::ServerBusy;
+    }
 
-    if (canWriteToAssetServer) {
+    if (error == AssetUtils::AssetServerError::NoError) {
         qCDebug(asset_server) << "Starting an UploadAssetTask for upload from" << message->getSourceID();
 
-        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit);
-        _transferTaskPool.start(task);
+        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit, _pendingUploads);
+        _uploadTaskPool.start(task);
     } else {
-        // this is a node the domain told us is not allowed to rez entities
-        // for now this also means it isn't allowed to add assets
-        // so return a packet with error that indicates that
-
-        auto permissionErrorPacket = NLPacket::create(PacketType::AssetUploadReply, sizeof(MessageID) + sizeof(AssetUtils::AssetServerError), true);
+        // return a packet with the error that kept the upload from starting
+        auto errorPacket = NLPacket::create(PacketType::AssetUploadReply, sizeof(MessageID) + sizeof(AssetUtils::AssetServerError), true);
 
         MessageID messageID;
         message->readPrimitive(&messageID);
 
-        // write the message ID and a permission denied error
-        permissionErrorPacket->writePrimitive(messageID);
-        permissionErrorPacket->writePrimitive(AssetUtils::AssetServerError::PermissionDenied);
+        // write the message ID and the error
+        errorPacket->writePrimitive(messageID);
+        errorPacket->writePrimitive(error);
 
         // send off the packet
         auto nodeList = DependencyManager::get<NodeList>();
         if (senderNode) {
-            nodeList->sendPacket(std::move(permissionErrorPacket), *senderNode);
+            nodeList->sendPacket(std::move(errorPacket), *senderNode);
         } else {
-            nodeList->sendPacket(std::move(permissionErrorPacket), message->getSenderSockAddr());
+            nodeList->sendPacket(std::move(errorPacket), message->getSenderSockAddr());
         }
     }
 }
@@ -957,6 +1014,11 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     });
 
+    serverStats["hot_asset_cache"] = _pageCache->getStats();
+    if (_bakeCache) {
+        serverStats["bake_cache"] = _bakeCache->getStats();
+    }
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -1175,6 +1237,8 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
             if (removeableFile.remove()) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
 
+                _pageCache->removeAsset(hash);
+
                 removeBakedPathsForDeletedAsset(hash);
             } else {
                 qCDebug(asset_server) << "\tAttempt to delete unmapped file" << hash << "failed";
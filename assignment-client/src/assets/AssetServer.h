@@ -12,12 +12,16 @@
 #ifndef hifi_AssetServer_h
 #define hifi_AssetServer_h
 
+#include <atomic>
+
 #include <QtCore/QDir>
 #include <QtCore/QThreadPool>
 #include <QRunnable>
 
+#include <shared/BakeCache.h>
 #include <ThreadedAssignment.h>
 
+#include "AssetPageCache.h"
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
 
@@ -153,12 +157,24 @@ private:
     QDir _resourcesDirectory;
     QDir _filesDirectory;
 
-    /// Task pool for handling uploads and downloads of assets
+    /// Task pool for handling downloads of assets
     QThreadPool _transferTaskPool;
 
+    /// Task pool for uploads, which wait on the network while they stream in and must not hold up downloads
+    QThreadPool _uploadTaskPool;
+
+    /// Uploads running or waiting in _uploadTaskPool, shared with the UploadAssetTasks that may outlive us
+    std::shared_ptr<std::atomic<int>> _pendingUploads;
+
     QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
     QThreadPool _bakingTaskPool;
 
+    /// Pages of recently sent assets, shared with the SendAssetTasks that may outlive us
+    std::shared_ptr<AssetPageCache> _pageCache;
+
+    /// Results of previous bakes keyed by the content they were baked from, null when disabled
+    BakeCachePointer _bakeCache;
+
     QMutex _queuedRequestsMutex;
     bool _isQueueingRequests { true };
     using RequestQueue = QVector<QPair<QSharedPointer<ReceivedMessage>, SharedNodePointer>>;
@@ -13,6 +13,8 @@
 
 #include <mutex>
 
+#include <QtCore/QDirIterator>
+#include <QtCore/QJsonObject>
 #include <QtCore/QThread>
 #include <QCoreApplication>
 
@@ -24,10 +26,16 @@ static const int OVEN_STATUS_CODE_ABORT { 2 };
 
 std::once_flag registerMetaTypesFlag;
 
-BakeAssetTask::BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath) :
+// where the oven put the unbaked original, relative to the temporary output directory
+static const QString BAKE_CACHE_ORIGINAL_DIRECTORY_KEY = "original";
+
+BakeAssetTask::BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                             BakeCachePointer bakeCache, const BakeCache::Key& bakeCacheKey) :
     _assetHash(assetHash),
     _assetPath(assetPath),
-    _filePath(filePath)
+    _filePath(filePath),
+    _bakeCache(bakeCache),
+    _bakeCacheKey(bakeCacheKey)
 {
 
     std::call_once(registerMetaTypesFlag, []() {
@@ -52,6 +60,12 @@ void BakeAssetTask::run() {
         return;
     }
 
+    if (restoreFromBakeCache(tempOutputDir)) {
+        qDebug() << "Restored bake of" << _assetPath << "from the bake cache";
+        emit bakeComplete(_assetHash, _assetPath, tempOutputDir);
+        return;
+    }
+
     // Copy file to bake the temporary dir and give a name the oven can work with
     auto assetName = _assetPath.split("/").last();
     auto tempAssetPath = tempOutputDir + "/" + assetName;
@@ -89,6 +103,7 @@ void BakeAssetTask::run() {
                 emit bakeFailed(_assetHash, _assetPath, errors);
             }
         } else if (exitCode == OVEN_STATUS_CODE_SUCCESS) {
+            storeInBakeCache(tempOutputDir);
             emit bakeComplete(_assetHash, _assetPath, tempOutputDir);
         } else if (exitStatus == QProcess::NormalExit && exitCode == OVEN_STATUS_CODE_ABORT) {
             _wasAborted.store(true);
@@ -142,3 +157,49 @@ void BakeAssetTask::abort() {
         _ovenProcess->terminate();
     }
 }
+
+bool BakeAssetTask::restoreFromBakeCache(const QString& tempOutputDir) {
+    if (!_bakeCache || _bakeCacheKey.empty()) {
+        return false;
+    }
+
+    QDir outputDir { tempOutputDir };
+    std::vector<QString> restoredFiles;
+    QJsonObject info;
+    auto hasOriginalDirectory = [](const QJsonObject& info) {
+        return !info[BAKE_CACHE_ORIGINAL_DIRECTORY_KEY].toString().isEmpty();
+    };
+    if (!_bakeCache->restore(_bakeCacheKey, outputDir, restoredFiles, &info, hasOriginalDirectory)) {
+        return false;
+    }
+
+    // the original isn't cached since the asset server already has it, but it looks for the folder next to the baked one
+    return outputDir.mkpath(info[BAKE_CACHE_ORIGINAL_DIRECTORY_KEY].toString());
+}
+
+void BakeAssetTask::storeInBakeCache(const QString& tempOutputDir) {
+    if (!_bakeCache || _bakeCacheKey.empty()) {
+        return;
+    }
+
+    // find the directory the oven baked into, the same way AssetServer::handleCompletedBake does
+    QDir outputDir { tempOutputDir };
+    auto directories = outputDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const auto& dirName : directories) {
+        QDir bakeDir { outputDir.filePath(dirName) };
+        if (!bakeDir.exists("baked") || !bakeDir.exists("original")) {
+            continue;
+        }
+
+        std::vector<QString> bakedFiles;
+        QDirIterator it(bakeDir.filePath("baked"), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            bakedFiles.push_back(it.next());
+        }
+
+        QJsonObject info;
+        info[BAKE_CACHE_ORIGINAL_DIRECTORY_KEY] = outputDir.relativeFilePath(bakeDir.filePath("original"));
+        _bakeCache->store(_bakeCacheKey, outputDir, bakedFiles, info);
+        return;
+    }
+}
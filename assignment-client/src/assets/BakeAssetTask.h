@@ -21,11 +21,13 @@
 #include <QProcess>
 
 #include <AssetUtils.h>
+#include <shared/BakeCache.h>
 
 class BakeAssetTask : public QObject, public QRunnable {
     Q_OBJECT
 public:
-    BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath);
+    BakeAssetTask(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                  BakeCachePointer bakeCache = nullptr, const BakeCache::Key& bakeCacheKey = BakeCache::Key());
 
     // Thread-safe inspection methods
     bool isBaking() { return _isBaking.load(); }
@@ -48,6 +50,13 @@ private:
     QString _filePath;
     std::unique_ptr<QProcess> _ovenProcess { nullptr };
     std::atomic<bool> _wasAborted { false };
+
+    /// restores a previous bake of the same content into the output directory instead of running the oven
+    bool restoreFromBakeCache(const QString& tempOutputDir);
+    void storeInBakeCache(const QString& tempOutputDir);
+
+    BakeCachePointer _bakeCache;
+    BakeCache::Key _bakeCacheKey;
 };
 
 #endif // hifi_BakeAssetTask_h
@@ -11,6 +11,7 @@
 
 #include "SendAssetTask.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <QFile>
@@ -26,11 +27,13 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             std::shared_ptr<AssetPageCache> pageCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _pageCache(pageCache)
 {
     
 }
@@ -82,25 +85,12 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
+                // a negative range is read back from the end of the file
+                qint64 offset = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : file.size() + byteRange.fromInclusive;
 
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
-                } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
-
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
-
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
-                }
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
+                writeAssetRange(file, hexHash, offset, size, *replyPacketList);
 
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
@@ -118,3 +108,58 @@ void SendAssetTask::run() {
         nodeList->sendPacketList(std::move(replyPacketList), _message->getSenderSockAddr());
     }
 }
+
+void SendAssetTask::writeAssetRange(QFile& file, const QString& hexHash, qint64 offset, qint64 size,
+                                    NLPacketList& packetList) {
+    // Pages are written straight from the cache or from the mapped file into the packet list, so the range is
+    // never held in memory twice. The file is only mapped once a page misses the cache.
+    const qint64 PAGE_SIZE = AssetPageCache::PAGE_SIZE;
+    const qint64 fileSize = file.size();
+    const qint64 end = offset + size;
+    const bool cacheable = _pageCache->isCacheable(fileSize);
+
+    uchar* mappedFile = nullptr;
+    bool mappingFailed = false;
+    qint64 bytesFromCache = 0;
+    qint64 bytesFromDisk = 0;
+
+    for (qint64 pageIndex = offset / PAGE_SIZE; pageIndex * PAGE_SIZE < end; ++pageIndex) {
+        qint64 pageStart = pageIndex * PAGE_SIZE;
+        qint64 pageLength = std::min(PAGE_SIZE, fileSize - pageStart);
+        qint64 from = std::max(offset, pageStart);
+        qint64 to = std::min(end, pageStart + pageLength);
+
+        if (cacheable) {
+            QByteArray cachedPage = _pageCache->getPage(hexHash, pageIndex);
+            if (!cachedPage.isNull()) {
+                packetList.write(cachedPage.constData() + (from - pageStart), to - from);
+                bytesFromCache += to - from;
+                continue;
+            }
+        }
+
+        if (!mappedFile && !mappingFailed) {
+            mappedFile = file.map(0, fileSize);
+            mappingFailed = (mappedFile == nullptr);
+        }
+
+        if (mappedFile) {
+            const char* pageData = reinterpret_cast<const char*>(mappedFile) + pageStart;
+            if (cacheable) {
+                _pageCache->insertPage(hexHash, pageIndex, QByteArray(pageData, pageLength));
+            }
+            packetList.write(pageData + (from - pageStart), to - from);
+        } else {
+            // we could not map the file (e.g. out of address space), fall back to reading one page at a time
+            file.seek(from);
+            packetList.write(file.read(to - from));
+        }
+        bytesFromDisk += to - from;
+    }
+
+    if (mappedFile) {
+        file.unmap(mappedFile);
+    }
+
+    _pageCache->recordBytesServed(bytesFromCache, bytesFromDisk);
+}
@@ -18,21 +18,28 @@
 #include <QtCore/QRunnable>
 
 #include "AssetUtils.h"
+#include "AssetPageCache.h"
 #include "AssetServer.h"
 #include "Node.h"
 
 class NLPacket;
+class NLPacketList;
+class QFile;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  std::shared_ptr<AssetPageCache> pageCache);
 
     void run() override;
 
 private:
+    void writeAssetRange(QFile& file, const QString& hexHash, qint64 offset, qint64 size, NLPacketList& packetList);
+
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    std::shared_ptr<AssetPageCache> _pageCache;
 };
 
 #endif
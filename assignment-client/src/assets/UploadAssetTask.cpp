@@ -11,8 +11,12 @@
 
 #include "UploadAssetTask.h"
 
-#include <QtCore/QBuffer>
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryFile>
 
 #include <AssetUtils.h>
 #include <NodeList.h>
@@ -20,27 +24,62 @@
 
 #include "ClientServerUtils.h"
 
+static const QString UPLOAD_TEMP_FILE_PREFIX = "upload-";
+static const QString UPLOAD_TEMP_FILE_TEMPLATE = UPLOAD_TEMP_FILE_PREFIX + "XXXXXX.tmp";
+
+static const int UPLOAD_HEADER_SIZE = sizeof(MessageID) + sizeof(uint64_t);
+
+// an upload that goes this long without receiving anything is abandoned
+static const unsigned long UPLOAD_IDLE_TIMEOUT_MSECS = 30 * 1000;
+
 UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir, uint64_t filesizeLimit) :
+                                 const QDir& resourcesDir, uint64_t filesizeLimit,
+                                 std::shared_ptr<std::atomic<int>> pendingUploads) :
     _receivedMessage(receivedMessage),
     _senderNode(senderNode),
     _resourcesDir(resourcesDir),
-    _filesizeLimit(filesizeLimit)
+    _filesizeLimit(filesizeLimit),
+    _pendingUploads(pendingUploads)
 {
     
 }
 
+UploadAssetTask::~UploadAssetTask() {
+    // the pool deletes us once we have run, or when it drops us without running
+    --(*_pendingUploads);
+}
+
+void UploadAssetTask::removeAbandonedUploads(const QDir& resourcesDir) {
+    auto abandonedUploads = resourcesDir.entryList({ UPLOAD_TEMP_FILE_PREFIX + "*" }, QDir::Files);
+    for (const auto& fileName : abandonedUploads) {
+        QFile::remove(resourcesDir.filePath(fileName));
+    }
+}
+
+bool UploadAssetTask::receiveData(QByteArray& data) {
+    // the message may still be arriving, take whatever has been received since the last call
+    auto received = _receivedMessage->takeReceivedData(UPLOAD_IDLE_TIMEOUT_MSECS);
+    data.append(received);
+    return !received.isEmpty() && !_receivedMessage->failed();
+}
+
 void UploadAssetTask::run() {
-    auto data = _receivedMessage->getMessage();
-    
-    QBuffer buffer { &data };
-    buffer.open(QIODevice::ReadOnly);
+    QByteArray data;
+    while (data.size() < UPLOAD_HEADER_SIZE && receiveData(data)) {
+    }
+
+    if (data.size() < UPLOAD_HEADER_SIZE) {
+        qWarning() << "UploadAssetTask did not receive a complete upload header from" << _receivedMessage->getSenderSockAddr();
+        return;
+    }
     
     MessageID messageID;
-    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
+    memcpy(&messageID, data.constData(), sizeof(messageID));
     
     uint64_t fileSize;
-    buffer.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    memcpy(&fileSize, data.constData() + sizeof(messageID), sizeof(fileSize));
+
+    data.remove(0, UPLOAD_HEADER_SIZE);
 
     if (_senderNode) {
         qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
@@ -54,64 +93,103 @@ void UploadAssetTask::run() {
     if (fileSize > _filesizeLimit) {
         replyPacket->writePrimitive(AssetUtils::AssetServerError::AssetTooLarge);
     } else {
-        QByteArray fileData = buffer.read(fileSize);
-        
-        auto hash = AssetUtils::hashData(fileData);
-        auto hexHash = hash.toHex();
-
-        if (_senderNode) {
-            qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID()) << "is: (" << hexHash << ")";
-        } else {
-            qDebug() << "Hash for uploaded file from" << _receivedMessage->getSenderSockAddr() << "is: (" << hexHash << ")";
-        }
-        
-        QFile file { _resourcesDir.filePath(QString(hexHash)) };
-
-        bool existingCorrectFile = false;
-        
-        if (file.exists()) {
-            // check if the local file has the correct contents, otherwise we overwrite
-            if (file.open(QIODevice::ReadOnly) && AssetUtils::hashData(file.readAll()) == hash) {
-                qDebug() << "Not overwriting existing verified file: " << hexHash;
-
-                existingCorrectFile = true;
-
-                replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
-                replyPacket->write(hash);
-            } else {
-                qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
-                file.close();
-            }
-        }
+        QByteArray hash;
+        auto error = writeUploadToFile(data, fileSize, hash);
 
-        if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
-                qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
-                file.close();
+        replyPacket->writePrimitive(error);
+        if (error == AssetUtils::AssetServerError::NoError) {
+            replyPacket->write(hash);
+        }
+    }
+    
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (_senderNode) {
+        nodeList->sendPacket(std::move(replyPacket), *_senderNode);
+    } else {
+        nodeList->sendPacket(std::move(replyPacket), _receivedMessage->getSenderSockAddr());
+    }
+}
 
-                replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
-                replyPacket->write(hash);
-            } else {
-                qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
+AssetUtils::AssetServerError UploadAssetTask::writeUploadToFile(QByteArray data, uint64_t fileSize, QByteArray& hash) {
+    // the upload goes to a temporary file next to the assets as it arrives, so it is never held in memory whole,
+    // and is only renamed to its hash once all of it has been received and hashed
+    QTemporaryFile tempFile { _resourcesDir.filePath(UPLOAD_TEMP_FILE_TEMPLATE) };
+    if (!tempFile.open()) {
+        qWarning() << "Failed to create a temporary file for upload in" << _resourcesDir.path() << " - upload failed.";
+        return AssetUtils::AssetServerError::FileOperationFailed;
+    }
 
-                // upload has failed - remove the file and return an error
-                auto removed = file.remove();
+    QCryptographicHash hasher { QCryptographicHash::Sha256 };
+    uint64_t bytesWritten = 0;
 
-                if (!removed) {
-                    qWarning() << "Removal of failed upload file" << hexHash << "failed.";
-                }
-                
-                replyPacket->writePrimitive(AssetUtils::AssetServerError::FileOperationFailed);
+    do {
+        auto bytesToWrite = (qint64)std::min((uint64_t)data.size(), fileSize - bytesWritten);
+        if (bytesToWrite > 0) {
+            hasher.addData(data.constData(), bytesToWrite);
+            if (tempFile.write(data.constData(), bytesToWrite) != bytesToWrite) {
+                qWarning() << "Failed to write upload to" << tempFile.fileName() << " - upload failed.";
+                return AssetUtils::AssetServerError::FileOperationFailed;
             }
+            bytesWritten += bytesToWrite;
         }
+        data.clear();
+    } while (bytesWritten < fileSize && receiveData(data));
 
-
+    if (bytesWritten < fileSize) {
+        qWarning() << "Upload ended after" << bytesWritten << "of" << fileSize << "bytes - upload failed.";
+        return AssetUtils::AssetServerError::FileOperationFailed;
     }
-    
-    auto nodeList = DependencyManager::get<NodeList>();
+
+    hash = hasher.result();
+    auto hexHash = hash.toHex();
+
     if (_senderNode) {
-        nodeList->sendPacket(std::move(replyPacket), *_senderNode);
+        qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID()) << "is: (" << hexHash << ")";
     } else {
-        nodeList->sendPacket(std::move(replyPacket), _receivedMessage->getSenderSockAddr());
+        qDebug() << "Hash for uploaded file from" << _receivedMessage->getSenderSockAddr() << "is: (" << hexHash << ")";
     }
+
+    // files are named by their hash and only ever appear through an atomic rename of a complete upload, so an
+    // existing file of the right size is this content, one of another size was truncated and is replaced
+    auto filePath = _resourcesDir.filePath(QString(hexHash));
+    auto isExistingCorrectFile = [&] {
+        QFileInfo existingFile { filePath };
+        return existingFile.isFile() && (uint64_t)existingFile.size() == fileSize;
+    };
+
+    if (isExistingCorrectFile()) {
+        qDebug() << "Not overwriting existing file: " << hexHash;
+        return AssetUtils::AssetServerError::NoError;
+    }
+
+    if (QFile::exists(filePath)) {
+        qDebug() << "Overwriting an existing file whose size did not match the upload: " << hexHash;
+        QFile::remove(filePath);
+    }
+
+    if (!tempFile.flush()) {
+        qWarning() << "Failed to flush upload" << hexHash << " - upload failed.";
+        return AssetUtils::AssetServerError::FileOperationFailed;
+    }
+    tempFile.close();
+
+    // we take ownership of the file from here, the rename must not be undone by QTemporaryFile
+    tempFile.setAutoRemove(false);
+    auto tempFilePath = tempFile.fileName();
+
+    if (QFile::rename(tempFilePath, filePath)) {
+        qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
+        return AssetUtils::AssetServerError::NoError;
+    }
+
+    QFile::remove(tempFilePath);
+
+    // a concurrent upload of the same content may have won the rename
+    if (isExistingCorrectFile()) {
+        qDebug() << "Not overwriting existing file: " << hexHash;
+        return AssetUtils::AssetServerError::NoError;
+    }
+
+    qWarning() << "Failed to move upload into place as" << hexHash << " - upload failed.";
+    return AssetUtils::AssetServerError::FileOperationFailed;
 }
@@ -14,11 +14,16 @@
 #ifndef hifi_UploadAssetTask_h
 #define hifi_UploadAssetTask_h
 
+#include <atomic>
+#include <memory>
+
 #include <QtCore/QDir>
 #include <QtCore/QObject>
 #include <QtCore/QRunnable>
 #include <QtCore/QSharedPointer>
 
+#include <AssetUtils.h>
+
 #include "ReceivedMessage.h"
 
 class NLPacketList;
@@ -26,16 +31,24 @@ class Node;
 
 class UploadAssetTask : public QRunnable {
 public:
-    UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, 
-                    const QDir& resourcesDir, uint64_t filesizeLimit);
+    UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode,
+                    const QDir& resourcesDir, uint64_t filesizeLimit, std::shared_ptr<std::atomic<int>> pendingUploads);
+    ~UploadAssetTask();
 
     void run() override;
 
+    /// removes temporary files left behind by uploads that were interrupted by a shutdown
+    static void removeAbandonedUploads(const QDir& resourcesDir);
+
 private:
+    bool receiveData(QByteArray& data);
+    AssetUtils::AssetServerError writeUploadToFile(QByteArray data, uint64_t fileSize, QByteArray& hash);
+
     QSharedPointer<ReceivedMessage> _receivedMessage;
     QSharedPointer<Node> _senderNode;
     QDir _resourcesDir;
     uint64_t _filesizeLimit;
+    std::shared_ptr<std::atomic<int>> _pendingUploads;
 };
 
 #endif // hifi_UploadAssetTask_h
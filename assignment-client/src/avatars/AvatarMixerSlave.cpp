@@ -578,15 +578,17 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
                 auto startSerialize = chrono::high_resolution_clock::now();
                 QByteArray bytes = sourceAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
                     sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
-                    &lastSentJointsForOther, avatarSpaceAvailable);
+                    &lastSentJointsForOther, avatarSpaceAvailable - (int)sizeof(quint16));
                 auto endSerialize = chrono::high_resolution_clock::now();
                 _stats.toByteArrayElapsedTime +=
                     (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
 
+                // the size goes first so that receivers can split the packet up and parse the avatars in parallel
+                avatarPacket->writePrimitive((quint16)bytes.size());
                 avatarPacket->write(bytes);
-                avatarSpaceAvailable -= bytes.size();
-                numAvatarDataBytes += bytes.size();
-                if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
+                avatarSpaceAvailable -= bytes.size() + (int)sizeof(quint16);
+                numAvatarDataBytes += bytes.size() + (int)sizeof(quint16);
+                if (!sendStatus || avatarSpaceAvailable < (int)(AvatarDataPacket::MIN_BULK_PACKET_SIZE + sizeof(quint16))) {
                     // Weren't able to fit everything.
                     nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
                     ++numPacketsSent;
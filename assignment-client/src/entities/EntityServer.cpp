@@ -48,6 +48,9 @@ EntityServer::EntityServer(ReceivedMessage& message) :
     DependencyManager::set<ModelFormatRegistry>(); // ModelFormatRegistry must be defined before ModelCache. See the ModelCache ctor
     DependencyManager::set<ModelCache>();
 
+    // every send thread splices from the same encoding of an entity instead of encoding it for each viewer
+    EntityItem::setEncodedDataCacheEnabled(true);
+
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListenerForTypes({ PacketType::EntityAdd,
         PacketType::EntityClone,
@@ -69,6 +72,10 @@ EntityServer::~EntityServer() {
         _pruneDeletedEntitiesTimer->stop();
         _pruneDeletedEntitiesTimer->deleteLater();
     }
+    if (_compressionDictionaryTimer) {
+        _compressionDictionaryTimer->stop();
+        _compressionDictionaryTimer->deleteLater();
+    }
 
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->removeNewlyCreatedHook(this);
@@ -120,6 +127,11 @@ void EntityServer::beforeRun() {
     const int PRUNE_DELETED_MODELS_INTERVAL_MSECS = 1 * 1000; // once every second
     _pruneDeletedEntitiesTimer->start(PRUNE_DELETED_MODELS_INTERVAL_MSECS);
 
+    _compressionDictionaryTimer = new QTimer();
+    connect(_compressionDictionaryTimer, &QTimer::timeout, this, &EntityServer::trainCompressionDictionary);
+    const int CHECK_COMPRESSION_DICTIONARY_INTERVAL_MSECS = 60 * 1000; // once a minute
+    _compressionDictionaryTimer->start(CHECK_COMPRESSION_DICTIONARY_INTERVAL_MSECS);
+
     DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
     connect(&domainHandler, &DomainHandler::settingsReceiveFail, this, &EntityServer::domainSettingsRequestFailed);
 }
@@ -127,8 +139,96 @@ void EntityServer::beforeRun() {
 void EntityServer::entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
 }
 
+OctreeCompressionDictionaryPointer EntityServer::getCompressionDictionary() const {
+    std::lock_guard<std::mutex> lock(_compressionDictionaryMutex);
+    return _compressionDictionary;
+}
+
+// Trains a dictionary out of the wire encoding of the domain's entities. Clients that asked for one are sent it as a
+// special packet, and their sections are compressed with it once their query reports they hold it.
+void EntityServer::trainCompressionDictionary() {
+    if (!_wantCompressionDictionary) {
+        return;
+    }
+
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    QList<EntityItemPointer> entities = tree->getAllEntities();
+    int entityCount = entities.size();
+
+    // only retrain when the content changed enough for the current dictionary to be stale
+    const int RETRAIN_ENTITY_COUNT_CHANGE_DIVISOR = 4; // a quarter more or fewer entities than when trained
+    if (getCompressionDictionary() && std::abs(entityCount - _compressionDictionaryEntityCount) <=
+        _compressionDictionaryEntityCount / RETRAIN_ENTITY_COUNT_CHANGE_DIVISOR) {
+        return;
+    }
+
+    const int MAX_SAMPLES = 4096;
+    quint64 trainStart = usecTimestampNow();
+    std::vector<QByteArray> samples;
+    samples.reserve(std::min(entityCount, MAX_SAMPLES));
+    int stride = std::max(1, entityCount / MAX_SAMPLES);
+    OctreePacketData packetData(false, MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+    tree->withReadLock([&] {
+        for (int i = 0; i < entityCount; i += stride) {
+            packetData.reset();
+            EncodeBitstreamParams params;
+            auto extra = std::make_shared<EntityTreeElementExtraEncodeData>();
+            if (entities[i]->appendEntityData(&packetData, params, extra) != OctreeElement::NONE) {
+                samples.emplace_back((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+            }
+        }
+    });
+
+    auto dictionary = OctreeCompressionDictionary::train(samples);
+    if (!dictionary) {
+        return;
+    }
+    OctreeCompressionDictionary::registerDictionary(dictionary);
+    {
+        std::lock_guard<std::mutex> lock(_compressionDictionaryMutex);
+        _compressionDictionary = dictionary;
+        _compressionDictionaryEntityCount = entityCount;
+    }
+    qDebug() << "EntityServer trained compression dictionary" << dictionary->getID() << "of" << dictionary->getData().size()
+        << "bytes from" << samples.size() << "entities in" << (usecTimestampNow() - trainStart) << "usecs";
+}
+
+bool EntityServer::shouldSendCompressionDictionary(const SharedNodePointer& node) const {
+    EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
+    if (!nodeData || !nodeData->wantCompressionDictionary()) {
+        return false;
+    }
+    auto dictionary = getCompressionDictionary();
+    if (!dictionary || nodeData->getCompressionDictionaryID() == dictionary->getID()) {
+        return false;
+    }
+    // the dictionary goes out reliably, only send it again if the client still hasn't reported it after a while
+    const quint64 RESEND_COMPRESSION_DICTIONARY_USECS = 10 * USECS_PER_SECOND;
+    return nodeData->getCompressionDictionarySentID() != dictionary->getID() ||
+        usecTimestampNow() - nodeData->getCompressionDictionarySentAt() > RESEND_COMPRESSION_DICTIONARY_USECS;
+}
+
+int EntityServer::sendCompressionDictionary(const SharedNodePointer& node) {
+    auto dictionary = getCompressionDictionary();
+    EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
+    if (!dictionary || !nodeData) {
+        return 0;
+    }
+
+    QByteArray payload = dictionary->toByteArray();
+    auto packetList = NLPacketList::create(PacketType::EntityCompressionDictionary, QByteArray(), true, true);
+    packetList->write(payload);
+    DependencyManager::get<NodeList>()->sendPacketList(std::move(packetList), *node);
+    nodeData->setCompressionDictionarySent(dictionary->getID(), usecTimestampNow());
+    return payload.size();
+}
+
 // EntityServer will use the "special packets" to send list of recently deleted entities
 bool EntityServer::hasSpecialPacketsToSend(const SharedNodePointer& node) {
+    if (shouldSendCompressionDictionary(node)) {
+        return true;
+    }
+
     bool shouldSendDeletedEntities = false;
 
     // check to see if any new entities have been added since we last sent to this node...
@@ -157,13 +257,13 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
     int totalBytes = 0;
 
     EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
-    if (nodeData) {
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    if (nodeData && tree->hasEntitiesDeletedSince(nodeData->getLastDeletedEntitiesSentAt())) {
 
         quint64 deletedEntitiesSentAt = nodeData->getLastDeletedEntitiesSentAt();
         quint64 considerEntitiesSince = EntityTree::getAdjustedConsiderSince(deletedEntitiesSentAt);
 
         quint64 deletePacketSentAt = usecTimestampNow();
-        EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
         auto recentlyDeleted = tree->getRecentlyDeletedEntityIDs();
 
         packetsSent = 0;
@@ -276,6 +376,14 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
         nodeData->setLastDeletedEntitiesSentAt(deletePacketSentAt);
     }
 
+    if (shouldSendCompressionDictionary(node)) {
+        int dictionaryBytes = sendCompressionDictionary(node);
+        if (dictionaryBytes > 0) {
+            totalBytes += dictionaryBytes;
+            packetsSent++;
+        }
+    }
+
     #ifdef EXTRA_ERASE_DEBUGGING
         if (packetsSent > 0) {
             qDebug() << "EntityServer::sendSpecialPackets() sent " << packetsSent << "special packets of " 
@@ -338,6 +446,14 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     tree->setWantEditLogging(wantEditLogging);
     tree->setWantTerseEditLogging(wantTerseEditLogging);
 
+    bool wantCompressionDictionary = true;
+    readOptionBool(QString("compressionDictionary"), settingsSectionObject, wantCompressionDictionary);
+    _wantCompressionDictionary = wantCompressionDictionary;
+    if (!_wantCompressionDictionary) {
+        std::lock_guard<std::mutex> lock(_compressionDictionaryMutex);
+        _compressionDictionary.reset();
+    }
+
     QString entityScriptSourceWhitelist;
     if (readOptionString("entityScriptSourceWhitelist", settingsSectionObject, entityScriptSourceWhitelist)) {
         tree->setEntityScriptSourceWhitelist(entityScriptSourceWhitelist);
@@ -413,6 +529,34 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    quint64 encodedDataHits = EntityItem::getEncodedDataCacheHits();
+    quint64 encodedDataMisses = EntityItem::getEncodedDataCacheMisses();
+    quint64 encodedDataLookups = encodedDataHits + encodedDataMisses;
+    statsString += "<b>Entity Server Shared Encoding Statistics</b>\r\n";
+    statsString += QString("         Encodings shared... %1\r\n").arg(encodedDataHits);
+    statsString += QString("        Entities encoded... %1\r\n").arg(encodedDataMisses);
+    statsString += QString("                Hit rate... %1%\r\n")
+        .arg(encodedDataLookups > 0 ? (100.0 * encodedDataHits) / encodedDataLookups : 0.0, 0, 'f', 1);
+    statsString += "\r\n\r\n";
+
+    quint64 entitiesSent = EntityTreeSendThread::_totalEntities;
+    quint64 compressedInputBytes = OctreePacketData::getCompressedInputBytes();
+    quint64 compressedOutputBytes = OctreePacketData::getCompressedOutputBytes();
+    quint64 compressCalls = OctreePacketData::getCompressContentCalls();
+    auto dictionary = getCompressionDictionary();
+    statsString += "<b>Entity Server Compression Statistics</b>\r\n";
+    statsString += QString("              Dictionary... %1\r\n")
+        .arg(dictionary ? QString("%1 (%2 bytes)").arg(dictionary->getID()).arg(dictionary->getData().size()) : QString("none"));
+    statsString += QString("           Entities sent... %1\r\n").arg(entitiesSent);
+    statsString += QString("        Bytes per entity... %1 wire / %2 uncompressed\r\n")
+        .arg(entitiesSent > 0 ? (double)OctreeSendThread::_totalBytes / entitiesSent : 0.0, 0, 'f', 1)
+        .arg(entitiesSent > 0 ? (double)compressedInputBytes / entitiesSent : 0.0, 0, 'f', 1);
+    statsString += QString("       Compression ratio... %1\r\n")
+        .arg(compressedOutputBytes > 0 ? (double)compressedInputBytes / compressedOutputBytes : 0.0, 0, 'f', 2);
+    statsString += QString("      Compress time/call... %1 usecs\r\n")
+        .arg(compressCalls > 0 ? (double)OctreePacketData::getCompressContentTime() / compressCalls : 0.0, 0, 'f', 1);
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
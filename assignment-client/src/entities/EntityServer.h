@@ -15,6 +15,9 @@
 #include "../octree/OctreeServer.h"
 
 #include <memory>
+#include <mutex>
+
+#include <OctreeCompressionDictionary.h>
 
 #include "EntityItem.h"
 #include "EntityServerConsts.h"
@@ -65,6 +68,7 @@ public slots:
     virtual void nodeKilled(SharedNodePointer node) override;
     void pruneDeletedEntities();
     void entityFilterAdded(EntityItemID id, bool success);
+    void trainCompressionDictionary();
 
 protected:
     virtual OctreePointer createTree() override;
@@ -78,6 +82,16 @@ private:
     SimpleEntitySimulationPointer _entitySimulation;
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
 
+    OctreeCompressionDictionaryPointer getCompressionDictionary() const;
+    bool shouldSendCompressionDictionary(const SharedNodePointer& node) const;
+    int sendCompressionDictionary(const SharedNodePointer& node);
+
+    bool _wantCompressionDictionary { true };
+    QTimer* _compressionDictionaryTimer = nullptr;
+    mutable std::mutex _compressionDictionaryMutex;
+    OctreeCompressionDictionaryPointer _compressionDictionary;
+    int _compressionDictionaryEntityCount { 0 };
+
     QReadWriteLock _viewerSendingStatsLock;
     QMap<QUuid, QMap<QUuid, ViewerSendingStats>> _viewerSendingStats;
 
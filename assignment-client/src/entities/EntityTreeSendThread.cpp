@@ -17,6 +17,8 @@
 
 #include "EntityServer.h"
 
+AtomicUIntStat EntityTreeSendThread::_totalEntities { 0 };
+
 EntityTreeSendThread::EntityTreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) :
     OctreeSendThread(myServer, node)
 {
@@ -121,6 +123,7 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
             assert(_sendQueue.empty());
 
             // Re-add elements from previous traversal if they still need to be sent
+            bool droppedEntities = false;
             while (!prevSendQueue.empty()) {
                 EntityItemPointer entity = prevSendQueue.top().getEntity();
                 bool forceRemove = prevSendQueue.top().shouldForceRemove();
@@ -137,9 +140,16 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
 
                     if (priority != PrioritizedEntity::DO_NOT_SEND) {
                         _sendQueue.emplace(entity, priority, forceRemove);
+                    } else {
+                        droppedEntities = true;
                     }
                 }
             }
+
+            if (droppedEntities) {
+                // subtrees holding the dropped entities were only complete because they were queued
+                _traversal.invalidateCompleteSubtrees();
+            }
         }
     }
 
@@ -153,6 +163,10 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
         #endif
         _traversal.traverse(TIME_BUDGET);
         OctreeServer::trackTreeTraverseTime((float)(usecTimestampNow() - startTime));
+
+        if (_traversal.finished()) {
+            OctreeServer::trackTraversalElements(_traversal.getNumVisitedElements(), _traversal.getNumSkippedElements());
+        }
     }
 
     bool sendComplete = OctreeSendThread::traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
@@ -247,6 +261,8 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
 
                     if (priority != PrioritizedEntity::DO_NOT_SEND) {
                         _sendQueue.emplace(entity, priority);
+                    } else {
+                        next.complete = false;
                     }
                 });
             });
@@ -276,8 +292,13 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
 
                         if (priority != PrioritizedEntity::DO_NOT_SEND) {
                             _sendQueue.emplace(entity, priority);
+                        } else if (knownTimestamp == _knownState.end()) {
+                            next.complete = false;
                         }
                     });
+                } else {
+                    // we only got here because something below this element changed
+                    next.complete = false;
                 }
             });
             break;
@@ -305,6 +326,8 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
 
                     if (priority != PrioritizedEntity::DO_NOT_SEND) {
                         _sendQueue.emplace(entity, priority);
+                    } else if (knownTimestamp == _knownState.end()) {
+                        next.complete = false;
                     }
                 });
             });
@@ -389,6 +412,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
             }
             if (queuedItem.shouldForceRemove()) {
                 _knownState.erase(entity.get());
+                _traversal.invalidateCompleteSubtrees();
             } else {
                 _knownState[entity.get()] = sendTime;
             }
@@ -409,6 +433,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
     }
     _packetData.endLevel(entitiesLevel);
     _packetData.updatePriorBytes(_numEntitiesOffset, (const unsigned char*)&_numEntities, sizeof(_numEntities));
+    _totalEntities += _numEntities;
     OctreeServer::trackEncodeTime((float)(usecTimestampNow() - encodeStart));
     return true;
 }
@@ -30,6 +30,8 @@ class EntityTreeSendThread : public OctreeSendThread {
 public:
     EntityTreeSendThread(OctreeServer* myServer, const SharedNodePointer& node);
 
+    static AtomicUIntStat _totalEntities;
+
 protected:
     bool traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene) override;
@@ -11,6 +11,8 @@
 
 #include "MessagesMixer.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
 #include <QBuffer>
@@ -21,6 +23,10 @@
 
 const QString MESSAGES_MIXER_LOGGING_NAME = "messages-mixer";
 
+// messages bigger than this are never held back, and a node's held messages are sent as soon as they add up to the max
+static const int MAX_COALESCED_MESSAGE_BYTES = 1024;
+static const int MAX_COALESCED_PAYLOAD_BYTES = 16 * 1024;
+
 MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(message)
 {
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &MessagesMixer::nodeKilled);
@@ -28,43 +34,134 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
     packetReceiver.registerListener(PacketType::MessagesData, this, "handleMessages");
     packetReceiver.registerListener(PacketType::MessagesSubscribe, this, "handleMessagesSubscribe");
     packetReceiver.registerListener(PacketType::MessagesUnsubscribe, this, "handleMessagesUnsubscribe");
+
+    connect(&_coalesceTimer, &QTimer::timeout, this, &MessagesMixer::sendCoalescedMessages);
+    _channelStatsTimer.start();
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    auto it = _nodeChannels.find(killedNode->getUUID());
+    if (it != _nodeChannels.end()) {
+        for (const auto& channel : it.value()) {
+            auto subscribers = _channelSubscribers.find(channel);
+            if (subscribers != _channelSubscribers.end()) {
+                subscribers->remove(killedNode->getUUID());
+                if (subscribers->isEmpty()) {
+                    _channelSubscribers.erase(subscribers);
+                }
+            }
+        }
+        _nodeChannels.erase(it);
     }
+    _coalescedPayloads.remove(killedNode->getUUID());
 }
 
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
-    QByteArray data;
-    QUuid senderID;
+    // only the channel is needed here, the message itself is forwarded without being decoded
+    QString channel;
     bool isText;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+    QByteArray content;
+    if (!MessagesClient::readMessagesPayload(*receivedMessage, channel, isText, content)) {
+        qDebug() << "Dropping malformed message from" << senderNode->getUUID();
+        return;
+    }
+
+    // encoded once and shared by every recipient
+    QByteArray payload;
+    if (receivedMessage->getBytesLeftToRead() >= NUM_BYTES_RFC4122_UUID) {
+        payload = receivedMessage->getMessage().left(receivedMessage->getPosition() + NUM_BYTES_RFC4122_UUID);
+    } else {
+        // packet was missing the sender UUID, use the default instead
+        payload = MessagesClient::encodeMessagesPayload(channel, isText, content, QUuid());
+    }
+
+    auto& channelStats = _channelStats[channel];
+    ++channelStats.messages;
+    channelStats.bytes += payload.size();
+
+    auto subscribers = _channelSubscribers.find(channel);
+    if (subscribers == _channelSubscribers.end()) {
+        return;
+    }
 
     auto nodeList = DependencyManager::get<NodeList>();
+    for (const auto& subscriberID : subscribers.value()) {
+        auto node = nodeList->nodeWithUUID(subscriberID);
+        if (node && node->getActiveSocket()) {
+            sendMessagesPayload(node, payload);
+            ++channelStats.deliveries;
+        }
+    }
+}
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getActiveSocket() && _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = isText ? MessagesClient::encodeMessagesPacket(channel, message, senderID) :
-                                   MessagesClient::encodeMessagesDataPacket(channel, data, senderID);
+void MessagesMixer::sendMessagesPayload(const SharedNodePointer& node, const QByteArray& payload) {
+    if (_coalesceIntervalMsecs > 0) {
+        auto& coalesced = _coalescedPayloads[node->getUUID()];
+
+        if (payload.size() <= MAX_COALESCED_MESSAGE_BYTES) {
+            coalesced.append(payload);
+            if (coalesced.size() >= MAX_COALESCED_PAYLOAD_BYTES) {
+                sendCoalescedMessagesToNode(node->getUUID(), coalesced);
+            }
+            return;
+        }
+
+        // keep the order messages were sent in
+        sendCoalescedMessagesToNode(node->getUUID(), coalesced);
+    }
+
+    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    packetList->write(payload);
+    DependencyManager::get<NodeList>()->sendPacketList(std::move(packetList), *node);
+}
+
+void MessagesMixer::sendCoalescedMessagesToNode(const QUuid& nodeID, QByteArray& payload) {
+    if (payload.isEmpty()) {
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto node = nodeList->nodeWithUUID(nodeID);
+    if (node && node->getActiveSocket()) {
+        auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+        packetList->write(payload);
         nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    }
+    payload.clear();
+}
+
+void MessagesMixer::sendCoalescedMessages() {
+    for (auto it = _coalescedPayloads.begin(); it != _coalescedPayloads.end(); ++it) {
+        sendCoalescedMessagesToNode(it.key(), it.value());
+    }
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
     _channelSubscribers[channel] << senderNode->getUUID();
+    _nodeChannels[senderNode->getUUID()] << channel;
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    removeSubscriber(channel, senderNode->getUUID());
+}
+
+void MessagesMixer::removeSubscriber(const QString& channel, const QUuid& nodeID) {
+    auto subscribers = _channelSubscribers.find(channel);
+    if (subscribers != _channelSubscribers.end()) {
+        subscribers->remove(nodeID);
+        if (subscribers->isEmpty()) {
+            _channelSubscribers.erase(subscribers);
+        }
+    }
+
+    auto channels = _nodeChannels.find(nodeID);
+    if (channels != _nodeChannels.end()) {
+        channels->remove(channel);
+        if (channels->isEmpty()) {
+            _nodeChannels.erase(channels);
+        }
     }
 }
 
@@ -81,11 +178,62 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesMixerObject;
+
+    // rates for each channel that saw traffic since the last stats packet
+    const float BITS_PER_BYTE = 8.0f;
+    const float MSECS_PER_SECOND = 1000.0f;
+    float elapsedSeconds = std::max(_channelStatsTimer.restart(), (qint64)1) / MSECS_PER_SECOND;
+
+    QJsonObject channelsObject;
+    for (auto it = _channelStats.constBegin(); it != _channelStats.constEnd(); ++it) {
+        QJsonObject channelStats;
+        channelStats["subscribers"] = _channelSubscribers.value(it.key()).size();
+        channelStats["messages_per_second"] = it->messages / elapsedSeconds;
+        channelStats["deliveries_per_second"] = it->deliveries / elapsedSeconds;
+        channelStats["inbound_kbps"] = (it->bytes * BITS_PER_BYTE) / (elapsedSeconds * MSECS_PER_SECOND);
+        channelsObject[it.key()] = channelStats;
+    }
+    _channelStats.clear();
+
+    statsObject["channels"] = channelsObject;
+    statsObject["num_channels"] = _channelSubscribers.size();
+    statsObject["coalesce_interval_ms"] = _coalesceIntervalMsecs;
+
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void MessagesMixer::run() {
+    // wait until we have the domain-server settings before deciding whether to coalesce
+    DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
+    connect(&domainHandler, &DomainHandler::settingsReceived, this, &MessagesMixer::domainSettingsRequestComplete);
+
     ThreadedAssignment::commonInit(MESSAGES_MIXER_LOGGING_NAME, NodeType::MessagesMixer);
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer });
 }
+
+void MessagesMixer::domainSettingsRequestComplete() {
+    parseDomainServerSettings(DependencyManager::get<NodeList>()->getDomainHandler().getSettingsObject());
+}
+
+void MessagesMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
+    const QString MESSAGES_MIXER_SETTINGS_KEY = "messages_mixer";
+    QJsonObject messagesMixerGroupObject = domainSettings[MESSAGES_MIXER_SETTINGS_KEY].toObject();
+
+    const QString COALESCE_INTERVAL_KEY = "coalesce_interval_ms";
+    const int MAX_COALESCE_INTERVAL_MSECS = 100;
+    bool ok;
+    int coalesceInterval = messagesMixerGroupObject[COALESCE_INTERVAL_KEY].toVariant().toInt(&ok);
+    if (!ok || coalesceInterval < 0) {
+        coalesceInterval = 0;
+    }
+    _coalesceIntervalMsecs = std::min(coalesceInterval, MAX_COALESCE_INTERVAL_MSECS);
+
+    if (_coalesceIntervalMsecs > 0) {
+        qDebug() << "Coalescing messages every" << _coalesceIntervalMsecs << "ms";
+        _coalesceTimer.start(_coalesceIntervalMsecs);
+    } else {
+        _coalesceTimer.stop();
+        sendCoalescedMessages();
+    }
+}
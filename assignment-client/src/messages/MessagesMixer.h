@@ -15,6 +15,9 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+
 #include <ThreadedAssignment.h>
 
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
@@ -29,12 +32,36 @@ public slots:
     void sendStatsPacket() override;
 
 private slots:
+    void domainSettingsRequestComplete();
     void handleMessages(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void sendCoalescedMessages();
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    struct ChannelStats {
+        quint64 messages { 0 };
+        quint64 bytes { 0 };
+        quint64 deliveries { 0 };
+    };
+
+    void parseDomainServerSettings(const QJsonObject& domainSettings);
+    void sendMessagesPayload(const SharedNodePointer& node, const QByteArray& payload);
+    void sendCoalescedMessagesToNode(const QUuid& nodeID, QByteArray& payload);
+    void removeSubscriber(const QString& channel, const QUuid& nodeID);
+
+    // channel -> subscribers, and the reverse so a killed node doesn't have to be looked for in every channel
+    QHash<QString, QSet<QUuid>> _channelSubscribers;
+    QHash<QUuid, QSet<QString>> _nodeChannels;
+
+    // channel activity since the last stats packet
+    QHash<QString, ChannelStats> _channelStats;
+    QElapsedTimer _channelStatsTimer;
+
+    // when set, small messages to the same node are held for up to this long and sent together
+    int _coalesceIntervalMsecs { 0 };
+    QTimer _coalesceTimer;
+    QHash<QUuid, QByteArray> _coalescedPayloads;
 };
 
 #endif // hifi_MessagesMixer_h
@@ -337,6 +337,10 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
     _packetData.changeSettings(true, targetSize); // FIXME - eventually support only compressed packets
 
+    // compress with the dictionary the client says it holds, as long as it is one we know
+    _packetData.setCompressionDictionary(nodeData->wantCompressionDictionary() ?
+        OctreeCompressionDictionary::find(nodeData->getCompressionDictionaryID()) : OctreeCompressionDictionaryPointer());
+
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
     if (shouldStartNewTraversal(nodeData, viewFrustumChanged)) {
@@ -64,6 +64,8 @@ int OctreeServer::_shortTreeWait = 0;
 int OctreeServer::_noTreeWait = 0;
 
 SimpleMovingAverage OctreeServer::_averageTreeTraverseTime(MOVING_AVERAGE_SAMPLE_COUNTS);
+SimpleMovingAverage OctreeServer::_averageTraversalVisitedElements(MOVING_AVERAGE_SAMPLE_COUNTS);
+SimpleMovingAverage OctreeServer::_averageTraversalSkippedElements(MOVING_AVERAGE_SAMPLE_COUNTS);
 
 SimpleMovingAverage OctreeServer::_averageNodeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 
@@ -114,6 +116,8 @@ void OctreeServer::resetSendingStats() {
     _noTreeWait = 0;
 
     _averageTreeTraverseTime.reset();
+    _averageTraversalVisitedElements.reset();
+    _averageTraversalSkippedElements.reset();
 
     _averageNodeWaitTime.reset();
 
@@ -180,6 +184,11 @@ void OctreeServer::trackTreeWaitTime(float time) {
     }
 }
 
+void OctreeServer::trackTraversalElements(uint32_t visited, uint32_t skipped) {
+    _averageTraversalVisitedElements.updateAverage((float)visited);
+    _averageTraversalSkippedElements.updateAverage((float)skipped);
+}
+
 void OctreeServer::trackCompressAndWriteTime(float time) {
     const float MAX_SHORT_TIME = 10.0f;
     const float MAX_LONG_TIME = 100.0f;
@@ -516,7 +525,11 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
         // traverse
         float averageTreeTraverseTime = getAverageTreeTraverseTime();
-        statsString += QString().sprintf("          Average tree traverse time:    %9.2f usecs\r\n\r\n", (double)averageTreeTraverseTime);
+        statsString += QString().sprintf("          Average tree traverse time:    %9.2f usecs\r\n", (double)averageTreeTraverseTime);
+        statsString += QString().sprintf("  Average elements visited per pass:    %9.2f\r\n",
+                                         (double)getAverageTraversalVisitedElements());
+        statsString += QString().sprintf("  Average elements skipped per pass:    %9.2f\r\n\r\n",
+                                         (double)getAverageTraversalSkippedElements());
 
         // encode
         float averageEncodeTime = getAverageEncodeTime();
@@ -1426,6 +1439,8 @@ void OctreeServer::sendStatsPacket() {
     octreeStats["1. elementCount"] = (double)OctreeElement::getNodeCount();
     octreeStats["2. internalElementCount"] = (double)OctreeElement::getInternalNodeCount();
     octreeStats["3. leafElementCount"] = (double)OctreeElement::getLeafNodeCount();
+    octreeStats["4. avgTraversalVisitedElements"] = getAverageTraversalVisitedElements();
+    octreeStats["5. avgTraversalSkippedElements"] = getAverageTraversalSkippedElements();
 
     // Stats Object 2
     QJsonObject dataObject1;
@@ -1435,6 +1450,8 @@ void OctreeServer::sendStatsPacket() {
     dataObject1["4. totalBytesOctalCodes"] = (double)OctreePacketData::getTotalBytesOfOctalCodes();
     dataObject1["5. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfBitMasks();
     dataObject1["6. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfColor();
+    dataObject1["7. totalBytesBeforeCompression"] = (double)OctreePacketData::getCompressedInputBytes();
+    dataObject1["8. totalBytesAfterCompression"] = (double)OctreePacketData::getCompressedOutputBytes();
 
     QJsonObject timingArray1;
     timingArray1["1. avgLoopTime"] = getAverageLoopTime();
@@ -1444,6 +1461,9 @@ void OctreeServer::sendStatsPacket() {
     timingArray1["5. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
     timingArray1["6. avgSendTime"] = getAveragePacketSendingTime();
     timingArray1["7. nodeWaitTime"] = getAverageNodeWaitTime();
+    quint64 compressCalls = OctreePacketData::getCompressContentCalls();
+    timingArray1["8. avgCompressCallTime"] = compressCalls > 0 ?
+        (double)OctreePacketData::getCompressContentTime() / compressCalls : 0.0;
 
     QJsonObject statsObject2;
     statsObject2["data"] = dataObject1;
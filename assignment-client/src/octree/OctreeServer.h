@@ -102,6 +102,10 @@ public:
     static void trackTreeTraverseTime(float time) { _averageTreeTraverseTime.updateAverage(time); }
     static float getAverageTreeTraverseTime() { return _averageTreeTraverseTime.getAverage(); }
 
+    static void trackTraversalElements(uint32_t visited, uint32_t skipped);
+    static float getAverageTraversalVisitedElements() { return _averageTraversalVisitedElements.getAverage(); }
+    static float getAverageTraversalSkippedElements() { return _averageTraversalSkippedElements.getAverage(); }
+
     static void trackNodeWaitTime(float time) { _averageNodeWaitTime.updateAverage(time); }
     static float getAverageNodeWaitTime() { return _averageNodeWaitTime.getAverage(); }
 
@@ -227,6 +231,8 @@ protected:
     static int _noTreeWait;
 
     static SimpleMovingAverage _averageTreeTraverseTime;
+    static SimpleMovingAverage _averageTraversalVisitedElements;
+    static SimpleMovingAverage _averageTraversalSkippedElements;
 
     static SimpleMovingAverage _averageNodeWaitTime;
 
@@ -0,0 +1,220 @@
+//
+//  EntityScriptEngineShards.cpp
+//  assignment-client/src/scripts
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityScriptEngineShards.h"
+
+#include <QtCore/QJsonObject>
+
+#if defined(Q_OS_WIN)
+#include <Windows.h>
+#elif defined(Q_OS_MAC)
+#include <mach/mach.h>
+#else
+#include <time.h>
+#endif
+
+#include <SharedUtil.h>
+
+using Lock = std::lock_guard<std::mutex>;
+
+// CPU time consumed by the calling thread, in microseconds
+static quint64 currentThreadCPUUsecs() {
+#if defined(Q_OS_WIN)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    auto toUsecs = [](const FILETIME& time) {
+        // FILETIME is in 100ns units
+        return ((quint64)time.dwHighDateTime << 32 | time.dwLowDateTime) / 10;
+    };
+    return toUsecs(kernelTime) + toUsecs(userTime);
+#elif defined(Q_OS_MAC)
+    mach_port_t thread = mach_thread_self();
+    thread_basic_info_data_t info;
+    mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+    kern_return_t result = thread_info(thread, THREAD_BASIC_INFO, (thread_info_t)&info, &count);
+    mach_port_deallocate(mach_task_self(), thread);
+    if (result != KERN_SUCCESS) {
+        return 0;
+    }
+    return (quint64)(info.user_time.seconds + info.system_time.seconds) * USECS_PER_SECOND +
+        info.user_time.microseconds + info.system_time.microseconds;
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return 0;
+    }
+    return (quint64)time.tv_sec * USECS_PER_SECOND + time.tv_nsec / NSECS_PER_USEC;
+#endif
+}
+
+void EntityScriptEngineShards::addShard(ScriptEnginePointer engine) {
+    auto shard = std::make_shared<Shard>();
+    shard->engine = engine;
+
+    // sample the CPU time of the shard thread once per script frame
+    std::weak_ptr<Shard> weakShard = shard;
+    QObject::connect(engine.data(), &ScriptEngine::update, engine.data(), [weakShard] {
+        auto shard = weakShard.lock();
+        if (!shard) {
+            return;
+        }
+        auto threadCPUUsecs = currentThreadCPUUsecs();
+        if (shard->lastThreadCPUUsecs != 0 && threadCPUUsecs > shard->lastThreadCPUUsecs) {
+            shard->cpuUsecs += threadCPUUsecs - shard->lastThreadCPUUsecs;
+        }
+        shard->lastThreadCPUUsecs = threadCPUUsecs;
+    }, Qt::DirectConnection);
+
+    Lock lock(_shardsMutex);
+    _shards.push_back(shard);
+}
+
+void EntityScriptEngineShards::clear() {
+    Lock lock(_shardsMutex);
+    _shards.clear();
+    _entityShards.clear();
+}
+
+int EntityScriptEngineShards::getNumShards() const {
+    Lock lock(_shardsMutex);
+    return (int)_shards.size();
+}
+
+int EntityScriptEngineShards::computeShardIndex(const EntityItemID& entityID, const QUuid& owningAvatarID) const {
+    // caller holds _shardsMutex
+    if (_shards.size() <= 1) {
+        return 0;
+    }
+    QUuid key = (_shardingMode == ShardingMode::Owner && !owningAvatarID.isNull()) ? owningAvatarID : entityID;
+    return (int)(qHash(key) % (uint)_shards.size());
+}
+
+EntityScriptEngineShards::ShardPointer EntityScriptEngineShards::getShardForEntity(const EntityItemID& entityID) const {
+    Lock lock(_shardsMutex);
+    if (_shards.empty()) {
+        return ShardPointer();
+    }
+    auto it = _entityShards.constFind(entityID);
+    int index = (it != _entityShards.constEnd()) ? it.value() : computeShardIndex(entityID, QUuid());
+    return _shards[index];
+}
+
+ScriptEnginePointer EntityScriptEngineShards::getEngineForEntity(const EntityItemID& entityID) const {
+    Lock lock(_shardsMutex);
+    auto it = _entityShards.constFind(entityID);
+    if (it == _entityShards.constEnd()) {
+        return ScriptEnginePointer();
+    }
+    return _shards[it.value()]->engine;
+}
+
+ScriptEnginePointer EntityScriptEngineShards::assignEntity(const EntityItemID& entityID, const QUuid& owningAvatarID) {
+    Lock lock(_shardsMutex);
+    if (_shards.empty()) {
+        return ScriptEnginePointer();
+    }
+    auto it = _entityShards.constFind(entityID);
+    if (it != _entityShards.constEnd()) {
+        return _shards[it.value()]->engine;
+    }
+    int index = computeShardIndex(entityID, owningAvatarID);
+    _entityShards.insert(entityID, index);
+    _shards[index]->numEntities++;
+    return _shards[index]->engine;
+}
+
+void EntityScriptEngineShards::releaseEntity(const EntityItemID& entityID) {
+    Lock lock(_shardsMutex);
+    auto it = _entityShards.find(entityID);
+    if (it != _entityShards.end()) {
+        _shards[it.value()]->numEntities--;
+        _entityShards.erase(it);
+    }
+}
+
+QList<EntityItemID> EntityScriptEngineShards::getAssignedEntities() const {
+    Lock lock(_shardsMutex);
+    return _entityShards.keys();
+}
+
+void EntityScriptEngineShards::invokeOnShard(const ShardPointer& shard, std::function<void(ScriptEnginePointer)> function) {
+    if (!shard || !shard->engine) {
+        return;
+    }
+    auto engine = shard->engine;
+    shard->queueDepth++;
+    QMetaObject::invokeMethod(engine.data(), [shard, engine, function] {
+        shard->queueDepth--;
+        shard->invocations++;
+        function(engine);
+    });
+}
+
+void EntityScriptEngineShards::invokeOnEntityShard(const EntityItemID& entityID,
+                                                   std::function<void(ScriptEnginePointer)> function) {
+    invokeOnShard(getShardForEntity(entityID), function);
+}
+
+void EntityScriptEngineShards::forEachEngine(std::function<void(const ScriptEnginePointer&)> function) const {
+    std::vector<ShardPointer> shards;
+    {
+        Lock lock(_shardsMutex);
+        shards = _shards;
+    }
+    for (auto& shard : shards) {
+        function(shard->engine);
+    }
+}
+
+int EntityScriptEngineShards::getNumRunningEntityScripts() const {
+    int numRunningScripts = 0;
+    forEachEngine([&](const ScriptEnginePointer& engine) {
+        numRunningScripts += engine->getNumRunningEntityScripts();
+    });
+    return numRunningScripts;
+}
+
+QJsonArray EntityScriptEngineShards::getStats() const {
+    std::vector<ShardPointer> shards;
+    {
+        Lock lock(_shardsMutex);
+        shards = _shards;
+    }
+
+    QJsonArray shardsStats;
+    for (auto& shard : shards) {
+        QJsonObject shardStats;
+        shardStats["engine"] = shard->engine->getFilename();
+        shardStats["num_entities"] = shard->numEntities.load();
+        shardStats["num_running_scripts"] = shard->engine->getNumRunningEntityScripts();
+        shardStats["queue_depth"] = shard->queueDepth.load();
+        shardStats["invocations"] = (double)shard->invocations.load();
+        shardStats["cpu_time_usecs"] = (double)shard->cpuUsecs.load();
+        shardsStats.append(shardStats);
+    }
+    return shardsStats;
+}
+
+void EntityScriptEngineShards::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                      const QStringList& params, const QUuid& remoteCallerID) {
+    invokeOnEntityShard(entityID, [entityID, methodName, params, remoteCallerID](ScriptEnginePointer engine) {
+        engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+    });
+}
+
+QFuture<QVariant> EntityScriptEngineShards::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    auto shard = getShardForEntity(entityID);
+    if (!shard) {
+        return QFuture<QVariant>();
+    }
+    return shard->engine->getLocalEntityScriptDetails(entityID);
+}
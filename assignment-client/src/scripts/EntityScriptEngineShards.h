@@ -0,0 +1,90 @@
+//
+//  EntityScriptEngineShards.h
+//  assignment-client/src/scripts
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptEngineShards_h
+#define hifi_EntityScriptEngineShards_h
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QUuid>
+
+#include <EntitiesScriptEngineProvider.h>
+#include <ScriptEngine.h>
+
+// Holds the pool of script engines used by the EntityScriptServer. Each engine runs on its own thread
+// and owns the server scripts of the entities assigned to it, so a slow script only stalls its own shard.
+// Entities are assigned to a shard the first time their script is loaded and keep it until they are released.
+class EntityScriptEngineShards : public EntitiesScriptEngineProvider {
+public:
+    enum class ShardingMode {
+        EntityID,   // spread entities by a hash of their ID
+        Owner       // keep entities with the same owning avatar together
+    };
+
+    void addShard(ScriptEnginePointer engine);
+    void clear();
+
+    int getNumShards() const;
+    bool isEmpty() const { return getNumShards() == 0; }
+
+    void setShardingMode(ShardingMode mode) { _shardingMode = mode; }
+    ShardingMode getShardingMode() const { return _shardingMode; }
+
+    // returns the engine currently running the script for this entity, if any
+    ScriptEnginePointer getEngineForEntity(const EntityItemID& entityID) const;
+
+    // assigns the entity to a shard (if it does not already have one) and returns that shard's engine
+    ScriptEnginePointer assignEntity(const EntityItemID& entityID, const QUuid& owningAvatarID);
+    void releaseEntity(const EntityItemID& entityID);
+    QList<EntityItemID> getAssignedEntities() const;
+
+    // runs the function on the thread of the shard that owns (or would own) the entity
+    void invokeOnEntityShard(const EntityItemID& entityID, std::function<void(ScriptEnginePointer)> function);
+
+    void forEachEngine(std::function<void(const ScriptEnginePointer&)> function) const;
+
+    int getNumRunningEntityScripts() const;
+    QJsonArray getStats() const;
+
+    // EntitiesScriptEngineProvider
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params = QStringList(), const QUuid& remoteCallerID = QUuid()) override;
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
+private:
+    struct Shard {
+        ScriptEnginePointer engine;
+        std::atomic<int> queueDepth { 0 };
+        std::atomic<int> numEntities { 0 };
+        std::atomic<quint64> cpuUsecs { 0 };
+        std::atomic<quint64> invocations { 0 };
+        quint64 lastThreadCPUUsecs { 0 }; // only touched on the shard thread
+    };
+    using ShardPointer = std::shared_ptr<Shard>;
+
+    int computeShardIndex(const EntityItemID& entityID, const QUuid& owningAvatarID) const;
+    ShardPointer getShardForEntity(const EntityItemID& entityID) const;
+    void invokeOnShard(const ShardPointer& shard, std::function<void(ScriptEnginePointer)> function);
+
+    mutable std::mutex _shardsMutex;
+    std::vector<ShardPointer> _shards;
+    QHash<EntityItemID, int> _entityShards;
+    std::atomic<ShardingMode> _shardingMode { ShardingMode::EntityID };
+};
+
+using EntityScriptEngineShardsPointer = QSharedPointer<EntityScriptEngineShards>;
+
+#endif // hifi_EntityScriptEngineShards_h
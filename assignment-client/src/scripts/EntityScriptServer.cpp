@@ -127,7 +127,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto engine = _entityScriptEngineShards->getEngineForEntity(entityID);
+        if (engine && engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -169,10 +170,41 @@ void EntityScriptServer::handleSettings() {
 
     qDebug() << QString("Received entity script server settings, Max Entity PPS: %1, Entity PPS Per Entity Script: %2")
                 .arg(_maxEntityPPS).arg(_entityPPSPerScript);
+
+    static const QString SCRIPT_ENGINE_SHARDS_OPTION = "script_engine_shards";
+    static const QString SHARDING_MODE_OPTION = "script_engine_sharding_mode";
+    static const QString SHARDING_MODE_OWNER = "owner";
+
+    auto shardingMode = entityScriptServerSettings[SHARDING_MODE_OPTION].toString() == SHARDING_MODE_OWNER ?
+        EntityScriptEngineShards::ShardingMode::Owner : EntityScriptEngineShards::ShardingMode::EntityID;
+    _entityScriptEngineShards->setShardingMode(shardingMode);
+
+    int numShards = entityScriptServerSettings[SCRIPT_ENGINE_SHARDS_OPTION].toInt(DEFAULT_NUM_SCRIPT_ENGINE_SHARDS);
+    numShards = std::min(std::max(numShards, 1), MAX_NUM_SCRIPT_ENGINE_SHARDS);
+
+    if (numShards != _numScriptEngineShards) {
+        qCDebug(entity_script_server) << "Changing number of script engine shards from" << _numScriptEngineShards
+            << "to" << numShards;
+        _numScriptEngineShards = numShards;
+
+        if (_entityViewer.getTree() && !_shuttingDown) {
+            // restart the scripts that are already running on the new set of shards
+            auto runningEntities = _entityScriptEngineShards->getAssignedEntities();
+            _entityScriptEngineShards->forEachEngine([](const ScriptEnginePointer& engine) {
+                engine->unloadAllEntityScripts();
+                engine->stop();
+                engine->waitTillDoneRunning();
+            });
+            resetEntitiesScriptEngine();
+            for (auto& entityID : runningEntities) {
+                checkAndCallPreload(entityID);
+            }
+        }
+    }
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = _entityScriptEngineShards->getNumRunningEntityScripts();
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplication would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -233,7 +265,7 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
+    if (!_entityScriptEngineShards->isEmpty() && _entityViewer.getTree() && !_shuttingDown) {
         auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
@@ -247,7 +279,7 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        _entityScriptEngineShards->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
     }
 }
 
@@ -433,7 +465,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+ScriptEnginePointer EntityScriptServer::createEntitiesScriptEngine(bool drivesEntityViewer) {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
 
@@ -449,35 +481,45 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
-        _entityViewer.queryOctree();
-        _entityViewer.getTree()->update();
-    });
+    // only one of the shards needs to keep the entity viewer up to date
+    if (drivesEntityViewer) {
+        connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+            _entityViewer.queryOctree();
+            _entityViewer.getTree()->update();
+        });
+    }
 
+    connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+            this, &EntityScriptServer::updateEntityPPS);
 
     newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
+    return newEngine;
+}
 
-    if (_entitiesScriptEngine) {
-        disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+void EntityScriptServer::resetEntitiesScriptEngine() {
+    _entityScriptEngineShards->forEachEngine([this](const ScriptEnginePointer& engine) {
+        disconnect(engine.data(), &ScriptEngine::entityScriptDetailsUpdated,
                    this, &EntityScriptServer::updateEntityPPS);
+    });
+    _entityScriptEngineShards->clear();
+
+    for (int i = 0; i < _numScriptEngineShards; ++i) {
+        _entityScriptEngineShards->addShard(createEntitiesScriptEngine(i == 0));
     }
 
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+    auto shardsProvider = qSharedPointerCast<EntitiesScriptEngineProvider>(_entityScriptEngineShards);
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(shardsProvider);
 }
 
 
 void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
+    // unload and stop the engines
+    _entityScriptEngineShards->forEachEngine([](const ScriptEnginePointer& engine) {
         // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
-        _entitiesScriptEngine->waitTillDoneRunning();
-    }
+        engine->unloadAllEntityScripts();
+        engine->stop();
+        engine->waitTillDoneRunning();
+    });
 
     _entityViewer.clear();
 
@@ -488,9 +530,9 @@ void EntityScriptServer::clear() {
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
-    }
+    _entityScriptEngineShards->forEachEngine([](const ScriptEnginePointer& engine) {
+        engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    });
     _shuttingDown = true;
 
     clear(); // always clear() on shutdown
@@ -498,7 +540,7 @@ void EntityScriptServer::shutdownScriptEngine() {
     auto scriptEngines = DependencyManager::get<ScriptEngines>();
     scriptEngines->shutdownScripting();
 
-    _entitiesScriptEngine.clear();
+    _entityScriptEngineShards->clear();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
@@ -516,8 +558,11 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown) {
+        _entityScriptEngineShards->invokeOnEntityShard(entityID, [entityID](ScriptEnginePointer engine) {
+            engine->unloadEntityScript(entityID, true);
+        });
+        _entityScriptEngineShards->releaseEntity(entityID);
     }
 }
 
@@ -528,27 +573,58 @@ void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool forceRedownload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    if (_entityViewer.getTree() && !_shuttingDown && !_entityScriptEngineShards->isEmpty()) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
-        EntityScriptDetails details;
-        bool isRunning = _entitiesScriptEngine->getEntityScriptDetails(entityID, details);
-        if (entity && (forceRedownload || !isRunning || details.scriptText != entity->getServerScripts())) {
-            if (isRunning) {
-                _entitiesScriptEngine->unloadEntityScript(entityID, true);
+        if (!entity) {
+            return;
+        }
+
+        QString scriptUrl = entity->getServerScripts();
+        auto engine = _entityScriptEngineShards->getEngineForEntity(entityID);
+        if (!engine) {
+            if (scriptUrl.isEmpty()) {
+                return;
             }
+            engine = _entityScriptEngineShards->assignEntity(entityID, entity->getOwningAvatarID());
+        }
 
-            QString scriptUrl = entity->getServerScripts();
+        EntityScriptDetails details;
+        bool isRunning = engine->getEntityScriptDetails(entityID, details);
+        if (forceRedownload || !isRunning || details.scriptText != scriptUrl) {
             if (!scriptUrl.isEmpty()) {
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, forceRedownload);
+            }
+
+            // the shard unloads and loads on its own thread, in order, so the script is never left half-replaced
+            _entityScriptEngineShards->invokeOnEntityShard(entityID,
+                [entityID, scriptUrl, isRunning, forceRedownload](ScriptEnginePointer engine) {
+                if (isRunning) {
+                    engine->unloadEntityScript(entityID, true);
+                }
+                if (!scriptUrl.isEmpty()) {
+                    engine->loadEntityScript(entityID, scriptUrl, forceRedownload);
+                }
+            });
+
+            if (scriptUrl.isEmpty()) {
+                _entityScriptEngineShards->releaseEntity(entityID);
             }
         }
     }
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    QJsonObject statsObject;
+    QJsonObject entityScriptServerObject;
+
+    entityScriptServerObject["num_shards"] = _entityScriptEngineShards->getNumShards();
+    entityScriptServerObject["sharding_mode"] =
+        _entityScriptEngineShards->getShardingMode() == EntityScriptEngineShards::ShardingMode::Owner ? "owner" : "id";
+    entityScriptServerObject["shards"] = _entityScriptEngineShards->getStats();
 
+    statsObject["entity_script_server"] = entityScriptServerObject;
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -23,6 +23,10 @@
 #include <ScriptEngine.h>
 #include <ThreadedAssignment.h>
 #include "../entities/EntityTreeHeadlessViewer.h"
+#include "EntityScriptEngineShards.h"
+
+static const int DEFAULT_NUM_SCRIPT_ENGINE_SHARDS = 1;
+static const int MAX_NUM_SCRIPT_ENGINE_SHARDS = 32;
 
 class EntityScriptServer : public ThreadedAssignment {
     Q_OBJECT
@@ -61,6 +65,7 @@ private:
     void selectAudioFormat(const QString& selectedCodecName);
 
     void resetEntitiesScriptEngine();
+    ScriptEnginePointer createEntitiesScriptEngine(bool drivesEntityViewer);
     void clear();
     void shutdownScriptEngine();
 
@@ -74,7 +79,8 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+    EntityScriptEngineShardsPointer _entityScriptEngineShards { EntityScriptEngineShardsPointer::create() };
+    int _numScriptEngineShards { DEFAULT_NUM_SCRIPT_ENGINE_SHARDS };
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
@@ -306,6 +306,9 @@ void DomainGatekeeper::updateNodePermissions() {
         }
 
         node->setPermissions(userPerms);
+        if (auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData())) {
+            nodeData->invalidateDomainListRecord();
+        }
 
         if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
             qDebug() << "node" << node->getUUID() << "no longer has permission to connect.";
@@ -375,6 +378,7 @@ SharedNodePointer DomainGatekeeper::processAssignmentConnectRequest(const NodeCo
     userPerms.permissions |= NodePermissions::Permission::canWriteToAssetServer;
     userPerms.permissions |= NodePermissions::Permission::canReplaceDomainContent;
     newNode->setPermissions(userPerms);
+    nodeData->invalidateDomainListRecord();
     return newNode;
 }
 
@@ -488,6 +492,9 @@ SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnect
     // grab the linked data for our new node so we can set the username
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(newNode->getLinkedData());
 
+    // the node may have been here before, make sure other nodes hear about its new sockets and permissions
+    nodeData->invalidateDomainListRecord();
+
     // if we have a username from the connect request, set it on the DomainServerNodeData
     nodeData->setUsername(username);
 
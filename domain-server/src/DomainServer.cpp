@@ -737,6 +737,7 @@ void DomainServer::setupNodeListAndAssignments() {
     packetReceiver.registerListener(PacketType::DomainListRequest, this, "processListRequestPacket");
     packetReceiver.registerListener(PacketType::DomainServerPathQuery, this, "processPathQueryPacket");
     packetReceiver.registerListener(PacketType::NodeJsonStats, this, "processNodeJSONStatsPacket");
+    packetReceiver.registerListener(PacketType::TraceSnapshot, this, "processTraceSnapshotPacket");
     packetReceiver.registerListener(PacketType::DomainDisconnectRequest, this, "processNodeDisconnectRequestPacket");
 
     // NodeList won't be available to the settings manager when it is created, so call registerListener here
@@ -1042,11 +1043,17 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     QDataStream packetStream(message->getMessage());
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
 
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
+
     // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr ||
+        sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+        nodeData->invalidateDomainListRecord();
+    }
 
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
+    nodeData->getDomainListDelta().setAcknowledgedVersion(nodeRequestData.domainListVersion);
 
     if (!nodeData->hasCheckedIn()) {
         nodeData->setHasCheckedIn(true);
@@ -1143,6 +1150,7 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     if (shouldReplicateNode(*newNode)) {
         qDebug() << "Setting node to replicated: " << newNode->getUUID();
         newNode->setIsReplicated(true);
+        nodeData->invalidateDomainListRecord();
     }
 
     // send out this node to our other connected nodes
@@ -1151,52 +1159,81 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
 
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
     const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID +
-        NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + 4;
+        NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + 4 + 3 * sizeof(quint32);
+
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
+    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+
+    // only send what changed since the last list the node has all of, or everything if it doesn't
+    auto& listDelta = nodeData->getDomainListDelta();
+
+    std::vector<SharedNodePointer> addedNodes;
+
+    if (nodeInterestSet.size() > 0 && nodeData->isAuthenticated()) {
+        listDelta.beginList();
+
+        // if this authenticated node has any interest types, send back those nodes as well
+        limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
+            if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
+                auto otherNodeData = static_cast<DomainServerNodeData*>(otherNode->getLinkedData());
+                if (otherNodeData && listDelta.addNode(otherNode->getUUID(), otherNodeData->getDomainListRecordRevision())) {
+                    addedNodes.push_back(otherNode);
+                }
+            }
+        });
+    } else {
+        // this node doesn't get to hear about anyone, send it an empty list but don't take away what it already has
+        listDelta.beginList(true);
+    }
+    std::vector<QUuid> removedNodes = listDelta.endList();
+    quint32 listVersion = listDelta.getListVersion();
+    quint32 baseVersion = listDelta.getBaseVersion();
 
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
     QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
     QDataStream extendedHeaderStream(&extendedHeader, QIODevice::WriteOnly);
 
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
-
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << limitedNodeList->getSessionLocalID();
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getLocalID();
     extendedHeaderStream << node->getPermissions();
     extendedHeaderStream << limitedNodeList->getAuthenticatePackets();
+    extendedHeaderStream << listVersion;
+    extendedHeaderStream << baseVersion;
+    extendedHeaderStream << (quint32)(addedNodes.size() + removedNodes.size());
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    for (const auto& otherNode : addedNodes) {
+        auto otherNodeData = static_cast<DomainServerNodeData*>(otherNode->getLinkedData());
 
-    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
-    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
 
-    if (nodeInterestSet.size() > 0) {
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        domainListStream << (quint8)LimitedNodeList::DomainListNode;
+        domainListPackets->write(otherNodeData->getDomainListRecord(*otherNode));
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([this, node, &domainListPackets, &domainListStream](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
-
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
+    }
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
-                }
-            });
-        }
+    for (const auto& removedNode : removedNodes) {
+        domainListPackets->startSegment();
+        domainListStream << (quint8)LimitedNodeList::DomainListRemovedNode;
+        domainListStream << removedNode;
+        domainListPackets->endSegment();
     }
 
     // send an empty list to the node, in case there were no other nodes
@@ -1812,6 +1849,58 @@ void DomainServer::processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> pa
     }
 }
 
+void DomainServer::processTraceSnapshotPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode) {
+    respondToTraceRequests(sendingNode->getUUID(), packetList->getMessage());
+}
+
+void DomainServer::requestTraceSnapshot(const SharedNodePointer& node, QPointer<HTTPConnection> connection) {
+    const int TRACE_REQUEST_TIMEOUT_MSECS = 10 * MSECS_PER_SECOND;
+
+    // a snapshot that is already on its way answers every request for it
+    QUuid nodeUUID = node->getUUID();
+    auto& pending = _pendingTraceRequests[nodeUUID];
+    pending.connections.push_back(connection);
+    if (pending.connections.size() > 1) {
+        return;
+    }
+
+    pending.requestID = ++_lastTraceRequestID;
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+    limitedNodeList->sendPacket(NLPacket::create(PacketType::TraceRequest, 0, true), *node);
+
+    quint64 requestID = pending.requestID;
+    QTimer::singleShot(TRACE_REQUEST_TIMEOUT_MSECS, this, [this, nodeUUID, requestID] {
+        auto itr = _pendingTraceRequests.find(nodeUUID);
+        if (itr != _pendingTraceRequests.end() && itr->requestID == requestID) {
+            qCDebug(domain_server) << "Timed out waiting for a trace snapshot from" << uuidStringWithoutCurlyBraces(nodeUUID);
+            respondToTraceRequests(nodeUUID, QByteArray());
+        }
+    });
+}
+
+void DomainServer::respondToTraceRequests(const QUuid& nodeUUID, const QByteArray& snapshot) {
+    auto itr = _pendingTraceRequests.find(nodeUUID);
+    if (itr == _pendingTraceRequests.end()) {
+        return;
+    }
+    auto connections = itr->connections;
+    _pendingTraceRequests.erase(itr);
+
+    auto contentDisposition = "attachment; filename=\"trace-" + uuidStringWithoutCurlyBraces(nodeUUID) + ".json.gz\"";
+    for (auto& connection : connections) {
+        if (!connection) {
+            continue;
+        }
+        if (snapshot.isEmpty()) {
+            connection->respond(HTTPConnection::StatusCode500, "Trace snapshot unavailable");
+        } else {
+            connection->respond(HTTPConnection::StatusCode200, snapshot, "application/gzip", {
+                { "Content-Disposition", contentDisposition.toUtf8() }
+            });
+        }
+    }
+}
+
 QJsonObject DomainServer::jsonForSocket(const HifiSockAddr& socket) {
     QJsonObject socketJSON;
 
@@ -2183,6 +2272,20 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         } else if (url.path() == URI_API_PLACES) {
             return forwardMetaverseAPIRequest(connection, "/api/v1/user/places", "");
         } else {
+            // check if this is for a trace snapshot from an assignment, the node sends it back asynchronously
+            const QString NODE_TRACE_REGEX_STRING = QString("\\%1\\/(%2)\\/trace.json.gz$").arg(URI_NODES).arg(UUID_REGEX_STRING);
+            QRegExp nodeTraceRegex(NODE_TRACE_REGEX_STRING);
+
+            if (nodeTraceRegex.indexIn(url.path()) != -1) {
+                SharedNodePointer matchingNode = nodeList->nodeWithUUID(QUuid(nodeTraceRegex.cap(1)));
+                if (matchingNode && matchingNode->getType() != NodeType::Agent) {
+                    requestTraceSnapshot(matchingNode, connectionPtr);
+                    return true;
+                }
+
+                return false;
+            }
+
             // check if this is for json stats for a node
             const QString NODE_JSON_REGEX_STRING = QString("\\%1\\/(%2).json\\/?$").arg(URI_NODES).arg(UUID_REGEX_STRING);
             QRegExp nodeShowRegex(NODE_JSON_REGEX_STRING);
@@ -3009,7 +3112,10 @@ void DomainServer::updateReplicatedNodes() {
                 qDebug() << "Setting node to replicated:"
                     << otherNode->getPermissions().getVerifiedUserName() << otherNode->getUUID();
             }
-            otherNode->setIsReplicated(shouldReplicate);
+            if (isReplicated != shouldReplicate) {
+                otherNode->setIsReplicated(shouldReplicate);
+                static_cast<DomainServerNodeData*>(otherNode->getLinkedData())->invalidateDomainListRecord();
+            }
         }
     );
 }
@@ -91,6 +91,7 @@ private slots:
     void processRequestAssignmentPacket(QSharedPointer<ReceivedMessage> packet);
     void processListRequestPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode);
+    void processTraceSnapshotPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode);
     void processPathQueryPacket(QSharedPointer<ReceivedMessage> packet);
     void processNodeDisconnectRequestPacket(QSharedPointer<ReceivedMessage> message);
     void processICEServerHeartbeatDenialPacket(QSharedPointer<ReceivedMessage> message);
@@ -169,6 +170,8 @@ private:
     unsigned int countConnectedUsers();
 
     void handleKillNode(SharedNodePointer nodeToKill);
+    void requestTraceSnapshot(const SharedNodePointer& node, QPointer<HTTPConnection> connection);
+    void respondToTraceRequests(const QUuid& nodeUUID, const QByteArray& snapshot);
     void broadcastNodeDisconnect(const SharedNodePointer& disconnnectedNode);
 
     void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
@@ -284,6 +287,13 @@ private:
 
     QHash<QUuid, QPointer<HTTPSConnection>> _pendingOAuthConnections;
 
+    struct PendingTraceRequest {
+        quint64 requestID { 0 };
+        QList<QPointer<HTTPConnection>> connections;
+    };
+    QHash<QUuid, PendingTraceRequest> _pendingTraceRequests;
+    quint64 _lastTraceRequestID { 0 };
+
     std::unordered_map<int, QByteArray> _pendingUploadedContents;
     std::unordered_map<int, std::unique_ptr<QTemporaryFile>> _pendingContentFiles;
 
@@ -11,6 +11,8 @@
 
 #include "DomainServerNodeData.h"
 
+#include <atomic>
+
 #include <QtCore/QDataStream>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
@@ -21,10 +23,27 @@
 
 DomainServerNodeData::StringPairHash DomainServerNodeData::_overrideHash;
 
-DomainServerNodeData::DomainServerNodeData() {
+static std::atomic<quint64> nextDomainListRecordRevision { 1 };
+
+DomainServerNodeData::DomainServerNodeData() :
+    _domainListRecordRevision(nextDomainListRecordRevision++)
+{
     _paymentIntervalTimer.start();
 }
 
+const QByteArray& DomainServerNodeData::getDomainListRecord(const Node& node) {
+    if (_domainListRecord.isEmpty()) {
+        QDataStream recordStream(&_domainListRecord, QIODevice::WriteOnly);
+        recordStream << node;
+    }
+    return _domainListRecord;
+}
+
+void DomainServerNodeData::invalidateDomainListRecord() {
+    _domainListRecord.clear();
+    _domainListRecordRevision = nextDomainListRecordRevision++;
+}
+
 void DomainServerNodeData::updateJSONStats(QByteArray statsByteArray) {
     auto document = QJsonDocument::fromBinaryData(statsByteArray);
     Q_ASSERT(document.isObject());
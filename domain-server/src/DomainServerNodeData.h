@@ -17,8 +17,10 @@
 #include <QtCore/QUuid>
 #include <QtCore/QJsonObject>
 
+#include <DomainListDelta.h>
 #include <HifiSockAddr.h>
 #include <NLPacket.h>
+#include <Node.h>
 #include <NodeData.h>
 #include <NodeType.h>
 
@@ -72,7 +74,16 @@ public:
 
     bool hasCheckedIn() const { return _hasCheckedIn; }
     void setHasCheckedIn(bool hasCheckedIn) { _hasCheckedIn = hasCheckedIn; }
-    
+
+    // This node as it appears in the DomainList of other nodes. It is serialized once and reused for every list
+    // until something in it changes, the revision is unique across all nodes and tells receivers apart from stale copies.
+    const QByteArray& getDomainListRecord(const Node& node);
+    quint64 getDomainListRecordRevision() const { return _domainListRecordRevision; }
+    void invalidateDomainListRecord();
+
+    // what this node was sent and told us it has of the DomainList, to only send it what changed
+    DomainListDeltaSender& getDomainListDelta() { return _domainListDelta; }
+
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
     QJsonArray overrideValuesIfNeeded(const QJsonArray& newStats);
@@ -99,6 +110,11 @@ private:
     bool _wasAssigned { false };
 
     bool _hasCheckedIn { false };
+
+    QByteArray _domainListRecord;
+    quint64 _domainListRecordRevision;
+
+    DomainListDeltaSender _domainListDelta;
 };
 
 #endif // hifi_DomainServerNodeData_h
@@ -41,6 +41,11 @@ NodeConnectionData NodeConnectionData::fromDataStream(QDataStream& dataStream, c
         >> newHeader.publicSockAddr >> newHeader.localSockAddr
         >> newHeader.interestList >> newHeader.placeName;
 
+    if (!isConnectRequest) {
+        // list requests carry the last DomainList version the node has all of
+        dataStream >> newHeader.domainListVersion;
+    }
+
     newHeader.senderSockAddr = senderSockAddr;
     
     if (newHeader.publicSockAddr.getAddress().isNull()) {
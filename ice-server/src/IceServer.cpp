@@ -13,8 +13,12 @@
 
 #include <openssl/x509.h>
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QDataStream>
+#include <QtCore/QFile>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -28,12 +32,56 @@
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+// longer than ICE_HEARBEAT_INTERVAL_MSECS so that an unchanged heartbeat is verified once every few heartbeats
+const quint64 VERIFICATION_RESULT_LIFETIME_USECS = 10 * USECS_PER_SECOND;
+
+// heartbeats past this many waiting for verification are dropped, the domain-server will send another one
+const int MAX_PENDING_VERIFICATIONS = 8192;
+
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
     _id(QUuid::createUuid()),
     _serverSocket(0, false),
     _activePeers()
 {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity ICE server");
+    parser.addHelpOption();
+
+    const QCommandLineOption verificationThreadsOption("verification-threads",
+        "number of threads verifying heartbeat signatures", "count");
+    parser.addOption(verificationThreadsOption);
+
+    const QCommandLineOption localPublicKeyOption("local-public-key",
+        "base64 DER public key used for every domain instead of asking the metaverse API (load testing only)", "path");
+    parser.addOption(localPublicKeyOption);
+
+    parser.process(arguments());
+
+    int verificationThreads = QThread::idealThreadCount();
+    if (parser.isSet(verificationThreadsOption)) {
+        verificationThreads = parser.value(verificationThreadsOption).toInt();
+    }
+    _verificationPool.setMaxThreadCount(std::max(verificationThreads, 1));
+    qDebug() << "Verifying heartbeats on" << _verificationPool.maxThreadCount() << "threads";
+
+    if (parser.isSet(localPublicKeyOption)) {
+        QFile publicKeyFile(parser.value(localPublicKeyOption));
+        if (publicKeyFile.open(QIODevice::ReadOnly)) {
+            auto publicKey = QByteArray::fromBase64(publicKeyFile.readAll().trimmed());
+            const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKey.constData());
+            RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKey.size());
+            if (rsaPublicKey) {
+                _localPublicKey = RSASharedPtr(rsaPublicKey, RSA_free);
+                qWarning() << "Using" << publicKeyFile.fileName() << "as the public key for every domain";
+            }
+        }
+
+        if (!_localPublicKey) {
+            qCritical() << "Could not load a public key from" << publicKeyFile.fileName();
+        }
+    }
+
     // start the ice-server socket
     qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
     _serverSocket.bind(QHostAddress::AnyIPv4, ICE_SERVER_DEFAULT_PORT);
@@ -55,6 +103,12 @@ IceServer::IceServer(int argc, char* argv[]) :
     connect(&networkAccessManager, &QNetworkAccessManager::finished, this, &IceServer::publicKeyReplyFinished);
 }
 
+IceServer::~IceServer() {
+    // verifications still running reference our peers and results, results they post back to us are dropped with us
+    _verificationPool.clear();
+    _verificationPool.waitForDone();
+}
+
 bool IceServer::packetVersionMatch(const udt::Packet& packet) {
     PacketType headerType = NLPacket::typeInHeader(packet);
     PacketVersion headerVersion = NLPacket::versionInHeader(packet);
@@ -74,20 +128,7 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
         
         if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
-            SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
-            if (peer) {
-                // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
-                peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
-
-                // we have an active and verified heartbeating peer
-                // send them an ACK packet so they know that they are being heard and ready for ICE
-                static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
-                _serverSocket.writePacket(*ackPacket, nlPacket->getSenderSockAddr());
-            } else {
-                // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
-                static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
-                _serverSocket.writePacket(*deniedPacket, nlPacket->getSenderSockAddr());
-            }
+            processHeartbeat(*nlPacket);
         } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
             QDataStream heartbeatStream(nlPacket.get());
             
@@ -102,21 +143,31 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
             // check if this node also included a UUID that they would like to connect to
             QUuid connectRequestID;
             heartbeatStream >> connectRequestID;
+
+            // copy what we need out of the peer, the verification threads may be updating it
+            QByteArray matchingPeerInformation;
+            HifiSockAddr matchingPeerSocket;
+            {
+                QReadLocker peersLocker(&_activePeersLock);
+                SharedNetworkPeer matchingPeer = _activePeers.value(connectRequestID);
+                if (matchingPeer && matchingPeer->getActiveSocket()) {
+                    matchingPeerInformation = matchingPeer->toByteArray();
+                    matchingPeerSocket = *matchingPeer->getActiveSocket();
+                }
+            }
             
-            SharedNetworkPeer matchingPeer = _activePeers.value(connectRequestID);
-            
-            if (matchingPeer) {
+            if (!matchingPeerInformation.isEmpty()) {
                 
                 qDebug() << "Sending information for peer" << connectRequestID << "to peer" << senderUUID;
                 
                 // we have the peer they want to connect to - send them pack the information for that peer
-                sendPeerInformationPacket(*matchingPeer, &nlPacket->getSenderSockAddr());
+                sendPeerInformationPacket(matchingPeerInformation, nlPacket->getSenderSockAddr());
                 
                 // we also need to send them to the active peer they are hoping to connect to
                 // create a dummy peer object we can pass to sendPeerInformationPacket
                 
                 NetworkPeer dummyPeer(senderUUID, publicSocket, localSocket);
-                sendPeerInformationPacket(dummyPeer, matchingPeer->getActiveSocket());
+                sendPeerInformationPacket(dummyPeer.toByteArray(), matchingPeerSocket);
             } else {
                 qDebug() << "Peer" << senderUUID << "asked for" << connectRequestID << "but no matching peer found";
             }
@@ -124,85 +175,158 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     }
 }
 
-SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
+void IceServer::processHeartbeat(NLPacket& packet) {
+    Heartbeat heartbeat;
+    heartbeat.senderSockAddr = packet.getSenderSockAddr();
 
     // pull the UUID, public and private sock addrs for this peer
-    QUuid senderUUID;
-    HifiSockAddr publicSocket, localSocket;
-    QByteArray signature;
-
     QDataStream heartbeatStream(&packet);
-    heartbeatStream >> senderUUID >> publicSocket >> localSocket;
+    heartbeatStream >> heartbeat.domainID >> heartbeat.publicSocket >> heartbeat.localSocket;
 
-    auto signedPlaintext = QByteArray::fromRawData(packet.getPayload(), heartbeatStream.device()->pos());
-    heartbeatStream >> signature;
+    // the packet goes away once we return, so take a deep copy of the signed part
+    heartbeat.signedPlaintext = QByteArray(packet.getPayload(), heartbeatStream.device()->pos());
+    heartbeatStream >> heartbeat.signature;
 
-    // make sure this is a verified heartbeat before performing any more processing
-    if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
-        // make sure we have this sender in our peer hash
-        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+    auto publicKey = publicKeyForHeartbeat(heartbeat.domainID);
+    if (!publicKey) {
+        finishHeartbeat(heartbeat, false);
+        return;
+    }
 
-        if (!matchingPeer) {
-            // if we don't have this sender we need to create them now
-            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
-            _activePeers.insert(senderUUID, matchingPeer);
+    // check if we've seen this exact heartbeat signed with this key recently
+    bool haveResult = false;
+    bool verified = false;
+    {
+        std::lock_guard<std::mutex> resultsLock(_verificationResultsMutex);
+        auto it = _verificationResults.constFind(heartbeat.signature);
+        if (it != _verificationResults.constEnd() && it->publicKey == publicKey
+            && it->signedPlaintext == heartbeat.signedPlaintext && it->expiryUsecs > usecTimestampNow()) {
+            haveResult = true;
+            verified = it->verified;
+        }
+    }
 
-            qDebug() << "Added a new network peer" << *matchingPeer;
-        } else {
-            // we already had the peer so just potentially update their sockets
-            matchingPeer->setPublicSocket(publicSocket);
-            matchingPeer->setLocalSocket(localSocket);
+    if (haveResult) {
+        if (verified) {
+            addOrUpdateHeartbeatingPeer(heartbeat);
         }
+        finishHeartbeat(heartbeat, verified);
+    } else if (_pendingVerifications < MAX_PENDING_VERIFICATIONS) {
+        ++_pendingVerifications;
+        QtConcurrent::run(&_verificationPool, [this, heartbeat, publicKey] {
+            verifyHeartbeat(heartbeat, publicKey);
+        });
+    }
+}
 
-        // update our last heard microstamp for this network peer to now
-        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
-        
-        return matchingPeer;
+void IceServer::verifyHeartbeat(const Heartbeat& heartbeat, RSASharedPtr publicKey) {
+    // this runs on _verificationPool
+
+    auto hashedPlaintext = QCryptographicHash::hash(heartbeat.signedPlaintext, QCryptographicHash::Sha256);
+    int verificationResult = RSA_verify(NID_sha256,
+                                        reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
+                                        hashedPlaintext.size(),
+                                        reinterpret_cast<const unsigned char*>(heartbeat.signature.constData()),
+                                        heartbeat.signature.size(),
+                                        publicKey.get());
+
+    // this is the only success case
+    bool verified = (verificationResult == 1);
+
+    {
+        std::lock_guard<std::mutex> resultsLock(_verificationResultsMutex);
+        _verificationResults[heartbeat.signature] = {
+            heartbeat.signedPlaintext, publicKey, verified, usecTimestampNow() + VERIFICATION_RESULT_LIFETIME_USECS
+        };
+    }
+
+    if (verified) {
+        addOrUpdateHeartbeatingPeer(heartbeat);
+    }
+
+    // replies and public key requests go out from the thread that owns the socket
+    QMetaObject::invokeMethod(this, [this, heartbeat, verified] {
+        --_pendingVerifications;
+        finishHeartbeat(heartbeat, verified);
+    }, Qt::QueuedConnection);
+}
+
+void IceServer::finishHeartbeat(const Heartbeat& heartbeat, bool verified) {
+    if (verified) {
+        // we have an active and verified heartbeating peer
+        // send them an ACK packet so they know that they are being heard and ready for ICE
+        static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
+        _serverSocket.writePacket(*ackPacket, heartbeat.senderSockAddr);
     } else {
-        // not verified, return the empty peer object
-        return SharedNetworkPeer();
+        if (!_localPublicKey && _domainPublicKeys.find(heartbeat.domainID) != _domainPublicKeys.end()
+            && !_pendingPublicKeyRequests.contains(heartbeat.domainID)) {
+            // we could not verify this heartbeat with the key we have (stale public key, bad actor)
+            // ask the metaverse API for the right public key
+            qDebug() << "Failed to verify heartbeat for" << heartbeat.domainID << "- re-requesting public key from API.";
+            requestDomainPublicKey(heartbeat.domainID);
+        }
+
+        // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
+        static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
+        _serverSocket.writePacket(*deniedPacket, heartbeat.senderSockAddr);
     }
 }
 
-bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature) {
-    // make sure we're not already waiting for a public key for this domain-server
-    if (!_pendingPublicKeyRequests.contains(domainID)) {
-        // check if we have a public key for this domain ID - if we do not then fire off the request for it
-        auto it = _domainPublicKeys.find(domainID);
-        if (it != _domainPublicKeys.end()) {
+void IceServer::addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat) {
+    QWriteLocker peersLocker(&_activePeersLock);
 
-            // attempt to verify the signature for this heartbeat
-            const auto rsaPublicKey = it->second.get();
+    // make sure we have this sender in our peer hash
+    SharedNetworkPeer matchingPeer = _activePeers.value(heartbeat.domainID);
 
-            if (rsaPublicKey) {
-                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
-                int verificationResult = RSA_verify(NID_sha256,
-                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
-                                                    hashedPlaintext.size(),
-                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
-                                                    signature.size(),
-                                                    rsaPublicKey);
-
-                if (verificationResult == 1) {
-                    // this is the only success case - we return true here to indicate that the heartbeat is verified
-                    return true;
-                } else {
-                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
-                }
+    if (!matchingPeer) {
+        // if we don't have this sender we need to create them now
+        matchingPeer = QSharedPointer<NetworkPeer>::create(heartbeat.domainID, heartbeat.publicSocket,
+                                                           heartbeat.localSocket);
 
-            } else {
-                // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-                qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
-                qWarning() << "Re-requesting public key from API";
-            }
+        // we may be on a verification thread, hand the peer to the thread that removes it
+        matchingPeer->moveToThread(thread());
+        _activePeers.insert(heartbeat.domainID, matchingPeer);
+
+        qDebug() << "Added a new network peer" << *matchingPeer;
+    } else {
+        // we already had the peer so just potentially update their sockets
+        matchingPeer->setPublicSocket(heartbeat.publicSocket);
+        matchingPeer->setLocalSocket(heartbeat.localSocket);
+    }
+
+    // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
+    matchingPeer->activateMatchingOrNewSymmetricSocket(heartbeat.senderSockAddr);
+
+    // update our last heard microstamp for this network peer to now
+    matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+}
+
+IceServer::RSASharedPtr IceServer::publicKeyForHeartbeat(const QUuid& domainID) {
+    if (_localPublicKey) {
+        return _localPublicKey;
+    }
+
+    // make sure we're not already waiting for a public key for this domain-server
+    if (_pendingPublicKeyRequests.contains(domainID)) {
+        return RSASharedPtr();
+    }
+
+    // check if we have a public key for this domain ID - if we do not then fire off the request for it
+    auto it = _domainPublicKeys.find(domainID);
+    if (it != _domainPublicKeys.end()) {
+        if (it->second) {
+            return it->second;
         }
 
-        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
-        // ask the metaverse API for the right public key and return false to indicate that this is not verified
-        requestDomainPublicKey(domainID);
+        // we can't let this user in since we couldn't convert their public key to an RSA key we could use
+        qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
+        qWarning() << "Re-requesting public key from API";
     }
 
-    return false;
+    // we could not verify this heartbeat (missing public key, could not load public key)
+    // ask the metaverse API for the right public key
+    requestDomainPublicKey(domainID);
+    return RSASharedPtr();
 }
 
 void IceServer::requestDomainPublicKey(const QUuid& domainID) {
@@ -254,7 +378,7 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
                 RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, apiPublicKey.size());
 
                 if (rsaPublicKey) {
-                    _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
+                    _domainPublicKeys[domainID] = RSASharedPtr(rsaPublicKey, RSA_free);
                 } else {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
@@ -280,17 +404,19 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
     reply->deleteLater();
 }
 
-void IceServer::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr) {
+void IceServer::sendPeerInformationPacket(const QByteArray& peerInformation, const HifiSockAddr& destinationSockAddr) {
     auto peerPacket = NLPacket::create(PacketType::ICEServerPeerInformation);
 
-    // get the byte array for this peer
-    peerPacket->write(peer.toByteArray());
+    // write the byte array for this peer
+    peerPacket->write(peerInformation);
     
     // write the current packet
-    _serverSocket.writePacket(*peerPacket, *destinationSockAddr);
+    _serverSocket.writePacket(*peerPacket, destinationSockAddr);
 }
 
 void IceServer::clearInactivePeers() {
+    QWriteLocker peersLocker(&_activePeersLock);
+
     NetworkPeerHash::iterator peerItem = _activePeers.begin();
 
     while (peerItem != _activePeers.end()) {
@@ -309,4 +435,22 @@ void IceServer::clearInactivePeers() {
             ++peerItem;
         }
     }
+
+    peersLocker.unlock();
+
+    clearExpiredVerificationResults();
+}
+
+void IceServer::clearExpiredVerificationResults() {
+    auto now = usecTimestampNow();
+
+    std::lock_guard<std::mutex> resultsLock(_verificationResultsMutex);
+    auto it = _verificationResults.begin();
+    while (it != _verificationResults.end()) {
+        if (it->expiryUsecs <= now) {
+            it = _verificationResults.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
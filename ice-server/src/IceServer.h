@@ -12,8 +12,12 @@
 #ifndef hifi_IceServer_h
 #define hifi_IceServer_h
 
+#include <mutex>
+
 #include <QtCore/QCoreApplication>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 #include <QUdpSocket>
 
 #include <openssl/rsa.h>
@@ -32,30 +36,65 @@ class IceServer : public QCoreApplication {
     Q_OBJECT
 public:
     IceServer(int argc, char* argv[]);
+    ~IceServer();
 private slots:
     void clearInactivePeers();
     void publicKeyReplyFinished(QNetworkReply* reply);
 private:
+    using RSASharedPtr = std::shared_ptr<RSA>;
+
+    struct Heartbeat {
+        QUuid domainID;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        QByteArray signedPlaintext;
+        QByteArray signature;
+        HifiSockAddr senderSockAddr;
+    };
+
     bool packetVersionMatch(const udt::Packet& packet);
     void processPacket(std::unique_ptr<udt::Packet> packet);
-    
-    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
-    void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
 
-    bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
+    void processHeartbeat(NLPacket& packet);
+    void verifyHeartbeat(const Heartbeat& heartbeat, RSASharedPtr publicKey);
+    void finishHeartbeat(const Heartbeat& heartbeat, bool verified);
+    void addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat);
+    void sendPeerInformationPacket(const QByteArray& peerInformation, const HifiSockAddr& destinationSockAddr);
+
+    RSASharedPtr publicKeyForHeartbeat(const QUuid& domainID);
     void requestDomainPublicKey(const QUuid& domainID);
+    void clearExpiredVerificationResults();
 
     QUuid _id;
     udt::Socket _serverSocket;
 
+    // written by the verification threads, read by the packet thread for ICE queries
     using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
     NetworkPeerHash _activePeers;
+    QReadWriteLock _activePeersLock;
 
-    using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
-    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
+    using DomainPublicKeyHash = std::unordered_map<QUuid, RSASharedPtr>;
     DomainPublicKeyHash _domainPublicKeys;
 
     QSet<QUuid> _pendingPublicKeyRequests;
+
+    // used for every domain instead of asking the metaverse API, for local load testing
+    RSASharedPtr _localPublicKey;
+
+    // RSA_verify runs here so that ICE queries are not stuck behind heartbeat verification
+    QThreadPool _verificationPool;
+    int _pendingVerifications { 0 };
+
+    // a domain-server re-sends the same signed heartbeat until its sockets change, so remember recent
+    // verification results by signature instead of re-running RSA_verify every couple of seconds
+    struct VerificationResult {
+        QByteArray signedPlaintext;
+        RSASharedPtr publicKey;
+        bool verified;
+        quint64 expiryUsecs;
+    };
+    QHash<QByteArray, VerificationResult> _verificationResults;
+    std::mutex _verificationResultsMutex;
 };
 
 #endif // hifi_IceServer_h
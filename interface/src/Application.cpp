@@ -5463,6 +5463,10 @@ void Application::init() {
         return atan2(maxSize, distance);
     });
 
+    auto shapeCache = std::make_shared<ShapeCache>(ShapeCache::DIRNAME);
+    shapeCache->initialize();
+    shapeCache->setMaxSize(ShapeCache::DEFAULT_SHAPE_CACHE_SIZE);
+    _shapeManager.setShapeCache(shapeCache);
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
 
@@ -6920,6 +6924,8 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType) {
         _octreeQuery.setBoundaryLevelAdjust(lodManager->getBoundaryLevelAdjust());
     }
     _octreeQuery.setReportInitialCompletion(isModifiedQuery);
+    _octreeQuery.setWantCompressionDictionary(true);
+    _octreeQuery.setCompressionDictionaryID(_octreeProcessor.getCompressionDictionaryID());
 
 
     auto nodeList = DependencyManager::get<NodeList>();
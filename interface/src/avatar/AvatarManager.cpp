@@ -110,6 +110,7 @@ void AvatarManager::init() {
         QWriteLocker locker(&_hashLock);
         _avatarHash.insert(MY_AVATAR_KEY, _myAvatar);
     }
+    _spatialGrid.update(MY_AVATAR_KEY, _myAvatar, _myAvatar->getWorldPosition());
 
     _shouldRender = DependencyManager::get<SceneScriptingInterface>()->shouldRenderAvatars();
     connect(DependencyManager::get<SceneScriptingInterface>().data(), &SceneScriptingInterface::shouldRenderAvatarsChanged,
@@ -165,6 +166,7 @@ void AvatarManager::updateMyAvatar(float deltaTime) {
     handleTransitAnimations(status);
 
     _myAvatar->update(deltaTime);
+    _spatialGrid.update(MY_AVATAR_KEY, _myAvatar, _myAvatar->getWorldPosition());
     render::Transaction transaction;
     _myAvatar->updateRenderItem(transaction);
     qApp->getMain3DScene()->enqueueTransaction(transaction);
@@ -341,6 +343,8 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                     avatar->setIsNewAvatar(false);
                 }
                 avatar->simulate(deltaTime, inView);
+                // simulation smooths the position, and transits can carry avatars far from their last packet
+                updateSpatialGrid(avatar->getSessionUUID(), avatar);
                 if (avatar->getSkeletonModel()->isLoaded() && avatar->getWorkloadRegion() == workload::Region::R1) {
                     _myAvatar->addAvatarHandsToFlow(avatar);
                 }
@@ -565,6 +569,7 @@ void AvatarManager::clearOtherAvatars() {
             auto avatar = std::static_pointer_cast<Avatar>(avatarIterator.value());
             if (avatar != _myAvatar) {
                 removedAvatars.push_back(avatar);
+                _spatialGrid.remove(avatarIterator.key());
                 avatarIterator = _avatarHash.erase(avatarIterator);
             } else {
                 ++avatarIterator;
@@ -579,6 +584,7 @@ void AvatarManager::clearOtherAvatars() {
 
 void AvatarManager::deleteAllAvatars() {
     assert(_avatarsToChangeInPhysics.empty());
+    _spatialGrid.clear();
     QReadLocker locker(&_hashLock);
     AvatarHash::iterator avatarIterator = _avatarHash.begin();
     while (avatarIterator != _avatarHash.end()) {
@@ -724,11 +730,7 @@ RayToAvatarIntersectionResult AvatarManager::findRayIntersectionVector(const Pic
             QVariantMap extraInfo;
             AvatarPointer avatar = nullptr;
             if (_myAvatar->getSessionUUID() != avatarID) {
-                auto avatarMap = getHashCopy();
-                AvatarHash::iterator itr = avatarMap.find(avatarID);
-                if (itr != avatarMap.end()) {
-                    avatar = std::static_pointer_cast<Avatar>(*itr);
-                }
+                avatar = std::static_pointer_cast<Avatar>(findAvatar(avatarID));
             } else {
                 avatar = _myAvatar;
             }
@@ -11,6 +11,7 @@
 
 #include "OctreePacketProcessor.h"
 
+#include <OctreeCompressionDictionary.h>
 #include <PerfStat.h>
 
 #include "Application.h"
@@ -26,6 +27,7 @@ OctreePacketProcessor::OctreePacketProcessor():
     const PacketReceiver::PacketTypeList octreePackets =
         { PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase, PacketType::EntityQueryInitialResultsComplete };
     packetReceiver.registerDirectListenerForTypes(octreePackets, this, "handleOctreePacket");
+    packetReceiver.registerListener(PacketType::EntityCompressionDictionary, this, "handleCompressionDictionaryPacket");
 }
 
 OctreePacketProcessor::~OctreePacketProcessor() { }
@@ -34,6 +36,15 @@ void OctreePacketProcessor::handleOctreePacket(QSharedPointer<ReceivedMessage> m
     queueReceivedPacket(message, senderNode);
 }
 
+void OctreePacketProcessor::handleCompressionDictionaryPacket(QSharedPointer<ReceivedMessage> message,
+                                                              SharedNodePointer senderNode) {
+    auto dictionary = OctreeCompressionDictionary::fromByteArray(message->getMessage());
+    if (dictionary) {
+        OctreeCompressionDictionary::registerDictionary(dictionary);
+        _compressionDictionaryID = dictionary->getID();
+    }
+}
+
 void OctreePacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                             "OctreePacketProcessor::processPacket()");
@@ -12,6 +12,8 @@
 #ifndef hifi_OctreePacketProcessor_h
 #define hifi_OctreePacketProcessor_h
 
+#include <atomic>
+
 #include <ReceivedPacketProcessor.h>
 #include <ReceivedMessage.h>
 
@@ -29,6 +31,9 @@ public:
     bool isLoadSequenceComplete() const { return _safeLanding->isLoadSequenceComplete(); }
     float domainLoadingProgress() const { return _safeLanding->loadingProgressPercentage(); }
 
+    // the compression dictionary we were last sent by the entity server, reported back in our queries
+    uint32_t getCompressionDictionaryID() const { return _compressionDictionaryID; }
+
 signals:
     void packetVersionMismatch();
 
@@ -37,8 +42,10 @@ protected:
 
 private slots:
     void handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleCompressionDictionaryPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
     std::unique_ptr<SafeLanding> _safeLanding;
+    std::atomic<uint32_t> _compressionDictionaryID { 0 };
 };
 #endif  // hifi_OctreePacketProcessor_h
@@ -18,6 +18,7 @@
 #include <QMutex>
 #include <QScriptValue>
 #include <vector>
+#include <atomic>
 #include <JointData.h>
 #include <QReadWriteLock>
 
@@ -435,7 +436,8 @@ protected:
     bool _enableInverseKinematics { true };
     bool _enabledAnimations { true };
 
-    mutable uint32_t _jointNameWarningCount { 0 };
+    // joint names are looked up by the models skinned to this rig, from worker threads
+    mutable std::atomic<uint32_t> _jointNameWarningCount { 0 };
 
     bool _enableDebugDrawIKTargets { false };
     bool _enableDebugDrawIKConstraints { false };
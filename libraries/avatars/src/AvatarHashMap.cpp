@@ -17,6 +17,7 @@
 #include <udt/PacketHeaders.h>
 #include <PerfStat.h>
 #include <SharedUtil.h>
+#include <TBBHelpers.h>
 
 #include "AvatarLogging.h"
 #include "AvatarTraits.h"
@@ -53,10 +54,19 @@ std::vector<QUuid> AvatarReplicas::getReplicaIDs(const QUuid& parentID) {
     return ids;
 }
 
+std::vector<AvatarSharedPointer> AvatarReplicas::getReplicas(const QUuid& parentID) const {
+    auto it = _replicasMap.find(parentID);
+    if (it != _replicasMap.end()) {
+        return it->second;
+    }
+    return std::vector<AvatarSharedPointer>();
+}
+
 void AvatarReplicas::parseDataFromBuffer(const QUuid& parentID, const QByteArray& buffer) {
-    if (_replicasMap.find(parentID) != _replicasMap.end()) {
-        auto &replicas = _replicasMap[parentID];
-        for (auto avatar : replicas) {
+    // only looks the parent up, so that avatars can be parsed in parallel
+    auto it = _replicasMap.find(parentID);
+    if (it != _replicasMap.end()) {
+        for (auto& avatar : it->second) {
             avatar->parseDataFromBuffer(buffer);
         }
     }
@@ -143,10 +153,9 @@ QVector<QUuid> AvatarHashMap::getAvatarIdentifiers() {
 }
 
 QVector<QUuid> AvatarHashMap::getAvatarsInRange(const glm::vec3& position, float rangeMeters) const {
-    auto hashCopy = getHashCopy();
     QVector<QUuid> avatarsInRange;
     auto rangeMetersSquared = rangeMeters * rangeMeters;
-    for (const AvatarSharedPointer& sharedAvatar : hashCopy) {
+    for (const AvatarSharedPointer& sharedAvatar : _spatialGrid.findInSphere(position, rangeMeters)) {
         glm::vec3 avatarPosition = sharedAvatar->getWorldPosition();
         auto distanceSquared = glm::distance2(avatarPosition, position);
         if (distanceSquared < rangeMetersSquared) {
@@ -157,8 +166,7 @@ QVector<QUuid> AvatarHashMap::getAvatarsInRange(const glm::vec3& position, float
 }
 
 bool AvatarHashMap::isAvatarInRange(const glm::vec3& position, const float range) {
-    auto hashCopy = getHashCopy();
-    foreach(const AvatarSharedPointer& sharedAvatar, hashCopy) {
+    for (const AvatarSharedPointer& sharedAvatar : _spatialGrid.findInSphere(position, range)) {
         glm::vec3 avatarPosition = sharedAvatar->getWorldPosition();
         float distance = glm::distance(avatarPosition, position);
         if (distance < range) {
@@ -184,10 +192,9 @@ void AvatarHashMap::setReplicaCount(int count) {
 }
 
 int AvatarHashMap::numberOfAvatarsInRange(const glm::vec3& position, float rangeMeters) {
-    auto hashCopy = getHashCopy();
     auto rangeMeters2 = rangeMeters * rangeMeters;
     int count = 0;
-    for (const AvatarSharedPointer& sharedAvatar : hashCopy) {
+    for (const AvatarSharedPointer& sharedAvatar : _spatialGrid.findInSphere(position, rangeMeters)) {
         glm::vec3 avatarPosition = sharedAvatar->getWorldPosition();
         auto distance2 = glm::distance2(avatarPosition, position);
         if (distance2 < rangeMeters2) {
@@ -213,6 +220,7 @@ AvatarSharedPointer AvatarHashMap::addAvatar(const QUuid& sessionUUID, const QWe
     {
         QWriteLocker locker(&_hashLock);
         _avatarHash.insert(sessionUUID, avatar);
+        _spatialGrid.update(sessionUUID, avatar, avatar->getWorldPosition());
     }
     emit avatarAddedEvent(sessionUUID);
     return avatar;
@@ -241,53 +249,90 @@ AvatarSharedPointer AvatarHashMap::findAvatar(const QUuid& sessionUUID) const {
 void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     DETAILED_PROFILE_RANGE(network, __FUNCTION__);
     PerformanceTimer perfTimer("receiveAvatar");
-    // enumerate over all of the avatars in this packet
-    // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
-    while (message->getBytesLeftToRead()) {
-        parseAvatarData(message, sendingNode);
-    }
-}
-
-AvatarSharedPointer AvatarHashMap::parseAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
-
-    int positionBeforeRead = message->getPosition();
 
-    QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
+    std::vector<AvatarDataRecord> records;
+    splitAvatarDataPacket(*message, records);
 
-    // make sure this isn't our own avatar data or for a previously ignored node
+    // enumerate over all of the avatars in this packet
+    // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
     auto nodeList = DependencyManager::get<NodeList>();
-    bool isNewAvatar;
-    if (sessionUUID != _lastOwnerSessionUUID && (!nodeList->isIgnoringNode(sessionUUID) || nodeList->getRequestsDomainListData())) {
-        auto avatar = newOrExistingAvatar(sessionUUID, sendingNode, isNewAvatar);
+    for (auto& record : records) {
+        // make sure this isn't our own avatar data or for a previously ignored node
+        if (record.sessionUUID == _lastOwnerSessionUUID ||
+            (nodeList->isIgnoringNode(record.sessionUUID) && !nodeList->getRequestsDomainListData())) {
+            continue;
+        }
 
-        if (isNewAvatar) {
+        record.avatar = newOrExistingAvatar(record.sessionUUID, sendingNode, record.isNew);
+        if (record.isNew) {
             QWriteLocker locker(&_hashLock);
-            avatar->setIsNewAvatar(true);
-            auto replicaIDs = _replicas.getReplicaIDs(sessionUUID);
+            record.avatar->setIsNewAvatar(true);
+            auto replicaIDs = _replicas.getReplicaIDs(record.sessionUUID);
             for (auto replicaID : replicaIDs) {
                 auto replicaAvatar = addAvatar(replicaID, sendingNode);
                 replicaAvatar->setIsNewAvatar(true);
-                _replicas.addReplica(sessionUUID, replicaAvatar);
+                _replicas.addReplica(record.sessionUUID, replicaAvatar);
             }
-        } 
-        
-        // have the matching (or new) avatar parse the data from the packet
-        int bytesRead = avatar->parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
-        _replicas.parseDataFromBuffer(sessionUUID, byteArray);
-        
-
-        return avatar;
+        }
+    }
+
+    // an avatar initializes itself on its first parse, so new ones are parsed here and the rest in parallel
+    const size_t MIN_AVATARS_TO_PARSE_IN_PARALLEL = 8;
+    std::vector<const AvatarDataRecord*> existingAvatarRecords;
+    existingAvatarRecords.reserve(records.size());
+    for (const auto& record : records) {
+        if (record.avatar && record.isNew) {
+            parseAvatarData(record);
+        } else if (record.avatar) {
+            existingAvatarRecords.push_back(&record);
+        }
+    }
+    if (existingAvatarRecords.size() >= MIN_AVATARS_TO_PARSE_IN_PARALLEL) {
+        tbb::parallel_for(size_t(0), existingAvatarRecords.size(), [&](size_t i) {
+            parseAvatarData(*existingAvatarRecords[i]);
+        });
     } else {
-        // create a dummy AvatarData class to throw this data on the ground
-        AvatarData dummyData;
-        int bytesRead = dummyData.parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
-        return std::make_shared<AvatarData>();
+        for (const auto record : existingAvatarRecords) {
+            parseAvatarData(*record);
+        }
+    }
+
+    bool hasReplicas = _replicas.getReplicaCount() > 0;
+    for (const auto& record : records) {
+        if (record.avatar) {
+            updateSpatialGrid(record.sessionUUID, record.avatar);
+            if (hasReplicas) {
+                for (const auto& replica : _replicas.getReplicas(record.sessionUUID)) {
+                    updateSpatialGrid(replica->getID(), replica);
+                }
+            }
+        }
     }
 }
 
+void AvatarHashMap::splitAvatarDataPacket(ReceivedMessage& message, std::vector<AvatarDataRecord>& records) {
+    // the data of each avatar is preceded by its size, which includes the session UUID at its start
+    while (message.getBytesLeftToRead() >= (qint64)sizeof(quint16)) {
+        quint16 recordSize;
+        message.readPrimitive(&recordSize);
+        if (recordSize < NUM_BYTES_RFC4122_UUID || recordSize > message.getBytesLeftToRead()) {
+            qCWarning(avatars) << "Dropping the rest of a BulkAvatarData packet with a bad avatar data size" << recordSize;
+            return;
+        }
+
+        AvatarDataRecord record;
+        record.sessionUUID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        record.data = message.readWithoutCopy(recordSize - NUM_BYTES_RFC4122_UUID);
+        records.push_back(record);
+    }
+}
+
+void AvatarHashMap::parseAvatarData(const AvatarDataRecord& record) {
+    // have the matching (or new) avatar parse the data from the packet
+    record.avatar->parseDataFromBuffer(record.data);
+    _replicas.parseDataFromBuffer(record.sessionUUID, record.data);
+}
+
 void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     QDataStream avatarIdentityStream(message->getMessage());
 
@@ -485,12 +530,14 @@ void AvatarHashMap::removeAvatar(const QUuid& sessionUUID, KillAvatarReason remo
         for (auto& replica : replicas) {
             auto removedReplica = _avatarHash.take(replica->getID());
             if (removedReplica) {
+                _spatialGrid.remove(replica->getID());
                 removedAvatars.push_back(removedReplica);
             }
         }
 
         auto removedAvatar = _avatarHash.take(sessionUUID);
         if (removedAvatar) {
+            _spatialGrid.remove(sessionUUID);
             removedAvatars.push_back(removedAvatar);
         }
     }
@@ -509,6 +556,15 @@ void AvatarHashMap::handleRemovedAvatar(const AvatarSharedPointer& removedAvatar
     emit avatarRemovedEvent(removedAvatar->getSessionUUID());
 }
 
+void AvatarHashMap::updateSpatialGrid(const QUuid& id, const AvatarSharedPointer& avatar) {
+    // removals take the avatar out of the hash and the grid under the write lock, holding the read lock keeps
+    // a removed avatar from being put back into the grid
+    QReadLocker locker(&_hashLock);
+    if (_avatarHash.value(id) == avatar) {
+        _spatialGrid.update(id, avatar, avatar->getWorldPosition());
+    }
+}
+
 void AvatarHashMap::sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& oldUUID) {
     _lastOwnerSessionUUID = oldUUID;
     emit avatarSessionChangedEvent(sessionUUID, oldUUID);
@@ -30,6 +30,7 @@
 #include "ScriptAvatarData.h"
 
 #include "AvatarData.h"
+#include "AvatarSpatialGrid.h"
 #include "AssociatedTraitValues.h"
 
 const int CLIENT_TO_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 50;
@@ -51,6 +52,7 @@ public:
     AvatarReplicas() {}
     void addReplica(const QUuid& parentID, AvatarSharedPointer replica);
     std::vector<QUuid> getReplicaIDs(const QUuid& parentID);
+    std::vector<AvatarSharedPointer> getReplicas(const QUuid& parentID) const;
     void parseDataFromBuffer(const QUuid& parentID, const QByteArray& buffer);
     void processAvatarIdentity(const QUuid& parentID, const QByteArray& identityData, bool& identityChanged, bool& displayNameChanged);
     void removeReplicas(const QUuid& parentID);
@@ -225,7 +227,16 @@ protected slots:
 protected:
     AvatarHashMap();
 
-    virtual AvatarSharedPointer parseAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+    // the data of one avatar in a BulkAvatarData packet
+    struct AvatarDataRecord {
+        QUuid sessionUUID;
+        QByteArray data;
+        AvatarSharedPointer avatar;
+        bool isNew { false };
+    };
+
+    void splitAvatarDataPacket(ReceivedMessage& message, std::vector<AvatarDataRecord>& records);
+    void parseAvatarData(const AvatarDataRecord& record);
     virtual AvatarSharedPointer newSharedAvatar(const QUuid& sessionUUID);
     virtual AvatarSharedPointer addAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer);
     AvatarSharedPointer newOrExistingAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer,
@@ -234,10 +245,16 @@ protected:
     virtual void removeAvatar(const QUuid& sessionUUID, KillAvatarReason removalReason = KillAvatarReason::NoReason);
     
     virtual void handleRemovedAvatar(const AvatarSharedPointer& removedAvatar, KillAvatarReason removalReason = KillAvatarReason::NoReason);
+
+    // moves the avatar in _spatialGrid, unless it was taken out of _avatarHash in the meantime (uses a QReadLocker on the hashLock)
+    void updateSpatialGrid(const QUuid& id, const AvatarSharedPointer& avatar);
     
     mutable QReadWriteLock _hashLock;
     AvatarHash _avatarHash;
 
+    // the positions of the avatars in _avatarHash, under the same keys; avatars are removed from both under the write lock
+    AvatarSpatialGrid _spatialGrid;
+
     std::unordered_map<QUuid, AvatarTraits::TraitVersions> _processedTraitVersions;
     AvatarReplicas _replicas;
 
@@ -0,0 +1,150 @@
+//
+//  AvatarSpatialGrid.cpp
+//  libraries/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarSpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtx/norm.hpp>
+
+const float AvatarSpatialGrid::CELL_SIZE = 8.0f;
+const float AvatarSpatialGrid::POSITION_SLACK = 2.0f;
+
+// cell coordinates are packed into 21 bits each, which covers far more than the extent of a domain
+static const int CELL_BITS = 21;
+static const int CELL_OFFSET = 1 << (CELL_BITS - 1);
+static const uint64_t CELL_MASK = (1 << CELL_BITS) - 1;
+
+static int toCellCoordinate(float position) {
+    const float MAX_CELL = (float)(CELL_OFFSET - 1);
+    float cell = floorf(position / AvatarSpatialGrid::CELL_SIZE);
+    if (cell >= -MAX_CELL && cell <= MAX_CELL) {
+        return (int)cell;
+    }
+    // NaN fails every comparison and lands in cell 0
+    return cell > 0.0f ? (int)MAX_CELL : (cell < 0.0f ? -(int)MAX_CELL : 0);
+}
+
+glm::ivec3 AvatarSpatialGrid::toCell(const glm::vec3& position) {
+    return glm::ivec3(toCellCoordinate(position.x), toCellCoordinate(position.y), toCellCoordinate(position.z));
+}
+
+AvatarSpatialGrid::CellKey AvatarSpatialGrid::toCellKey(const glm::ivec3& cell) {
+    return ((uint64_t)(cell.x + CELL_OFFSET) << (2 * CELL_BITS)) |
+        ((uint64_t)(cell.y + CELL_OFFSET) << CELL_BITS) |
+        (uint64_t)(cell.z + CELL_OFFSET);
+}
+
+glm::ivec3 AvatarSpatialGrid::fromCellKey(CellKey key) {
+    return glm::ivec3((int)((key >> (2 * CELL_BITS)) & CELL_MASK) - CELL_OFFSET,
+                      (int)((key >> CELL_BITS) & CELL_MASK) - CELL_OFFSET,
+                      (int)(key & CELL_MASK) - CELL_OFFSET);
+}
+
+void AvatarSpatialGrid::removeFromCell(const Entry* entry) {
+    auto cellItr = _cells.find(entry->cell);
+    if (cellItr == _cells.end()) {
+        return;
+    }
+    auto& cellEntries = cellItr->second;
+    auto itr = std::find(cellEntries.begin(), cellEntries.end(), entry);
+    if (itr != cellEntries.end()) {
+        *itr = cellEntries.back();
+        cellEntries.pop_back();
+    }
+    if (cellEntries.empty()) {
+        _cells.erase(cellItr);
+    }
+}
+
+void AvatarSpatialGrid::update(const QUuid& id, const AvatarSharedPointer& avatar, const glm::vec3& position) {
+    CellKey cell = toCellKey(toCell(position));
+
+    QWriteLocker locker(&_lock);
+    auto itr = _entries.find(id);
+    if (itr == _entries.end()) {
+        itr = _entries.emplace(id, Entry { avatar, position, cell }).first;
+        _cells[cell].push_back(&itr->second);
+        return;
+    }
+
+    Entry& entry = itr->second;
+    entry.avatar = avatar;
+    entry.position = position;
+    if (entry.cell != cell) {
+        removeFromCell(&entry);
+        entry.cell = cell;
+        _cells[cell].push_back(&entry);
+    }
+}
+
+void AvatarSpatialGrid::remove(const QUuid& id) {
+    QWriteLocker locker(&_lock);
+    auto itr = _entries.find(id);
+    if (itr != _entries.end()) {
+        removeFromCell(&itr->second);
+        _entries.erase(itr);
+    }
+}
+
+void AvatarSpatialGrid::clear() {
+    QWriteLocker locker(&_lock);
+    _cells.clear();
+    _entries.clear();
+}
+
+size_t AvatarSpatialGrid::size() const {
+    QReadLocker locker(&_lock);
+    return _entries.size();
+}
+
+std::vector<AvatarSharedPointer> AvatarSpatialGrid::findInSphere(const glm::vec3& center, float radius) const {
+    std::vector<AvatarSharedPointer> avatars;
+    float reach = radius + POSITION_SLACK;
+    float reachSquared = reach * reach;
+    glm::ivec3 minCell = toCell(center - glm::vec3(reach));
+    glm::ivec3 maxCell = toCell(center + glm::vec3(reach));
+
+    QReadLocker locker(&_lock);
+    auto visitCell = [&](const std::vector<const Entry*>& cellEntries) {
+        for (const Entry* entry : cellEntries) {
+            if (glm::distance2(entry->position, center) <= reachSquared) {
+                auto avatar = entry->avatar.lock();
+                if (avatar) {
+                    avatars.push_back(avatar);
+                }
+            }
+        }
+    };
+
+    // a large radius covers more cells than there are avatars, in which case visit the occupied cells instead
+    glm::vec3 cellCounts = glm::vec3(maxCell - minCell) + 1.0f;
+    if (cellCounts.x * cellCounts.y * cellCounts.z > (float)_cells.size()) {
+        for (const auto& cell : _cells) {
+            glm::ivec3 coordinates = fromCellKey(cell.first);
+            if (glm::all(glm::greaterThanEqual(coordinates, minCell)) && glm::all(glm::lessThanEqual(coordinates, maxCell))) {
+                visitCell(cell.second);
+            }
+        }
+    } else {
+        for (int x = minCell.x; x <= maxCell.x; x++) {
+            for (int y = minCell.y; y <= maxCell.y; y++) {
+                for (int z = minCell.z; z <= maxCell.z; z++) {
+                    auto itr = _cells.find(toCellKey(glm::ivec3(x, y, z)));
+                    if (itr != _cells.end()) {
+                        visitCell(itr->second);
+                    }
+                }
+            }
+        }
+    }
+    return avatars;
+}
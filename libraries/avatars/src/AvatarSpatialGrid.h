@@ -0,0 +1,62 @@
+//
+//  AvatarSpatialGrid.h
+//  libraries/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSpatialGrid_h
+#define hifi_AvatarSpatialGrid_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+
+#include <UUIDHasher.h>
+
+#include "AvatarData.h"
+
+/// A uniform grid over avatar positions, so that range queries only visit the avatars in nearby cells instead of copying
+/// and scanning the whole AvatarHash.  Positions are those of the last update, and an avatar may have moved a little
+/// since, so queries reach POSITION_SLACK further and return candidates that callers check against current positions.
+class AvatarSpatialGrid {
+public:
+    static const float CELL_SIZE; // meters
+    static const float POSITION_SLACK; // meters
+
+    void update(const QUuid& id, const AvatarSharedPointer& avatar, const glm::vec3& position);
+    void remove(const QUuid& id);
+    void clear();
+    size_t size() const;
+
+    /// \return the avatars last seen within radius + POSITION_SLACK of center
+    std::vector<AvatarSharedPointer> findInSphere(const glm::vec3& center, float radius) const;
+
+private:
+    using CellKey = uint64_t;
+
+    struct Entry {
+        AvatarWeakPointer avatar;
+        glm::vec3 position;
+        CellKey cell;
+    };
+
+    static glm::ivec3 toCell(const glm::vec3& position);
+    static CellKey toCellKey(const glm::ivec3& cell);
+    static glm::ivec3 fromCellKey(CellKey key);
+
+    void removeFromCell(const Entry* entry);
+
+    mutable QReadWriteLock _lock;
+    std::unordered_map<QUuid, Entry> _entries;
+    std::unordered_map<CellKey, std::vector<const Entry*>> _cells;
+};
+
+#endif // hifi_AvatarSpatialGrid_h
@@ -13,6 +13,8 @@
 
 #include "ModelBakingLoggingCategory.h"
 
+BakeCachePointer Baker::_bakeCache;
+
 bool Baker::shouldStop() {
     if (_shouldAbort) {
         setWasAborted(true);
@@ -59,3 +61,15 @@ void Baker::setWasAborted(bool wasAborted) {
         emit aborted();
     }
 }
+
+bool Baker::restoreFromBakeCache(const BakeCache::Key& key, const QDir& outputDirectory, QJsonObject* info,
+                                 const BakeCache::InfoValidator& isValid) {
+    return _bakeCache && _bakeCache->restore(key, outputDirectory, _outputFiles, info, isValid);
+}
+
+void Baker::storeInBakeCache(const BakeCache::Key& key, const QDir& outputDirectory, const std::vector<QString>& files,
+                             const QJsonObject& info) {
+    if (_bakeCache) {
+        _bakeCache->store(key, outputDirectory, files, info);
+    }
+}
@@ -14,6 +14,8 @@
 
 #include <QtCore/QObject>
 
+#include <shared/BakeCache.h>
+
 class Baker : public QObject {
     Q_OBJECT
 
@@ -37,6 +39,10 @@ public:
 
     bool wasAborted() const { return _wasAborted.load(); }
 
+    // when set, bakers skip bakes that were already done with the same input and options
+    static void setBakeCache(BakeCachePointer bakeCache) { _bakeCache = bakeCache; }
+    static BakeCachePointer getBakeCache() { return _bakeCache; }
+
 public slots:
     virtual void bake() = 0;
     virtual void abort() { _shouldAbort.store(true); }
@@ -51,6 +57,12 @@ protected:
 
     void handleErrors(const QStringList& errors);
 
+    // adds the files of a cached bake to _outputFiles, returns false if there is no bake cache or no such bake
+    bool restoreFromBakeCache(const BakeCache::Key& key, const QDir& outputDirectory, QJsonObject* info = nullptr,
+                              const BakeCache::InfoValidator& isValid = BakeCache::InfoValidator());
+    void storeInBakeCache(const BakeCache::Key& key, const QDir& outputDirectory, const std::vector<QString>& files,
+                          const QJsonObject& info = QJsonObject());
+
     // List of baked output files. For instance, for an FBX this would
     // include the .fbx, a .fst pointing to the fbx, and all of the fbx texture files.
     std::vector<QString> _outputFiles;
@@ -62,6 +74,8 @@ protected:
 
     std::atomic<bool> _shouldAbort { false };
     std::atomic<bool> _wasAborted { false };
+
+    static BakeCachePointer _bakeCache;
 };
 
 #endif // hifi_Baker_h
@@ -19,6 +19,9 @@
 
 const int ASCII_CHARACTERS_UPPER_LIMIT = 126;
 
+// bump this whenever a change to the baker changes its output, so bakes cached by older versions aren't used
+static const int JS_BAKE_CACHE_VERSION = 1;
+
 JSBaker::JSBaker(const QUrl& jsURL, const QString& bakedOutputDir) :
     _jsURL(jsURL),
     _bakedOutputDir(bakedOutputDir)
@@ -91,6 +94,22 @@ void JSBaker::handleScriptNetworkReply() {
 }
 
 void JSBaker::processScript() {
+    auto fileName = _jsURL.fileName();
+    auto baseName = fileName.left(fileName.lastIndexOf('.'));
+    auto bakedFilename = baseName + BAKED_JS_EXTENSION;
+
+    _bakedJSFilePath = _bakedOutputDir + "/" + bakedFilename;
+
+    BakeCache::Key bakeCacheKey;
+    if (getBakeCache()) {
+        bakeCacheKey = BakeCache::computeKey(metaObject()->className(), JS_BAKE_CACHE_VERSION, bakedFilename.toUtf8(), _originalScript);
+        if (restoreFromBakeCache(bakeCacheKey, _bakedOutputDir)) {
+            qCDebug(js_baking) << "Restored cached bake of" << _jsURL << "to" << _bakedJSFilePath;
+            emit finished();
+            return;
+        }
+    }
+
     // Read file into an array
     QByteArray outputJS;
 
@@ -103,12 +122,6 @@ void JSBaker::processScript() {
     }
 
     // Bake Successful. Export the file
-    auto fileName = _jsURL.fileName();
-    auto baseName = fileName.left(fileName.lastIndexOf('.'));
-    auto bakedFilename = baseName + BAKED_JS_EXTENSION;
-
-    _bakedJSFilePath = _bakedOutputDir + "/" + bakedFilename;
-
     QFile bakedFile;
     bakedFile.setFileName(_bakedJSFilePath);
     if (!bakedFile.open(QIODevice::WriteOnly)) {
@@ -117,11 +130,16 @@ void JSBaker::processScript() {
     }
 
     bakedFile.write(outputJS);
+    bakedFile.close();
 
     // Export successful
     _outputFiles.push_back(_bakedJSFilePath);
     qCDebug(js_baking) << "Exported" << _jsURL << "minified to" << _bakedJSFilePath;
 
+    if (!bakeCacheKey.empty()) {
+        storeInBakeCache(bakeCacheKey, _bakedOutputDir, { _bakedJSFilePath });
+    }
+
     // emit signal to indicate the JS baking is finished
     emit finished();
 }
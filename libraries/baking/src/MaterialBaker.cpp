@@ -23,7 +23,7 @@
 
 #include <graphics-scripting/GraphicsScriptingInterface.h>
 
-std::function<QThread*()> MaterialBaker::_getNextOvenWorkerThreadOperator;
+std::function<void(Baker*)> MaterialBaker::_queueOvenBakeOperator;
 
 static int materialNum = 0;
 
@@ -144,13 +144,13 @@ void MaterialBaker::processMaterial() {
                             textureBaker->setMapChannel(mapChannel);
                             connect(textureBaker.data(), &TextureBaker::finished, this, &MaterialBaker::handleFinishedTextureBaker);
                             _textureBakers.insert(textureKey, textureBaker);
-                            textureBaker->moveToThread(_getNextOvenWorkerThreadOperator ? _getNextOvenWorkerThreadOperator() : thread());
-                            // By default, Qt will invoke this bake immediately if the TextureBaker is on the same worker thread as this MaterialBaker.
-                            // We don't want that, because threads may be waiting for work while this thread is stuck processing a TextureBaker.
-                            // On top of that, _textureBakers isn't fully populated.
-                            // So, use Qt::QueuedConnection.
-                            // TODO: Better thread utilization at the top level, not just the MaterialBaker level
-                            QMetaObject::invokeMethod(textureBaker.data(), "bake", Qt::QueuedConnection);
+                            if (_queueOvenBakeOperator) {
+                                // the oven starts dependencies ahead of its queue, on whichever worker thread is least busy
+                                _queueOvenBakeOperator(textureBaker.data());
+                            } else {
+                                // Qt would invoke this bake immediately otherwise, before _textureBakers is fully populated
+                                QMetaObject::invokeMethod(textureBaker.data(), "bake", Qt::QueuedConnection);
+                            }
                         }
                         _materialsNeedingRewrite.insert(textureKey, networkMaterial.second);
                     } else {
@@ -186,6 +186,10 @@ void MaterialBaker::handleFinishedTextureBaker() {
             for (auto networkMaterial : _materialsNeedingRewrite.values(textureKey)) {
                 networkMaterial->getTextureMap(baker->getMapChannel())->getTextureSource()->setUrl(relativeURL);
             }
+
+            if (baker->hasExternalSource()) {
+                _externalTextureHashes[textureKey] = baker->getSourceHash();
+            }
         } else {
             // this texture failed to bake - this doesn't fail the entire bake but we need to add the errors from
             // the texture to our warnings
@@ -37,7 +37,10 @@ public:
 
     NetworkMaterialResourcePointer getNetworkMaterialResource() const { return _materialResource; }
 
-    static void setNextOvenWorkerThreadOperator(std::function<QThread*()> getNextOvenWorkerThreadOperator) { _getNextOvenWorkerThreadOperator = getNextOvenWorkerThreadOperator; }
+    // source hashes of the baked textures that were loaded from their own URL rather than handed to us
+    const QHash<TextureKey, QByteArray>& getExternalTextureHashes() const { return _externalTextureHashes; }
+
+    static void setQueueOvenBakeOperator(std::function<void(Baker*)> queueOvenBakeOperator) { _queueOvenBakeOperator = queueOvenBakeOperator; }
 
 public slots:
     virtual void bake() override;
@@ -62,13 +65,14 @@ private:
 
     QHash<TextureKey, QSharedPointer<TextureBaker>> _textureBakers;
     QMultiHash<TextureKey, std::shared_ptr<NetworkMaterial>> _materialsNeedingRewrite;
+    QHash<TextureKey, QByteArray> _externalTextureHashes;
 
     QString _bakedOutputDir;
     QString _textureOutputDir;
     QString _bakedMaterialData;
 
     QScriptEngine _scriptEngine;
-    static std::function<QThread*()> _getNextOvenWorkerThreadOperator;
+    static std::function<void(Baker*)> _queueOvenBakeOperator;
     TextureFileNamer _textureFileNamer;
 
     void addTexture(const QString& materialName, image::TextureUsage::Type textureUsage, const hfm::Texture& texture);
@@ -42,7 +42,26 @@
 
 #include "baking/BakerLibrary.h"
 
+#include <QDirIterator>
 #include <QJsonArray>
+#include <QJsonDocument>
+
+// bump this whenever a change to the baker changes its output, so bakes cached by older versions aren't used
+static const int MODEL_BAKE_CACHE_VERSION = 1;
+
+static const QString CACHED_MAPPING_KEY = "mapping";
+static const QString CACHED_DEPENDENCIES_KEY = "dependencies";
+
+static QByteArray serializeMappingForCacheKey(const hifi::VariantHash& mapping) {
+    // QHash order changes from one run to the next, sort the entries so the same mapping always gives the same key
+    QStringList entries;
+    for (auto it = mapping.cbegin(); it != mapping.cend(); ++it) {
+        QJsonArray value { QJsonValue::fromVariant(it.value()) };
+        entries << it.key() + "=" + QJsonDocument(value).toJson(QJsonDocument::Compact);
+    }
+    entries.sort();
+    return entries.join('\n').toUtf8();
+}
 
 ModelBaker::ModelBaker(const QUrl& inputModelURL, const QString& bakedOutputDirectory, const QString& originalOutputDirectory, bool hasBeenBaked) :
     _modelURL(inputModelURL),
@@ -206,30 +225,45 @@ void ModelBaker::handleModelNetworkReply() {
 }
 
 void ModelBaker::bakeSourceCopy() {
-    QFile modelFile(_originalOutputModelPath);
-    if (!modelFile.open(QIODevice::ReadOnly)) {
+    // map the model rather than reading it, the FBX serializer only decodes the arrays it needs straight out of it
+    _modelSource = FBXSource::fromFile(_originalOutputModelPath);
+    if (!_modelSource) {
         handleError("Error opening " + _originalOutputModelPath + " for reading");
         return;
     }
-    hifi::ByteArray modelData = modelFile.readAll();
+    hifi::ByteArray modelData = _modelSource->bytes();
+
+    auto serializer = DependencyManager::get<ModelFormatRegistry>()->getSerializerForMediaType(modelData, _modelURL, "");
+    if (!serializer) {
+        handleError("Could not recognize file type of model file " + _originalOutputModelPath);
+        return;
+    }
+
+    // Only FBX models are cached, other formats can pull in material libraries we don't track. Material maps can
+    // reference material files by URL, so those aren't cached either.
+    if (getBakeCache() && std::dynamic_pointer_cast<FBXSerializer>(serializer) && !_mapping.contains(MATERIAL_MAPPING_FIELD)) {
+        QByteArray options = _modelURL.toString().toUtf8() + '\n' + _mappingURL.toString().toUtf8() + '\n' +
+            serializeMappingForCacheKey(_mapping) + (_hasBeenBaked ? '1' : '0');
+        _bakeCacheKey = BakeCache::computeKey(metaObject()->className(), MODEL_BAKE_CACHE_VERSION, options, modelData);
+
+        if (restoreCachedBake()) {
+            return;
+        }
+    }
 
     std::vector<hifi::ByteArray> dracoMeshes;
     std::vector<std::vector<hifi::ByteArray>> dracoMaterialLists; // Material order for per-mesh material lookup used by dracoMeshes
 
     {
-        auto serializer = DependencyManager::get<ModelFormatRegistry>()->getSerializerForMediaType(modelData, _modelURL, "");
-        if (!serializer) {
-            handleError("Could not recognize file type of model file " + _originalOutputModelPath);
-            return;
-        }
         hifi::VariantHash serializerMapping = _mapping;
         serializerMapping["combineParts"] = true; // set true so that OBJSerializer reads material info from material library
         serializerMapping["deduplicateIndices"] = true; // Draco compression also deduplicates, but we might as well shave it off to save on some earlier processing (currently FBXSerializer only)
-        hfm::Model::Pointer loadedModel = serializer->read(modelData, serializerMapping, _modelURL);
+        std::shared_ptr<FBXSerializer> fbxSerializer = std::dynamic_pointer_cast<FBXSerializer>(serializer);
+        hfm::Model::Pointer loadedModel = fbxSerializer ? fbxSerializer->read(_modelSource, serializerMapping, _modelURL) :
+            serializer->read(modelData, serializerMapping, _modelURL);
 
         // Temporarily support copying the pre-parsed node from FBXSerializer, for better performance in FBXBaker
         // TODO: Pure HFM baking
-        std::shared_ptr<FBXSerializer> fbxSerializer = std::dynamic_pointer_cast<FBXSerializer>(serializer);
         if (fbxSerializer) {
             qCDebug(model_baking) << "Parsing" << _modelURL;
             _rootNode = fbxSerializer->_rootNode;
@@ -418,14 +452,80 @@ void ModelBaker::outputBakedFST() {
         handleError("Failed to write to file '" + outputFSTURL + "'");
         return;
     }
+    fstOutputFile.close();
     _outputFiles.push_back(outputFSTURL);
     _outputMappingURL = outputFSTURL;
 
     exportScene();
+    storeBakeInCache();
     qCDebug(model_baking) << "Finished baking, emitting finished" << _modelURL;
     emit finished();
 }
 
+bool ModelBaker::restoreCachedBake() {
+    // textures outside of the model were baked from files that may have changed since
+    auto dependenciesUnchanged = [](const QJsonObject& info) {
+        for (const auto& value : info[CACHED_DEPENDENCIES_KEY].toArray()) {
+            auto dependency = value.toObject();
+            QFile textureFile { QUrl(dependency["url"].toString()).toLocalFile() };
+            if (!textureFile.open(QIODevice::ReadOnly)) {
+                return false;
+            }
+            auto textureType = (image::TextureUsage::Type)dependency["type"].toInt();
+            auto sourceHash = TextureBaker::computeSourceHash(textureFile.readAll(), textureType);
+            if (sourceHash.toHex() != dependency["hash"].toString().toLatin1()) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    QJsonObject info;
+    if (!restoreFromBakeCache(_bakeCacheKey, _bakedOutputDir, &info, dependenciesUnchanged)) {
+        return false;
+    }
+
+    _outputMappingURL = _bakedOutputDir + "/" + info[CACHED_MAPPING_KEY].toString();
+    qCDebug(model_baking) << "Restored cached bake of" << _modelURL;
+    emit finished();
+    return true;
+}
+
+void ModelBaker::storeBakeInCache() {
+    // a bake with warnings is missing something, e.g. a texture that failed to download, so it is worth retrying
+    if (_bakeCacheKey.empty() || hasErrors() || hasWarnings()) {
+        return;
+    }
+
+    QJsonArray dependencies;
+    if (_materialBaker) {
+        const auto& textureHashes = _materialBaker->getExternalTextureHashes();
+        for (auto it = textureHashes.cbegin(); it != textureHashes.cend(); ++it) {
+            // remote textures can't be checked without downloading them again
+            if (!it.key().first.isLocalFile()) {
+                return;
+            }
+            QJsonObject dependency;
+            dependency["url"] = it.key().first.toString();
+            dependency["type"] = (int)it.key().second;
+            dependency["hash"] = QString(it.value().toHex());
+            dependencies.append(dependency);
+        }
+    }
+
+    // the baked output folder only holds this model's bake, including the textures and materials baked for it
+    std::vector<QString> bakedFiles;
+    QDirIterator it(_bakedOutputDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        bakedFiles.push_back(it.next());
+    }
+
+    QJsonObject info;
+    info[CACHED_MAPPING_KEY] = QFileInfo(_outputMappingURL).fileName();
+    info[CACHED_DEPENDENCIES_KEY] = dependencies;
+    storeInBakeCache(_bakeCacheKey, _bakedOutputDir, bakedFiles, info);
+}
+
 void ModelBaker::abort() {
     Baker::abort();
 
@@ -67,6 +67,8 @@ protected:
     void exportScene();
 
     FBXNode _rootNode;
+    // the mapped source model, arrays in _rootNode point into it
+    FBXSource::Pointer _modelSource;
     QUrl _modelURL;
     QUrl _outputURLSuffix;
     QUrl _mappingURL;
@@ -88,6 +90,9 @@ private:
     void outputBakedFST();
     void bakeMaterialMap();
 
+    bool restoreCachedBake();
+    void storeBakeInCache();
+
     bool _hasBeenBaked { false };
 
     hfm::Model::Pointer _hfmModel;
@@ -95,6 +100,7 @@ private:
     int _materialMapIndex { 0 };
     QJsonArray _materialMappingJSON;
     QSharedPointer<MaterialBaker> _materialBaker;
+    BakeCache::Key _bakeCacheKey;
 };
 
 #endif // hifi_ModelBaker_h
@@ -11,9 +11,13 @@
 
 #include "TextureBaker.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include <QtCore/QDir>
 #include <QtCore/QEventLoop>
 #include <QtCore/QFile>
+#include <QtCore/QHash>
 #include <QtNetwork/QNetworkReply>
 
 #include <image/TextureProcessing.h>
@@ -30,7 +34,16 @@ const QString BAKED_TEXTURE_KTX_EXT = ".ktx";
 const QString BAKED_TEXTURE_BCN_SUFFIX = "_bcn.ktx";
 const QString BAKED_META_TEXTURE_SUFFIX = ".texmeta.json";
 
+// bump this whenever a change to the baker changes its output, so bakes cached by older versions aren't used
+static const int TEXTURE_BAKE_CACHE_VERSION = 1;
+
 bool TextureBaker::_compressionEnabled = true;
+std::atomic<int> TextureBaker::_numDedupedBakes { 0 };
+
+// bakes in progress, by source hash and compression setting, so a texture shared between models that are baked at the
+// same time is only processed once; entries go away when their bake is done, later bakes find its output in the BakeCache
+static std::mutex sharedBakesMutex;
+static QHash<QByteArray, std::shared_ptr<TextureBaker::SharedTextureBake>> sharedBakes;
 
 TextureBaker::TextureBaker(const QUrl& textureURL, image::TextureUsage::Type textureType,
                            const QDir& outputDirectory, const QString& baseFilename,
@@ -39,7 +52,8 @@ TextureBaker::TextureBaker(const QUrl& textureURL, image::TextureUsage::Type tex
     _originalTexture(textureContent),
     _textureType(textureType),
     _baseFilename(baseFilename),
-    _outputDirectory(outputDirectory)
+    _outputDirectory(outputDirectory),
+    _hasExternalSource(textureContent.isEmpty())
 {
     if (baseFilename.isEmpty()) {
         // figure out the baked texture filename
@@ -56,6 +70,13 @@ TextureBaker::TextureBaker(const QUrl& textureURL, image::TextureUsage::Type tex
     _originalCopyFilePath = _outputDirectory.absoluteFilePath(_baseFilename + originalExtension);
 }
 
+QByteArray TextureBaker::computeSourceHash(const QByteArray& textureContent, image::TextureUsage::Type textureType) {
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+    hasher.addData(textureContent);
+    hasher.addData((const char*)&textureType, sizeof(textureType));
+    return hasher.result();
+}
+
 void TextureBaker::bake() {
     // once our texture is loaded, kick off a the processing
     connect(this, &TextureBaker::originalTextureLoaded, this, &TextureBaker::processTexture);
@@ -130,13 +151,7 @@ void TextureBaker::handleTextureNetworkReply() {
 void TextureBaker::processTexture() {
     // the baked textures need to have the source hash added for cache checks in Interface
     // so we add that to the processed texture before handling it off to be serialized
-    QCryptographicHash hasher(QCryptographicHash::Md5);
-    hasher.addData(_originalTexture);
-    hasher.addData((const char*)&_textureType, sizeof(_textureType));
-    auto hashData = hasher.result();
-    std::string hash = hashData.toHex().toStdString();
-
-    TextureMeta meta;
+    _sourceHash = computeSourceHash(_originalTexture, _textureType);
 
     QString originalCopyFilePath = _originalCopyFilePath.toString();
 
@@ -150,14 +165,68 @@ void TextureBaker::processTexture() {
         // IMPORTANT: _originalTexture is empty past this point
         _originalTexture.clear();
         _outputFiles.push_back(originalCopyFilePath);
-        meta.original = _originalCopyFilePath.fileName();
     }
 
+    if (getBakeCache()) {
+        // the original's filename is in the meta file, and the baked files are named after it
+        QByteArray options = _originalCopyFilePath.fileName().toUtf8();
+        options.append(_compressionEnabled ? '1' : '0');
+        _bakeCacheKey = BakeCache::computeKey(metaObject()->className(), TEXTURE_BAKE_CACHE_VERSION, options, _sourceHash);
+
+        if (restoreFromBakeCache(_bakeCacheKey, _outputDirectory)) {
+            _metaTextureFileName = _outputDirectory.absoluteFilePath(_baseFilename + BAKED_META_TEXTURE_SUFFIX);
+            qCDebug(model_baking) << "Restored cached bake of texture" << _textureURL;
+            setIsFinished(true);
+            return;
+        }
+    }
+
+    if (joinSharedBake()) {
+        return;
+    }
+
+    bakeTexture();
+}
+
+bool TextureBaker::joinSharedBake() {
+    _sharedBakeKey = _sourceHash;
+    _sharedBakeKey.append(_compressionEnabled ? '1' : '0');
+
+    std::lock_guard<std::mutex> lock(sharedBakesMutex);
+    auto& sharedBake = sharedBakes[_sharedBakeKey];
+    if (!sharedBake) {
+        // nobody else is baking this texture, we do it and the ones that show up while we are at it wait on us
+        sharedBake = std::make_shared<SharedTextureBake>();
+        _isSharedBakeOwner = true;
+        return false;
+    }
+
+    sharedBake->waitingBakers.push_back(this);
+    return true;
+}
+
+void TextureBaker::bakeTexture() {
+    TextureMeta meta;
+    bool succeeded = writeBakedTextures(meta);
+
+    if (_isSharedBakeOwner) {
+        publishSharedBake(succeeded, meta);
+    }
+
+    if (succeeded) {
+        finishBake(meta);
+    }
+}
+
+bool TextureBaker::writeBakedTextures(TextureMeta& meta) {
+    std::string hash = _sourceHash.toHex().toStdString();
+    QString originalCopyFilePath = _originalCopyFilePath.toString();
+
     // Load the copy of the original file from the baked output directory. New images will be created using the original as the source data.
     auto buffer = std::static_pointer_cast<QIODevice>(std::make_shared<QFile>(originalCopyFilePath));
     if (!buffer->open(QIODevice::ReadOnly)) {
         handleError("Could not open original file at " + originalCopyFilePath);
-        return;
+        return false;
     }
 
     // Compressed KTX
@@ -172,24 +241,24 @@ void TextureBaker::processTexture() {
                                                         target, _abortProcessing);
             if (!processedTexture) {
                 handleError("Could not process texture " + _textureURL.toString());
-                return;
+                return false;
             }
             processedTexture->setSourceHash(hash);
 
             if (shouldStop()) {
-                return;
+                return false;
             }
 
             auto memKTX = gpu::Texture::serialize(*processedTexture);
             if (!memKTX) {
                 handleError("Could not serialize " + _textureURL.toString() + " to KTX");
-                return;
+                return false;
             }
 
             const char* name = khronos::gl::texture::toString(memKTX->_header.getGLInternaFormat());
             if (name == nullptr) {
                 handleError("Could not determine internal format for compressed KTX: " + _textureURL.toString());
-                return;
+                return false;
             }
 
             const char* data = reinterpret_cast<const char*>(memKTX->_storage->data());
@@ -200,7 +269,7 @@ void TextureBaker::processTexture() {
             QFile bakedTextureFile { filePath };
             if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(data, length) == -1) {
                 handleError("Could not write baked texture for " + _textureURL.toString());
-                return;
+                return false;
             }
             _outputFiles.push_back(filePath);
             meta.availableTextureTypes[memKTX->_header.getGLInternaFormat()] = fileName;
@@ -214,18 +283,18 @@ void TextureBaker::processTexture() {
                                                     ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType, false, gpu::BackendTarget::GL45, _abortProcessing);
         if (!processedTexture) {
             handleError("Could not process texture " + _textureURL.toString());
-            return;
+            return false;
         }
         processedTexture->setSourceHash(hash);
 
         if (shouldStop()) {
-            return;
+            return false;
         }
 
         auto memKTX = gpu::Texture::serialize(*processedTexture);
         if (!memKTX) {
             handleError("Could not serialize " + _textureURL.toString() + " to KTX");
-            return;
+            return false;
         }
 
         const char* data = reinterpret_cast<const char*>(memKTX->_storage->data());
@@ -236,7 +305,7 @@ void TextureBaker::processTexture() {
         QFile bakedTextureFile { filePath };
         if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(data, length) == -1) {
             handleError("Could not write baked texture for " + _textureURL.toString());
-            return;
+            return false;
         }
         _outputFiles.push_back(filePath);
         meta.uncompressed = fileName;
@@ -244,15 +313,105 @@ void TextureBaker::processTexture() {
         buffer.reset();
     }
 
+    return true;
+}
+
+void TextureBaker::publishSharedBake(bool succeeded, const TextureMeta& meta) {
+    std::shared_ptr<SharedTextureBake> doneBake;
+    std::vector<QPointer<TextureBaker>> waitingBakers;
     {
-        auto data = meta.serialize();
-        _metaTextureFileName = _outputDirectory.absoluteFilePath(_baseFilename + BAKED_META_TEXTURE_SUFFIX);
-        QFile file { _metaTextureFileName };
-        if (!file.open(QIODevice::WriteOnly) || file.write(data) == -1) {
-            handleError("Could not write meta texture for " + _textureURL.toString());
-        } else {
-            _outputFiles.push_back(_metaTextureFileName);
+        std::lock_guard<std::mutex> lock(sharedBakesMutex);
+        auto it = sharedBakes.find(_sharedBakeKey);
+        if (it == sharedBakes.end()) {
+            return;
+        }
+        waitingBakers.swap(it.value()->waitingBakers);
+
+        if (succeeded) {
+            doneBake = it.value();
+            doneBake->outputDirectory = _outputDirectory;
+            doneBake->baseFilename = _baseFilename;
+            doneBake->meta = meta;
         }
+        // a failed bake lets the next baker that needs this texture try again
+        sharedBakes.erase(it);
+    }
+
+    for (auto& waitingBaker : waitingBakers) {
+        TextureBaker* baker = waitingBaker.data();
+        if (!baker) {
+            continue;
+        }
+        QMetaObject::invokeMethod(baker, [baker, doneBake] {
+            if (baker->shouldStop()) {
+                return;
+            }
+            if (!doneBake || !baker->copySharedBake(*doneBake)) {
+                baker->bakeTexture();
+            }
+        }, Qt::QueuedConnection);
+    }
+}
+
+bool TextureBaker::copySharedBake(const SharedTextureBake& sharedBake) {
+    size_t numOutputFiles = _outputFiles.size();
+    TextureMeta meta;
+
+    // the shared bake's files are named after its base filename, ours get the same names with our base filename
+    auto copyBakedFile = [&](const QString& sharedFileName, QUrl& fileName) {
+        QString copyFileName = _baseFilename + sharedFileName.mid(sharedBake.baseFilename.length());
+        QString sourcePath = sharedBake.outputDirectory.absoluteFilePath(sharedFileName);
+        QString copyPath = _outputDirectory.absoluteFilePath(copyFileName);
+        if (copyPath != sourcePath) {
+            QFile::remove(copyPath);
+            if (!QFile::copy(sourcePath, copyPath)) {
+                return false;
+            }
+        }
+        _outputFiles.push_back(copyPath);
+        fileName = copyFileName;
+        return true;
+    };
+
+    bool copied = true;
+    for (const auto& textureType : sharedBake.meta.availableTextureTypes) {
+        copied = copied && copyBakedFile(textureType.second.toString(), meta.availableTextureTypes[textureType.first]);
+    }
+    if (!sharedBake.meta.uncompressed.isEmpty()) {
+        copied = copied && copyBakedFile(sharedBake.meta.uncompressed.toString(), meta.uncompressed);
+    }
+
+    if (!copied) {
+        // the shared bake's output is gone, bake the texture ourselves
+        _outputFiles.resize(numOutputFiles);
+        return false;
+    }
+
+    ++_numDedupedBakes;
+    finishBake(meta);
+    return true;
+}
+
+void TextureBaker::finishBake(TextureMeta& meta) {
+    meta.original = _originalCopyFilePath.fileName();
+
+    auto data = meta.serialize();
+    _metaTextureFileName = _outputDirectory.absoluteFilePath(_baseFilename + BAKED_META_TEXTURE_SUFFIX);
+    QFile file { _metaTextureFileName };
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) == -1) {
+        handleError("Could not write meta texture for " + _textureURL.toString());
+        return;
+    }
+    file.close();
+    _outputFiles.push_back(_metaTextureFileName);
+
+    if (!_bakeCacheKey.empty()) {
+        // the original is copied on every bake anyway, there's no need to cache it
+        std::vector<QString> bakedFiles;
+        std::copy_if(_outputFiles.begin(), _outputFiles.end(), std::back_inserter(bakedFiles), [this](const QString& path) {
+            return path != _originalCopyFilePath.toString();
+        });
+        storeInBakeCache(_bakeCacheKey, _outputDirectory, bakedFiles);
     }
 
     qCDebug(model_baking) << "Baked texture" << _textureURL;
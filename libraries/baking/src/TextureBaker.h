@@ -12,7 +12,13 @@
 #ifndef hifi_TextureBaker_h
 #define hifi_TextureBaker_h
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtCore/QUrl>
 #include <QtCore/QRunnable>
 #include <QDir>
@@ -23,6 +29,7 @@
 #include "Baker.h"
 
 #include <material-networking/MaterialCache.h>
+#include <TextureMeta.h>
 
 extern const QString BAKED_TEXTURE_KTX_EXT;
 extern const QString BAKED_META_TEXTURE_SUFFIX;
@@ -43,10 +50,27 @@ public:
 
     QString getMetaTextureFileName() const { return _metaTextureFileName; }
 
+    // false for textures whose content was handed to us, e.g. from inside a model
+    bool hasExternalSource() const { return _hasExternalSource; }
+    // the hash of the original texture and usage type, set once the texture is loaded
+    const QByteArray& getSourceHash() const { return _sourceHash; }
+
     virtual void setWasAborted(bool wasAborted) override;
 
     static void setCompressionEnabled(bool enabled) { _compressionEnabled = enabled; }
 
+    static QByteArray computeSourceHash(const QByteArray& textureContent, image::TextureUsage::Type textureType);
+
+    // number of bakes that copied the output of an identical texture baked by another baker
+    static int getNumDedupedBakes() { return _numDedupedBakes.load(); }
+
+    struct SharedTextureBake {
+        QDir outputDirectory;
+        QString baseFilename;
+        TextureMeta meta;
+        std::vector<QPointer<TextureBaker>> waitingBakers;
+    };
+
     void setMapChannel(graphics::Material::MapChannel mapChannel) { _mapChannel = mapChannel; }
     graphics::Material::MapChannel getMapChannel() const { return _mapChannel; }
     image::TextureUsage::Type getTextureType() const { return _textureType; }
@@ -65,6 +89,14 @@ private:
     void loadTexture();
     void handleTextureNetworkReply();
 
+    // returns true if another baker is baking the same texture, and this bake will use its output
+    bool joinSharedBake();
+    void bakeTexture();
+    bool writeBakedTextures(TextureMeta& meta);
+    void publishSharedBake(bool succeeded, const TextureMeta& meta);
+    bool copySharedBake(const SharedTextureBake& sharedBake);
+    void finishBake(TextureMeta& meta);
+
     QUrl _textureURL;
     QByteArray _originalTexture;
     image::TextureUsage::Type _textureType;
@@ -75,10 +107,16 @@ private:
     QDir _outputDirectory;
     QString _metaTextureFileName;
     QUrl _originalCopyFilePath;
+    QByteArray _sourceHash;
+    bool _hasExternalSource { false };
+    BakeCache::Key _bakeCacheKey;
+    QByteArray _sharedBakeKey;
+    bool _isSharedBakeOwner { false };
 
     std::atomic<bool> _abortProcessing { false };
 
     static bool _compressionEnabled;
+    static std::atomic<int> _numDedupedBakes;
 };
 
 #endif // hifi_TextureBaker_h
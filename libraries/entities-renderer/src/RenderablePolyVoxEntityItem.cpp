@@ -18,6 +18,8 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QCryptographicHash>
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtConcurrent/QtConcurrentRun>
 
 #include <model-networking/SimpleMeshProxy.h>
@@ -78,6 +80,7 @@
 #include "PhysicalEntitySimulation.h"
 
 const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
+const int VOXEL_CHUNK_SIZE = 16; // cells per side of the chunks that are meshed separately
 
 /*
   A PolyVoxEntity has several interdependent parts:
@@ -102,7 +105,13 @@ const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
   the surface style.
 
   When a script changes _volData, compressVolumeDataAndSendEditPacket is called to update _voxelData and to
-  send a packet to the entity-server.
+  send a packet to the entity-server.  The packet only carries the box of voxels that was edited (see
+  PolyVoxEntityItem::makeVoxelDataDelta).  _voxelData is recompressed by one worker at a time, and the whole volume
+  is sent once the edits stop.
+
+  _volData is split into chunks of VOXEL_CHUNK_SIZE^3 cells.  Changing a voxel bumps the version of the chunks whose
+  surface it touches, and recomputeMesh and computeShapeInfoWorker only redo the chunks whose mesh or collision hulls
+  are older than that.  The per-chunk results are kept and stitched together into _mesh and _shapeInfo.
 
   decompressVolumeData, recomputeMesh, computeShapeInfoWorker, and compressVolumeDataAndSendEditPacket are too expensive
   to run on a thread that has other things to do.  These use QtConcurrent::run to spawn a thread.  As each thread
@@ -169,8 +178,12 @@ bool isEdged(PolyVoxEntityItem::PolyVoxSurfaceStyle surfaceStyle) {
 void RenderablePolyVoxEntityItem::setVoxelData(const QByteArray& voxelData) {
     // compressed voxel information from the entity-server
     withWriteLock([&] {
-        if (_voxelData != voxelData) {
-            _voxelData = voxelData;
+        QByteArray newVoxelData = voxelData;
+        if (isVoxelDataDelta(voxelData) && !applyVoxelDataDelta(_voxelData, voxelData, newVoxelData)) {
+            return;
+        }
+        if (_voxelData != newVoxelData) {
+            _voxelData = newVoxelData;
             _voxelDataDirty = true;
         }
     });
@@ -199,6 +212,7 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
         } else {
             _volDataDirty = true;
             _voxelSurfaceStyle = voxelSurfaceStyle;
+            markAllChunksDirty();
         }
     });
 
@@ -265,7 +279,7 @@ bool RenderablePolyVoxEntityItem::setVoxel(const ivec3& v, uint8_t toValue) {
         result = setVoxelInternal(v, toValue);
     });
     if (result) {
-        compressVolumeDataAndSendEditPacket();
+        compressVolumeDataAndSendEditPacket(v, v + 1);
     }
 
     return result;
@@ -282,20 +296,17 @@ void RenderablePolyVoxEntityItem::forEachVoxelValue(const ivec3& voxelSize, std:
 }
 
 QByteArray RenderablePolyVoxEntityItem::volDataToArray(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) const {
-    int totalSize = voxelXSize * voxelYSize * voxelZSize;
-    ivec3 voxelSize{ voxelXSize, voxelYSize, voxelZSize };
-    ivec3 low{ 0 };
-    int index = 0;
+    return volDataRegionToArray(ivec3(0), ivec3(voxelXSize, voxelYSize, voxelZSize));
+}
 
-    QByteArray result = QByteArray(totalSize, '\0');
+QByteArray RenderablePolyVoxEntityItem::volDataRegionToArray(const ivec3& low, const ivec3& size) const {
+    // copy a box of voxels, in user voxel-coords, with x varying fastest
+    QByteArray result = QByteArray(size.x * size.y * size.z, '\0');
+    char* data = result.data();
+    int index = 0;
     withReadLock([&] {
-        if (isEdged()) {
-            low += 1;
-            voxelSize += 2;
-        }
-
-        loop3(low, voxelSize, [&](const ivec3& v){
-            result[index++] = _volData->getVoxelAt(v.x, v.y, v.z);
+        loop3(low, low + size, [&](const ivec3& v) {
+            data[index++] = getVoxelInternal(v);
         });
     });
 
@@ -314,7 +325,7 @@ bool RenderablePolyVoxEntityItem::setAll(uint8_t toValue) {
         });
     });
     if (result) {
-        compressVolumeDataAndSendEditPacket();
+        compressVolumeDataAndSendEditPacket(ivec3(0), ivec3(_voxelVolumeSize));
     }
     return result;
 }
@@ -339,7 +350,7 @@ bool RenderablePolyVoxEntityItem::setCuboid(const glm::vec3& lowPosition, const
         });
     });
     if (result) {
-        compressVolumeDataAndSendEditPacket();
+        compressVolumeDataAndSendEditPacket(low, high);
     }
     return result;
 }
@@ -377,7 +388,7 @@ bool RenderablePolyVoxEntityItem::setSphereInVolume(const vec3& center, float ra
     });
 
     if (result) {
-        compressVolumeDataAndSendEditPacket();
+        compressVolumeDataAndSendEditPacket(glm::floor(center - radius), glm::ceil(center + radius));
     }
     return result;
 }
@@ -437,7 +448,7 @@ bool RenderablePolyVoxEntityItem::setSphere(const vec3& centerWorldCoords, float
     });
 
     if (result) {
-        compressVolumeDataAndSendEditPacket();
+        compressVolumeDataAndSendEditPacket(lowI, highI);
     }
     return result;
 }
@@ -485,7 +496,7 @@ bool RenderablePolyVoxEntityItem::setCapsule(const vec3& startWorldCoords, const
     });
 
     if (result) {
-        compressVolumeDataAndSendEditPacket();
+        compressVolumeDataAndSendEditPacket(lowI, highI);
     }
     return result;
 }
@@ -807,9 +818,44 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(const glm::vec3& voxelVolum
         _volData.reset(new PolyVox::SimpleVolume<uint8_t>(PolyVox::Region(lowCorner, highCorner)));
         // having the "outside of voxel-space" value be 255 has helped me notice some problems.
         _volData->setBorderValue(255);
+        resetChunks();
+    });
+}
+
+void RenderablePolyVoxEntityItem::resetChunks() {
+    // lay out chunks to cover the cells of a newly allocated _volData.  This assumes that the caller has
+    // write-locked the entity.
+    ivec3 numCells = ivec3(_volData->getWidth(), _volData->getHeight(), _volData->getDepth()) - 1;
+    _numChunks = glm::max((numCells + VOXEL_CHUNK_SIZE - 1) / VOXEL_CHUNK_SIZE, ivec3(1));
+    _chunks.clear();
+    _chunks.resize(_numChunks.x * _numChunks.y * _numChunks.z);
+    _chunksGeneration++;
+}
+
+void RenderablePolyVoxEntityItem::markChunksDirty(const ivec3& volDataCoords) {
+    // a voxel is a corner of the cells on either side of it, and marching-cubes looks one voxel further out for
+    // normals.  Bump the version of every chunk that holds one of those cells.  This assumes that the caller has
+    // write-locked the entity.
+    ivec3 low = glm::max(volDataCoords - 2, ivec3(0)) / VOXEL_CHUNK_SIZE;
+    ivec3 high = glm::min(glm::max(volDataCoords + 1, ivec3(0)) / VOXEL_CHUNK_SIZE, _numChunks - 1);
+    loop3(low, high + 1, [&](const ivec3& chunk) {
+        _chunks[(chunk.z * _numChunks.y + chunk.y) * _numChunks.x + chunk.x].version++;
     });
 }
 
+void RenderablePolyVoxEntityItem::markAllChunksDirty() {
+    // this assumes that the caller has write-locked the entity
+    for (auto& chunk : _chunks) {
+        chunk.version++;
+    }
+}
+
+static ivec3 getChunkLow(int index, const ivec3& numChunks) {
+    // the corner of a chunk, in _volData coords
+    ivec3 chunk { index % numChunks.x, (index / numChunks.x) % numChunks.y, index / (numChunks.x * numChunks.y) };
+    return chunk * VOXEL_CHUNK_SIZE;
+}
+
 bool inUserBounds(const std::shared_ptr<PolyVox::SimpleVolume<uint8_t>> vol,
                   PolyVoxEntityItem::PolyVoxSurfaceStyle surfaceStyle,
                   const ivec3& v) {
@@ -865,16 +911,16 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(const ivec3& v, uint8_t toVal
 
     result = updateOnCount(v, toValue);
 
-    if (isEdged()) {
-        _volData->setVoxelAt(v.x + 1, v.y + 1, v.z + 1, toValue);
-    } else {
-        _volData->setVoxelAt(v.x, v.y, v.z, toValue);
-    }
+    ivec3 volDataCoords = isEdged() ? v + 1 : v;
+    _volData->setVoxelAt(volDataCoords.x, volDataCoords.y, volDataCoords.z, toValue);
 
     if (glm::any(glm::equal(ivec3(0), v))) {
         _neighborsNeedUpdate = true;
     }
 
+    if (result) {
+        markChunksDirty(volDataCoords);
+    }
     _volDataDirty |= result;
 
     return result;
@@ -952,69 +998,117 @@ void RenderablePolyVoxEntityItem::setVoxelsFromData(QByteArray uncompressedData,
     // this accepts the payload from decompressVolumeData
     withWriteLock([&] {
         loop3(ivec3(0), ivec3(voxelXSize, voxelYSize, voxelZSize), [&](const ivec3& v) {
-            int uncompressedIndex = (v.z * voxelYSize * voxelXSize) + (v.y * voxelZSize) + v.x;
+            int uncompressedIndex = (v.z * voxelYSize * voxelXSize) + (v.y * voxelXSize) + v.x;
             setVoxelInternal(v, uncompressedData[uncompressedIndex]);
         });
         _volDataDirty = true;
     });
 }
 
-void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacket() {
-    // compress the data in _volData and save the results.  The compressed form is used during
-    // saves to disk and for transmission over the wire to the entity-server
+void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacket(const ivec3& editLow, const ivec3& editHigh) {
+    // send the edited box of voxels to the entity-server, and bring _voxelData (which is used during saves to disk and
+    // for the whole-volume update) up to date.  Only one worker compresses the whole volume at a time; edits made
+    // while it runs are picked up by its next pass.
 
-    EntityItemPointer entity = getThisPointer();
+    EntityTreeElementPointer element = getElement();
+    EntityTreePointer tree = element ? element->getTree() : nullptr;
 
-    quint16 voxelXSize;
-    quint16 voxelYSize;
-    quint16 voxelZSize;
-    withReadLock([&] {
-        voxelXSize = _voxelVolumeSize.x;
-        voxelYSize = _voxelVolumeSize.y;
-        voxelZSize = _voxelVolumeSize.z;
+    ivec3 voxelVolumeSize;
+    bool startCompressing = false;
+    withWriteLock([&] {
+        voxelVolumeSize = _voxelVolumeSize;
+        _voxelEditCount++;
+        if (!_compressingVolumeData) {
+            _compressingVolumeData = true;
+            startCompressing = true;
+        }
     });
 
-    EntityTreeElementPointer element = getElement();
-    EntityTreePointer tree = element ? element->getTree() : nullptr;
+    // the delta is made here rather than on a worker so that deltas for overlapping edits are sent in order
+    ivec3 low = glm::clamp(editLow, ivec3(0), voxelVolumeSize);
+    ivec3 size = glm::clamp(editHigh, low, voxelVolumeSize) - low;
+    int editVolume = size.x * size.y * size.z;
+    if (isDomainEntity() && editVolume > 0 && editVolume < voxelVolumeSize.x * voxelVolumeSize.y * voxelVolumeSize.z) {
+        QByteArray delta = makeVoxelDataDelta(low, size, volDataRegionToArray(low, size));
+        if (delta.size() <= MAX_VOXEL_DATA_SIZE) {
+            queueVoxelDataEdit(tree, delta);
+        }
+    }
 
-    QtConcurrent::run([voxelXSize, voxelYSize, voxelZSize, entity, tree] {
-        auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
-        QByteArray uncompressedData = polyVoxEntity->volDataToArray(voxelXSize, voxelYSize, voxelZSize);
+    if (startCompressing) {
+        auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
+        QtConcurrent::run([entity, tree] {
+            entity->compressVolumeData(tree);
+        });
+    }
+}
 
-        QByteArray newVoxelData;
-        QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
+void RenderablePolyVoxEntityItem::compressVolumeData(const EntityTreePointer& tree) {
+    // compress the data in _volData into _voxelData, then send the whole volume.  The entity-server already has the
+    // edits from their deltas, but this also covers any delta that was lost along the way.
+    QByteArray newVoxelData;
+    bool done = false;
+    while (!done) {
+        quint16 voxelXSize;
+        quint16 voxelYSize;
+        quint16 voxelZSize;
+        uint32_t voxelEditCount;
+        withReadLock([&] {
+            voxelXSize = _voxelVolumeSize.x;
+            voxelYSize = _voxelVolumeSize.y;
+            voxelZSize = _voxelVolumeSize.z;
+            voxelEditCount = _voxelEditCount;
+        });
 
+        QByteArray uncompressedData = volDataToArray(voxelXSize, voxelYSize, voxelZSize);
+
+        newVoxelData.clear();
+        QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
         writer << voxelXSize << voxelYSize << voxelZSize;
+        writer << qCompress(uncompressedData, 9);
 
-        QByteArray compressedData = qCompress(uncompressedData, 9);
-        writer << compressedData;
+        withWriteLock([&] {
+            // _volData is where this came from, so there is no need to set _voxelDataDirty
+            if (newVoxelData.size() <= MAX_VOXEL_DATA_SIZE) {
+                _voxelData = newVoxelData;
+            }
+            done = (voxelEditCount == _voxelEditCount);
+            if (done) {
+                _compressingVolumeData = false;
+            }
+        });
+    }
 
-        // make sure the compressed data can be sent over the wire-protocol
-        if (newVoxelData.size() > 1150) {
-            // HACK -- until we have a way to allow for properties larger than MTU, don't update.
-            // revert the active voxel-space to the last version that fit.
-            qCDebug(entitiesrenderer) << "compressed voxel data is too large" << entity->getName() << entity->getID();
-            return;
-        }
+    // make sure the compressed data can be sent over the wire-protocol
+    if (newVoxelData.size() > MAX_VOXEL_DATA_SIZE) {
+        // HACK -- until we have a way to allow for properties larger than MTU, don't update.
+        qCDebug(entitiesrenderer) << "compressed voxel data is too large" << getName() << getID();
+        return;
+    }
 
-        auto now = usecTimestampNow();
-        entity->setLastEdited(now);
-        entity->setLastBroadcast(now);
+    queueVoxelDataEdit(tree, newVoxelData);
+}
 
-        std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->setVoxelData(newVoxelData);
+void RenderablePolyVoxEntityItem::queueVoxelDataEdit(const EntityTreePointer& tree, const QByteArray& voxelData) {
+    if (!tree) {
+        return;
+    }
 
-        tree->withReadLock([&] {
-            EntityItemProperties properties = entity->getProperties();
-            properties.setVoxelDataDirty();
-            properties.setLastEdited(now);
+    auto now = usecTimestampNow();
+    setLastEdited(now);
+    setLastBroadcast(now);
 
-            EntitySimulationPointer simulation = tree ? tree->getSimulation() : nullptr;
-            PhysicalEntitySimulationPointer peSimulation = std::static_pointer_cast<PhysicalEntitySimulation>(simulation);
-            EntityEditPacketSender* packetSender = peSimulation ? peSimulation->getPacketSender() : nullptr;
-            if (packetSender) {
-                packetSender->queueEditEntityMessage(PacketType::EntityEdit, tree, entity->getID(), properties);
-            }
-        });
+    tree->withReadLock([&] {
+        EntityItemProperties properties = getProperties();
+        properties.setVoxelData(voxelData);
+        properties.setLastEdited(now);
+
+        EntitySimulationPointer simulation = tree->getSimulation();
+        PhysicalEntitySimulationPointer peSimulation = std::static_pointer_cast<PhysicalEntitySimulation>(simulation);
+        EntityEditPacketSender* packetSender = peSimulation ? peSimulation->getPacketSender() : nullptr;
+        if (packetSender) {
+            packetSender->queueEditEntityMessage(PacketType::EntityEdit, tree, getID(), properties);
+        }
     });
 }
 
@@ -1075,6 +1169,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int y = 0; y < _volData->getHeight(); y++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentXPNeighbor->getVoxel({ 0, y, z });
+                    if (_volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
+                        markChunksDirty({ _volData->getWidth() - 1, y, z });
+                    }
                     if ((y == 0 || z == 0) && _volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
                         bonkNeighbors();
                     }
@@ -1090,6 +1187,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentYPNeighbor->getVoxel({ x, 0, z });
+                    if (_volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
+                        markChunksDirty({ x, _volData->getHeight() - 1, z });
+                    }
                     if ((x == 0 || z == 0) && _volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
                         bonkNeighbors();
                     }
@@ -1105,6 +1205,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int y = 0; y < _volData->getHeight(); y++) {
                     uint8_t neighborValue = currentZPNeighbor->getVoxel({ x, y, 0 });
+                    if (_volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
+                        markChunksDirty({ x, y, _volData->getDepth() - 1 });
+                    }
                     _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
                     if ((x == 0 || y == 0) && _volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
                         bonkNeighbors();
@@ -1116,8 +1219,48 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
     }
 }
 
+static graphics::MeshPointer makeMesh(const std::vector<PolyVox::PositionMaterialNormal>& vecVertices,
+                                      const std::vector<uint32_t>& vecIndices) {
+    graphics::MeshPointer mesh(new graphics::Mesh());
+
+    // convert PolyVox mesh to a Sam mesh
+    auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
+                                                     (gpu::Byte*)vecIndices.data());
+    auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
+    gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
+    mesh->setIndexBuffer(indexBufferView);
+
+    auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
+                                                      (gpu::Byte*)vecVertices.data());
+    auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
+    gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
+                                     vertexBufferPtr->getSize(),
+                                     sizeof(PolyVox::PositionMaterialNormal),
+                                     gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+    mesh->setVertexBuffer(vertexBufferView);
+
+
+    // TODO -- use 3-byte normals rather than 3-float normals
+    mesh->addAttribute(gpu::Stream::NORMAL,
+                       gpu::BufferView(vertexBufferPtr,
+                                       sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
+                                       vertexBufferPtr->getSize(),
+                                       sizeof(PolyVox::PositionMaterialNormal),
+                                       gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+
+    std::vector<graphics::Mesh::Part> parts;
+    parts.emplace_back(graphics::Mesh::Part((graphics::Index)0, // startIndex
+                                         (graphics::Index)vecIndices.size(), // numIndices
+                                         (graphics::Index)0, // baseVertex
+                                         graphics::Mesh::TRIANGLES)); // topology
+    mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(graphics::Mesh::Part),
+                                                        (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
+    return mesh;
+}
+
 void RenderablePolyVoxEntityItem::recomputeMesh() {
-    // use _volData to make a renderable mesh
+    // use _volData to make a renderable mesh.  The chunks that changed since they were last meshed are extracted in
+    // parallel, and setChunkMeshes stitches them together with the meshes of the other chunks.
     PolyVoxSurfaceStyle voxelSurfaceStyle;
     withReadLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
@@ -1128,88 +1271,127 @@ void RenderablePolyVoxEntityItem::recomputeMesh() {
 
     auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
-    QtConcurrent::run([entity, voxelSurfaceStyle] {
-        graphics::MeshPointer mesh(new graphics::Mesh());
+    uint32_t chunksGeneration { 0 };
+    ivec3 numChunks;
+    ivec3 volumeHigh { 0 };
+    std::vector<VoxelChunkMesh> chunkMeshes;
+    withWriteLock([&] {
+        chunksGeneration = _chunksGeneration;
+        numChunks = _numChunks;
+        if (_volData) {
+            volumeHigh = ivec3(_volData->getWidth(), _volData->getHeight(), _volData->getDepth()) - 1;
+        }
+        for (int i = 0; i < (int)_chunks.size(); i++) {
+            VoxelChunk& chunk = _chunks[i];
+            if (chunk.version != chunk.mesh.version && chunk.version != chunk.meshingVersion) {
+                chunk.meshingVersion = chunk.version;
+                VoxelChunkMesh chunkMesh;
+                chunkMesh.index = i;
+                chunkMesh.version = chunk.version;
+                chunkMeshes.push_back(chunkMesh);
+            }
+        }
+    });
 
-        // A mesh object to hold the result of surface extraction
-        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+    QtConcurrent::run([entity, voxelSurfaceStyle, chunksGeneration, numChunks, volumeHigh, chunkMeshes]() mutable {
+        QtConcurrent::blockingMap(chunkMeshes, [&](VoxelChunkMesh& chunkMesh) {
+            // chunks share the voxels on their faces so that the surface is continuous from one to the next
+            ivec3 low = getChunkLow(chunkMesh.index, numChunks);
+            ivec3 high = glm::min(low + VOXEL_CHUNK_SIZE, volumeHigh);
+            PolyVox::Region region(PolyVox::Vector3DInt32(low.x, low.y, low.z), PolyVox::Vector3DInt32(high.x, high.y, high.z));
 
-        entity->withReadLock([&] {
-            PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
-            switch (voxelSurfaceStyle) {
-                case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
+            // A mesh object to hold the result of surface extraction
+            PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+
+            entity->withReadLock([&] {
+                PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
+                if (!volData) {
+                    return;
                 }
-                case PolyVoxEntityItem::SURFACE_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
+                switch (voxelSurfaceStyle) {
+                    case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
+                        PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                            (volData, region, &polyVoxMesh);
+                        surfaceExtractor.execute();
+                        break;
+                    }
+                    case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
+                        PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                            (volData, region, &polyVoxMesh);
+                        surfaceExtractor.execute();
+                        break;
+                    }
+                    case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
+                        PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                            (volData, region, &polyVoxMesh);
+                        surfaceExtractor.execute();
+                        break;
+                    }
+                    case PolyVoxEntityItem::SURFACE_CUBIC: {
+                        PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                            (volData, region, &polyVoxMesh);
+                        surfaceExtractor.execute();
+                        break;
+                    }
                 }
+            });
+
+            // the extractors place vertices relative to the low corner of the region, move them into voxel-space
+            PolyVox::Vector3DFloat offset((float)low.x, (float)low.y, (float)low.z);
+            chunkMesh.vertices = polyVoxMesh.getRawVertexData();
+            for (auto& vertex : chunkMesh.vertices) {
+                vertex.setPosition(vertex.getPosition() + offset);
             }
+            chunkMesh.indices = polyVoxMesh.getIndices();
         });
 
-        // convert PolyVox mesh to a Sam mesh
-        const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
-        auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
-                                                         (gpu::Byte*)vecIndices.data());
-        auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
-        gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
-        mesh->setIndexBuffer(indexBufferView);
-
-        const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getRawVertexData();
-        auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
-                                                          (gpu::Byte*)vecVertices.data());
-        auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
-        gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
-                                         vertexBufferPtr->getSize(),
-                                         sizeof(PolyVox::PositionMaterialNormal),
-                                         gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-        mesh->setVertexBuffer(vertexBufferView);
-
-
-        // TODO -- use 3-byte normals rather than 3-float normals
-        mesh->addAttribute(gpu::Stream::NORMAL,
-                           gpu::BufferView(vertexBufferPtr,
-                                           sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
-                                           vertexBufferPtr->getSize(),
-                                           sizeof(PolyVox::PositionMaterialNormal),
-                                           gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
-
-        std::vector<graphics::Mesh::Part> parts;
-        parts.emplace_back(graphics::Mesh::Part((graphics::Index)0, // startIndex
-                                             (graphics::Index)vecIndices.size(), // numIndices
-                                             (graphics::Index)0, // baseVertex
-                                             graphics::Mesh::TRIANGLES)); // topology
-        mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(graphics::Mesh::Part),
-                                                            (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
-        entity->setMesh(mesh);
+        entity->setChunkMeshes(chunksGeneration, chunkMeshes);
     });
 }
 
-void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh) {
+void RenderablePolyVoxEntityItem::setChunkMeshes(uint32_t chunksGeneration, const std::vector<VoxelChunkMesh>& chunkMeshes) {
     // this catches the payload from recomputeMesh
     bool neighborsNeedUpdate;
     withWriteLock([&] {
+        bool meshChanged = !_mesh;
+        if (chunksGeneration == _chunksGeneration) {
+            for (const auto& chunkMesh : chunkMeshes) {
+                VoxelChunk& chunk = _chunks[chunkMesh.index];
+                if (chunk.meshingVersion == chunkMesh.version) {
+                    chunk.meshingVersion = 0;
+                }
+                // an older worker may finish after a newer one
+                if (chunkMesh.version > chunk.mesh.version) {
+                    chunk.mesh = chunkMesh;
+                    meshChanged = true;
+                }
+            }
+        }
+
+        if (meshChanged) {
+            size_t numVertices = 0;
+            size_t numIndices = 0;
+            for (const auto& chunk : _chunks) {
+                numVertices += chunk.mesh.vertices.size();
+                numIndices += chunk.mesh.indices.size();
+            }
+            std::vector<PolyVox::PositionMaterialNormal> vertices;
+            std::vector<uint32_t> indices;
+            vertices.reserve(numVertices);
+            indices.reserve(numIndices);
+            for (const auto& chunk : _chunks) {
+                uint32_t baseVertex = (uint32_t)vertices.size();
+                vertices.insert(vertices.end(), chunk.mesh.vertices.begin(), chunk.mesh.vertices.end());
+                for (uint32_t index : chunk.mesh.indices) {
+                    indices.push_back(baseVertex + index);
+                }
+            }
+            _mesh = makeMesh(vertices, indices);
+        }
+
         if (!_collisionless) {
             _flags |= Simulation::DIRTY_SHAPE | Simulation::DIRTY_MASS;
         }
-        _mesh = mesh;
         _meshDirty = true;
         _meshReady = true;
         neighborsNeedUpdate = _neighborsNeedUpdate;
@@ -1224,155 +1406,177 @@ void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh) {
 
 void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
     // this creates a collision-shape for the physics engine.  The shape comes from
-    // _volData for cubic extractors and from _mesh for marching-cube extractors
+    // _volData for cubic extractors and from the chunk meshes for marching-cube extractors.  Only the
+    // chunks whose mesh has changed since their hulls were made are redone.
     if (!_meshReady) {
         return;
     }
 
-    EntityItemPointer entity = getThisPointer();
+    auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
     PolyVoxSurfaceStyle voxelSurfaceStyle;
     glm::vec3 voxelVolumeSize;
-    graphics::MeshPointer mesh;
+    uint32_t chunksGeneration;
+    ivec3 numChunks;
+    std::vector<VoxelChunkMesh> chunkMeshes;
 
     withReadLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
         voxelVolumeSize = _voxelVolumeSize;
-        mesh = _mesh;
+        chunksGeneration = _chunksGeneration;
+        numChunks = _numChunks;
+        bool fromMesh = voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
+            voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES;
+        for (int i = 0; i < (int)_chunks.size(); i++) {
+            const VoxelChunk& chunk = _chunks[i];
+            if (chunk.pointsVersion != chunk.mesh.version) {
+                if (fromMesh) {
+                    chunkMeshes.push_back(chunk.mesh);
+                } else {
+                    VoxelChunkMesh chunkMesh;
+                    chunkMesh.index = i;
+                    chunkMesh.version = chunk.mesh.version;
+                    chunkMeshes.push_back(chunkMesh);
+                }
+            }
+        }
     });
+    glm::mat4 vtoM = voxelToLocalMatrix();
+
+    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, chunksGeneration, numChunks, chunkMeshes, vtoM] {
+        std::function<VoxelChunkPoints(const VoxelChunkMesh&)> computeChunkPoints = [&](const VoxelChunkMesh& chunkMesh) {
+            VoxelChunkPoints chunkPoints;
+            chunkPoints.index = chunkMesh.index;
+            chunkPoints.version = chunkMesh.version;
+            ShapeInfo::PointCollection& pointCollection = chunkPoints.points;
+
+            if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
+                voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
+                // pull each triangle in the mesh into a polyhedron which can be collided with
+                const auto& vertices = chunkMesh.vertices;
+                const auto& indices = chunkMesh.indices;
+                for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                    const PolyVox::Vector3DFloat& v0 = vertices[indices[i]].getPosition();
+                    const PolyVox::Vector3DFloat& v1 = vertices[indices[i + 1]].getPosition();
+                    const PolyVox::Vector3DFloat& v2 = vertices[indices[i + 2]].getPosition();
+                    glm::vec3 p0(v0.getX(), v0.getY(), v0.getZ());
+                    glm::vec3 p1(v1.getX(), v1.getY(), v1.getZ());
+                    glm::vec3 p2(v2.getX(), v2.getY(), v2.getZ());
+
+                    glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
+                    glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+                    glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
+
+                    QVector<glm::vec3> pointsInPart;
+                    pointsInPart << p0;
+                    pointsInPart << p1;
+                    pointsInPart << p2;
+                    pointsInPart << p3;
+                    // add next convex hull
+                    pointCollection << pointsInPart;
+                }
+            } else {
+                // each voxel of _volData belongs to the chunk holding the cell it is the low corner of
+                ivec3 edge = PolyVoxEntityItem::isEdged(voxelSurfaceStyle) ? ivec3(1) : ivec3(0);
+                ivec3 chunkLow = getChunkLow(chunkMesh.index, numChunks) - edge;
+                ivec3 low = glm::max(chunkLow, ivec3(0));
+                ivec3 high = glm::min(chunkLow + VOXEL_CHUNK_SIZE, ivec3(voxelVolumeSize));
+
+                float offL = -0.5f;
+                float offH = 0.5f;
+                if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
+                    offL += 1.0f;
+                    offH += 1.0f;
+                }
 
-    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, mesh] {
-        auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
-        QVector<QVector<glm::vec3>> pointCollection;
-        AABox box;
-        glm::mat4 vtoM = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->voxelToLocalMatrix();
-
-        if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
-            voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
-            // pull each triangle in the mesh into a polyhedron which can be collided with
-            unsigned int i = 0;
-
-            const gpu::BufferView& vertexBufferView = mesh->getVertexBuffer();
-            const gpu::BufferView& indexBufferView = mesh->getIndexBuffer();
-
-            gpu::BufferView::Iterator<const uint32_t> it = indexBufferView.cbegin<uint32_t>();
-            while (it != indexBufferView.cend<uint32_t>()) {
-                uint32_t p0Index = *(it++);
-                uint32_t p1Index = *(it++);
-                uint32_t p2Index = *(it++);
-
-                const glm::vec3& p0 = vertexBufferView.get<const glm::vec3>(p0Index);
-                const glm::vec3& p1 = vertexBufferView.get<const glm::vec3>(p1Index);
-                const glm::vec3& p2 = vertexBufferView.get<const glm::vec3>(p2Index);
-
-                glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
-                glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-                glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
-
-                glm::vec3 p0Model = glm::vec3(vtoM * glm::vec4(p0, 1.0f));
-                glm::vec3 p1Model = glm::vec3(vtoM * glm::vec4(p1, 1.0f));
-                glm::vec3 p2Model = glm::vec3(vtoM * glm::vec4(p2, 1.0f));
-                glm::vec3 p3Model = glm::vec3(vtoM * glm::vec4(p3, 1.0f));
-
-                box += p0Model;
-                box += p1Model;
-                box += p2Model;
-                box += p3Model;
-
-                QVector<glm::vec3> pointsInPart;
-                pointsInPart << p0Model;
-                pointsInPart << p1Model;
-                pointsInPart << p2Model;
-                pointsInPart << p3Model;
-                // add next convex hull
-                QVector<glm::vec3> newMeshPoints;
-                pointCollection << newMeshPoints;
-                // add points to the new convex hull
-                pointCollection[i++] << pointsInPart;
+                entity->withReadLock([&] {
+                    loop3(low, high, [&](const ivec3& v) {
+                        if (entity->getVoxelInternal(v) == 0) {
+                            return;
+                        }
+                        const auto& x = v.x;
+                        const auto& y = v.y;
+                        const auto& z = v.z;
+                        if (glm::all(glm::greaterThan(v, ivec3(0))) &&
+                            glm::all(glm::lessThan(v, ivec3(voxelVolumeSize) - 1)) &&
+                            (entity->getVoxelInternal({ x - 1, y, z }) > 0) &&
+                            (entity->getVoxelInternal({ x, y - 1, z }) > 0) &&
+                            (entity->getVoxelInternal({ x, y, z - 1 }) > 0) &&
+                            (entity->getVoxelInternal({ x + 1, y, z }) > 0) &&
+                            (entity->getVoxelInternal({ x, y + 1, z }) > 0) &&
+                            (entity->getVoxelInternal({ x, y, z + 1 }) > 0)) {
+                            // this voxel has neighbors in every cardinal direction, so there's no need
+                            // to include it in the collision hull.
+                            return;
+                        }
+
+                        QVector<glm::vec3> pointsInPart;
+                        pointsInPart << glm::vec3(x + offL, y + offL, z + offL);
+                        pointsInPart << glm::vec3(x + offL, y + offL, z + offH);
+                        pointsInPart << glm::vec3(x + offL, y + offH, z + offL);
+                        pointsInPart << glm::vec3(x + offL, y + offH, z + offH);
+                        pointsInPart << glm::vec3(x + offH, y + offL, z + offL);
+                        pointsInPart << glm::vec3(x + offH, y + offL, z + offH);
+                        pointsInPart << glm::vec3(x + offH, y + offH, z + offL);
+                        pointsInPart << glm::vec3(x + offH, y + offH, z + offH);
+
+                        // add next convex hull
+                        pointCollection << pointsInPart;
+                    });
+                });
             }
-        } else {
-            unsigned int i = 0;
-            polyVoxEntity->forEachVoxelValue(voxelVolumeSize, [&](const ivec3& v, uint8_t value) {
-                if (value > 0) {
-                    const auto& x = v.x;
-                    const auto& y = v.y;
-                    const auto& z = v.z;
-                    if (glm::all(glm::greaterThan(v, ivec3(0))) && 
-                        glm::all(glm::lessThan(v, ivec3(voxelVolumeSize) - 1)) && 
-                        (polyVoxEntity->getVoxelInternal({ x - 1, y, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y - 1, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y, z - 1 }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x + 1, y, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y + 1, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y, z + 1 }) > 0)) {
-                        // this voxel has neighbors in every cardinal direction, so there's no need
-                        // to include it in the collision hull.
-                        return;
-                    }
+            return chunkPoints;
+        };
 
-                    QVector<glm::vec3> pointsInPart;
+        std::vector<VoxelChunkPoints> chunkPoints =
+            QtConcurrent::blockingMapped<std::vector<VoxelChunkPoints>>(chunkMeshes, computeChunkPoints);
+        entity->setChunkCollisionPoints(chunksGeneration, chunkPoints, vtoM);
+    });
+}
 
-                    float offL = -0.5f;
-                    float offH = 0.5f;
-                    if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
-                        offL += 1.0f;
-                        offH += 1.0f;
-                    }
+void RenderablePolyVoxEntityItem::setChunkCollisionPoints(uint32_t chunksGeneration,
+                                                          const std::vector<VoxelChunkPoints>& chunkPoints,
+                                                          const glm::mat4& voxelToLocal) {
+    // this catches the payload from computeShapeInfoWorker
+    ShapeInfo::PointCollection pointCollection;
+    AABox box;
+    // the points are in model-space, so the key changes with the voxels, the dimensions and the registration point
+    QCryptographicHash shapeKeyHash(QCryptographicHash::Md5);
 
-                    glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
-                    glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
-                    glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
-                    glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
-                    glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
-                    glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
-                    glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
-                    glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
-
-                    box += p000;
-                    box += p001;
-                    box += p010;
-                    box += p011;
-                    box += p100;
-                    box += p101;
-                    box += p110;
-                    box += p111;
-
-                    pointsInPart << p000;
-                    pointsInPart << p001;
-                    pointsInPart << p010;
-                    pointsInPart << p011;
-                    pointsInPart << p100;
-                    pointsInPart << p101;
-                    pointsInPart << p110;
-                    pointsInPart << p111;
+    withWriteLock([&] {
+        if (chunksGeneration == _chunksGeneration) {
+            for (const auto& points : chunkPoints) {
+                VoxelChunk& chunk = _chunks[points.index];
+                if (points.version > chunk.pointsVersion) {
+                    chunk.points = points.points;
+                    chunk.pointsVersion = points.version;
+                }
+            }
+        }
 
-                    // add next convex hull
-                    QVector<glm::vec3> newMeshPoints;
-                    pointCollection << newMeshPoints;
-                    // add points to the new convex hull
-                    pointCollection[i++] << pointsInPart;
+        for (const auto& chunk : _chunks) {
+            for (const auto& pointsInVoxel : chunk.points) {
+                QVector<glm::vec3> pointsInModel;
+                pointsInModel.reserve(pointsInVoxel.size());
+                for (const auto& point : pointsInVoxel) {
+                    glm::vec3 pointInModel = glm::vec3(voxelToLocal * glm::vec4(point, 1.0f));
+                    box += pointInModel;
+                    pointsInModel << pointInModel;
                 }
-            });
+                shapeKeyHash.addData((const char*)pointsInModel.constData(), pointsInModel.size() * sizeof(glm::vec3));
+                pointCollection << pointsInModel;
+            }
         }
-        polyVoxEntity->setCollisionPoints(pointCollection, box);
     });
-}
 
-void RenderablePolyVoxEntityItem::setCollisionPoints(ShapeInfo::PointCollection pointCollection, AABox box) {
-    // this catches the payload from computeShapeInfoWorker
     if (pointCollection.isEmpty()) {
         EntityItem::computeShapeInfo(_shapeInfo);
         return;
     }
 
     glm::vec3 collisionModelDimensions = box.getDimensions();
-    // include the registrationPoint in the shape key, because the offset is already
-    // included in the points and the shapeManager wont know that the shape has changed.
     withWriteLock([&] {
-        QString shapeKey = QString(_voxelData.toBase64()) + "," +
-            QString::number(_registrationPoint.x) + "," +
-            QString::number(_registrationPoint.y) + "," +
-            QString::number(_registrationPoint.z);
+        QString shapeKey = QString(shapeKeyHash.result().toHex());
         _shapeInfo.setParams(SHAPE_TYPE_COMPOUND, collisionModelDimensions, shapeKey);
         _shapeInfo.setPointCollection(pointCollection);
         _meshDirty = false;
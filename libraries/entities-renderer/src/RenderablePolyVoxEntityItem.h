@@ -18,6 +18,7 @@
 
 #include <PolyVoxCore/SimpleVolume.h>
 #include <PolyVoxCore/Raycast.h>
+#include <PolyVoxCore/VertexTypes.h>
 
 #include <gpu/Forward.h>
 #include <gpu/Context.h>
@@ -107,9 +108,26 @@ public:
     void setVoxelsFromData(QByteArray uncompressedData, quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize);
     void forEachVoxelValue(const ivec3& voxelSize, std::function<void(const ivec3&, uint8_t)> thunk);
     QByteArray volDataToArray(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) const;
+    QByteArray volDataRegionToArray(const ivec3& low, const ivec3& size) const;
+
+    // the surface of the volume is extracted in chunks, each covering VOXEL_CHUNK_SIZE^3 cells of _volData.  An edit
+    // only marks the chunks around the voxels it changed, and only those are re-meshed and given new collision hulls.
+    struct VoxelChunkMesh {
+        int index { 0 };
+        uint32_t version { 0 };
+        std::vector<PolyVox::PositionMaterialNormal> vertices; // in voxel-space
+        std::vector<uint32_t> indices;
+    };
+    struct VoxelChunkPoints {
+        int index { 0 };
+        uint32_t version { 0 };
+        ShapeInfo::PointCollection points; // in voxel-space
+    };
+
+    void setChunkMeshes(uint32_t chunksGeneration, const std::vector<VoxelChunkMesh>& chunkMeshes);
+    void setChunkCollisionPoints(uint32_t chunksGeneration, const std::vector<VoxelChunkPoints>& chunkPoints,
+                                 const glm::mat4& voxelToLocal);
 
-    void setMesh(graphics::MeshPointer mesh);
-    void setCollisionPoints(ShapeInfo::PointCollection points, AABox box);
     PolyVox::SimpleVolume<uint8_t>* getVolData() { return _volData.get(); }
 
     uint8_t getVoxelInternal(const ivec3& v) const;
@@ -121,7 +139,19 @@ public:
     virtual scriptable::ScriptableModelBase getScriptableModel() override;
 
 private:
+    struct VoxelChunk {
+        uint32_t version { 1 }; // bumped whenever a voxel this chunk's surface depends on changes
+        uint32_t meshingVersion { 0 }; // the version a worker is currently meshing, if any
+        uint32_t pointsVersion { 0 }; // the version of the mesh that points was made from
+        VoxelChunkMesh mesh;
+        ShapeInfo::PointCollection points;
+    };
+
     bool updateOnCount(const ivec3& v, uint8_t toValue);
+    void resetChunks();
+    void markChunksDirty(const ivec3& volDataCoords);
+    void markAllChunksDirty();
+    void queueVoxelDataEdit(const EntityTreePointer& tree, const QByteArray& voxelData);
     PolyVox::RaycastResult doRayCast(glm::vec4 originInVoxel, glm::vec4 farInVoxel, glm::vec4& result) const;
 
     void recomputeMesh();
@@ -132,7 +162,8 @@ private:
 
     // these are run off the main thread
     void decompressVolumeData();
-    void compressVolumeDataAndSendEditPacket();
+    void compressVolumeDataAndSendEditPacket(const ivec3& editLow, const ivec3& editHigh);
+    void compressVolumeData(const EntityTreePointer& tree);
     void computeShapeInfoWorker();
 
     // The PolyVoxEntityItem class has _voxelData which contains dimensions and compressed voxel data.  The dimensions
@@ -148,6 +179,13 @@ private:
     bool _volDataDirty { false }; // does recomputeMesh need to be called?
     int _onCount; // how many non-zero voxels are in _volData
 
+    std::vector<VoxelChunk> _chunks;
+    ivec3 _numChunks { 0 };
+    uint32_t _chunksGeneration { 0 }; // bumped when _volData is re-allocated, so results for the old chunks are dropped
+
+    uint32_t _voxelEditCount { 0 };
+    bool _compressingVolumeData { false }; // is a worker bringing _voxelData up to date with _volData?
+
     bool _neighborsNeedUpdate { false };
 
     // these are cached lookups of _xNNeighborID, _yNNeighborID, _zNNeighborID, _xPNeighborID, _yPNeighborID, _zPNeighborID
@@ -11,6 +11,8 @@
 
 #include "DiffTraversal.h"
 
+#include <algorithm>
+
 #include <OctreeUtils.h>
 
 #include "EntityPriorityQueue.h"
@@ -37,9 +39,13 @@ void DiffTraversal::Waypoint::getNextVisibleElementFirstTime(DiffTraversal::Visi
             while (_nextIndex < NUMBER_OF_CHILDREN) {
                 EntityTreeElementPointer nextElement = element->getChildAtIndex(_nextIndex);
                 ++_nextIndex;
-                if (nextElement && view.shouldTraverseElement(*nextElement)) {
-                    next.element = nextElement;
-                    return;
+                if (nextElement) {
+                    if (view.shouldTraverseElement(*nextElement)) {
+                        next.element = nextElement;
+                        return;
+                    }
+                    // out of view: this subtree may hold entities that were never considered
+                    _subtreeComplete = false;
                 }
             }
         }
@@ -47,8 +53,8 @@ void DiffTraversal::Waypoint::getNextVisibleElementFirstTime(DiffTraversal::Visi
     next.element.reset();
 }
 
-void DiffTraversal::Waypoint::getNextVisibleElementRepeat(
-        DiffTraversal::VisibleElement& next, const DiffTraversal::View& view, uint64_t lastTime) {
+void DiffTraversal::Waypoint::getNextVisibleElementRepeat(DiffTraversal::VisibleElement& next,
+        const DiffTraversal::View& view, uint64_t lastTime, const CompleteSubtrees& completeSubtrees) {
     if (_nextIndex == -1) {
         // root case is special
         ++_nextIndex;
@@ -57,6 +63,8 @@ void DiffTraversal::Waypoint::getNextVisibleElementRepeat(
             next.element = element;
             return;
         }
+        // the root's own entities are not scanned this pass
+        _subtreeComplete = false;
     }
     if (_nextIndex < NUMBER_OF_CHILDREN) {
         EntityTreeElementPointer element = _weakElement.lock();
@@ -64,12 +72,16 @@ void DiffTraversal::Waypoint::getNextVisibleElementRepeat(
             while (_nextIndex < NUMBER_OF_CHILDREN) {
                 EntityTreeElementPointer nextElement = element->getChildAtIndex(_nextIndex);
                 ++_nextIndex;
-                if (nextElement &&
-                    nextElement->getLastChanged() > lastTime &&
-                    view.shouldTraverseElement(*nextElement)) {
-
-                    next.element = nextElement;
-                    return;
+                if (nextElement) {
+                    if (nextElement->getLastChanged() > lastTime && view.shouldTraverseElement(*nextElement)) {
+                        next.element = nextElement;
+                        return;
+                    }
+                    if (DiffTraversal::isSubtreeComplete(*nextElement, completeSubtrees)) {
+                        ++_numSkippedChildren;
+                    } else {
+                        _subtreeComplete = false;
+                    }
                 }
             }
         }
@@ -78,7 +90,7 @@ void DiffTraversal::Waypoint::getNextVisibleElementRepeat(
 }
 
 void DiffTraversal::Waypoint::getNextVisibleElementDifferential(DiffTraversal::VisibleElement& next,
-        const DiffTraversal::View& view, const DiffTraversal::View& lastView) {
+        const DiffTraversal::View& view, const DiffTraversal::View& lastView, const CompleteSubtrees& completeSubtrees) {
     if (_nextIndex == -1) {
         // root case is special
         ++_nextIndex;
@@ -91,9 +103,18 @@ void DiffTraversal::Waypoint::getNextVisibleElementDifferential(DiffTraversal::V
             while (_nextIndex < NUMBER_OF_CHILDREN) {
                 EntityTreeElementPointer nextElement = element->getChildAtIndex(_nextIndex);
                 ++_nextIndex;
-                if (nextElement && view.shouldTraverseElement(*nextElement)) {
-                    next.element = nextElement;
-                    return;
+                if (nextElement) {
+                    // everything in a complete subtree is already known, and stays known in any view
+                    // until something under it changes
+                    if (DiffTraversal::isSubtreeComplete(*nextElement, completeSubtrees)) {
+                        ++_numSkippedChildren;
+                        continue;
+                    }
+                    if (view.shouldTraverseElement(*nextElement)) {
+                        next.element = nextElement;
+                        return;
+                    }
+                    _subtreeComplete = false;
                 }
             }
         }
@@ -101,6 +122,17 @@ void DiffTraversal::Waypoint::getNextVisibleElementDifferential(DiffTraversal::V
     next.element.reset();
 }
 
+bool DiffTraversal::isSubtreeComplete(const EntityTreeElement& element, const CompleteSubtrees& completeSubtrees) {
+    auto itr = completeSubtrees.find(&element);
+    // an expired entry was left by a deleted element that this one has taken the place of
+    if (itr == completeSubtrees.end() || itr->second.element.expired()) {
+        return false;
+    }
+    // the element's own timestamps are bumped whenever anything under it is added, removed, moved or edited
+    uint64_t completedTime = itr->second.completedTime;
+    return element.getLastChanged() < completedTime && element.getLastChangedContent() < completedTime;
+}
+
 bool DiffTraversal::View::usesViewFrustums() const {
     return !viewFrustums.empty();
 }
@@ -211,10 +243,13 @@ DiffTraversal::Type DiffTraversal::prepareNewTraversal(const DiffTraversal::View
     // external code should update the _scanElementCallback after calling prepareNewTraversal
     //
 
+    sweepCompleteSubtrees();
+
     Type type;
     // If usesViewFrustum changes, treat it as a First traversal
     if (forceFirstPass || _completedView.startTime == 0 || _currentView.usesViewFrustums() != _completedView.usesViewFrustums()) {
         type = Type::First;
+        invalidateCompleteSubtrees();
         _currentView.viewFrustums = view.viewFrustums;
         _currentView.lodScaleFactor = view.lodScaleFactor;
         _getNextVisibleElementCallback = [this](DiffTraversal::VisibleElement& next) {
@@ -223,14 +258,14 @@ DiffTraversal::Type DiffTraversal::prepareNewTraversal(const DiffTraversal::View
     } else if (!_currentView.usesViewFrustums() || _completedView.isVerySimilar(view)) {
         type = Type::Repeat;
         _getNextVisibleElementCallback = [this](DiffTraversal::VisibleElement& next) {
-            _path.back().getNextVisibleElementRepeat(next, _completedView, _completedView.startTime);
+            _path.back().getNextVisibleElementRepeat(next, _completedView, _completedView.startTime, _completeSubtrees);
         };
     } else {
         type = Type::Differential;
         _currentView.viewFrustums = view.viewFrustums;
         _currentView.lodScaleFactor = view.lodScaleFactor;
         _getNextVisibleElementCallback = [this](DiffTraversal::VisibleElement& next) {
-            _path.back().getNextVisibleElementDifferential(next, _currentView, _completedView);
+            _path.back().getNextVisibleElementDifferential(next, _currentView, _completedView, _completeSubtrees);
         };
     }
 
@@ -240,10 +275,51 @@ DiffTraversal::Type DiffTraversal::prepareNewTraversal(const DiffTraversal::View
     _path.back().initRootNextIndex();
 
     _currentView.startTime = usecTimestampNow();
+    _numVisitedElements = 0;
+    _numSkippedElements = 0;
 
     return type;
 }
 
+void DiffTraversal::finishWaypoint() {
+    // all of the children of the last waypoint have been visited or skipped, so we now know
+    // whether everything in its subtree was accounted for during this pass
+    const Waypoint& waypoint = _path.back();
+    _numSkippedElements += waypoint.getNumSkippedChildren();
+    bool complete = waypoint.isSubtreeComplete();
+    EntityTreeElementPointer element = waypoint.getElement();
+    if (element) {
+        if (complete) {
+            _completeSubtrees[element.get()] = { element, _currentView.startTime };
+        } else {
+            _completeSubtrees.erase(element.get());
+        }
+    } else {
+        complete = false;
+    }
+    _path.pop_back();
+    if (!complete && !_path.empty()) {
+        _path.back().setSubtreeIncomplete();
+    }
+}
+
+void DiffTraversal::sweepCompleteSubtrees() {
+    // going through every entry costs about as much as the entries added since the last sweep, so this stays
+    // cheap for passes that skip most of the tree
+    const size_t MIN_COMPLETE_SUBTREES_TO_SWEEP = 64;
+    if (_completeSubtrees.size() < std::max(MIN_COMPLETE_SUBTREES_TO_SWEEP, 2 * _numCompleteSubtreesAfterSweep)) {
+        return;
+    }
+    for (auto itr = _completeSubtrees.begin(); itr != _completeSubtrees.end(); ) {
+        if (itr->second.element.expired()) {
+            itr = _completeSubtrees.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    _numCompleteSubtreesAfterSweep = _completeSubtrees.size();
+}
+
 void DiffTraversal::getNextVisibleElement(DiffTraversal::VisibleElement& next) {
     if (_path.empty()) {
         next.element.reset();
@@ -259,7 +335,7 @@ void DiffTraversal::getNextVisibleElement(DiffTraversal::VisibleElement& next) {
         // we're done at this level
         while (!next.element) {
             // pop one level
-            _path.pop_back();
+            finishWaypoint();
             if (_path.empty()) {
                 // we've traversed the entire tree
                 _completedView = _currentView;
@@ -273,6 +349,9 @@ void DiffTraversal::getNextVisibleElement(DiffTraversal::VisibleElement& next) {
             }
         }
     }
+    if (next.element) {
+        ++_numVisitedElements;
+    }
 }
 
 void DiffTraversal::setScanCallback(std::function<void (DiffTraversal::VisibleElement&)> cb) {
@@ -289,7 +368,12 @@ void DiffTraversal::traverse(uint64_t timeBudget) {
     getNextVisibleElement(next);
     while (next.element) {
         if (next.element->hasContent()) {
+            next.complete = true;
             _scanElementCallback(next);
+            if (!next.complete) {
+                // the waypoint at the end of the path belongs to the element we just scanned
+                _path.back().setSubtreeIncomplete();
+            }
         }
         if (usecTimestampNow() > expiry) {
             break;
@@ -12,6 +12,8 @@
 #ifndef hifi_DiffTraversal_h
 #define hifi_DiffTraversal_h
 
+#include <unordered_map>
+
 #include <shared/ConicalViewFrustum.h>
 
 #include "EntityTreeElement.h"
@@ -24,7 +26,20 @@ public:
     class VisibleElement {
     public:
         EntityTreeElementPointer element;
+        // the scan callback clears this when it leaves any of the element's entities unaccounted for
+        bool complete { true };
+    };
+
+    // CompleteSubtrees is the change journal of a traversal: it maps elements whose whole subtree was
+    // accounted for by the scan callback to the start time of the pass that did so.  A subtree that
+    // has not changed since then holds nothing new and is skipped by Repeat and Differential passes.
+    // Entries hold on to their element weakly, those of deleted elements are swept out as new ones come in.
+    class CompleteSubtree {
+    public:
+        EntityTreeElementWeakPointer element;
+        uint64_t completedTime;
     };
+    using CompleteSubtrees = std::unordered_map<const EntityTreeElement*, CompleteSubtree>;
 
     // View is a struct with a ViewFrustum and LOD parameters
     class View {
@@ -46,17 +61,28 @@ public:
         Waypoint(EntityTreeElementPointer& element);
 
         void getNextVisibleElementFirstTime(VisibleElement& next, const View& view);
-        void getNextVisibleElementRepeat(VisibleElement& next, const View& view, uint64_t lastTime);
-        void getNextVisibleElementDifferential(VisibleElement& next, const View& view, const View& lastView);
+        void getNextVisibleElementRepeat(VisibleElement& next, const View& view, uint64_t lastTime,
+                                         const CompleteSubtrees& completeSubtrees);
+        void getNextVisibleElementDifferential(VisibleElement& next, const View& view, const View& lastView,
+                                               const CompleteSubtrees& completeSubtrees);
 
         int8_t getNextIndex() const { return _nextIndex; }
         void initRootNextIndex() { _nextIndex = -1; }
 
+        EntityTreeElementPointer getElement() const { return _weakElement.lock(); }
+        bool isSubtreeComplete() const { return _subtreeComplete; }
+        void setSubtreeIncomplete() { _subtreeComplete = false; }
+        uint32_t getNumSkippedChildren() const { return _numSkippedChildren; }
+
     protected:
         EntityTreeElementWeakPointer _weakElement;
         int8_t _nextIndex;
+        bool _subtreeComplete { true };
+        uint8_t _numSkippedChildren { 0 };
     };
 
+    static bool isSubtreeComplete(const EntityTreeElement& element, const CompleteSubtrees& completeSubtrees);
+
     typedef enum { First, Repeat, Differential } Type;
 
     DiffTraversal();
@@ -71,16 +97,30 @@ public:
     void setScanCallback(std::function<void (VisibleElement&)> cb);
     void traverse(uint64_t timeBudget);
 
-    void reset() { _path.clear(); _completedView.startTime = 0; } // resets our state to force a new "First" traversal
+    void reset() { _path.clear(); _completedView.startTime = 0; invalidateCompleteSubtrees(); } // resets our state to force a new "First" traversal
+
+    // forget which subtrees were complete, e.g. when entities the scan callback had accounted for are dropped
+    void invalidateCompleteSubtrees() { _completeSubtrees.clear(); _numCompleteSubtreesAfterSweep = 0; }
+
+    // element counts of the current (or last) pass: visited by the traversal, and skipped as complete and unchanged
+    uint32_t getNumVisitedElements() const { return _numVisitedElements; }
+    uint32_t getNumSkippedElements() const { return _numSkippedElements; }
+    size_t getNumCompleteSubtrees() const { return _completeSubtrees.size(); }
 
 private:
     void getNextVisibleElement(VisibleElement& next);
+    void finishWaypoint();
+    void sweepCompleteSubtrees();
 
     View _currentView;
     View _completedView;
     std::vector<Waypoint> _path;
     std::function<void (VisibleElement&)> _getNextVisibleElementCallback { nullptr };
     std::function<void (VisibleElement&)> _scanElementCallback { [](VisibleElement& e){} };
+    CompleteSubtrees _completeSubtrees;
+    size_t _numCompleteSubtreesAfterSweep { 0 };
+    uint32_t _numVisitedElements { 0 };
+    uint32_t _numSkippedElements { 0 };
 };
 
 #endif // hifi_EntityPriorityQueue_h
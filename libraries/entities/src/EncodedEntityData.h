@@ -0,0 +1,58 @@
+//
+//  EncodedEntityData.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EncodedEntityData_h
+#define hifi_EncodedEntityData_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+#include <OctreePacketData.h>
+
+#include "EntityPropertyFlags.h"
+
+/// The complete wire encoding of an EntityItem, shared by every EntityTreeSendThread that sends the same version of
+/// the entity. Clients that need less than the whole record (a partial send that is being continued, or a packet
+/// without room for all of it) are served by splicing the header and the property ranges they want.
+class EncodedEntityData {
+public:
+    class Version {
+    public:
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        uint32_t generation { 0 }; // bumped for changes that do not move the timestamps (e.g. simulation ownership)
+
+        bool operator==(const Version& other) const {
+            return lastEdited == other.lastEdited && lastUpdated == other.lastUpdated &&
+                lastSimulated == other.lastSimulated && generation == other.generation;
+        }
+        bool operator!=(const Version& other) const { return !(*this == other); }
+    };
+
+    Version version;
+
+    /// the properties present in data, as written in its property flags
+    EntityPropertyFlags properties;
+
+    /// header [0, headerLength), property flags [headerLength, propertyDataOffset), property data [propertyDataOffset, end)
+    QByteArray data;
+    int headerLength { 0 };
+    int propertyDataOffset { 0 };
+
+    /// one range per property in properties, in encoding order; offsets are into data
+    std::vector<OctreePacketData::TaggedRange> propertyRanges;
+};
+
+using EncodedEntityDataPointer = std::shared_ptr<const EncodedEntityData>;
+
+#endif // hifi_EncodedEntityData_h
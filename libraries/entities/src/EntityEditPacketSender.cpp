@@ -70,6 +70,43 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType type,
                                                     EntityTreePointer entityTree,
                                                     EntityItemID entityItemID,
                                                     const EntityItemProperties& properties) {
+    std::vector<EditMessagePair> messages;
+    encodeEditEntityMessage(type, entityTree, entityItemID, properties, messages);
+    for (auto& message : messages) {
+        queueOctreeEditMessage(message.first, message.second);
+    }
+}
+
+void EntityEditPacketSender::queueEditEntityMessages(PacketType type,
+                                                     EntityTreePointer entityTree,
+                                                     const QVector<EntityItemID>& entityItemIDs,
+                                                     const QVector<EntityItemProperties>& properties) {
+    assert(entityItemIDs.size() == properties.size());
+    std::vector<EditMessagePair> messages;
+    for (int i = 0; i < entityItemIDs.size(); ++i) {
+        encodeEditEntityMessage(type, entityTree, entityItemIDs[i], properties[i], messages);
+    }
+
+    // the adds go first and together, the edits that follow may carry the properties of an add that didn't fit
+    std::vector<QByteArray> addMessages;
+    for (auto& message : messages) {
+        if (message.first == PacketType::EntityAdd) {
+            addMessages.push_back(std::move(message.second));
+        }
+    }
+    queueOctreeEditMessages(PacketType::EntityAdd, addMessages);
+    for (auto& message : messages) {
+        if (message.first != PacketType::EntityAdd) {
+            queueOctreeEditMessage(message.first, message.second);
+        }
+    }
+}
+
+void EntityEditPacketSender::encodeEditEntityMessage(PacketType type,
+                                                     EntityTreePointer entityTree,
+                                                     EntityItemID entityItemID,
+                                                     const EntityItemProperties& properties,
+                                                     std::vector<EditMessagePair>& messages) {
     if (properties.getEntityHostType() == entity::HostType::AVATAR) {
         if (!_myAvatar) {
             qCWarning(entities) << "Suppressing entity edit message: cannot send avatar entity edit with no myAvatar";
@@ -121,12 +158,12 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType type,
             qCWarning(entities).nospace() << "queueEditEntityMessage: some of the properties don't fit and can't be sent. entityID=" << uuidStringWithoutCurlyBraces(entityItemID);
         } else {
             #ifdef WANT_DEBUG
-                qCDebug(entities) << "calling queueOctreeEditMessage()...";
+                qCDebug(entities) << "encoded edit message...";
                 qCDebug(entities) << "    id:" << entityItemID;
                 qCDebug(entities) << "    properties:" << properties;
             #endif
 
-            queueOctreeEditMessage(type, bufferOut);
+            messages.push_back({ type, bufferOut });
             if (type == PacketType::EntityAdd && !properties.getCertificateID().isEmpty()) {
                 emit addingEntityWithCertificate(properties.getCertificateID(), DependencyManager::get<AddressManager>()->getPlaceName());
             }
@@ -35,6 +35,10 @@ public:
     void queueEditEntityMessage(PacketType type, EntityTreePointer entityTree,
                                 EntityItemID entityItemID, const EntityItemProperties& properties);
 
+    /// Queues the edit messages of several entities together, so that their adds share reliable packet lists.
+    void queueEditEntityMessages(PacketType type, EntityTreePointer entityTree,
+                                 const QVector<EntityItemID>& entityItemIDs, const QVector<EntityItemProperties>& properties);
+
 
     void queueEraseEntityMessage(const EntityItemID& entityItemID);
     void queueCloneEntityMessage(const EntityItemID& entityIDToClone, const EntityItemID& newEntityID);
@@ -52,6 +56,8 @@ public slots:
 private:
     friend class MyAvatar;
     void queueEditAvatarEntityMessage(EntityTreePointer entityTree, EntityItemID entityItemID);
+    void encodeEditEntityMessage(PacketType type, EntityTreePointer entityTree, EntityItemID entityItemID,
+                                 const EntityItemProperties& properties, std::vector<EditMessagePair>& messages);
 
 private:
     std::mutex _mutex;
@@ -49,6 +49,9 @@ int entityItemPointernMetaTypeId = qRegisterMetaType<EntityItemPointer>();
 int EntityItem::_maxActionsDataSize = 800;
 quint64 EntityItem::_rememberDeletedActionTime = 20 * USECS_PER_SECOND;
 QString EntityItem::_marketplacePublicKey;
+std::atomic<bool> EntityItem::_encodedDataCacheEnabled { false };
+std::atomic<quint64> EntityItem::_encodedDataCacheHits { 0 };
+std::atomic<quint64> EntityItem::_encodedDataCacheMisses { 0 };
 
 std::function<glm::quat(const glm::vec3&, const glm::quat&, BillboardMode, const glm::vec3&)> EntityItem::_getBillboardRotationOperator = [](const glm::vec3&, const glm::quat& rotation, BillboardMode, const glm::vec3&) { return rotation; };
 std::function<glm::vec3()> EntityItem::_getPrimaryViewFrustumPositionOperator = []() { return glm::vec3(0.0f); };
@@ -153,8 +156,183 @@ EntityPropertyFlags EntityItem::getEntityProperties(EncodeBitstreamParams& param
     return requestedProperties;
 }
 
+// Writes the final property flags over the placeholder flags at propertyFlagsOffset. If the final flags are shorter,
+// the property data that follows is shifted down to close the gap.
+static void finalizePropertyFlags(OctreePacketData* packetData, EntityPropertyFlags propertyFlags,
+                                  int propertyFlagsOffset, int oldPropertyFlagsLength, int startOfEntityItemData) {
+    int endOfEntityItemData = packetData->getUncompressedByteOffset();
+    QByteArray encodedPropertyFlags = propertyFlags;
+    int newPropertyFlagsLength = encodedPropertyFlags.length();
+    packetData->updatePriorBytes(propertyFlagsOffset,
+            (const unsigned char*)encodedPropertyFlags.constData(), encodedPropertyFlags.length());
+
+    // if the size of the PropertyFlags shrunk, we need to shift everything down to front of packet.
+    if (newPropertyFlagsLength < oldPropertyFlagsLength) {
+        int oldSize = packetData->getUncompressedSize();
+        const unsigned char* modelItemData = packetData->getUncompressedData(propertyFlagsOffset + oldPropertyFlagsLength);
+        int modelItemDataLength = endOfEntityItemData - startOfEntityItemData;
+        int newEntityItemDataStart = propertyFlagsOffset + newPropertyFlagsLength;
+        packetData->updatePriorBytes(newEntityItemDataStart, modelItemData, modelItemDataLength);
+        int newSize = oldSize - (oldPropertyFlagsLength - newPropertyFlagsLength);
+        packetData->setUncompressedSize(newSize);
+
+    } else {
+        assert(newPropertyFlagsLength == oldPropertyFlagsLength); // should not have grown
+    }
+}
+
 OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                             EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData) const {
+    if (_encodedDataCacheEnabled) {
+        EncodedEntityDataPointer encoded = getEncodedData();
+        if (encoded) {
+            return appendEncodedData(*encoded, packetData, params, entityTreeElementExtraEncodeData);
+        }
+    }
+    return encodeEntityData(packetData, params, entityTreeElementExtraEncodeData);
+}
+
+EncodedEntityDataPointer EntityItem::getEncodedData() const {
+    EncodedEntityData::Version version;
+    version.generation = _encodedDataGeneration;
+    version.lastEdited = getLastEdited();
+    version.lastUpdated = getLastUpdated();
+    version.lastSimulated = getLastSimulated();
+
+    {
+        std::lock_guard<std::mutex> lock(_encodedDataMutex);
+        if (_encodedData && _encodedData->version == version) {
+            _encodedDataCacheHits++;
+            return _encodedData;
+        }
+    }
+    _encodedDataCacheMisses++;
+
+    // encode the whole entity once, with no per-client state: a fresh params has a no-op trackSend()
+    const int MAX_ENCODED_ENTITY_SIZE = 64 * 1024;
+    static thread_local OctreePacketData scratch(false, MAX_ENCODED_ENTITY_SIZE);
+    scratch.reset();
+
+    auto encoded = std::make_shared<EncodedEntityData>();
+    encoded->version = version;
+
+    EncodeBitstreamParams encodeParams;
+    auto extra = std::make_shared<EntityTreeElementExtraEncodeData>();
+    int propertyFlagsOffset = 0;
+    scratch.setTaggedRanges(&encoded->propertyRanges);
+    OctreeElement::AppendState appendState = encodeEntityData(&scratch, encodeParams, extra, &propertyFlagsOffset);
+    scratch.setTaggedRanges(nullptr);
+
+    if (appendState != OctreeElement::COMPLETED) {
+        // too big to share, every client encodes it on its own
+        return EncodedEntityDataPointer();
+    }
+
+    encoded->data = QByteArray((const char*)scratch.getUncompressedData(), scratch.getUncompressedSize());
+
+    // the ranges were recorded before the property flags were shrunk, move them to where the data ended up
+    int propertyDataLength = 0;
+    for (const auto& range : encoded->propertyRanges) {
+        propertyDataLength += range.length;
+        encoded->properties.setHasProperty((EntityPropertyList)range.tag);
+    }
+    encoded->headerLength = propertyFlagsOffset;
+    encoded->propertyDataOffset = encoded->data.size() - propertyDataLength;
+    if (encoded->propertyRanges.empty() || encoded->propertyDataOffset < encoded->headerLength) {
+        return EncodedEntityDataPointer();
+    }
+    int shift = encoded->propertyRanges.front().offset - encoded->propertyDataOffset;
+    int expectedOffset = encoded->propertyDataOffset;
+    for (auto& range : encoded->propertyRanges) {
+        range.offset -= shift;
+        if (range.offset != expectedOffset) {
+            // something other than a tagged property was written between the properties, we can't splice this
+            return EncodedEntityDataPointer();
+        }
+        expectedOffset += range.length;
+    }
+
+    std::lock_guard<std::mutex> lock(_encodedDataMutex);
+    _encodedData = encoded;
+    return encoded;
+}
+
+OctreeElement::AppendState EntityItem::appendEncodedData(const EncodedEntityData& encoded, OctreePacketData* packetData,
+                                            EncodeBitstreamParams& params,
+                                            EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData) const {
+    const unsigned char* data = (const unsigned char*)encoded.data.constData();
+    bool continuingPartialSend = entityTreeElementExtraEncodeData &&
+        entityTreeElementExtraEncodeData->entities.contains(getEntityItemID());
+
+    // the common case: everything is wanted and everything fits
+    if (!continuingPartialSend && packetData->appendRawData(data, encoded.data.size())) {
+        params.trackSend(getID(), getLastEdited());
+        return OctreeElement::COMPLETED;
+    }
+
+    EntityPropertyFlags requestedProperties = continuingPartialSend ?
+        entityTreeElementExtraEncodeData->entities.value(getEntityItemID()) : encoded.properties;
+    if (!!(requestedProperties - encoded.properties)) {
+        // the client still wants properties this version doesn't carry, let the full encoder decide what to do
+        return encodeEntityData(packetData, params, entityTreeElementExtraEncodeData);
+    }
+
+    OctreeElement::AppendState appendState = OctreeElement::COMPLETED; // assume the best
+    EntityPropertyFlags propertiesDidntFit = requestedProperties;
+    EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
+    int propertyCount = 0;
+
+    LevelDetails entityLevel = packetData->startLevel();
+
+    bool headerFits = packetData->appendRawData(data, encoded.headerLength);
+    int propertyFlagsOffset = packetData->getUncompressedByteOffset();
+    QByteArray encodedPropertyFlags = propertyFlags;
+    int oldPropertyFlagsLength = encodedPropertyFlags.length();
+    headerFits = headerFits && packetData->appendRawData(encodedPropertyFlags);
+    int startOfEntityItemData = packetData->getUncompressedByteOffset();
+
+    if (headerFits) {
+        propertyFlags -= PROP_LAST_ITEM;
+        for (const auto& range : encoded.propertyRanges) {
+            EntityPropertyList property = (EntityPropertyList)range.tag;
+            if (!requestedProperties.getHasProperty(property)) {
+                continue;
+            }
+            if (packetData->appendRawData(data + range.offset, range.length)) {
+                propertyFlags += property;
+                propertiesDidntFit -= property;
+                propertyCount++;
+            } else {
+                appendState = OctreeElement::PARTIAL;
+            }
+        }
+    }
+
+    if (propertyCount > 0) {
+        finalizePropertyFlags(packetData, propertyFlags, propertyFlagsOffset, oldPropertyFlagsLength, startOfEntityItemData);
+        packetData->endLevel(entityLevel);
+    } else {
+        packetData->discardLevel(entityLevel);
+        appendState = OctreeElement::NONE; // if we got here, then we didn't include the item
+    }
+
+    // If any part of the model items didn't fit, then the element is considered partial
+    if (appendState != OctreeElement::COMPLETED) {
+        // add this item into our list for the next appendElementData() pass
+        entityTreeElementExtraEncodeData->entities.insert(getEntityItemID(), propertiesDidntFit);
+    }
+
+    // if any part of our entity was sent, call trackSend
+    if (appendState != OctreeElement::NONE) {
+        params.trackSend(getID(), getLastEdited());
+    }
+
+    return appendState;
+}
+
+OctreeElement::AppendState EntityItem::encodeEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
+                                            EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
+                                            int* propertyFlagsOffsetOut) const {
 
     // ALL this fits...
     //    object ID [16 bytes]
@@ -350,26 +528,10 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     }
 
     if (propertyCount > 0) {
-        int endOfEntityItemData = packetData->getUncompressedByteOffset();
-        encodedPropertyFlags = propertyFlags;
-        int newPropertyFlagsLength = encodedPropertyFlags.length();
-        packetData->updatePriorBytes(propertyFlagsOffset,
-                (const unsigned char*)encodedPropertyFlags.constData(), encodedPropertyFlags.length());
-
-        // if the size of the PropertyFlags shrunk, we need to shift everything down to front of packet.
-        if (newPropertyFlagsLength < oldPropertyFlagsLength) {
-            int oldSize = packetData->getUncompressedSize();
-            const unsigned char* modelItemData = packetData->getUncompressedData(propertyFlagsOffset + oldPropertyFlagsLength);
-            int modelItemDataLength = endOfEntityItemData - startOfEntityItemData;
-            int newEntityItemDataStart = propertyFlagsOffset + newPropertyFlagsLength;
-            packetData->updatePriorBytes(newEntityItemDataStart, modelItemData, modelItemDataLength);
-            int newSize = oldSize - (oldPropertyFlagsLength - newPropertyFlagsLength);
-            packetData->setUncompressedSize(newSize);
-
-        } else {
-            assert(newPropertyFlagsLength == oldPropertyFlagsLength); // should not have grown
+        finalizePropertyFlags(packetData, propertyFlags, propertyFlagsOffset, oldPropertyFlagsLength, startOfEntityItemData);
+        if (propertyFlagsOffsetOut) {
+            *propertyFlagsOffsetOut = propertyFlagsOffset;
         }
-
         packetData->endLevel(entityLevel);
     } else {
         packetData->discardLevel(entityLevel);
@@ -1942,6 +2104,7 @@ void EntityItem::setVelocity(const glm::vec3& value) {
             }
             setLocalVelocity(velocity);
             _flags |= Simulation::DIRTY_LINEAR_VELOCITY;
+            invalidateEncodedData();
         }
     }
 }
@@ -1989,6 +2152,7 @@ void EntityItem::setAngularVelocity(const glm::vec3& value) {
             }
             setLocalAngularVelocity(angularVelocity);
             _flags |= Simulation::DIRTY_ANGULAR_VELOCITY;
+            invalidateEncodedData();
         }
     }
 }
@@ -2114,6 +2278,7 @@ void EntityItem::setSimulationOwner(const QUuid& id, uint8_t priority) {
         qCDebug(entities) << "sim ownership for" << getDebugName() << "is now" << id << priority;
     }
     _simulationOwner.set(id, priority);
+    invalidateEncodedData();
 }
 
 void EntityItem::setSimulationOwner(const SimulationOwner& owner) {
@@ -2124,6 +2289,7 @@ void EntityItem::setSimulationOwner(const SimulationOwner& owner) {
 
     if (_simulationOwner.set(owner)) {
         markDirtyFlags(Simulation::DIRTY_SIMULATOR_ID);
+        invalidateEncodedData();
     }
 }
 
@@ -2133,6 +2299,7 @@ void EntityItem::clearSimulationOwnership() {
     }
 
     _simulationOwner.clear();
+    invalidateEncodedData();
     // don't bother setting the DIRTY_SIMULATOR_ID flag because:
     // (a) when entity-server calls clearSimulationOwnership() the dirty-flags are meaningless (only used by interface)
     // (b) the interface only calls clearSimulationOwnership() in a context that already knows best about dirty flags
@@ -2717,6 +2884,8 @@ void EntityItem::markAsChangedOnServer() {
     withWriteLock([&] {
         _changedOnServer = usecTimestampNow();
     });
+    // the server changed something without an edit, so the timestamps of the shared encoding didn't move
+    invalidateEncodedData();
 }
 
 quint64 EntityItem::getLastChangedOnServer() const {
@@ -2788,9 +2957,14 @@ glm::vec3 EntityItem::getAcceleration() const {
 }
 
 void EntityItem::setAcceleration(const glm::vec3& value) {
+    bool changed = false;
     withWriteLock([&] {
+        changed = _acceleration != value;
         _acceleration = value;
     });
+    if (changed) {
+        invalidateEncodedData();
+    }
 }
 
 float EntityItem::getDamping() const {
@@ -3218,6 +3392,7 @@ void EntityItem::deregisterChangeHandler(const ChangeHandlerId& changeHandlerId)
 }
 
 void EntityItem::somethingChangedNotification() {
+    invalidateEncodedData();
     auto id = getEntityItemID();
     withReadLock([&] {
         for (const auto& handler : _changeHandlers.values()) {
@@ -12,7 +12,9 @@
 #ifndef hifi_EntityItem_h
 #define hifi_EntityItem_h
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 
 #include <glm/glm.hpp>
@@ -28,6 +30,7 @@
 #include <SpatiallyNestable.h>
 #include <Interpolate.h>
 
+#include "EncodedEntityData.h"
 #include "EntityItemID.h"
 #include "EntityItemPropertiesDefaults.h"
 #include "EntityPropertyFlags.h"
@@ -135,6 +138,17 @@ public:
     virtual OctreeElement::AppendState appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                                         EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData) const;
 
+    // When enabled (by the entity-server), appendEntityData() encodes each version of an entity once and shares the
+    // result between all the send threads, so the per-client cost is a copy or a splice instead of a full encode.
+    static void setEncodedDataCacheEnabled(bool enabled) { _encodedDataCacheEnabled = enabled; }
+    static bool isEncodedDataCacheEnabled() { return _encodedDataCacheEnabled; }
+    static quint64 getEncodedDataCacheHits() { return _encodedDataCacheHits; }
+    static quint64 getEncodedDataCacheMisses() { return _encodedDataCacheMisses; }
+    static void resetEncodedDataCacheStats() { _encodedDataCacheHits = 0; _encodedDataCacheMisses = 0; }
+
+    // drops the shared encoding, for changes that don't bump the edit timestamps
+    void invalidateEncodedData() { _encodedDataGeneration++; }
+
     virtual void appendSubclassData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                     EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
                                     EntityPropertyFlags& requestedProperties,
@@ -573,6 +587,14 @@ protected:
 
     void somethingChangedNotification();
 
+    OctreeElement::AppendState encodeEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
+                                                EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
+                                                int* propertyFlagsOffsetOut = nullptr) const;
+    EncodedEntityDataPointer getEncodedData() const;
+    OctreeElement::AppendState appendEncodedData(const EncodedEntityData& encoded, OctreePacketData* packetData,
+                                                 EncodeBitstreamParams& params,
+                                                 EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData) const;
+
     void setSimulated(bool simulated) { _simulated = simulated; }
 
     const QByteArray getDynamicDataInternal() const;
@@ -752,6 +774,13 @@ protected:
 
     QHash<QUuid, EntityDynamicPointer> _grabActions;
 
+    mutable std::mutex _encodedDataMutex;
+    mutable EncodedEntityDataPointer _encodedData;
+    std::atomic<uint32_t> _encodedDataGeneration { 0 };
+    static std::atomic<bool> _encodedDataCacheEnabled;
+    static std::atomic<quint64> _encodedDataCacheHits;
+    static std::atomic<quint64> _encodedDataCacheMisses;
+
 private:
     static std::function<glm::quat(const glm::vec3&, const glm::quat&, BillboardMode, const glm::vec3&)> _getBillboardRotationOperator;
     static std::function<glm::vec3()> _getPrimaryViewFrustumPositionOperator;
@@ -25,6 +25,7 @@
                 propertiesDidntFit -= P;                            \
                 propertyCount++;                                    \
                 packetData->endLevel(propertyLevel);                \
+                packetData->tagRange(P, propertyLevel);             \
             } else {                                                \
                 packetData->discardLevel(propertyLevel);            \
                 appendState = OctreeElement::PARTIAL;               \
@@ -29,6 +29,12 @@ public:
 
     quint64 getLastDeletedEntitiesSentAt() const { return _lastDeletedEntitiesSentAt; }
     void setLastDeletedEntitiesSentAt(quint64 sentAt) { _lastDeletedEntitiesSentAt = sentAt; }
+
+    // the compression dictionary last sent to this node, so it is only sent again if it changes or seems lost
+    uint32_t getCompressionDictionarySentID() const { return _compressionDictionarySentID; }
+    quint64 getCompressionDictionarySentAt() const { return _compressionDictionarySentAt; }
+    void setCompressionDictionarySent(uint32_t id, quint64 sentAt)
+        { _compressionDictionarySentID = id; _compressionDictionarySentAt = sentAt; }
     
     // these can only be called from the OctreeSendThread for the given Node
     void insertSentFilteredEntity(const QUuid& entityID) { _sentFilteredEntities.insert(entityID); }
@@ -46,6 +52,8 @@ public:
 
 private:
     quint64 _lastDeletedEntitiesSentAt { usecTimestampNow() };
+    uint32_t _compressionDictionarySentID { 0 };
+    quint64 _compressionDictionarySentAt { 0 };
     QSet<QUuid> _sentFilteredEntities;
     QHash<QUuid, QSet<QUuid>> _flaggedExtraEntities;
     QHash<QUuid, QSet<QUuid>> _previousFlaggedExtraEntities;
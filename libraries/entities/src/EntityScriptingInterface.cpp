@@ -469,14 +469,17 @@ void synchronizeEditedGrabProperties(EntityItemProperties& properties, const QSt
 }
 
 
-QUuid EntityScriptingInterface::addEntityInternal(const EntityItemProperties& properties, entity::HostType entityHostType) {
-    PROFILE_RANGE(script_entities, __FUNCTION__);
-
-    _activityTracking.addedEntityCount++;
-
-    auto nodeList = DependencyManager::get<NodeList>();
-    const auto sessionID = nodeList->getSessionUUID();
+entity::HostType EntityScriptingInterface::getEntityHostType(const QString& entityHostTypeString) {
+    if (entityHostTypeString == "local") {
+        return entity::HostType::LOCAL;
+    } else if (entityHostTypeString == "avatar") {
+        return entity::HostType::AVATAR;
+    }
+    return entity::HostType::DOMAIN;
+}
 
+EntityItemProperties EntityScriptingInterface::convertPropertiesForAdd(const EntityItemProperties& properties,
+                                                                       entity::HostType entityHostType, const QUuid& sessionID) {
     EntityItemProperties propertiesWithSimID = properties;
     propertiesWithSimID.setEntityHostType(entityHostType);
     if (entityHostType == entity::HostType::AVATAR) {
@@ -495,6 +498,18 @@ QUuid EntityScriptingInterface::addEntityInternal(const EntityItemProperties& pr
     propertiesWithSimID = convertPropertiesFromScriptSemantics(propertiesWithSimID, scalesWithParent);
     propertiesWithSimID.setDimensionsInitialized(properties.dimensionsChanged());
     synchronizeEditedGrabProperties(propertiesWithSimID, QString());
+    return propertiesWithSimID;
+}
+
+QUuid EntityScriptingInterface::addEntityInternal(const EntityItemProperties& properties, entity::HostType entityHostType) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    _activityTracking.addedEntityCount++;
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    const auto sessionID = nodeList->getSessionUUID();
+
+    EntityItemProperties propertiesWithSimID = convertPropertiesForAdd(properties, entityHostType, sessionID);
 
     EntityItemID id;
     // If we have a local entity tree set, then also update it.
@@ -509,37 +524,87 @@ QUuid EntityScriptingInterface::addEntityInternal(const EntityItemProperties& pr
     }
 }
 
+QVector<QUuid> EntityScriptingInterface::addEntities(const QVector<EntityItemProperties>& properties,
+                                                     const QString& entityHostTypeString) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    int numEntities = properties.size();
+    _activityTracking.addedEntityCount += numEntities;
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    const auto sessionID = nodeList->getSessionUUID();
+    entity::HostType entityHostType = getEntityHostType(entityHostTypeString);
+
+    QVector<EntityItemID> ids;
+    QVector<EntityItemProperties> propertiesWithSimID;
+    ids.reserve(numEntities);
+    propertiesWithSimID.reserve(numEntities);
+    for (const auto& entityProperties : properties) {
+        ids.push_back(EntityItemID(QUuid::createUuid()));
+        propertiesWithSimID.push_back(convertPropertiesForAdd(entityProperties, entityHostType, sessionID));
+    }
+
+    QVector<bool> added(numEntities, true);
+    if (_entityTree) {
+        _entityTree->withWriteLock([&] {
+            for (int i = 0; i < numEntities; ++i) {
+                added[i] = addLocalEntityCopyInternal(propertiesWithSimID[i], ids[i], false);
+            }
+        });
+    }
+
+    QVector<QUuid> results(numEntities);
+    QVector<EntityItemID> addedIDs;
+    QVector<EntityItemProperties> addedProperties;
+    addedIDs.reserve(numEntities);
+    addedProperties.reserve(numEntities);
+    for (int i = 0; i < numEntities; ++i) {
+        if (added[i]) {
+            results[i] = ids[i];
+            addedIDs.push_back(ids[i]);
+            addedProperties.push_back(propertiesWithSimID[i]);
+        }
+    }
+    getEntityPacketSender()->queueEditEntityMessages(PacketType::EntityAdd, _entityTree, addedIDs, addedProperties);
+    return results;
+}
+
 bool EntityScriptingInterface::addLocalEntityCopy(EntityItemProperties& properties, EntityItemID& id, bool isClone) {
     bool success = true;
     id = EntityItemID(QUuid::createUuid());
 
     if (_entityTree) {
         _entityTree->withWriteLock([&] {
-            EntityItemPointer entity = _entityTree->addEntity(id, properties, isClone);
-            if (entity) {
-                if (properties.queryAACubeRelatedPropertyChanged()) {
-                    // due to parenting, the server may not know where something is in world-space, so include the bounding cube.
-                    bool success;
-                    AACube queryAACube = entity->getQueryAACube(success);
-                    if (success) {
-                        properties.setQueryAACube(queryAACube);
-                    }
-                }
-
-                entity->setLastBroadcast(usecTimestampNow());
-                // since we're creating this object we will immediately volunteer to own its simulation
-                entity->upgradeScriptSimulationPriority(VOLUNTEER_SIMULATION_PRIORITY);
-                properties.setLastEdited(entity->getLastEdited());
-            } else {
-                qCDebug(entities) << "script failed to add new Entity to local Octree";
-                success = false;
-            }
+            success = addLocalEntityCopyInternal(properties, id, isClone);
         });
     }
 
     return success;
 }
 
+bool EntityScriptingInterface::addLocalEntityCopyInternal(EntityItemProperties& properties, const EntityItemID& id, bool isClone) {
+    EntityItemPointer entity = _entityTree->addEntity(id, properties, isClone);
+    if (!entity) {
+        qCDebug(entities) << "script failed to add new Entity to local Octree";
+        return false;
+    }
+
+    if (properties.queryAACubeRelatedPropertyChanged()) {
+        // due to parenting, the server may not know where something is in world-space, so include the bounding cube.
+        bool success;
+        AACube queryAACube = entity->getQueryAACube(success);
+        if (success) {
+            properties.setQueryAACube(queryAACube);
+        }
+    }
+
+    entity->setLastBroadcast(usecTimestampNow());
+    // since we're creating this object we will immediately volunteer to own its simulation
+    entity->upgradeScriptSimulationPriority(VOLUNTEER_SIMULATION_PRIORITY);
+    properties.setLastEdited(entity->getLastEdited());
+    return true;
+}
+
 QUuid EntityScriptingInterface::addModelEntity(const QString& name, const QString& modelUrl, const QString& textures,
                                                 const QString& shapeType, bool dynamic, bool collisionless, bool grabbable,
                                                 const glm::vec3& position, const glm::vec3& gravity) {
@@ -773,101 +838,146 @@ QScriptValue EntityScriptingInterface::getMultipleEntityPropertiesInternal(QScri
 QUuid EntityScriptingInterface::editEntity(const QUuid& id, const EntityItemProperties& scriptSideProperties) {
     PROFILE_RANGE(script_entities, __FUNCTION__);
 
-    _activityTracking.editedEntityCount++;
+    return editEntitiesInternal({ id }, { scriptSideProperties }).first();
+}
+
+QVector<QUuid> EntityScriptingInterface::editEntities(const QVector<QUuid>& entityIDs,
+                                                      const QVector<EntityItemProperties>& properties) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    if (properties.size() != 1 && properties.size() != entityIDs.size()) {
+        qCWarning(entities) << "editEntities: expected one set of properties or one per entity, got" << properties.size()
+                            << "for" << entityIDs.size() << "entities";
+        return QVector<QUuid>(entityIDs.size());
+    }
+    return editEntitiesInternal(entityIDs, properties);
+}
+
+QVector<QUuid> EntityScriptingInterface::editEntitiesInternal(const QVector<QUuid>& ids,
+                                                              const QVector<EntityItemProperties>& scriptSideProperties) {
+    int numEdits = ids.size();
+    _activityTracking.editedEntityCount += numEdits;
 
     const auto sessionID = DependencyManager::get<NodeList>()->getSessionUUID();
 
-    EntityItemProperties properties = scriptSideProperties;
+    // a single set of properties applies to all of the entities
+    QVector<EntityItemProperties> properties(numEdits);
+    QVector<EntityItemID> entityIDs(numEdits);
+    for (int i = 0; i < numEdits; ++i) {
+        properties[i] = scriptSideProperties.size() == 1 ? scriptSideProperties[0] : scriptSideProperties[i];
+        entityIDs[i] = EntityItemID(ids[i]);
+    }
 
-    EntityItemID entityID(id);
+    // the edit messages to send, in order
+    QVector<EntityItemID> messageIDs;
+    QVector<EntityItemProperties> messageProperties;
+
+    QVector<QUuid> results = ids;
+    QVector<bool> shouldSend(numEdits, true);
     if (!_entityTree) {
-        properties.setLastEditedBy(sessionID);
-        queueEntityMessage(PacketType::EntityEdit, entityID, properties);
-        return id;
+        for (int i = 0; i < numEdits; ++i) {
+            properties[i].setLastEditedBy(sessionID);
+        }
+        getEntityPacketSender()->queueEditEntityMessages(PacketType::EntityEdit, _entityTree, entityIDs, properties);
+        return results;
     }
 
-    EntityItemPointer entity(nullptr);
-    SimulationOwner simulationOwner;
+    QVector<EntityItemPointer> entities(numEdits);
+    QVector<SimulationOwner> simulationOwners(numEdits);
     _entityTree->withReadLock([&] {
-        // make a copy of entity for local logic outside of tree lock
-        entity = _entityTree->findEntityByEntityItemID(entityID);
-        if (!entity) {
-            return;
-        }
+        for (int i = 0; i < numEdits; ++i) {
+            // make a copy of entity for local logic outside of tree lock
+            EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityIDs[i]);
+            entities[i] = entity;
+            if (!entity) {
+                continue;
+            }
 
-        if (entity->isAvatarEntity() && entity->getOwningAvatarID() != sessionID) {
-            // don't edit other avatar's avatarEntities
-            properties = EntityItemProperties();
-            return;
+            if (entity->isAvatarEntity() && entity->getOwningAvatarID() != sessionID) {
+                // don't edit other avatar's avatarEntities
+                properties[i] = EntityItemProperties();
+                continue;
+            }
+            // make a copy of simulationOwner for local logic outside of tree lock
+            simulationOwners[i] = entity->getSimulationOwner();
         }
-        // make a copy of simulationOwner for local logic outside of tree lock
-        simulationOwner = entity->getSimulationOwner();
     });
 
-    QString previousUserdata;
-    if (entity) {
-        if (properties.hasTransformOrVelocityChanges() && entity->hasGrabs()) {
-            // if an entity is grabbed, the grab will override any position changes
-            properties.clearTransformOrVelocityChanges();
-        }
-        if (properties.hasSimulationRestrictedChanges()) {
-            if (_bidOnSimulationOwnership) {
-                // flag for simulation ownership, or upgrade existing ownership priority
-                // (actual bids for simulation ownership are sent by the PhysicalEntitySimulation)
-                entity->upgradeScriptSimulationPriority(properties.computeSimulationBidPriority());
-                if (simulationOwner.getID() == sessionID) {
-                    // we own the simulation --> copy ALL restricted properties
-                    properties.copySimulationRestrictedProperties(entity);
-                } else {
-                    // we don't own the simulation but think we would like to
+    for (int i = 0; i < numEdits; ++i) {
+        EntityItemPointer& entity = entities[i];
+        EntityItemProperties& entityProperties = properties[i];
+        const SimulationOwner& simulationOwner = simulationOwners[i];
 
-                    uint8_t desiredPriority = entity->getScriptSimulationPriority();
-                    if (desiredPriority < simulationOwner.getPriority()) {
-                        // the priority at which we'd like to own it is not high enough
-                        // --> assume failure and clear all restricted property changes
-                        properties.clearSimulationRestrictedProperties();
+        QString previousUserdata;
+        if (entity) {
+            if (entityProperties.hasTransformOrVelocityChanges() && entity->hasGrabs()) {
+                // if an entity is grabbed, the grab will override any position changes
+                entityProperties.clearTransformOrVelocityChanges();
+            }
+            if (entityProperties.hasSimulationRestrictedChanges()) {
+                if (_bidOnSimulationOwnership) {
+                    // flag for simulation ownership, or upgrade existing ownership priority
+                    // (actual bids for simulation ownership are sent by the PhysicalEntitySimulation)
+                    entity->upgradeScriptSimulationPriority(entityProperties.computeSimulationBidPriority());
+                    if (simulationOwner.getID() == sessionID) {
+                        // we own the simulation --> copy ALL restricted properties
+                        entityProperties.copySimulationRestrictedProperties(entity);
                     } else {
-                        // the priority at which we'd like to own it is high enough to win.
-                        // --> assume success and copy ALL restricted properties
-                        properties.copySimulationRestrictedProperties(entity);
+                        // we don't own the simulation but think we would like to
+
+                        uint8_t desiredPriority = entity->getScriptSimulationPriority();
+                        if (desiredPriority < simulationOwner.getPriority()) {
+                            // the priority at which we'd like to own it is not high enough
+                            // --> assume failure and clear all restricted property changes
+                            entityProperties.clearSimulationRestrictedProperties();
+                        } else {
+                            // the priority at which we'd like to own it is high enough to win.
+                            // --> assume success and copy ALL restricted properties
+                            entityProperties.copySimulationRestrictedProperties(entity);
+                        }
                     }
+                } else if (!simulationOwner.getID().isNull()) {
+                    // someone owns this but not us
+                    // clear restricted properties
+                    entityProperties.clearSimulationRestrictedProperties();
                 }
-            } else if (!simulationOwner.getID().isNull()) {
-                // someone owns this but not us
-                // clear restricted properties
-                properties.clearSimulationRestrictedProperties();
+                // clear the cached simulationPriority level
+                entity->upgradeScriptSimulationPriority(0);
             }
-            // clear the cached simulationPriority level
-            entity->upgradeScriptSimulationPriority(0);
-        }
 
-        // set these to make EntityItemProperties::getScalesWithParent() work correctly
-        entity::HostType entityHostType = entity->getEntityHostType();
-        properties.setEntityHostType(entityHostType);
-        if (entityHostType == entity::HostType::LOCAL) {
-            properties.setCollisionless(true);
-        }
-        properties.setOwningAvatarID(entity->getOwningAvatarID());
+            // set these to make EntityItemProperties::getScalesWithParent() work correctly
+            entity::HostType entityHostType = entity->getEntityHostType();
+            entityProperties.setEntityHostType(entityHostType);
+            if (entityHostType == entity::HostType::LOCAL) {
+                entityProperties.setCollisionless(true);
+            }
+            entityProperties.setOwningAvatarID(entity->getOwningAvatarID());
 
-        // make sure the properties has a type, so that the encode can know which properties to include
-        properties.setType(entity->getType());
+            // make sure the properties has a type, so that the encode can know which properties to include
+            entityProperties.setType(entity->getType());
 
-        previousUserdata = entity->getUserData();
-    } else if (_bidOnSimulationOwnership) {
-        // bail when simulation participants don't know about entity
-        return QUuid();
-    }
-    // TODO: it is possible there is no remaining useful changes in properties and we should bail early.
-    // How to check for this cheaply?
+            previousUserdata = entity->getUserData();
+        } else if (_bidOnSimulationOwnership) {
+            // bail when simulation participants don't know about entity
+            results[i] = QUuid();
+            shouldSend[i] = false;
+            continue;
+        }
+        // TODO: it is possible there is no remaining useful changes in properties and we should bail early.
+        // How to check for this cheaply?
 
-    properties = convertPropertiesFromScriptSemantics(properties, properties.getScalesWithParent());
-    synchronizeEditedGrabProperties(properties, previousUserdata);
-    properties.setLastEditedBy(sessionID);
+        entityProperties = convertPropertiesFromScriptSemantics(entityProperties, entityProperties.getScalesWithParent());
+        synchronizeEditedGrabProperties(entityProperties, previousUserdata);
+        entityProperties.setLastEditedBy(sessionID);
+    }
 
     // done reading and modifying properties --> start write
-    bool updatedEntity = false;
     _entityTree->withWriteLock([&] {
-        updatedEntity = _entityTree->updateEntity(entityID, properties);
+        for (int i = 0; i < numEdits; ++i) {
+            if (shouldSend[i]) {
+                _entityTree->updateEntity(entityIDs[i], properties[i]);
+            }
+        }
     });
 
     // FIXME: We need to figure out a better way to handle this. Allowing these edits to go through potentially
@@ -879,80 +989,100 @@ QUuid EntityScriptingInterface::editEntity(const QUuid& id, const EntityItemProp
     //     return QUuid();
     // }
 
-    bool hasQueryAACubeRelatedChanges = properties.queryAACubeRelatedPropertyChanged();
     // done writing, send update
     _entityTree->withReadLock([&] {
-        // find the entity again: maybe it was removed since we last found it
-        entity = _entityTree->findEntityByEntityItemID(entityID);
-        if (entity) {
-            uint64_t now = usecTimestampNow();
-            entity->setLastBroadcast(now);
-
-            if (hasQueryAACubeRelatedChanges) {
-                properties.setQueryAACube(entity->getQueryAACube());
-
-                // if we've moved an entity with children, check/update the queryAACube of all descendents and tell the server
-                // if they've changed.
-                entity->forEachDescendant([&](SpatiallyNestablePointer descendant) {
-                    if (descendant->getNestableType() == NestableType::Entity) {
-                        if (descendant->updateQueryAACube()) {
-                            EntityItemPointer entityDescendant = std::static_pointer_cast<EntityItem>(descendant);
-                            EntityItemProperties newQueryCubeProperties;
-                            newQueryCubeProperties.setQueryAACube(descendant->getQueryAACube());
-                            newQueryCubeProperties.setLastEdited(properties.getLastEdited());
-                            queueEntityMessage(PacketType::EntityEdit, descendant->getID(), newQueryCubeProperties);
-                            entityDescendant->setLastBroadcast(now);
+        uint64_t now = usecTimestampNow();
+        for (int i = 0; i < numEdits; ++i) {
+            if (!shouldSend[i]) {
+                continue;
+            }
+            const EntityItemProperties& entityProperties = properties[i];
+
+            // find the entity again: maybe it was removed since we last found it
+            EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityIDs[i]);
+            entities[i] = entity;
+            if (entity) {
+                entity->setLastBroadcast(now);
+
+                if (entityProperties.queryAACubeRelatedPropertyChanged()) {
+                    properties[i].setQueryAACube(entity->getQueryAACube());
+
+                    // if we've moved an entity with children, check/update the queryAACube of all descendents and tell the server
+                    // if they've changed.
+                    entity->forEachDescendant([&](SpatiallyNestablePointer descendant) {
+                        if (descendant->getNestableType() == NestableType::Entity) {
+                            if (descendant->updateQueryAACube()) {
+                                EntityItemPointer entityDescendant = std::static_pointer_cast<EntityItem>(descendant);
+                                EntityItemProperties newQueryCubeProperties;
+                                newQueryCubeProperties.setQueryAACube(descendant->getQueryAACube());
+                                newQueryCubeProperties.setLastEdited(entityProperties.getLastEdited());
+                                messageIDs.push_back(descendant->getID());
+                                messageProperties.push_back(newQueryCubeProperties);
+                                entityDescendant->setLastBroadcast(now);
+                            }
                         }
-                    }
-                });
+                    });
+                }
             }
         }
     });
-    if (!entity) {
-        if (hasQueryAACubeRelatedChanges) {
-            // Sometimes ESS don't have the entity they are trying to edit in their local tree.  In this case,
-            // convertPropertiesFromScriptSemantics doesn't get called and local* edits will get dropped.
-            // This is because, on the script side, "position" is in world frame, but in the network
-            // protocol and in the internal data-structures, "position" is "relative to parent".
-            // Compensate here.  The local* versions will get ignored during the edit-packet encoding.
-            if (properties.localPositionChanged()) {
-                properties.setPosition(properties.getLocalPosition());
-            }
-            if (properties.localRotationChanged()) {
-                properties.setRotation(properties.getLocalRotation());
-            }
-            if (properties.localVelocityChanged()) {
-                properties.setVelocity(properties.getLocalVelocity());
-            }
-            if (properties.localAngularVelocityChanged()) {
-                properties.setAngularVelocity(properties.getLocalAngularVelocity());
-            }
-            if (properties.localDimensionsChanged()) {
-                properties.setDimensions(properties.getLocalDimensions());
-            }
+
+    for (int i = 0; i < numEdits; ++i) {
+        if (!shouldSend[i]) {
+            continue;
         }
-        // we've made an edit to an entity we don't know about, or to a non-entity.  If it's a known non-entity,
-        // print a warning and don't send an edit packet to the entity-server.
-        QSharedPointer<SpatialParentFinder> parentFinder = DependencyManager::get<SpatialParentFinder>();
-        if (parentFinder) {
-            bool success;
-            auto nestableWP = parentFinder->find(id, success, static_cast<SpatialParentTree*>(_entityTree.get()));
-            if (success) {
-                auto nestable = nestableWP.lock();
-                if (nestable) {
-                    NestableType nestableType = nestable->getNestableType();
-                    if (nestableType == NestableType::Avatar) {
-                        qCWarning(entities) << "attempted edit on non-entity: " << id << nestable->getName();
-                        return QUuid(); // null script value to indicate failure
+        EntityItemProperties& entityProperties = properties[i];
+        if (!entities[i]) {
+            if (entityProperties.queryAACubeRelatedPropertyChanged()) {
+                // Sometimes ESS don't have the entity they are trying to edit in their local tree.  In this case,
+                // convertPropertiesFromScriptSemantics doesn't get called and local* edits will get dropped.
+                // This is because, on the script side, "position" is in world frame, but in the network
+                // protocol and in the internal data-structures, "position" is "relative to parent".
+                // Compensate here.  The local* versions will get ignored during the edit-packet encoding.
+                if (entityProperties.localPositionChanged()) {
+                    entityProperties.setPosition(entityProperties.getLocalPosition());
+                }
+                if (entityProperties.localRotationChanged()) {
+                    entityProperties.setRotation(entityProperties.getLocalRotation());
+                }
+                if (entityProperties.localVelocityChanged()) {
+                    entityProperties.setVelocity(entityProperties.getLocalVelocity());
+                }
+                if (entityProperties.localAngularVelocityChanged()) {
+                    entityProperties.setAngularVelocity(entityProperties.getLocalAngularVelocity());
+                }
+                if (entityProperties.localDimensionsChanged()) {
+                    entityProperties.setDimensions(entityProperties.getLocalDimensions());
+                }
+            }
+            // we've made an edit to an entity we don't know about, or to a non-entity.  If it's a known non-entity,
+            // print a warning and don't send an edit packet to the entity-server.
+            QSharedPointer<SpatialParentFinder> parentFinder = DependencyManager::get<SpatialParentFinder>();
+            if (parentFinder) {
+                bool success;
+                auto nestableWP = parentFinder->find(ids[i], success, static_cast<SpatialParentTree*>(_entityTree.get()));
+                if (success) {
+                    auto nestable = nestableWP.lock();
+                    if (nestable) {
+                        NestableType nestableType = nestable->getNestableType();
+                        if (nestableType == NestableType::Avatar) {
+                            qCWarning(entities) << "attempted edit on non-entity: " << ids[i] << nestable->getName();
+                            results[i] = QUuid(); // null script value to indicate failure
+                            shouldSend[i] = false;
+                            continue;
+                        }
                     }
                 }
             }
         }
+        // we queue edit packets even if we don't know about the entity.  This is to allow AC agents
+        // to edit entities they know only by ID.
+        messageIDs.push_back(entityIDs[i]);
+        messageProperties.push_back(entityProperties);
     }
-    // we queue edit packets even if we don't know about the entity.  This is to allow AC agents
-    // to edit entities they know only by ID.
-    queueEntityMessage(PacketType::EntityEdit, entityID, properties);
-    return id;
+
+    getEntityPacketSender()->queueEditEntityMessages(PacketType::EntityEdit, _entityTree, messageIDs, messageProperties);
+    return results;
 }
 
 void EntityScriptingInterface::deleteEntity(const QUuid& id) {
@@ -270,15 +270,7 @@ public slots:
      * print("Entity created: " + entityID);
      */
     Q_INVOKABLE QUuid addEntity(const EntityItemProperties& properties, const QString& entityHostTypeString) {
-        entity::HostType entityHostType;
-        if (entityHostTypeString == "local") {
-            entityHostType = entity::HostType::LOCAL;
-        } else if (entityHostTypeString == "avatar") {
-            entityHostType = entity::HostType::AVATAR;
-        } else {
-            entityHostType = entity::HostType::DOMAIN;
-        }
-        return addEntityInternal(properties, entityHostType);
+        return addEntityInternal(properties, getEntityHostType(entityHostTypeString));
     }
 
     /**jsdoc
@@ -293,6 +285,30 @@ public slots:
         return addEntityInternal(properties, entityHostType);
     }
 
+    /**jsdoc
+     * Add several new entities at once. This is much faster than calling {@link Entities.addEntity|addEntity} for each of 
+     * them: the entity tree is locked once for all of them and their add messages share packets.
+     * @function Entities.addEntities
+     * @param {Entities.EntityProperties[]} properties - The properties of each entity to create.
+     * @param {EntityHostType} [entityHostType="domain"] - How all of the entities are sent over the wire, see 
+     *     {@link Entities.addEntity|addEntity}.
+     * @returns {Uuid[]} The IDs of the entities, in the order of their properties. The ID of an entity that couldn't be 
+     *     created is {@link Uuid|Uuid.NULL}.
+     * @example <caption>Create a row of boxes in front of your avatar.</caption>
+     * var properties = [];
+     * for (var i = 0; i < 10; i++) {
+     *     properties.push({
+     *         type: "Box",
+     *         position: Vec3.sum(MyAvatar.position, Vec3.multiplyQbyV(MyAvatar.orientation, { x: i - 5, y: 0, z: -5 })),
+     *         dimensions: { x: 0.5, y: 0.5, z: 0.5 }
+     *     });
+     * }
+     * var entityIDs = Entities.addEntities(properties);
+     * print("Entities created: " + JSON.stringify(entityIDs));
+     */
+    Q_INVOKABLE QVector<QUuid> addEntities(const QVector<EntityItemProperties>& properties,
+                                           const QString& entityHostTypeString = "domain");
+
     /// temporary method until addEntity can be used from QJSEngine
     /// Deliberately not adding jsdoc, only used internally.
     Q_INVOKABLE QUuid addModelEntity(const QString& name, const QString& modelUrl, const QString& textures, const QString& shapeType, bool dynamic,
@@ -352,6 +368,20 @@ public slots:
      */
     Q_INVOKABLE QUuid editEntity(const QUuid& entityID, const EntityItemProperties& properties);
 
+    /**jsdoc
+     * Update several entities at once. This is much faster than calling {@link Entities.editEntity|editEntity} for each of 
+     * them: the entity tree is locked once for all of them and their edit messages share packets.
+     * @function Entities.editEntities
+     * @param {Uuid[]} entityIDs - The IDs of the entities to edit.
+     * @param {Entities.EntityProperties[]} properties - The properties to update each entity with, in the order of their 
+     *     IDs, or a single set of properties to update all of the entities with.
+     * @returns {Uuid[]} For each entity, its ID if the edit was successful, otherwise {@link Uuid|Uuid.NULL}.
+     * @example <caption>Turn the nearby entities red.</caption>
+     * var entityIDs = Entities.findEntities(MyAvatar.position, 10);
+     * Entities.editEntities(entityIDs, [{ color: { red: 255, green: 0, blue: 0 } }]);
+     */
+    Q_INVOKABLE QVector<QUuid> editEntities(const QVector<QUuid>& entityIDs, const QVector<EntityItemProperties>& properties);
+
     /**jsdoc
      * Delete an entity.
      * @function Entities.deleteEntity
@@ -2112,6 +2142,12 @@ private:
     bool setPoints(QUuid entityID, std::function<bool(LineEntityItem&)> actor);
     void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties);
     bool addLocalEntityCopy(EntityItemProperties& propertiesWithSimID, EntityItemID& id, bool isClone = false);
+    // the caller must hold the tree's write lock
+    bool addLocalEntityCopyInternal(EntityItemProperties& propertiesWithSimID, const EntityItemID& id, bool isClone);
+    EntityItemProperties convertPropertiesForAdd(const EntityItemProperties& properties, entity::HostType entityHostType,
+                                                 const QUuid& sessionID);
+    QVector<QUuid> editEntitiesInternal(const QVector<QUuid>& entityIDs, const QVector<EntityItemProperties>& properties);
+    static entity::HostType getEntityHostType(const QString& entityHostTypeString);
 
     EntityItemPointer checkForTreeEntityAndTypeMatch(const QUuid& entityID,
                                                      EntityTypes::EntityType entityType = EntityTypes::Unknown);
@@ -2414,6 +2414,11 @@ void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
     _entityMap.insert(id, entity);
 }
 
+QList<EntityItemPointer> EntityTree::getAllEntities() const {
+    QReadLocker locker(&_entityMapLock);
+    return _entityMap.values();
+}
+
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
     QWriteLocker locker(&_entityMapLock);
     _entityMap.remove(id);
@@ -40,6 +40,8 @@ bool PolyVoxEntityItem::isEdged(PolyVoxSurfaceStyle surfaceStyle) {
 const glm::vec3 PolyVoxEntityItem::DEFAULT_VOXEL_VOLUME_SIZE = glm::vec3(32, 32, 32);
 const float PolyVoxEntityItem::MAX_VOXEL_DIMENSION = 128.0f;
 const QByteArray PolyVoxEntityItem::DEFAULT_VOXEL_DATA(PolyVoxEntityItem::makeEmptyVoxelData());
+// HACK -- until we have a way to allow for properties larger than MTU, voxelData has to fit in an edit packet
+const int PolyVoxEntityItem::MAX_VOXEL_DATA_SIZE = 1150;
 const PolyVoxEntityItem::PolyVoxSurfaceStyle PolyVoxEntityItem::DEFAULT_VOXEL_SURFACE_STYLE =
     PolyVoxEntityItem::SURFACE_EDGED_CUBIC;
 const QString PolyVoxEntityItem::DEFAULT_X_TEXTURE_URL = QString("");
@@ -66,6 +68,86 @@ QByteArray PolyVoxEntityItem::makeEmptyVoxelData(quint16 voxelXSize, quint16 vox
     return newVoxelData;
 }
 
+QByteArray PolyVoxEntityItem::makeVoxelDataDelta(const ivec3& low, const ivec3& size, const QByteArray& uncompressedData) {
+    QByteArray delta;
+    QDataStream writer(&delta, QIODevice::WriteOnly | QIODevice::Truncate);
+    writer << (quint16)0; // no volume has a zero x size, so this marks the data as a delta
+    writer << (quint16)low.x << (quint16)low.y << (quint16)low.z;
+    writer << (quint16)size.x << (quint16)size.y << (quint16)size.z;
+    writer << qCompress(uncompressedData, 9);
+    return delta;
+}
+
+bool PolyVoxEntityItem::isVoxelDataDelta(const QByteArray& voxelData) {
+    return voxelData.size() >= (int)sizeof(quint16) && voxelData[0] == 0 && voxelData[1] == 0;
+}
+
+// qCompress() prefixes its output with the uncompressed size as a big-endian quint32, and qUncompress() allocates that
+// much up front. Check it against the size the volume calls for before trusting the data.
+static bool uncompressVoxels(const QByteArray& compressedData, size_t expectedSize, QByteArray& uncompressedData) {
+    const int SIZE_HEADER_BYTES = 4;
+    if (compressedData.size() <= SIZE_HEADER_BYTES) {
+        return false;
+    }
+    auto header = reinterpret_cast<const uchar*>(compressedData.constData());
+    size_t claimedSize = ((size_t)header[0] << 24) | ((size_t)header[1] << 16) | ((size_t)header[2] << 8) | (size_t)header[3];
+    if (claimedSize != expectedSize) {
+        return false;
+    }
+    uncompressedData = qUncompress(compressedData);
+    return (size_t)uncompressedData.size() == expectedSize;
+}
+
+bool PolyVoxEntityItem::applyVoxelDataDelta(const QByteArray& voxelData, const QByteArray& delta, QByteArray& result) {
+    // both arrays hold their voxels with x varying fastest, then y, then z
+    QDataStream reader(voxelData);
+    quint16 voxelXSize { 0 }, voxelYSize { 0 }, voxelZSize { 0 };
+    QByteArray compressedData;
+    reader >> voxelXSize >> voxelYSize >> voxelZSize >> compressedData;
+    const quint16 MAX_DIMENSION = (quint16)MAX_VOXEL_DIMENSION;
+    if (reader.status() != QDataStream::Ok || voxelXSize == 0 || voxelYSize == 0 || voxelZSize == 0 ||
+        voxelXSize > MAX_DIMENSION || voxelYSize > MAX_DIMENSION || voxelZSize > MAX_DIMENSION) {
+        return false;
+    }
+    size_t rawSize = (size_t)voxelXSize * voxelYSize * voxelZSize;
+    QByteArray uncompressedData;
+    if (!uncompressVoxels(compressedData, rawSize, uncompressedData)) {
+        return false;
+    }
+
+    QDataStream deltaReader(delta);
+    quint16 marker { 1 };
+    quint16 lowX { 0 }, lowY { 0 }, lowZ { 0 };
+    quint16 sizeX { 0 }, sizeY { 0 }, sizeZ { 0 };
+    QByteArray compressedRegion;
+    deltaReader >> marker >> lowX >> lowY >> lowZ >> sizeX >> sizeY >> sizeZ >> compressedRegion;
+    if (deltaReader.status() != QDataStream::Ok || marker != 0 ||
+        lowX + sizeX > voxelXSize || lowY + sizeY > voxelYSize || lowZ + sizeZ > voxelZSize) {
+        return false;
+    }
+    // the region is inside the volume, so its dimensions are clamped too
+    QByteArray region;
+    if (!uncompressVoxels(compressedRegion, (size_t)sizeX * sizeY * sizeZ, region)) {
+        return false;
+    }
+
+    const char* source = region.constData();
+    char* destination = uncompressedData.data();
+    for (int z = 0; z < sizeZ; z++) {
+        for (int y = 0; y < sizeY; y++) {
+            int index = ((lowZ + z) * voxelYSize + lowY + y) * voxelXSize + lowX;
+            memcpy(destination + index, source, sizeX);
+            source += sizeX;
+        }
+    }
+
+    result.clear();
+    QDataStream writer(&result, QIODevice::WriteOnly | QIODevice::Truncate);
+    writer << voxelXSize << voxelYSize << voxelZSize;
+    writer << qCompress(uncompressedData, 9);
+    return result.size() <= MAX_VOXEL_DATA_SIZE;
+}
+
 PolyVoxEntityItem::PolyVoxEntityItem(const EntityItemID& entityItemID) : EntityItem(entityItemID) {
     _type = EntityTypes::PolyVox;
 }
@@ -233,7 +315,16 @@ void PolyVoxEntityItem::debugDump() const {
 
 void PolyVoxEntityItem::setVoxelData(const QByteArray& voxelData) {
     withWriteLock([&] {
-        _voxelData = voxelData;
+        if (isVoxelDataDelta(voxelData)) {
+            QByteArray newVoxelData;
+            if (!applyVoxelDataDelta(_voxelData, voxelData, newVoxelData)) {
+                qCDebug(entities) << "Ignoring voxel-data delta that doesn't fit the volume of" << getID();
+                return;
+            }
+            _voxelData = newVoxelData;
+        } else {
+            _voxelData = voxelData;
+        }
         _voxelDataDirty = true;
     });
 }
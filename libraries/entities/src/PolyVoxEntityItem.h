@@ -99,6 +99,7 @@ class PolyVoxEntityItem : public EntityItem {
     static const float MAX_VOXEL_DIMENSION;
 
     static const QByteArray DEFAULT_VOXEL_DATA;
+    static const int MAX_VOXEL_DATA_SIZE;
     static const PolyVoxSurfaceStyle DEFAULT_VOXEL_SURFACE_STYLE;
 
     glm::vec3 voxelCoordsToWorldCoords(const glm::vec3& voxelCoords) const;
@@ -124,6 +125,13 @@ class PolyVoxEntityItem : public EntityItem {
 
     static QByteArray makeEmptyVoxelData(quint16 voxelXSize = 16, quint16 voxelYSize = 16, quint16 voxelZSize = 16);
 
+    // voxelData normally holds the whole volume: its x, y and z sizes followed by the compressed voxels.  An edit to a
+    // box of voxels can instead be sent as a delta, which starts with a zero x size and is followed by the low corner
+    // and size of the box and its compressed voxels.  The entity-server merges deltas into the volume it stores.
+    static QByteArray makeVoxelDataDelta(const ivec3& low, const ivec3& size, const QByteArray& uncompressedData);
+    static bool isVoxelDataDelta(const QByteArray& voxelData);
+    static bool applyVoxelDataDelta(const QByteArray& voxelData, const QByteArray& delta, QByteArray& result);
+
     static const QString DEFAULT_X_TEXTURE_URL;
     void setXTextureURL(const QString& xTextureURL);
     QString getXTextureURL() const;
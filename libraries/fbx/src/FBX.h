@@ -12,7 +12,11 @@
 #ifndef hifi_FBX_h_
 #define hifi_FBX_h_
 
+#include <algorithm>
+#include <memory>
+
 #include <QMetaType>
+#include <QSysInfo>
 #include <QVariant>
 #include <QVector>
 
@@ -33,6 +37,89 @@ static const int32_t FBX_PROPERTY_COMPRESSED_FLAG = 1;
 // The version of the FBX node containing the draco mesh. See also: DRACO_MESH_VERSION in HFM.h
 static const int FBX_DRACO_MESH_VERSION = 2;
 
+class QFile;
+
+/// The bytes of a binary FBX document, either shared with a byte array or mapped from a file. Array properties of
+/// the nodes parsed from it point into these bytes, so it is kept alive for as long as any of those nodes.
+class FBXSource {
+public:
+    using Pointer = std::shared_ptr<const FBXSource>;
+
+    static Pointer fromData(const hifi::ByteArray& data);
+    /// maps the file read-only instead of reading it, answers null if it can't be opened or mapped
+    static Pointer fromFile(const QString& path);
+
+    ~FBXSource();
+
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+    /// the document's bytes without a copy, only valid for as long as this source is
+    hifi::ByteArray bytes() const { return hifi::ByteArray::fromRawData(_data, (int)_size); }
+
+private:
+    FBXSource() {}
+
+    hifi::ByteArray _bytes;
+    std::unique_ptr<QFile> _file;
+    const char* _data { nullptr };
+    size_t _size { 0 };
+};
+
+/// Inflates (or copies, if not compressed) the data of a binary array into output, which must have exactly outputSize
+/// bytes. \exception QString if the data is corrupt
+void decodeFBXArrayData(const char* data, quint32 dataLength, quint32 encoding, char* output, size_t outputSize);
+
+/// An array property of a binary FBX node, decoded when it is read rather than when the document is parsed. Parsing
+/// only records where the array is, so geometry is inflated once, straight into the vector that is handed out, and
+/// arrays nobody reads are never inflated at all. Converts to the matching QVector<T> through QVariant.
+template <typename T>
+class FBXBinaryArray {
+public:
+    FBXBinaryArray() {}
+    FBXBinaryArray(const FBXSource::Pointer& source, const char* data, quint32 length, quint32 encoding,
+                   quint32 dataLength) :
+        _source(source), _data(data), _length(length), _encoding(encoding), _dataLength(dataLength) {}
+
+    int size() const { return (int)_length; }
+    quint32 getEncoding() const { return _encoding; }
+
+    /// the array as stored in the document, without a copy
+    hifi::ByteArray getEncodedData() const { return hifi::ByteArray::fromRawData(_data, (int)_dataLength); }
+
+    /// \exception QString if the array is corrupt
+    QVector<T> decode() const {
+        QVector<T> values;
+        values.resize(_length);
+        if (_length > 0) {
+            decodeFBXArrayData(_data, _dataLength, _encoding, (char*)values.data(), _length * sizeof(T));
+            if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) {
+                for (T& value : values) {
+                    char* bytes = (char*)&value;
+                    std::reverse(bytes, bytes + sizeof(T));
+                }
+            }
+        }
+        return values;
+    }
+
+    /// for conversions through QVariant, which can't report errors, answers an empty vector if the array is corrupt
+    QVector<T> toVector() const;
+
+private:
+    FBXSource::Pointer _source;
+    const char* _data { nullptr };
+    quint32 _length { 0 };
+    quint32 _encoding { FBX_PROPERTY_UNCOMPRESSED_FLAG };
+    quint32 _dataLength { 0 };
+};
+
+Q_DECLARE_METATYPE(FBXBinaryArray<float>)
+Q_DECLARE_METATYPE(FBXBinaryArray<double>)
+Q_DECLARE_METATYPE(FBXBinaryArray<qint64>)
+Q_DECLARE_METATYPE(FBXBinaryArray<qint32>)
+Q_DECLARE_METATYPE(FBXBinaryArray<bool>)
+
 class FBXNode;
 using FBXNodeList = QList<FBXNode>;
 
@@ -11,13 +11,13 @@
 
 #include "FBXSerializer.h"
 
-#include <QBuffer>
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/transform.hpp>
 
 #include <FaceshiftConstants.h>
+#include <TBBHelpers.h>
 
 #include <hfm/ModelFormatLogging.h>
 
@@ -451,6 +451,14 @@ HFMModel* FBXSerializer::extractHFMModel(const hifi::VariantHash& mapping, const
     glm::vec3 ambientColor;
     QString hifiGlobalNodeID;
     unsigned int meshIndex = 0;
+    // mesh geometry nodes are extracted in parallel once all of the objects have been seen, each mesh only depends
+    // on its own node and its index is assigned in document order so that the result doesn't change
+    struct PendingMesh {
+        const FBXNode* object;
+        QString id;
+        unsigned int meshIndex;
+    };
+    std::vector<PendingMesh> pendingMeshes;
     haveReportedUnhandledRotationOrder = false;
     int fbxVersionNumber = -1;
     foreach (const FBXNode& child, node.children) {
@@ -513,7 +521,7 @@ HFMModel* FBXSerializer::extractHFMModel(const hifi::VariantHash& mapping, const
             foreach (const FBXNode& object, child.children) {
                 if (object.name == "Geometry") {
                     if (object.properties.at(2) == "Mesh") {
-                        meshes.insert(getID(object.properties), extractMesh(object, meshIndex, deduplicateIndices));
+                        pendingMeshes.push_back({ &object, getID(object.properties), meshIndex++ });
                     } else { // object.properties.at(2) == "Shape"
                         ExtractedBlendshape extracted = { getID(object.properties), extractBlendshape(object) };
                         blendshapes.append(extracted);
@@ -1100,6 +1108,16 @@ HFMModel* FBXSerializer::extractHFMModel(const hifi::VariantHash& mapping, const
                 }
 #endif
             }
+
+            std::vector<ExtractedMesh> extractedMeshes(pendingMeshes.size());
+            tbb::parallel_for(size_t(0), pendingMeshes.size(), [&](size_t i) {
+                unsigned int pendingMeshIndex = pendingMeshes[i].meshIndex;
+                extractedMeshes[i] = extractMesh(*pendingMeshes[i].object, pendingMeshIndex, deduplicateIndices);
+            });
+            for (size_t i = 0; i < pendingMeshes.size(); i++) {
+                meshes.insert(pendingMeshes[i].id, extractedMeshes[i]);
+            }
+            pendingMeshes.clear();
         } else if (child.name == "Connections") {
             static const QVariant OO = hifi::ByteArray("OO");
             static const QVariant OP = hifi::ByteArray("OP");
@@ -1668,10 +1686,11 @@ std::unique_ptr<hfm::Serializer::Factory> FBXSerializer::getFactory() const {
 }
 
 HFMModel::Pointer FBXSerializer::read(const hifi::ByteArray& data, const hifi::VariantHash& mapping, const hifi::URL& url) {
-    QBuffer buffer(const_cast<hifi::ByteArray*>(&data));
-    buffer.open(QIODevice::ReadOnly);
+    return read(FBXSource::fromData(data), mapping, url);
+}
 
-    _rootNode = parseFBX(&buffer);
+HFMModel::Pointer FBXSerializer::read(const FBXSource::Pointer& source, const hifi::VariantHash& mapping, const hifi::URL& url) {
+    _rootNode = parseFBX(source);
 
     // FBXSerializer's mapping parameter supports the bool "deduplicateIndices," which is passed into FBXSerializer::extractMesh as "deduplicate"
 
@@ -113,9 +113,13 @@ public:
     /// Reads HFMModel from the supplied model and mapping data.
     /// \exception QString if an error occurs in parsing
     HFMModel::Pointer read(const hifi::ByteArray& data, const hifi::VariantHash& mapping, const hifi::URL& url = hifi::URL()) override;
+    /// Reads HFMModel from a source that may be a mapped file, the parsed nodes keep it alive.
+    /// \exception QString if an error occurs in parsing
+    HFMModel::Pointer read(const FBXSource::Pointer& source, const hifi::VariantHash& mapping, const hifi::URL& url = hifi::URL());
 
     FBXNode _rootNode;
     static FBXNode parseFBX(QIODevice* device);
+    static FBXNode parseFBX(const FBXSource::Pointer& source);
 
     HFMModel* extractHFMModel(const hifi::VariantHash& mapping, const QString& url);
 
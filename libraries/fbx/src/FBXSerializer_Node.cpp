@@ -12,198 +12,211 @@
 #include "FBXSerializer.h"
 
 #include <iostream>
+#include <mutex>
+
 #include <QtCore/QBuffer>
-#include <QtCore/QDataStream>
 #include <QtCore/QIODevice>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
 #include <QtCore/QDebug>
-#include <QtCore/QtEndian>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 
+#include <zlib.h>
+
 #include <shared/NsightHelpers.h>
 #include <hfm/ModelFormatLogging.h>
 
-template<class T>
-int streamSize() {
-    return sizeof(T);
+FBXSource::Pointer FBXSource::fromData(const hifi::ByteArray& data) {
+    auto source = std::shared_ptr<FBXSource>(new FBXSource());
+    source->_bytes = data;
+    source->_data = source->_bytes.constData();
+    source->_size = source->_bytes.size();
+    return source;
 }
 
-template<bool>
-int streamSize() {
-    return 1;
+FBXSource::Pointer FBXSource::fromFile(const QString& path) {
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly) || file->size() == 0) {
+        return nullptr;
+    }
+    auto data = file->map(0, file->size());
+    if (!data) {
+        return nullptr;
+    }
+
+    auto source = std::shared_ptr<FBXSource>(new FBXSource());
+    source->_data = (const char*)data;
+    source->_size = file->size();
+    source->_file = std::move(file);
+    return source;
 }
 
-template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
-
-    in >> arrayLength;
-    if (arrayLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
-        throw QString("FBX file most likely corrupt: binary data exceeds data limits");
-    }
-    in >> encoding;
-    in >> compressedLength;
-    if (compressedLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
-        throw QString("FBX file most likely corrupt: compressed binary data exceeds data limits");
-    }
-    position += sizeof(quint32) * 3;
-
-    QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        hifi::ByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            hifi::ByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
-        }
+FBXSource::~FBXSource() {
+    // closing the file unmaps it
+}
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
+void decodeFBXArrayData(const char* data, quint32 dataLength, quint32 encoding, char* output, size_t outputSize) {
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        // inflate straight into the output, anything but exactly outputSize bytes means the array is corrupt
+        uLongf inflatedSize = (uLongf)outputSize;
+        int status = uncompress((Bytef*)output, &inflatedSize, (const Bytef*)data, dataLength);
+        if (status != Z_OK || inflatedSize != outputSize) {
+            throw QString("corrupt fbx file");
         }
     } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            hifi::ByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            hifi::ByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
+        if (dataLength != outputSize) {
+            throw QString("corrupt fbx file");
         }
+        memcpy(output, data, outputSize);
     }
-    return QVariant::fromValue(values);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
-    switch (ch) {
-        case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
-        }
-        case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
-        }
-        case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
-        }
-        case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
-        }
-        case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
-        }
-        case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
-        }
-        case 'f': {
-            return readBinaryArray<float>(in, position);
-        }
-        case 'd': {
-            return readBinaryArray<double>(in, position);
+template <typename T>
+QVector<T> FBXBinaryArray<T>::toVector() const {
+    try {
+        return decode();
+    } catch (const QString& error) {
+        qCWarning(modelformat) << "Could not decode FBX array:" << error;
+        return QVector<T>();
+    }
+}
+
+template class FBXBinaryArray<float>;
+template class FBXBinaryArray<double>;
+template class FBXBinaryArray<qint64>;
+template class FBXBinaryArray<qint32>;
+template class FBXBinaryArray<bool>;
+
+static void registerBinaryArrayConverters() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        QMetaType::registerConverter<FBXBinaryArray<float>, QVector<float>>(&FBXBinaryArray<float>::toVector);
+        QMetaType::registerConverter<FBXBinaryArray<double>, QVector<double>>(&FBXBinaryArray<double>::toVector);
+        QMetaType::registerConverter<FBXBinaryArray<qint64>, QVector<qint64>>(&FBXBinaryArray<qint64>::toVector);
+        QMetaType::registerConverter<FBXBinaryArray<qint32>, QVector<qint32>>(&FBXBinaryArray<qint32>::toVector);
+        QMetaType::registerConverter<FBXBinaryArray<bool>, QVector<bool>>(&FBXBinaryArray<bool>::toVector);
+    });
+}
+
+namespace {
+
+// Reads the binary format straight out of the document's bytes, every read is bounds checked against the end of the
+// document. See http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for the layout.
+class BinaryReader {
+public:
+    BinaryReader(const FBXSource::Pointer& source) :
+        _source(source),
+        _begin(source->data()),
+        _cursor(source->data()),
+        _end(source->data() + source->size()) {}
+
+    qint64 getPosition() const { return _cursor - _begin; }
+    bool atEnd() const { return _cursor >= _end; }
+
+    const char* skip(size_t size) {
+        if (size > (size_t)(_end - _cursor)) {
+            throw QString("FBX file most likely corrupt: unexpected end of data");
         }
-        case 'l': {
-            return readBinaryArray<qint64>(in, position);
+        const char* data = _cursor;
+        _cursor += size;
+        return data;
+    }
+
+    template <typename T>
+    T read() {
+        T value;
+        memcpy(&value, skip(sizeof(T)), sizeof(T));
+        if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) {
+            char* bytes = (char*)&value;
+            std::reverse(bytes, bytes + sizeof(T));
         }
-        case 'i': {
-            return readBinaryArray<qint32>(in, position);
+        return value;
+    }
+
+    template <typename T>
+    QVariant readArray() {
+        quint32 arrayLength = read<quint32>();
+        if (arrayLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
+            throw QString("FBX file most likely corrupt: binary data exceeds data limits");
         }
-        case 'b': {
-            return readBinaryArray<bool>(in, position);
+        quint32 encoding = read<quint32>();
+        quint32 compressedLength = read<quint32>();
+        if (compressedLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
+            throw QString("FBX file most likely corrupt: compressed binary data exceeds data limits");
         }
+
+        // only remember where the array is, it's decoded when somebody reads it
+        quint32 dataLength = (encoding == FBX_PROPERTY_COMPRESSED_FLAG) ? compressedLength : arrayLength * sizeof(T);
+        const char* data = skip(dataLength);
+        return QVariant::fromValue(FBXBinaryArray<T>(_source, data, arrayLength, encoding, dataLength));
+    }
+
+    QVariant readProperty();
+    FBXNode readNode(bool has64BitPositions);
+
+private:
+    FBXSource::Pointer _source;
+    const char* _begin;
+    const char* _cursor;
+    const char* _end;
+};
+
+QVariant BinaryReader::readProperty() {
+    char ch = read<char>();
+    switch (ch) {
+        case 'Y':
+            return QVariant::fromValue(read<qint16>());
+        case 'C':
+            return QVariant::fromValue(read<qint8>() != 0);
+        case 'I':
+            return QVariant::fromValue(read<qint32>());
+        case 'F':
+            return QVariant::fromValue(read<float>());
+        case 'D':
+            return QVariant::fromValue(read<double>());
+        case 'L':
+            return QVariant::fromValue(read<qint64>());
+        case 'f':
+            return readArray<float>();
+        case 'd':
+            return readArray<double>();
+        case 'l':
+            return readArray<qint64>();
+        case 'i':
+            return readArray<qint32>();
+        case 'b':
+            return readArray<bool>();
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            // strings and raw data (e.g. embedded textures) are copied, they often outlive the document
+            quint32 length = read<quint32>();
+            const char* data = skip(length);
+            return QVariant::fromValue(hifi::ByteArray(data, length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode BinaryReader::readNode(bool has64BitPositions) {
     qint64 endOffset;
     quint64 propertyCount;
-    quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
     // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
+    // from here on out, but if the file is an older format we read into temp 32bit 
     // values and then assign to our actual 64bit values.
     if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+        endOffset = read<qint64>();
+        propertyCount = read<quint64>();
+        read<quint64>(); // property list length
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = read<qint32>();
+        propertyCount = read<quint32>();
+        read<quint32>(); // property list length
+    }
+    quint8 nameLength = read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -211,15 +224,14 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = hifi::ByteArray(skip(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(readProperty());
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (endOffset > getPosition()) {
+        FBXNode child = readNode(has64BitPositions);
         if (!child.name.isNull()) {
             node.children.append(child);
         }
@@ -228,6 +240,8 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
     return node;
 }
 
+}
+
 class Tokenizer {
 public:
 
@@ -352,13 +366,26 @@ FBXNode parseTextFBXNode(Tokenizer& tokenizer) {
 }
 
 FBXNode FBXSerializer::parseFBX(QIODevice* device) {
-    PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, device);
+    // share the bytes of in-memory documents rather than reading a copy
+    auto buffer = qobject_cast<QBuffer*>(device);
+    if (buffer && buffer->pos() == 0) {
+        return parseFBX(FBXSource::fromData(buffer->data()));
+    }
+    return parseFBX(FBXSource::fromData(device->readAll()));
+}
+
+FBXNode FBXSerializer::parseFBX(const FBXSource::Pointer& source) {
+    PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, (qint64)source->size());
     // verify the prolog
-    if (device->peek(FBX_BINARY_PROLOG.size()) != FBX_BINARY_PROLOG) {
+    if (!source->bytes().startsWith(FBX_BINARY_PROLOG)) {
         // parse as a text file
+        hifi::ByteArray bytes = source->bytes();
+        QBuffer device(&bytes);
+        device.open(QIODevice::ReadOnly);
+
         FBXNode top;
-        Tokenizer tokenizer(device);
-        while (device->bytesAvailable()) {
+        Tokenizer tokenizer(&device);
+        while (device.bytesAvailable()) {
             FBXNode next = parseTextFBXNode(tokenizer);
             if (next.name.isNull()) {
                 return top;
@@ -369,9 +396,8 @@ FBXNode FBXSerializer::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
+
+    registerBinaryArrayConverters();
 
     // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
     // of the FBX binary format
@@ -380,18 +406,16 @@ FBXNode FBXSerializer::parseFBX(QIODevice* device) {
     //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
     //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
     //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
+    BinaryReader reader(source);
+    reader.skip(FBX_HEADER_BYTES_BEFORE_VERSION);
+    quint32 fileVersion = reader.read<quint32>();
     qCDebug(modelformat) << "fileVersion:" << fileVersion;
     bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
 
     // parse the top-level node
     FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (!reader.atEnd()) {
+        FBXNode next = reader.readNode(has64BitPositions);
         if (next.name.isNull()) {
             return top;
 
@@ -411,6 +435,7 @@ glm::vec3 FBXSerializer::getVec3(const QVariantList& properties, int index) {
 
 QVector<glm::vec4> FBXSerializer::createVec4Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec4> values;
+    values.reserve(doubleVector.size() / 4);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -424,6 +449,7 @@ QVector<glm::vec4> FBXSerializer::createVec4Vector(const QVector<double>& double
 
 QVector<glm::vec4> FBXSerializer::createVec4VectorRGBA(const QVector<double>& doubleVector, glm::vec4& average) {
     QVector<glm::vec4> values;
+    values.reserve(doubleVector.size() / 4);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -441,6 +467,7 @@ QVector<glm::vec4> FBXSerializer::createVec4VectorRGBA(const QVector<double>& do
 
 QVector<glm::vec3> FBXSerializer::createVec3Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec3> values;
+    values.reserve(doubleVector.size() / 3);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 3) * 3); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -452,6 +479,7 @@ QVector<glm::vec3> FBXSerializer::createVec3Vector(const QVector<double>& double
 
 QVector<glm::vec2> FBXSerializer::createVec2Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec2> values;
+    values.reserve(doubleVector.size() / 2);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 2) * 2); it != end; ) {
         float s = *it++;
         float t = *it++;
@@ -476,7 +504,11 @@ QVector<int> FBXSerializer::getIntVector(const FBXNode& node) {
     if (node.properties.isEmpty()) {
         return QVector<int>();
     }
-    QVector<int> vector = node.properties.at(0).value<QVector<int> >();
+    const QVariant& property = node.properties.at(0);
+    if (property.userType() == qMetaTypeId<FBXBinaryArray<qint32>>()) {
+        return property.value<FBXBinaryArray<qint32>>().decode();
+    }
+    QVector<int> vector = property.value<QVector<int> >();
     if (!vector.isEmpty()) {
         return vector;
     }
@@ -495,7 +527,11 @@ QVector<float> FBXSerializer::getFloatVector(const FBXNode& node) {
     if (node.properties.isEmpty()) {
         return QVector<float>();
     }
-    QVector<float> vector = node.properties.at(0).value<QVector<float> >();
+    const QVariant& property = node.properties.at(0);
+    if (property.userType() == qMetaTypeId<FBXBinaryArray<float>>()) {
+        return property.value<FBXBinaryArray<float>>().decode();
+    }
+    QVector<float> vector = property.value<QVector<float> >();
     if (!vector.isEmpty()) {
         return vector;
     }
@@ -514,7 +550,11 @@ QVector<double> FBXSerializer::getDoubleVector(const FBXNode& node) {
     if (node.properties.isEmpty()) {
         return QVector<double>();
     }
-    QVector<double> vector = node.properties.at(0).value<QVector<double> >();
+    const QVariant& property = node.properties.at(0);
+    if (property.userType() == qMetaTypeId<FBXBinaryArray<double>>()) {
+        return property.value<FBXBinaryArray<double>>().decode();
+    }
+    QVector<double> vector = property.value<QVector<double> >();
     if (!vector.isEmpty()) {
         return vector;
     }
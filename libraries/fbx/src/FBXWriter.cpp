@@ -54,6 +54,22 @@ void writeVector(QDataStream& out, char ch, QVector<T> vec) {
     out.writeRawData(data.constData(), data.size());
 }
 
+// arrays that were parsed from a binary document and never decoded are written as they were stored
+template <typename T>
+bool writeEncodedArray(QDataStream& out, char ch, const QVariant& prop) {
+    if (prop.userType() != qMetaTypeId<FBXBinaryArray<T>>()) {
+        return false;
+    }
+    auto array = prop.value<FBXBinaryArray<T>>();
+    auto data = array.getEncodedData();
+
+    out.device()->write(&ch, 1);
+    out << (int32_t)array.size();
+    out << (int32_t)array.getEncoding();
+    out << (int32_t)data.size();
+    out.writeRawData(data.constData(), data.size());
+    return true;
+}
 
 QByteArray FBXWriter::encodeFBX(const FBXNode& root) {
     QByteArray data;
@@ -174,6 +190,12 @@ void FBXWriter::encodeFBXProperty(QDataStream& out, const QVariant& prop) {
         }
         default:
         {
+            if (writeEncodedArray<float>(out, 'f', prop) || writeEncodedArray<double>(out, 'd', prop) ||
+                writeEncodedArray<qint64>(out, 'l', prop) || writeEncodedArray<qint32>(out, 'i', prop) ||
+                writeEncodedArray<bool>(out, 'b', prop)) {
+                break;
+            }
+
             if (prop.canConvert<QVector<float>>()) {
                 writeVector(out, 'f', prop.value<QVector<float>>());
             } else if (prop.canConvert<QVector<double>>()) {
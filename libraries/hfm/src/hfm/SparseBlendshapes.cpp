@@ -0,0 +1,166 @@
+//
+//  SparseBlendshapes.cpp
+//  libraries/hfm/src/hfm
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SparseBlendshapes.h"
+
+#include <cmath>
+
+// on x86 architecture, assume that SSE2 is present
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define BLENDSHAPES_SSE
+#endif
+
+using namespace hfm;
+
+const float BlendshapeAccumulator::MIN_COEFFICIENT = 0.0001f;
+const float BlendshapeAccumulator::CHANGE_THRESHOLD = 0.001f;
+const int BlendshapeAccumulator::MAX_INCREMENTAL_UPDATES = 256;
+
+// a blendshape that was switched off is always removed so that the mesh can get back to rest
+static bool hasChanged(float target, float applied) {
+    return fabsf(target - applied) > BlendshapeAccumulator::CHANGE_THRESHOLD || (target == 0.0f && applied != 0.0f);
+}
+
+static void copyOffset(const QVector<glm::vec3>& source, int index, float* destination) {
+    if (index < source.size()) {
+        const glm::vec3& offset = source.at(index);
+        destination[0] = offset.x;
+        destination[1] = offset.y;
+        destination[2] = offset.z;
+    }
+}
+
+SparseBlendshapes::SparseBlendshapes(const QVector<Blendshape>& blendshapes, int numVertices) :
+    _numVertices(numVertices) {
+
+    size_t numEntries = 0;
+    for (const Blendshape& blendshape : blendshapes) {
+        numEntries += blendshape.indices.size();
+    }
+    _rows.reserve(blendshapes.size() + 1);
+    _indices.reserve(numEntries);
+    _offsets.reserve(numEntries * FLOATS_PER_VERTEX);
+
+    _rows.push_back(0);
+    for (const Blendshape& blendshape : blendshapes) {
+        for (int i = 0; i < blendshape.indices.size(); i++) {
+            int index = blendshape.indices.at(i);
+            if (index < 0 || index >= numVertices) {
+                continue;
+            }
+            _indices.push_back((uint32_t)index);
+
+            // missing normals and tangents are left at zero
+            size_t entry = _offsets.size();
+            _offsets.resize(entry + FLOATS_PER_VERTEX, 0.0f);
+            copyOffset(blendshape.vertices, i, &_offsets[entry]);
+            copyOffset(blendshape.normals, i, &_offsets[entry + 4]);
+            copyOffset(blendshape.tangents, i, &_offsets[entry + 8]);
+        }
+        _rows.push_back((uint32_t)_indices.size());
+    }
+}
+
+void SparseBlendshapes::accumulate(int blendshape, float positionCoefficient, float normalCoefficient, float* offsets) const {
+    const uint32_t* indices = _indices.data();
+    const float* entries = _offsets.data();
+    uint32_t end = _rows[blendshape + 1];
+
+#ifdef BLENDSHAPES_SSE
+    __m128 position = _mm_set1_ps(positionCoefficient);
+    __m128 normal = _mm_set1_ps(normalCoefficient);
+    for (uint32_t i = _rows[blendshape]; i < end; i++) {
+        const float* entry = entries + i * FLOATS_PER_VERTEX;
+        float* offset = offsets + indices[i] * FLOATS_PER_VERTEX;
+        _mm_storeu_ps(offset, _mm_add_ps(_mm_loadu_ps(offset), _mm_mul_ps(_mm_loadu_ps(entry), position)));
+        _mm_storeu_ps(offset + 4, _mm_add_ps(_mm_loadu_ps(offset + 4), _mm_mul_ps(_mm_loadu_ps(entry + 4), normal)));
+        _mm_storeu_ps(offset + 8, _mm_add_ps(_mm_loadu_ps(offset + 8), _mm_mul_ps(_mm_loadu_ps(entry + 8), normal)));
+    }
+#else
+    for (uint32_t i = _rows[blendshape]; i < end; i++) {
+        const float* entry = entries + i * FLOATS_PER_VERTEX;
+        float* offset = offsets + indices[i] * FLOATS_PER_VERTEX;
+        for (int j = 0; j < 4; j++) {
+            offset[j] += entry[j] * positionCoefficient;
+        }
+        for (int j = 4; j < FLOATS_PER_VERTEX; j++) {
+            offset[j] += entry[j] * normalCoefficient;
+        }
+    }
+#endif
+}
+
+bool BlendshapeAccumulator::update(const SparseBlendshapes& blendshapes, const QVector<float>& coefficients, float normalScale,
+                                   std::vector<uint32_t>& changedVertices) {
+    changedVertices.clear();
+    int numBlendshapes = blendshapes.getNumBlendshapes();
+    size_t numOffsets = (size_t)blendshapes.getNumVertices() * SparseBlendshapes::FLOATS_PER_VERTEX;
+
+    bool rebuild = _offsets.size() != numOffsets || (int)_coefficients.size() != numBlendshapes ||
+        _numIncrementalUpdates >= MAX_INCREMENTAL_UPDATES;
+
+    // compare the cost of applying the changes with that of starting over
+    _targets.resize(numBlendshapes);
+    size_t numRebuildEntries = 0;
+    size_t numChangedEntries = 0;
+    for (int i = 0; i < numBlendshapes; i++) {
+        float target = (i < coefficients.size() && coefficients.at(i) >= MIN_COEFFICIENT) ? coefficients.at(i) : 0.0f;
+        _targets[i] = target;
+        if (target != 0.0f) {
+            numRebuildEntries += blendshapes.getNumEntries(i);
+        }
+        if (!rebuild && hasChanged(target, _coefficients[i])) {
+            numChangedEntries += blendshapes.getNumEntries(i);
+        }
+    }
+
+    if (rebuild || numChangedEntries > numRebuildEntries) {
+        _offsets.assign(numOffsets, 0.0f);
+        _coefficients.assign(numBlendshapes, 0.0f);
+        for (int i = 0; i < numBlendshapes; i++) {
+            float target = _targets[i];
+            if (target != 0.0f) {
+                blendshapes.accumulate(i, target, target * normalScale, _offsets.data());
+                _coefficients[i] = target;
+            }
+        }
+        _changed.assign(blendshapes.getNumVertices(), 0);
+        _numIncrementalUpdates = 0;
+        return true;
+    }
+
+    if (numChangedEntries == 0) {
+        return false;
+    }
+    for (int i = 0; i < numBlendshapes; i++) {
+        float target = _targets[i];
+        if (!hasChanged(target, _coefficients[i])) {
+            continue;
+        }
+        float delta = target - _coefficients[i];
+        blendshapes.accumulate(i, delta, delta * normalScale, _offsets.data());
+        _coefficients[i] = target;
+
+        const uint32_t* indices = blendshapes.getIndices(i);
+        for (size_t j = 0, n = blendshapes.getNumEntries(i); j < n; j++) {
+            uint32_t index = indices[j];
+            if (!_changed[index]) {
+                _changed[index] = 1;
+                changedVertices.push_back(index);
+            }
+        }
+    }
+    for (uint32_t index : changedVertices) {
+        _changed[index] = 0;
+    }
+    _numIncrementalUpdates++;
+    return false;
+}
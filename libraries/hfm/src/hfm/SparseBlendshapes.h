@@ -0,0 +1,78 @@
+//
+//  SparseBlendshapes.h
+//  libraries/hfm/src/hfm
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SparseBlendshapes_h
+#define hifi_SparseBlendshapes_h
+
+#include <memory>
+#include <vector>
+
+#include "HFM.h"
+
+namespace hfm {
+
+/// The blendshapes of one mesh in compressed sparse row form, built once when the model is loaded.
+/// Row i lists the vertices moved by blendshape i.  The position, normal and tangent offsets of each entry are
+/// padded to four floats so that they can be accumulated four lanes at a time.
+class SparseBlendshapes {
+public:
+    using Pointer = std::shared_ptr<const SparseBlendshapes>;
+
+    /// position, normal and tangent offsets, each padded to four floats
+    static const int FLOATS_PER_VERTEX = 12;
+
+    SparseBlendshapes(const QVector<Blendshape>& blendshapes, int numVertices);
+
+    int getNumVertices() const { return _numVertices; }
+    int getNumBlendshapes() const { return (int)_rows.size() - 1; }
+    size_t getNumEntries() const { return _indices.size(); }
+    size_t getNumEntries(int blendshape) const { return _rows[blendshape + 1] - _rows[blendshape]; }
+
+    /// \return the indices of the vertices moved by a blendshape, getNumEntries(blendshape) of them
+    const uint32_t* getIndices(int blendshape) const { return _indices.data() + _rows[blendshape]; }
+
+    /// Adds a blendshape scaled by the coefficients to offsets, which holds FLOATS_PER_VERTEX floats per vertex.
+    void accumulate(int blendshape, float positionCoefficient, float normalCoefficient, float* offsets) const;
+
+private:
+    int _numVertices;
+    std::vector<uint32_t> _rows;
+    std::vector<uint32_t> _indices;
+    std::vector<float> _offsets;
+};
+
+/// The blended offsets of one mesh.  Each update applies only the blendshapes whose coefficient moved by more than
+/// CHANGE_THRESHOLD, by the difference, and reports which vertices that touched.  It rebuilds from scratch the first
+/// time, when that is cheaper than the difference, and every MAX_INCREMENTAL_UPDATES updates so rounding can't build up.
+class BlendshapeAccumulator {
+public:
+    /// coefficients below this are treated as 0
+    static const float MIN_COEFFICIENT;
+    static const float CHANGE_THRESHOLD;
+    static const int MAX_INCREMENTAL_UPDATES;
+
+    /// \return true if every vertex was recomputed, otherwise the vertices that changed are in changedVertices
+    bool update(const SparseBlendshapes& blendshapes, const QVector<float>& coefficients, float normalScale,
+                std::vector<uint32_t>& changedVertices);
+
+    /// \return the offsets of a vertex, laid out as in SparseBlendshapes
+    const float* getOffsets(int vertex) const { return _offsets.data() + vertex * SparseBlendshapes::FLOATS_PER_VERTEX; }
+
+private:
+    std::vector<float> _offsets;
+    std::vector<float> _coefficients;
+    std::vector<float> _targets;
+    std::vector<uint8_t> _changed;
+    int _numIncrementalUpdates { 0 };
+};
+
+};
+
+#endif // hifi_SparseBlendshapes_h
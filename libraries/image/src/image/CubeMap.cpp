@@ -10,7 +10,9 @@
 //
 #include "CubeMap.h"
 
+#include <algorithm>
 #include <cmath>
+#include <random>
 #include <TBBHelpers.h>
 
 #include "RandomAndNoise.h"
@@ -23,6 +25,12 @@
 
 #include <nvtt/nvtt.h>
 
+// on x86 architecture, assume that SSE2 is present
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define CUBEMAP_SSE
+#endif
+
 using namespace image;
 
 static const glm::vec3 FACE_NORMALS[24] = {
@@ -81,6 +89,49 @@ public:
     }
 
     glm::vec4 fetch(int face, glm::vec2 uv) const {
+        Texels texels;
+        computeTexels(face, uv, texels);
+
+        glm::vec4 colorLL = *texels.LL;
+        glm::vec4 colorHL = *texels.HL;
+        glm::vec4 colorLH = *texels.LH;
+        glm::vec4 colorHH = *texels.HH;
+
+        colorLL += (colorHL - colorLL) * texels.frac.x;
+        colorLH += (colorHH - colorLH) * texels.frac.x;
+        return colorLL + (colorLH - colorLL) * texels.frac.y;
+    }
+
+#ifdef CUBEMAP_SSE
+    // Same as fetch() but the texels are a single register each, the GGX convolution does this thousands of times per texel
+    __m128 fetchSSE(int face, glm::vec2 uv) const {
+        Texels texels;
+        computeTexels(face, uv, texels);
+
+        __m128 colorLL = _mm_loadu_ps(&texels.LL->x);
+        __m128 colorHL = _mm_loadu_ps(&texels.HL->x);
+        __m128 colorLH = _mm_loadu_ps(&texels.LH->x);
+        __m128 colorHH = _mm_loadu_ps(&texels.HH->x);
+        __m128 fracX = _mm_set1_ps(texels.frac.x);
+        __m128 fracY = _mm_set1_ps(texels.frac.y);
+
+        colorLL = _mm_add_ps(colorLL, _mm_mul_ps(_mm_sub_ps(colorHL, colorLL), fracX));
+        colorLH = _mm_add_ps(colorLH, _mm_mul_ps(_mm_sub_ps(colorHH, colorLH), fracX));
+        return _mm_add_ps(colorLL, _mm_mul_ps(_mm_sub_ps(colorLH, colorLL), fracY));
+    }
+#endif
+
+private:
+
+    struct Texels {
+        const glm::vec4* LL;
+        const glm::vec4* HL;
+        const glm::vec4* LH;
+        const glm::vec4* HH;
+        glm::vec2 frac;
+    };
+
+    void computeTexels(int face, glm::vec2 uv, Texels& texels) const {
         glm::vec2 coordFrac = uv * glm::vec2(_dims) - 0.5f;
         glm::vec2 coords = glm::floor(coordFrac);
 
@@ -103,14 +154,11 @@ public:
         assert(offsetHL >= 0 && offsetHL < _lineStride * (_dims.y + 2 * EDGE_WIDTH));
         assert(offsetLH >= 0 && offsetLH < _lineStride * (_dims.y + 2 * EDGE_WIDTH));
         assert(offsetHH >= 0 && offsetHH < _lineStride * (_dims.y + 2 * EDGE_WIDTH));
-        glm::vec4 colorLL = pixels[offsetLL];
-        glm::vec4 colorHL = pixels[offsetHL];
-        glm::vec4 colorLH = pixels[offsetLH];
-        glm::vec4 colorHH = pixels[offsetHH];
-
-        colorLL += (colorHL - colorLL) * coordFrac.x;
-        colorLH += (colorHH - colorLH) * coordFrac.x;
-        return colorLL + (colorLH - colorLL) * coordFrac.y;
+        texels.LL = pixels.data() + offsetLL;
+        texels.HL = pixels.data() + offsetHL;
+        texels.LH = pixels.data() + offsetLH;
+        texels.HH = pixels.data() + offsetHH;
+        texels.frac = coordFrac;
     }
 
 private:
@@ -325,14 +373,12 @@ CubeMap::CubeMap(int width, int height, int mipCount) {
 CubeMap::CubeMap(const std::vector<Image>& faces, int mipCount, const std::atomic<bool>& abortProcessing) {
     reset(faces.front().getWidth(), faces.front().getHeight(), mipCount);
 
-    int face;
-
-    nvtt::Surface surface;
-    surface.setAlphaMode(nvtt::AlphaMode_None);
-    surface.setWrapMode(nvtt::WrapMode_Mirror);
+    // Compute mips, the faces are independent
+    tbb::parallel_for(0, 6, [&](int face) {
+        nvtt::Surface surface;
+        surface.setAlphaMode(nvtt::AlphaMode_None);
+        surface.setWrapMode(nvtt::WrapMode_Mirror);
 
-    // Compute mips
-    for (face = 0; face < 6; face++) {
         Image faceImage = faces[face].getConvertedToFormat(Image::Format_RGBAF);
 
         surface.setImage(nvtt::InputFormat_RGBA_32F, _width, _height, 1, faceImage.editBits());
@@ -346,7 +392,7 @@ CubeMap::CubeMap(const std::vector<Image>& faces, int mipCount, const std::atomi
 
             copySurface(surface, editFace(mipLevel, face), getMipLineStride(mipLevel));
         }
-    }
+    });
 
     if (abortProcessing.load()) {
         return;
@@ -506,13 +552,31 @@ glm::vec4 CubeMap::fetchLod(const glm::vec3& dir, float lod) const {
 struct CubeMap::GGXSamples {
     float invTotalWeight;
     std::vector<glm::vec4> points;
+
+    // The same samples split per component for the convolution loop. z is also N.L in tangent space, and
+    // the source lod of each sample is resolved once here instead of for every texel.
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<gpu::uint16> loLevel;
+    std::vector<gpu::uint16> hiLevel;
+    std::vector<float> lodFrac;
+};
+
+struct CubeMap::GGXTile {
+    gpu::uint16 mipLevel;
+    int face;
+    int beginX;
+    int endX;
+    int beginY;
+    int endY;
 };
 
 // All the GGX convolution code is inspired from:
 // https://placeholderart.wordpress.com/2015/07/28/implementation-notes-runtime-environment-map-filtering-for-image-based-lighting/
 // Computation is done in tangent space so normal is always (0,0,1) which simplifies a lot of things
 
-void CubeMap::generateGGXSamples(GGXSamples& data, float roughness, const int resolution) {
+void CubeMap::generateGGXSamples(GGXSamples& data, float roughness, const int resolution, gpu::uint16 maxLevel) {
     glm::vec2 xi;
     glm::vec3 L;
     glm::vec3 H;
@@ -524,6 +588,10 @@ void CubeMap::generateGGXSamples(GGXSamples& data, float roughness, const int re
     size_t hammersleySampleIndex = 0;
     float NdotL;
 
+    // Seeded so that the same skybox always convolves to the same result
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
     data.invTotalWeight = 0.0f;
 
     // Do some computation in tangent space
@@ -540,8 +608,8 @@ void CubeMap::generateGGXSamples(GGXSamples& data, float roughness, const int re
 
         while (NdotL <= 0.0f) {
             // Create a purely random sample
-            xi.x = rand() / float(RAND_MAX);
-            xi.y = rand() / float(RAND_MAX);
+            xi.x = distribution(generator);
+            xi.y = distribution(generator);
             H = ggx::sample(xi, roughness);
             L = H * (2.0f * H.z) - glm::vec3(0.0f, 0.0f, 1.0f);
             NdotL = L.z;
@@ -565,17 +633,36 @@ void CubeMap::generateGGXSamples(GGXSamples& data, float roughness, const int re
         sampleIndex++;
     }
     data.invTotalWeight = 1.0f / data.invTotalWeight;
+
+    data.x.resize(sampleCount);
+    data.y.resize(sampleCount);
+    data.z.resize(sampleCount);
+    data.loLevel.resize(sampleCount);
+    data.hiLevel.resize(sampleCount);
+    data.lodFrac.resize(sampleCount);
+
+    for (sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++) {
+        // Same lod split as fetchLod
+        const auto& sample = data.points[sampleIndex];
+        const float lod = glm::clamp<float>(sample.w, 0.0f, (float)maxLevel);
+
+        data.x[sampleIndex] = sample.x;
+        data.y[sampleIndex] = sample.y;
+        data.z[sampleIndex] = sample.z;
+        data.loLevel[sampleIndex] = (gpu::uint16)std::floor(lod);
+        data.hiLevel[sampleIndex] = (gpu::uint16)std::ceil(lod);
+        data.lodFrac[sampleIndex] = lod - (float)data.loLevel[sampleIndex];
+    }
 }
 
 void CubeMap::convolveForGGX(CubeMap& output, const std::atomic<bool>& abortProcessing) const {
     // This should match the value in the getMipLevelFromRoughness function (LightAmbient.slh)
     static const float ROUGHNESS_1_MIP_RESOLUTION = 1.5f;
     static const size_t MAX_SAMPLE_COUNT = 4000;
+    static const int TILE_SIZE = 16;
 
     const auto mipCount = getMipCount();
-    GGXSamples params;
-
-    params.points.reserve(MAX_SAMPLE_COUNT);
+    std::vector<GGXSamples> mipSamples(mipCount);
 
     for (gpu::uint16 mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
         // This is the inverse code found in LightAmbient.slh in getMipLevelFromRoughness
@@ -591,70 +678,141 @@ void CubeMap::convolveForGGX(CubeMap& output, const std::atomic<bool>& abortProc
         sampleCount = std::min(sampleCount, 2 * mipTotalPixelCount);
         sampleCount = std::min(MAX_SAMPLE_COUNT, sampleCount);
 
+        auto& params = mipSamples[mipLevel];
         params.points.resize(sampleCount);
-        generateGGXSamples(params, mipRoughness, _width);
+        generateGGXSamples(params, mipRoughness, _width, mipCount - 1);
+    }
+
+    std::vector<ConstMip> sourceMips;
+    sourceMips.reserve(mipCount);
+    for (gpu::uint16 mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+        sourceMips.emplace_back(mipLevel, this);
+    }
 
+    // Every tile of every face of every mip goes to the pool at once. Rough mips are small but take the
+    // most samples per texel, on their own they wouldn't have enough tiles to keep the threads busy.
+    std::vector<GGXTile> tiles;
+    for (gpu::uint16 mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+        const auto mipDimensions = output.getMipDimensions(mipLevel);
         for (int face = 0; face < 6; face++) {
-            convolveMipFaceForGGX(params, output, mipLevel, face, abortProcessing);
+            for (int y = 0; y < mipDimensions.y; y += TILE_SIZE) {
+                for (int x = 0; x < mipDimensions.x; x += TILE_SIZE) {
+                    tiles.push_back({ mipLevel, face, x, std::min(x + TILE_SIZE, mipDimensions.x), y, std::min(y + TILE_SIZE, mipDimensions.y) });
+                }
+            }
+        }
+    }
+    // Most expensive tiles first so the cheap ones fill the gaps at the end
+    std::stable_sort(tiles.begin(), tiles.end(), [&](const GGXTile& a, const GGXTile& b) {
+        return mipSamples[a.mipLevel].points.size() > mipSamples[b.mipLevel].points.size();
+    });
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, tiles.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+        for (auto tileIndex = range.begin(); tileIndex < range.end(); tileIndex++) {
             if (abortProcessing.load()) {
                 return;
             }
+            const auto& tile = tiles[tileIndex];
+            convolveTileForGGX(tile, mipSamples[tile.mipLevel], sourceMips, output, abortProcessing);
         }
-    }
+    });
 }
 
-void CubeMap::convolveMipFaceForGGX(const GGXSamples& samples, CubeMap& output, gpu::uint16 mipLevel, int face, const std::atomic<bool>& abortProcessing) const {
-    const glm::vec3* faceNormals = FACE_NORMALS + face * 4;
+void CubeMap::convolveTileForGGX(const GGXTile& tile, const GGXSamples& samples, const std::vector<ConstMip>& sourceMips, CubeMap& output, const std::atomic<bool>& abortProcessing) const {
+    const glm::vec3* faceNormals = FACE_NORMALS + tile.face * 4;
     const glm::vec3 deltaYNormalLo = faceNormals[2] - faceNormals[0];
     const glm::vec3 deltaYNormalHi = faceNormals[3] - faceNormals[1];
-    const auto mipDimensions = output.getMipDimensions(mipLevel);
-    const auto outputLineStride = output.getMipLineStride(mipLevel);
-    auto outputFacePixels = output.editFace(mipLevel, face);
-
-    tbb::parallel_for(tbb::blocked_range2d<int, int>(0, mipDimensions.y, 32, 0, mipDimensions.x, 32), [&](const tbb::blocked_range2d<int, int>& range) {
-        auto rowRange = range.rows();
-        auto colRange = range.cols();
+    const auto mipDimensions = output.getMipDimensions(tile.mipLevel);
+    const auto outputLineStride = output.getMipLineStride(tile.mipLevel);
+    auto outputFacePixels = output.editFace(tile.mipLevel, tile.face);
 
-        for (auto y = rowRange.begin(); y < rowRange.end(); y++) {
-            if (abortProcessing.load()) {
-                break;
-            }
+    for (auto y = tile.beginY; y < tile.endY; y++) {
+        if (abortProcessing.load()) {
+            break;
+        }
 
-            const float yAlpha = (y + 0.5f) / mipDimensions.y;
-            const glm::vec3 normalXLo = faceNormals[0] + deltaYNormalLo * yAlpha;
-            const glm::vec3 normalXHi = faceNormals[1] + deltaYNormalHi * yAlpha;
-            const glm::vec3 deltaXNormal = normalXHi - normalXLo;
+        const float yAlpha = (y + 0.5f) / mipDimensions.y;
+        const glm::vec3 normalXLo = faceNormals[0] + deltaYNormalLo * yAlpha;
+        const glm::vec3 normalXHi = faceNormals[1] + deltaYNormalHi * yAlpha;
+        const glm::vec3 deltaXNormal = normalXHi - normalXLo;
 
-            for (auto x = colRange.begin(); x < colRange.end(); x++) {
-                const float xAlpha = (x + 0.5f) / mipDimensions.x;
-                // Interpolate normal for this pixel
-                const glm::vec3 normal = glm::normalize(normalXLo + deltaXNormal * xAlpha);
+        for (auto x = tile.beginX; x < tile.endX; x++) {
+            const float xAlpha = (x + 0.5f) / mipDimensions.x;
+            // Interpolate normal for this pixel
+            const glm::vec3 normal = glm::normalize(normalXLo + deltaXNormal * xAlpha);
 
-                outputFacePixels[x + y * outputLineStride] = computeConvolution(normal, samples);
-            }
+            outputFacePixels[x + y * outputLineStride] = computeConvolution(normal, samples, sourceMips);
         }
-    });
+    }
 }
 
-glm::vec4 CubeMap::computeConvolution(const glm::vec3& N, const GGXSamples& samples) const {
+glm::vec4 CubeMap::computeConvolution(const glm::vec3& N, const GGXSamples& samples, const std::vector<ConstMip>& sourceMips) {
+    static const size_t SAMPLE_BLOCK_SIZE = 64;
+
     // from tangent-space vector to world-space
     glm::vec3 bitangent = std::abs(N.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
     glm::vec3 tangent = glm::normalize(glm::cross(bitangent, N));
     bitangent = glm::cross(N, tangent);
 
     const size_t sampleCount = samples.points.size();
+    const float* sampleX = samples.x.data();
+    const float* sampleY = samples.y.data();
+    const float* sampleZ = samples.z.data();
+
+    float dirX[SAMPLE_BLOCK_SIZE];
+    float dirY[SAMPLE_BLOCK_SIZE];
+    float dirZ[SAMPLE_BLOCK_SIZE];
+
+#ifdef CUBEMAP_SSE
+    __m128 prefilteredColorSSE = _mm_setzero_ps();
+#else
     glm::vec4 prefilteredColor = glm::vec4(0.0f);
+#endif
+
+    for (size_t blockStart = 0; blockStart < sampleCount; blockStart += SAMPLE_BLOCK_SIZE) {
+        const size_t blockSize = std::min(SAMPLE_BLOCK_SIZE, sampleCount - blockStart);
+
+        // Now back to world space, a block at a time so the compiler can vectorize it
+        for (size_t i = 0; i < blockSize; ++i) {
+            const size_t sampleIndex = blockStart + i;
+            dirX[i] = tangent.x * sampleX[sampleIndex] + bitangent.x * sampleY[sampleIndex] + N.x * sampleZ[sampleIndex];
+            dirY[i] = tangent.y * sampleX[sampleIndex] + bitangent.y * sampleY[sampleIndex] + N.y * sampleZ[sampleIndex];
+            dirZ[i] = tangent.z * sampleX[sampleIndex] + bitangent.z * sampleY[sampleIndex] + N.z * sampleZ[sampleIndex];
+        }
 
-    for (size_t i = 0; i < sampleCount; ++i) {
-        const auto& sample = samples.points[i];
-        glm::vec3 L(sample.x, sample.y, sample.z);
-        float NdotL = L.z;
-        float mipLevel = sample.w;
-        // Now back to world space
-        L = tangent * L.x + bitangent * L.y + N * L.z;
-        prefilteredColor += fetchLod(L, mipLevel) * NdotL;
+        for (size_t i = 0; i < blockSize; ++i) {
+            const size_t sampleIndex = blockStart + i;
+            const float NdotL = sampleZ[sampleIndex];
+            const auto loLevel = samples.loLevel[sampleIndex];
+            const auto hiLevel = samples.hiLevel[sampleIndex];
+            const float lodFrac = samples.lodFrac[sampleIndex];
+            int face;
+            glm::vec2 uv;
+
+            getFaceUV(glm::vec3(dirX[i], dirY[i], dirZ[i]), &face, &uv);
+
+#ifdef CUBEMAP_SSE
+            __m128 color = sourceMips[loLevel].fetchSSE(face, uv);
+            if (hiLevel != loLevel) {
+                __m128 hiColor = sourceMips[hiLevel].fetchSSE(face, uv);
+                color = _mm_add_ps(color, _mm_mul_ps(_mm_sub_ps(hiColor, color), _mm_set1_ps(lodFrac)));
+            }
+            prefilteredColorSSE = _mm_add_ps(prefilteredColorSSE, _mm_mul_ps(color, _mm_set1_ps(NdotL)));
+#else
+            glm::vec4 color = sourceMips[loLevel].fetch(face, uv);
+            if (hiLevel != loLevel) {
+                color += (sourceMips[hiLevel].fetch(face, uv) - color) * lodFrac;
+            }
+            prefilteredColor += color * NdotL;
+#endif
+        }
     }
+
+#ifdef CUBEMAP_SSE
+    glm::vec4 prefilteredColor;
+    _mm_storeu_ps(&prefilteredColor.x, prefilteredColorSSE);
+#endif
     prefilteredColor = prefilteredColor * samples.invTotalWeight;
     prefilteredColor.a = 1.0f;
     return prefilteredColor;
-}
\ No newline at end of file
+}
@@ -69,6 +69,7 @@ namespace image {
     private:
 
         struct GGXSamples;
+        struct GGXTile;
         class Mip;
         class ConstMip;
 
@@ -80,10 +81,10 @@ namespace image {
         std::vector<Faces> _mips;
 
         static void getFaceUV(const glm::vec3& dir, int* index, glm::vec2* uv);
-        static void generateGGXSamples(GGXSamples& data, float roughness, const int resolution);
+        static void generateGGXSamples(GGXSamples& data, float roughness, const int resolution, gpu::uint16 maxLevel);
         static void copyFace(int width, int height, const glm::vec4* source, size_t srcLineStride, glm::vec4* dest, size_t dstLineStride);
-        void convolveMipFaceForGGX(const GGXSamples& samples, CubeMap& output, gpu::uint16 mipLevel, int face, const std::atomic<bool>& abortProcessing) const;
-        glm::vec4 computeConvolution(const glm::vec3& normal, const GGXSamples& samples) const;
+        void convolveTileForGGX(const GGXTile& tile, const GGXSamples& samples, const std::vector<ConstMip>& sourceMips, CubeMap& output, const std::atomic<bool>& abortProcessing) const;
+        static glm::vec4 computeConvolution(const glm::vec3& normal, const GGXSamples& samples, const std::vector<ConstMip>& sourceMips);
 
     };
 
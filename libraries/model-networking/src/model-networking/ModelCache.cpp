@@ -39,6 +39,7 @@ public:
 };
 
 int geometryMappingPairTypeId = qRegisterMetaType<GeometryMappingPair>("GeometryMappingPair");
+int geometryBlendshapesPointerTypeId = qRegisterMetaType<GeometryBlendshapesPointer>("GeometryBlendshapesPointer");
 
 // From: https://stackoverflow.com/questions/41145012/how-to-hash-qvariant
 class QVariantHasher {
@@ -181,8 +182,16 @@ void GeometryReader::run() {
         auto processedHFMModel = modelBaker.getHFMModel();
         auto materialMapping = modelBaker.getMaterialMapping();
 
+        // Lay out the blendshapes for the Blender here rather than every time they are blended
+        auto blendshapes = std::make_shared<Geometry::GeometryBlendshapes>();
+        for (const HFMMesh& mesh : processedHFMModel->meshes) {
+            blendshapes->push_back(mesh.blendshapes.isEmpty() ? nullptr :
+                std::make_shared<const hfm::SparseBlendshapes>(mesh.blendshapes, mesh.vertices.size()));
+        }
+
         QMetaObject::invokeMethod(resource.data(), "setGeometryDefinition",
-                Q_ARG(HFMModel::Pointer, processedHFMModel), Q_ARG(MaterialMapping, materialMapping));
+                Q_ARG(HFMModel::Pointer, processedHFMModel), Q_ARG(MaterialMapping, materialMapping),
+                Q_ARG(GeometryBlendshapesPointer, blendshapes));
     } catch (const std::exception&) {
         auto resource = _resource.toStrongRef();
         if (resource) {
@@ -297,6 +306,7 @@ void GeometryResource::onGeometryMappingLoaded(bool success) {
         _materialMapping = _geometryResource->_materialMapping;
         _meshParts = _geometryResource->_meshParts;
         _meshes = _geometryResource->_meshes;
+        _blendshapes = _geometryResource->_blendshapes;
         _materials = _geometryResource->_materials;
 
         // Avoid holding onto extra references
@@ -316,10 +326,12 @@ void GeometryResource::setExtra(void* extra) {
     _combineParts = geometryExtra ? geometryExtra->combineParts : true;
 }
 
-void GeometryResource::setGeometryDefinition(HFMModel::Pointer hfmModel, const MaterialMapping& materialMapping) {
+void GeometryResource::setGeometryDefinition(HFMModel::Pointer hfmModel, const MaterialMapping& materialMapping,
+                                             GeometryBlendshapesPointer blendshapes) {
     // Assume ownership of the processed HFMModel
     _hfmModel = hfmModel;
     _materialMapping = materialMapping;
+    _blendshapes = blendshapes;
 
     // Copy materials
     QHash<QString, size_t> materialIDAtlas;
@@ -429,6 +441,7 @@ Geometry::Geometry(const Geometry& geometry) {
     _materialMapping = geometry._materialMapping;
     _meshes = geometry._meshes;
     _meshParts = geometry._meshParts;
+    _blendshapes = geometry._blendshapes;
 
     _materials.reserve(geometry._materials.size());
     for (const auto& material : geometry._materials) {
@@ -504,6 +517,13 @@ const std::shared_ptr<NetworkMaterial> Geometry::getShapeMaterial(int partID) co
     return nullptr;
 }
 
+hfm::SparseBlendshapes::Pointer Geometry::getBlendshapes(int meshIndex) const {
+    if (_blendshapes && meshIndex >= 0 && meshIndex < (int)_blendshapes->size()) {
+        return _blendshapes->at(meshIndex);
+    }
+    return nullptr;
+}
+
 void GeometryResourceWatcher::startWatching() {
     connect(_resource.data(), &Resource::finished, this, &GeometryResourceWatcher::resourceFinished);
     connect(_resource.data(), &Resource::onRefresh, this, &GeometryResourceWatcher::resourceRefreshed);
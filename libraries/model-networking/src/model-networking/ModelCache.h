@@ -16,6 +16,7 @@
 #include <ResourceCache.h>
 
 #include <graphics/Asset.h>
+#include <hfm/SparseBlendshapes.h>
 
 #include "FBXSerializer.h"
 #include <material-networking/MaterialCache.h>
@@ -39,6 +40,7 @@ public:
     // Immutable over lifetime
     using GeometryMeshes = std::vector<std::shared_ptr<const graphics::Mesh>>;
     using GeometryMeshParts = std::vector<std::shared_ptr<const MeshPart>>;
+    using GeometryBlendshapes = std::vector<hfm::SparseBlendshapes::Pointer>;
 
     // Mutable, but must retain structure of vector
     using NetworkMaterials = std::vector<std::shared_ptr<NetworkMaterial>>;
@@ -50,6 +52,9 @@ public:
     const GeometryMeshes& getMeshes() const { return *_meshes; }
     const std::shared_ptr<NetworkMaterial> getShapeMaterial(int shapeID) const;
 
+    /// \return the blendshapes of a mesh laid out for blending, or nullptr if it has none
+    hfm::SparseBlendshapes::Pointer getBlendshapes(int meshIndex) const;
+
     const QVariantMap getTextures() const;
     void setTextures(const QVariantMap& textureMap);
 
@@ -63,6 +68,7 @@ protected:
     MaterialMapping _materialMapping;
     std::shared_ptr<const GeometryMeshes> _meshes;
     std::shared_ptr<const GeometryMeshParts> _meshParts;
+    std::shared_ptr<const GeometryBlendshapes> _blendshapes;
 
     // Copied to each geometry, mutable throughout lifetime via setTextures
     NetworkMaterials _materials;
@@ -74,6 +80,9 @@ private:
     mutable bool _areTexturesLoaded { false };
 };
 
+using GeometryBlendshapesPointer = std::shared_ptr<const Geometry::GeometryBlendshapes>;
+Q_DECLARE_METATYPE(GeometryBlendshapesPointer)
+
 /// A geometry loaded from the network.
 class GeometryResource : public Resource, public Geometry {
     Q_OBJECT
@@ -98,7 +107,8 @@ private slots:
 protected:
     friend class ModelCache;
 
-    Q_INVOKABLE void setGeometryDefinition(HFMModel::Pointer hfmModel, const MaterialMapping& materialMapping);
+    Q_INVOKABLE void setGeometryDefinition(HFMModel::Pointer hfmModel, const MaterialMapping& materialMapping,
+                                           GeometryBlendshapesPointer blendshapes);
 
     // Geometries may not hold onto textures while cached - that is for the texture cache
     // Instead, these methods clear and reset textures from the geometry when caching/loading
@@ -46,6 +46,8 @@ QString AssetUpload::getErrorString() const {
             return "There was a problem reaching your Asset Server. Please check your network connectivity.";
         case AssetUpload::ServerFileError:
             return "The Asset Server failed to store the asset. Please try again.";
+        case AssetUpload::ServerBusy:
+            return "The Asset Server is busy with other uploads. Please try again later.";
         default:
             return QString("Unknown error with code %1").arg(_error);
     }
@@ -98,6 +100,9 @@ void AssetUpload::start() {
                 case AssetUtils::AssetServerError::FileOperationFailed:
                     _error = ServerFileError;
                     break;
+                case AssetUtils::AssetServerError::ServerBusy:
+                    _error = ServerBusy;
+                    break;
                 default:
                     _error = FileOpenError;
                     break;
@@ -0,0 +1,80 @@
+//
+//  DomainListDelta.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainListDelta.h"
+
+#include <algorithm>
+
+const quint32 DomainListDeltaSender::FULL_LIST_INTERVAL = 60;
+
+quint32 DomainListDeltaSender::beginList(bool forceFull) {
+    _listVersion = std::max(_sentVersion + 1, (quint32)1);
+    _listedNodes.clear();
+
+    // Only send what changed since the last list if the receiver says it has all of that list, otherwise start over.
+    // A new list is a new version either way, so a receiver that missed part of it keeps acknowledging the old one.
+    _baseVersion = _sentVersion;
+    if (forceFull || _baseVersion == 0 || _acknowledgedVersion != _baseVersion || _listVersion % FULL_LIST_INTERVAL == 0) {
+        _baseVersion = 0;
+        _sentRecords.clear();
+    }
+    return _baseVersion;
+}
+
+bool DomainListDeltaSender::addNode(const QUuid& nodeID, quint64 revision) {
+    _listedNodes.insert(nodeID);
+    auto it = _sentRecords.find(nodeID);
+    if (it != _sentRecords.end() && it.value() == revision) {
+        return false;
+    }
+    _sentRecords[nodeID] = revision;
+    return true;
+}
+
+std::vector<QUuid> DomainListDeltaSender::endList() {
+    std::vector<QUuid> removedNodes;
+    for (auto it = _sentRecords.begin(); it != _sentRecords.end();) {
+        if (!_listedNodes.contains(it.key())) {
+            removedNodes.push_back(it.key());
+            it = _sentRecords.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _listedNodes.clear();
+    _sentVersion = _listVersion;
+    return removedNodes;
+}
+
+void DomainListDeltaReceiver::reset() {
+    _version = 0;
+    _pendingVersion = 0;
+    _pendingBaseVersion = 0;
+    _pendingNumEntries = 0;
+    _pendingEntries = 0;
+}
+
+void DomainListDeltaReceiver::beginPacket(quint32 listVersion, quint32 baseVersion, quint32 numEntries) {
+    if (listVersion != _pendingVersion) {
+        _pendingVersion = listVersion;
+        _pendingEntries = 0;
+    }
+    _pendingBaseVersion = baseVersion;
+    _pendingNumEntries = numEntries;
+}
+
+void DomainListDeltaReceiver::endPacket() {
+    // changes are only complete on top of the list they were made from, if we don't have that one
+    // we keep acknowledging what we do have and the domain-server will send everything again
+    if (_pendingEntries >= _pendingNumEntries && _version != _pendingVersion &&
+        (_pendingBaseVersion == 0 || _pendingBaseVersion == _version)) {
+        _version = _pendingVersion;
+    }
+}
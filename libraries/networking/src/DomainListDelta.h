@@ -0,0 +1,79 @@
+//
+//  DomainListDelta.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainListDelta_h
+#define hifi_DomainListDelta_h
+
+#include <atomic>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QUuid>
+
+/// The domain-server side of delta encoded DomainLists, one per receiving node. It remembers the revision of every
+/// node record sent to the receiver, so that once the receiver acknowledges a list the next one only carries what
+/// changed since.
+class DomainListDeltaSender {
+public:
+    /// every this many lists a full one goes out, in case the receiver dropped a node without telling us
+    static const quint32 FULL_LIST_INTERVAL;
+
+    /// the last list the receiver told us it has all of, 0 when it wants a full list
+    void setAcknowledgedVersion(quint32 version) { _acknowledgedVersion = version; }
+    quint32 getAcknowledgedVersion() const { return _acknowledgedVersion; }
+    quint32 getSentVersion() const { return _sentVersion; }
+
+    /// Starts the next list.  \return the version it is built on, 0 for a full list
+    quint32 beginList(bool forceFull = false);
+    quint32 getListVersion() const { return _listVersion; }
+    quint32 getBaseVersion() const { return _baseVersion; }
+
+    /// \return true when the record must be in the list being built
+    bool addNode(const QUuid& nodeID, quint64 revision);
+
+    /// Ends the list.  \return the nodes the receiver was sent before that are not in this list anymore
+    std::vector<QUuid> endList();
+
+private:
+    QHash<QUuid, quint64> _sentRecords;
+    QSet<QUuid> _listedNodes;
+    quint32 _acknowledgedVersion { 0 };
+    quint32 _sentVersion { 0 };
+    quint32 _listVersion { 0 };
+    quint32 _baseVersion { 0 };
+};
+
+/// The node side of delta encoded DomainLists: counts the entries of a list across its packets to know which list
+/// we have all of, which is the version acknowledged in our list requests.
+class DomainListDeltaReceiver {
+public:
+    /// we have no list anymore, ask for a full one
+    void reset();
+
+    void beginPacket(quint32 listVersion, quint32 baseVersion, quint32 numEntries);
+    void entryRead() { ++_pendingEntries; }
+    void endPacket();
+
+    /// A node was dropped without the domain-server removing it (e.g. it went silent).  The domain-server still
+    /// thinks we have it and wouldn't send it again until it changes, so ask for a full list.  Safe from any thread.
+    void nodeDroppedLocally() { _version = 0; }
+
+    quint32 getVersion() const { return _version; }
+
+private:
+    std::atomic<quint32> _version { 0 };
+    quint32 _pendingVersion { 0 };
+    quint32 _pendingBaseVersion { 0 };
+    quint32 _pendingNumEntries { 0 };
+    quint32 _pendingEntries { 0 };
+};
+
+#endif // hifi_DomainListDelta_h
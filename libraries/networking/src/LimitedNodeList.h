@@ -110,6 +110,13 @@ public:
     };
 
     Q_ENUM(ConnectionStep);
+
+    // each entry of a DomainList is one of these followed by either a node and its connection secret, or a node UUID
+    enum DomainListEntryType : quint8 {
+        DomainListNode = 0,
+        DomainListRemovedNode
+    };
+
     QUuid getSessionUUID() const;
     void setSessionUUID(const QUuid& sessionUUID);
     Node::LocalID getSessionLocalID() const;
@@ -61,57 +61,66 @@ void MessagesClient::decodeMessagesPacket(QSharedPointer<ReceivedMessage> receiv
 
 std::unique_ptr<NLPacketList> MessagesClient::encodeMessagesPacket(QString channel, QString message, QUuid senderID) {
     auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
-
-    auto channelUtf8 = channel.toUtf8();
-    quint16 channelLength = channelUtf8.length();
-    packetList->writePrimitive(channelLength);
-    packetList->write(channelUtf8);
-
-    bool isTextMessage = true;
-    packetList->writePrimitive(isTextMessage);
-
-    auto messageUtf8 = message.toUtf8();
-    quint32 messageLength = messageUtf8.length();
-    packetList->writePrimitive(messageLength);
-    packetList->write(messageUtf8);
-
-    packetList->write(senderID.toRfc4122());
-
+    packetList->write(encodeMessagesPayload(channel, true, message.toUtf8(), senderID));
     return packetList;
 }
 
 std::unique_ptr<NLPacketList> MessagesClient::encodeMessagesDataPacket(QString channel, QByteArray data, QUuid senderID) {
     auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    packetList->write(encodeMessagesPayload(channel, false, data, senderID));
+    return packetList;
+}
 
+QByteArray MessagesClient::encodeMessagesPayload(const QString& channel, bool isText, const QByteArray& content, const QUuid& senderID) {
     auto channelUtf8 = channel.toUtf8();
     quint16 channelLength = channelUtf8.length();
-    packetList->writePrimitive(channelLength);
-    packetList->write(channelUtf8);
-
-    bool isTextMessage = false;
-    packetList->writePrimitive(isTextMessage);
-
-    quint32 dataLength = data.length();
-    packetList->writePrimitive(dataLength);
-    packetList->write(data);
+    quint32 contentLength = content.length();
+
+    QByteArray payload;
+    payload.reserve(sizeof(channelLength) + channelLength + sizeof(isText) + sizeof(contentLength) + contentLength +
+                    NUM_BYTES_RFC4122_UUID);
+    payload.append(reinterpret_cast<const char*>(&channelLength), sizeof(channelLength));
+    payload.append(channelUtf8);
+    payload.append(reinterpret_cast<const char*>(&isText), sizeof(isText));
+    payload.append(reinterpret_cast<const char*>(&contentLength), sizeof(contentLength));
+    payload.append(content);
+    payload.append(senderID.toRfc4122());
+    return payload;
+}
 
-    packetList->write(senderID.toRfc4122());
+bool MessagesClient::readMessagesPayload(ReceivedMessage& receivedMessage, QString& channel, bool& isText, QByteArray& content) {
+    quint16 channelLength;
+    if (receivedMessage.readPrimitive(&channelLength) != sizeof(channelLength) ||
+        channelLength > receivedMessage.getBytesLeftToRead()) {
+        return false;
+    }
+    channel = QString::fromUtf8(receivedMessage.readWithoutCopy(channelLength));
 
-    return packetList;
+    quint32 contentLength;
+    if (receivedMessage.readPrimitive(&isText) != sizeof(isText) ||
+        receivedMessage.readPrimitive(&contentLength) != sizeof(contentLength) ||
+        contentLength > receivedMessage.getBytesLeftToRead()) {
+        return false;
+    }
+    content = receivedMessage.readWithoutCopy(contentLength);
+    return true;
 }
 
-
 void MessagesClient::handleMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
     QString channel, message;
     QByteArray data;
     bool isText { false };
     QUuid senderID;
-    decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
-    if (isText) {
-        emit messageReceived(channel, message, senderID, false);
-    } else {
-        emit dataReceived(channel, data, senderID, false);
-    }
+
+    // the messages-mixer can coalesce several messages into one packet list
+    do {
+        decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+        if (isText) {
+            emit messageReceived(channel, message, senderID, false);
+        } else {
+            emit dataReceived(channel, data, senderID, false);
+        }
+    } while (receivedMessage->getBytesLeftToRead() > 0);
 }
 
 void MessagesClient::sendMessage(QString channel, QString message, bool localOnly) {
@@ -167,6 +167,13 @@ public:
     static std::unique_ptr<NLPacketList> encodeMessagesPacket(QString channel, QString message, QUuid senderID);
     static std::unique_ptr<NLPacketList> encodeMessagesDataPacket(QString channel, QByteArray data, QUuid senderID);
 
+    // A single message as it appears in a MessagesData packet. The messages-mixer may send several back to back.
+    static QByteArray encodeMessagesPayload(const QString& channel, bool isText, const QByteArray& content, const QUuid& senderID);
+
+    // Reads the channel and content of the next message without copying them. Returns false, leaving the read position
+    // undefined, when the lengths in the message run past its end.
+    static bool readMessagesPayload(ReceivedMessage& receivedMessage, QString& channel, bool& isText, QByteArray& content);
+
 signals:
     /**jsdoc
      * Triggered when a text message is received.
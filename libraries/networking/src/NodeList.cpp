@@ -103,6 +103,9 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     // anytime we get a new node we may need to re-send our set of ignored node IDs to it
     connect(this, &LimitedNodeList::nodeActivated, this, &NodeList::maybeSendIgnoreSetToNode);
 
+    // a node we drop on our own is still in the domain-server's idea of our list, have it send everything again
+    connect(this, &LimitedNodeList::nodeKilled, this, &NodeList::handleNodeKilled, Qt::DirectConnection);
+
     // setup our timer to send keepalive pings (it's started and stopped on domain connect/disconnect)
     _keepAlivePingTimer.setInterval(KEEPALIVE_PING_INTERVAL_MS); // 1s, Qt::CoarseTimer acceptable
     connect(&_keepAlivePingTimer, &QTimer::timeout, this, &NodeList::sendKeepAlivePings);
@@ -160,6 +163,18 @@ qint64 NodeList::sendStatsToDomainServer(QJsonObject statsObject) {
     return sendStats(statsObject, _domainHandler.getSockAddr());
 }
 
+void NodeList::sendTraceSnapshotToDomainServer(QByteArray snapshot) {
+    if (thread() != QThread::currentThread()) {
+        QMetaObject::invokeMethod(this, "sendTraceSnapshotToDomainServer", Qt::QueuedConnection,
+                                  Q_ARG(QByteArray, snapshot));
+        return;
+    }
+
+    auto snapshotPacketList = NLPacketList::create(PacketType::TraceSnapshot, QByteArray(), true, true);
+    snapshotPacketList->write(snapshot);
+    sendPacketList(std::move(snapshotPacketList), _domainHandler.getSockAddr());
+}
+
 void NodeList::timePingReply(ReceivedMessage& message, const SharedNodePointer& sendingNode) {
     PingType_t pingType;
 
@@ -274,6 +289,9 @@ void NodeList::reset(bool skipDomainHandlerReset) {
     setSessionUUID(QUuid());
     setSessionLocalID(Node::NULL_LOCAL_ID);
 
+    // we no longer have any list, ask for the whole thing
+    _domainListDelta.reset();
+
     // if we setup the DTLS socket, also disconnect from the DTLS socket readyRead() so it can handle handshaking
     if (_dtlsSocket) {
         disconnect(_dtlsSocket, 0, this, 0);
@@ -423,6 +441,8 @@ void NodeList::sendDomainServerCheckIn() {
                 const QByteArray& usernameSignature = accountManager->getAccountInfo().getUsernameSignature(connectionToken);
                 packetStream << usernameSignature;
             }
+        } else {
+            packetStream << _domainListDelta.getVersion();
         }
 
         flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SendDSCheckIn);
@@ -690,10 +710,34 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> isAuthenticated;
     setAuthenticatePackets(isAuthenticated);
 
+    // The list is either everything we should know about (base version 0) or what changed since the base version.
+    // Its entries can be spread over several packets, count them to know when we have all of it.
+    quint32 listVersion;
+    quint32 baseVersion;
+    quint32 numEntries;
+    packetStream >> listVersion >> baseVersion >> numEntries;
+
+    _domainListDelta.beginPacket(listVersion, baseVersion, numEntries);
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
-        parseNodeFromPacketStream(packetStream);
+        quint8 entryType;
+        packetStream >> entryType;
+
+        if (entryType == DomainListNode) {
+            parseNodeFromPacketStream(packetStream);
+        } else if (entryType == DomainListRemovedNode) {
+            QUuid nodeUUID;
+            packetStream >> nodeUUID;
+            killDomainListNode(nodeUUID);
+        } else {
+            qCWarning(networking) << "Unknown DomainList entry type" << entryType;
+            break;
+        }
+        _domainListDelta.entryRead();
     }
+
+    _domainListDelta.endPacket();
 }
 
 void NodeList::processDomainServerAddedNode(QSharedPointer<ReceivedMessage> message) {
@@ -708,10 +752,25 @@ void NodeList::processDomainServerRemovedNode(QSharedPointer<ReceivedMessage> me
     // read the UUID from the packet, remove it if it exists
     QUuid nodeUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
     qCDebug(networking) << "Received packet from domain-server to remove node with UUID" << uuidStringWithoutCurlyBraces(nodeUUID);
+    killDomainListNode(nodeUUID);
+}
+
+void NodeList::killDomainListNode(const QUuid& nodeUUID) {
+    // the domain-server knows this one is gone, no need to ask it for everything again
+    _removingDomainListNode = nodeUUID;
     killNodeWithUUID(nodeUUID);
+    _removingDomainListNode = QUuid();
+
     removeDelayedAdd(nodeUUID);
 }
 
+void NodeList::handleNodeKilled(SharedNodePointer node) {
+    if (QThread::currentThread() == thread() && node->getUUID() == _removingDomainListNode) {
+        return;
+    }
+    _domainListDelta.nodeDroppedLocally();
+}
+
 void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     NewNodeInfo info;
 
@@ -33,6 +33,7 @@
 #include <SettingHandle.h>
 
 #include "DomainHandler.h"
+#include "DomainListDelta.h"
 #include "LimitedNodeList.h"
 #include "Node.h"
 
@@ -60,6 +61,9 @@ public:
     Q_INVOKABLE qint64 sendStats(QJsonObject statsObject, HifiSockAddr destination);
     Q_INVOKABLE qint64 sendStatsToDomainServer(QJsonObject statsObject);
 
+    /// sends a gzipped trace snapshot in answer to the domain-server's TraceRequest
+    Q_INVOKABLE void sendTraceSnapshotToDomainServer(QByteArray snapshot);
+
     DomainHandler& getDomainHandler() { return _domainHandler; }
 
     const NodeSet& getNodeInterestSet() const { return _nodeTypesOfInterest; }
@@ -147,6 +151,8 @@ private slots:
 
     void maybeSendIgnoreSetToNode(SharedNodePointer node);
 
+    void handleNodeKilled(SharedNodePointer node);
+
 private:
     NodeList() : LimitedNodeList(INVALID_PORT, INVALID_PORT) { assert(false); } // Not implemented, needed for DependencyManager templates compile
     NodeList(char ownerType, int socketListenPort = INVALID_PORT, int dtlsListenPort = INVALID_PORT);
@@ -161,6 +167,7 @@ private:
     void sendDSPathQuery(const QString& newPath);
 
     void parseNodeFromPacketStream(QDataStream& packetStream);
+    void killDomainListNode(const QUuid& nodeUUID);
 
     void pingPunchForInactiveNode(const SharedNodePointer& node);
 
@@ -176,6 +183,10 @@ private:
 
     bool _sendDomainServerCheckInEnabled { true };
 
+    // the last DomainList we have all of, acknowledged in our list requests so the domain-server only sends changes
+    DomainListDeltaReceiver _domainListDelta;
+    QUuid _removingDomainListNode; // the node the domain-server is removing, only touched on our thread
+
     mutable QReadWriteLock _ignoredSetLock;
     tbb::concurrent_unordered_set<QUuid, UUIDHasher> _ignoredNodeIDs;
     mutable QReadWriteLock _personalMutedSetLock;
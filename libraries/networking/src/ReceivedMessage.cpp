@@ -57,8 +57,12 @@ ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, Pa
 }
 
 void ReceivedMessage::setFailed() {
-    _failed = true;
-    _isComplete = true;
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        _failed = true;
+        _isComplete = true;
+    }
+    _dataReceived.notify_all();
     emit completed();
 }
 
@@ -71,18 +75,39 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
+    bool isLastPacket = packet.getPacketPosition() == NLPacket::PacketPosition::LAST;
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        _data.append(packet.getPayload(), packet.getPayloadSize());
+        if (isLastPacket) {
+            _isComplete = true;
+        }
+    }
+    _dataReceived.notify_all();
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress(getSize());
     }
 
-    if (packet.getPacketPosition() == NLPacket::PacketPosition::LAST) {
-        _isComplete = true;
+    if (isLastPacket) {
         emit completed();
     }
 }
 
+QByteArray ReceivedMessage::takeReceivedData(unsigned long timeoutMsecs) {
+    std::unique_lock<std::mutex> lock(_dataMutex);
+
+    _dataReceived.wait_for(lock, std::chrono::milliseconds(timeoutMsecs), [this] {
+        return _data.size() > _position || _isComplete;
+    });
+
+    QByteArray data = _data.mid(_position);
+    _bytesTaken += _data.size();
+    _data.clear();
+    _position = 0;
+    return data;
+}
+
 qint64 ReceivedMessage::peek(char* data, qint64 size) {
     size_t bytesLeft = _data.size() - _position;
     size_t sizeRead = std::min((size_t)size, bytesLeft);
@@ -142,6 +167,10 @@ QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
 }
 
 void ReceivedMessage::onComplete() {
-    _isComplete = true;
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        _isComplete = true;
+    }
+    _dataReceived.notify_all();
     emit completed();
 }
@@ -16,6 +16,8 @@
 #include <QObject>
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 #include "NLPacketList.h"
 
@@ -48,7 +50,8 @@ public:
     // Get the number of packets that were used to send this message
     qint64 getNumPackets() const { return _numPackets; }
 
-    qint64 getSize() const { return _data.size(); }
+    // includes data already handed out by takeReceivedData
+    qint64 getSize() const { return _bytesTaken + _data.size(); }
 
     qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
 
@@ -74,6 +77,12 @@ public:
     // exceed that of the ReceivedMessage.
     QByteArray readWithoutCopy(qint64 size);
 
+    // Streaming read for a message delivered while still pending: returns everything received past the read
+    // position and drops it from the message, so a consumer that keeps up holds only what is in flight.
+    // Waits up to timeoutMsecs when nothing is available; an empty result means the message is complete
+    // (or failed) and has been fully taken, or that nothing arrived in time.
+    QByteArray takeReceivedData(unsigned long timeoutMsecs);
+
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
 
@@ -91,6 +100,7 @@ private:
     QByteArray _headData;
 
     std::atomic<qint64> _position { 0 };
+    std::atomic<qint64> _bytesTaken { 0 };
     std::atomic<qint64> _numPackets { 0 };
 
     NLPacket::LocalID _sourceID { NLPacket::NULL_LOCAL_ID };
@@ -100,6 +110,10 @@ private:
 
     std::atomic<bool> _isComplete { true };  
     std::atomic<bool> _failed { false };
+
+    // guards _data against appendPacket while takeReceivedData is streaming it out
+    std::mutex _dataMutex;
+    std::condition_variable _dataReceived;
 };
 
 Q_DECLARE_METATYPE(ReceivedMessage*)
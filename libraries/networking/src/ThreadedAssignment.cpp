@@ -14,10 +14,14 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QRunnable>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTimer>
 
+#include <Gzip.h>
 #include <LogHandler.h>
+#include <Trace.h>
 
 #include "NetworkLogging.h"
 
@@ -37,6 +41,34 @@ ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     // if the NL tells us we got a DS response, clear our member variable of queued check-ins
     auto nodeList = DependencyManager::get<NodeList>();
     connect(nodeList.data(), &NodeList::receivedDomainServerList, this, &ThreadedAssignment::clearQueuedCheckIns);
+
+    // the domain-server asks for a trace snapshot when one is downloaded from its web interface
+    nodeList->getPacketReceiver().registerListener(PacketType::TraceRequest, this, "handleTraceRequest");
+}
+
+// Writing out a full set of trace buffers takes a while, so the snapshot is built off the assignment's thread.
+class TraceSnapshotTask : public QRunnable {
+public:
+    void run() override {
+        auto tracer = DependencyManager::get<tracing::Tracer>();
+        QByteArray snapshot;
+        if (tracer) {
+            gzip(tracer->toJson(), snapshot);
+        }
+        DependencyManager::get<NodeList>()->sendTraceSnapshotToDomainServer(snapshot);
+    }
+};
+
+void ThreadedAssignment::handleTraceRequest(QSharedPointer<ReceivedMessage> message) {
+    // TraceRequest isn't sourced, make sure it came from our domain-server before we send it what we've been doing
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (message->getSenderSockAddr() != nodeList->getDomainHandler().getSockAddr()) {
+        qCWarning(networking) << "Ignoring a TraceRequest from" << message->getSenderSockAddr() << "- it is not the domain-server";
+        return;
+    }
+
+    qCDebug(networking) << "Sending a trace snapshot to the domain-server";
+    QThreadPool::globalInstance()->start(new TraceSnapshotTask());
 }
 
 void ThreadedAssignment::setFinished(bool isFinished) {
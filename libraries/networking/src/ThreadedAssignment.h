@@ -54,6 +54,7 @@ protected slots:
 
 private slots:
     void checkInWithDomainServerOrExit();
+    void handleTraceRequest(QSharedPointer<ReceivedMessage> message);
 };
 
 typedef QSharedPointer<ThreadedAssignment> SharedAssignmentPointer;
@@ -27,7 +27,9 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::StunResponse:
             return 17;
         case PacketType::DomainList:
-            return static_cast<PacketVersion>(DomainListVersion::AuthenticationOptional);
+            return static_cast<PacketVersion>(DomainListVersion::DeltaEncoded);
+        case PacketType::DomainListRequest:
+            return static_cast<PacketVersion>(DomainListRequestVersion::AcknowledgesListVersion);
         case PacketType::EntityAdd:
         case PacketType::EntityClone:
         case PacketType::EntityEdit:
@@ -35,15 +37,16 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::EntityPhysics:
             return static_cast<PacketVersion>(EntityVersion::LAST_PACKET_TYPE);
         case PacketType::EntityQuery:
-            return static_cast<PacketVersion>(EntityQueryPacketVersion::ConicalFrustums);
+            return static_cast<PacketVersion>(EntityQueryPacketVersion::CompressionDictionary);
         case PacketType::AvatarIdentity:
         case PacketType::AvatarData:
             return static_cast<PacketVersion>(AvatarMixerPacketVersion::SendVerificationFailed);
         case PacketType::BulkAvatarData:
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::BulkAvatarDataRecordSizes);
         case PacketType::KillAvatar:
             return static_cast<PacketVersion>(AvatarMixerPacketVersion::SendVerificationFailed);
         case PacketType::MessagesData:
-            return static_cast<PacketVersion>(MessageDataVersion::TextOrBinaryData);
+            return static_cast<PacketVersion>(MessageDataVersion::CoalescedMessages);
         // ICE packets
         case PacketType::ICEServerPeerInformation:
             return 17;
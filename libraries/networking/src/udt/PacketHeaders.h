@@ -135,6 +135,9 @@ public:
         AudioSoloRequest,
         BulkAvatarTraitsAck,
         StopInjector,
+        EntityCompressionDictionary,
+        TraceRequest,
+        TraceSnapshot,
         NUM_PACKET_TYPE
     };
 
@@ -154,6 +157,7 @@ public:
     const static QSet<PacketTypeEnum::Value> getNonVerifiedPackets() {
         const static QSet<PacketTypeEnum::Value> NON_VERIFIED_PACKETS = QSet<PacketTypeEnum::Value>()
             << PacketTypeEnum::Value::NodeJsonStats
+            << PacketTypeEnum::Value::TraceSnapshot
             << PacketTypeEnum::Value::EntityQuery
             << PacketTypeEnum::Value::OctreeDataNack
             << PacketTypeEnum::Value::EntityEditNack
@@ -185,7 +189,8 @@ public:
             << PacketTypeEnum::Value::OctreeFileReplacement << PacketTypeEnum::Value::ReplicatedMicrophoneAudioNoEcho
             << PacketTypeEnum::Value::ReplicatedMicrophoneAudioWithEcho << PacketTypeEnum::Value::ReplicatedInjectAudio
             << PacketTypeEnum::Value::ReplicatedSilentAudioFrame << PacketTypeEnum::Value::ReplicatedAvatarIdentity
-            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData;
+            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData
+            << PacketTypeEnum::Value::TraceRequest;
         return NON_SOURCED_PACKETS;
     }
 
@@ -270,6 +275,7 @@ enum class EntityVersion : PacketVersion {
     DisableWebMedia,
     ParticleShapeType,
     ParticleShapeTypeDeadlockFix,
+    PolyVoxVoxelDataDeltas,
 
     // Add new versions above here
     NUM_PACKET_TYPE,
@@ -287,7 +293,8 @@ enum class EntityQueryPacketVersion: PacketVersion {
     ConnectionIdentifier = 20,
     RemovedJurisdictions = 21,
     MultiFrustumQuery = 22,
-    ConicalFrustums = 23
+    ConicalFrustums = 23,
+    CompressionDictionary = 24
 };
 
 enum class AssetServerPacketVersion: PacketVersion {
@@ -334,7 +341,8 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     SendMaxTranslationDimension,
     FBXJointOrderChange,
     HandControllerSection,
-    SendVerificationFailed
+    SendVerificationFailed,
+    BulkAvatarDataRecordSizes
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
@@ -362,7 +370,13 @@ enum class DomainListVersion : PacketVersion {
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
     GetMachineFingerprintFromUUIDSupport,
-    AuthenticationOptional
+    AuthenticationOptional,
+    DeltaEncoded
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreDeltaEncodedList = 22,
+    AcknowledgesListVersion
 };
 
 enum class AudioVersion : PacketVersion {
@@ -377,7 +391,8 @@ enum class AudioVersion : PacketVersion {
 };
 
 enum class MessageDataVersion : PacketVersion {
-    TextOrBinaryData = 18
+    TextOrBinaryData = 18,
+    CoalescedMessages
 };
 
 enum class IcePingVersion : PacketVersion {
@@ -0,0 +1,316 @@
+//
+//  OctreeCompressionDictionary.cpp
+//  libraries/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeCompressionDictionary.h"
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <QtCore/QtEndian>
+
+#include <zlib.h>
+
+#include "OctreeLogging.h"
+
+// qCompress() writes the uncompressed size in front of the zlib stream
+static const int SIZE_HEADER_BYTES = sizeof(quint32);
+static const quint32 MAX_UNCOMPRESSED_SIZE = 1024 * 1024;
+static const unsigned char ZLIB_FDICT_FLAG = 0x20;
+
+namespace {
+
+// deflate state is a few hundred KB, keep one per thread and reset it between sections
+class Deflater {
+public:
+    ~Deflater() {
+        if (_initialized) {
+            deflateEnd(&_stream);
+        }
+    }
+
+    z_stream* begin(int level) {
+        if (_initialized && level != _level) {
+            deflateEnd(&_stream);
+            _initialized = false;
+        }
+        if (!_initialized) {
+            memset(&_stream, 0, sizeof(_stream));
+            if (deflateInit(&_stream, level) != Z_OK) {
+                return nullptr;
+            }
+            _initialized = true;
+            _level = level;
+        } else if (deflateReset(&_stream) != Z_OK) {
+            return nullptr;
+        }
+        return &_stream;
+    }
+
+private:
+    z_stream _stream;
+    bool _initialized { false };
+    int _level { 0 };
+};
+
+std::mutex registryMutex;
+
+// most recently used first
+std::list<OctreeCompressionDictionaryPointer>& registry() {
+    static std::list<OctreeCompressionDictionaryPointer> dictionaries;
+    return dictionaries;
+}
+
+std::list<OctreeCompressionDictionaryPointer>::iterator findInRegistry(uint32_t id) {
+    return std::find_if(registry().begin(), registry().end(), [id](const OctreeCompressionDictionaryPointer& dictionary) {
+        return dictionary->getID() == id;
+    });
+}
+
+}
+
+OctreeCompressionDictionary::OctreeCompressionDictionary(const QByteArray& data) :
+    _data(data.right(MAX_SIZE))
+{
+    uLong adler = adler32(0L, Z_NULL, 0);
+    _id = (uint32_t)adler32(adler, (const Bytef*)_data.constData(), (uInt)_data.size());
+}
+
+QByteArray OctreeCompressionDictionary::compress(const unsigned char* data, int length, int level) const {
+    static thread_local Deflater deflater;
+
+    z_stream* stream = deflater.begin(level);
+    if (!stream || deflateSetDictionary(stream, (const Bytef*)_data.constData(), (uInt)_data.size()) != Z_OK) {
+        return QByteArray();
+    }
+
+    uLong bound = deflateBound(stream, (uLong)length);
+    QByteArray result(SIZE_HEADER_BYTES + (int)bound, Qt::Uninitialized);
+    qToBigEndian<quint32>((quint32)length, (uchar*)result.data());
+
+    stream->next_in = const_cast<Bytef*>(data);
+    stream->avail_in = (uInt)length;
+    stream->next_out = (Bytef*)result.data() + SIZE_HEADER_BYTES;
+    stream->avail_out = (uInt)bound;
+
+    if (deflate(stream, Z_FINISH) != Z_STREAM_END) {
+        return QByteArray();
+    }
+    result.resize(SIZE_HEADER_BYTES + (int)stream->total_out);
+    return result;
+}
+
+bool OctreeCompressionDictionary::usesDictionary(const unsigned char* data, int length) {
+    // the second byte of the zlib header holds the FDICT flag
+    return length > SIZE_HEADER_BYTES + 1 && (data[SIZE_HEADER_BYTES + 1] & ZLIB_FDICT_FLAG);
+}
+
+QByteArray OctreeCompressionDictionary::uncompress(const unsigned char* data, int length) {
+    if (length <= SIZE_HEADER_BYTES) {
+        return QByteArray();
+    }
+    quint32 expectedSize = qFromBigEndian<quint32>(data);
+    if (expectedSize == 0 || expectedSize > MAX_UNCOMPRESSED_SIZE) {
+        return QByteArray();
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit(&stream) != Z_OK) {
+        return QByteArray();
+    }
+
+    QByteArray result((int)expectedSize, Qt::Uninitialized);
+    stream.next_in = const_cast<Bytef*>(data + SIZE_HEADER_BYTES);
+    stream.avail_in = (uInt)(length - SIZE_HEADER_BYTES);
+    stream.next_out = (Bytef*)result.data();
+    stream.avail_out = (uInt)expectedSize;
+
+    int status = inflate(&stream, Z_FINISH);
+    if (status == Z_NEED_DICT) {
+        // zlib leaves the ID of the dictionary it wants in adler
+        auto dictionary = find((uint32_t)stream.adler);
+        if (dictionary) {
+            status = inflateSetDictionary(&stream, (const Bytef*)dictionary->_data.constData(),
+                                          (uInt)dictionary->_data.size());
+            if (status == Z_OK) {
+                status = inflate(&stream, Z_FINISH);
+            }
+        } else {
+            qCDebug(octree) << "OctreeCompressionDictionary::uncompress -- unknown dictionary" << (uint32_t)stream.adler;
+        }
+    }
+
+    // a section that holds less than its header claims is as broken as one that holds more
+    bool success = (status == Z_STREAM_END && stream.total_out == expectedSize);
+    result.resize((int)stream.total_out);
+    inflateEnd(&stream);
+
+    return success ? result : QByteArray();
+}
+
+OctreeCompressionDictionaryPointer OctreeCompressionDictionary::train(const std::vector<QByteArray>& samples, int size) {
+    const int KMER_LENGTH = sizeof(uint64_t);
+    const int SEGMENT_LENGTH = 64;
+    const int SEGMENT_STRIDE = SEGMENT_LENGTH / 2;
+    const size_t MIN_SAMPLES = 8;
+
+    size = std::min(size, (int)MAX_SIZE);
+    if (size <= 0 || samples.size() < MIN_SAMPLES) {
+        return OctreeCompressionDictionaryPointer();
+    }
+
+    auto kmerAt = [](const char* data) {
+        uint64_t kmer;
+        memcpy(&kmer, data, sizeof(kmer));
+        return kmer;
+    };
+
+    // count the samples each k-mer appears in, one that only shows up in a single sample isn't worth dictionary bytes
+    std::unordered_map<uint64_t, int> frequencies;
+    for (const auto& sample : samples) {
+        std::unordered_set<uint64_t> seen;
+        for (int i = 0; i + KMER_LENGTH <= sample.size(); ++i) {
+            uint64_t kmer = kmerAt(sample.constData() + i);
+            if (seen.insert(kmer).second) {
+                frequencies[kmer]++;
+            }
+        }
+    }
+
+    struct Segment {
+        int score;
+        int sample;
+        int offset;
+        int length;
+    };
+
+    auto scoreSegment = [&](const Segment& segment) {
+        int score = 0;
+        const char* data = samples[segment.sample].constData() + segment.offset;
+        for (int i = 0; i + KMER_LENGTH <= segment.length; ++i) {
+            auto it = frequencies.find(kmerAt(data + i));
+            if (it != frequencies.end() && it->second > 1) {
+                score += it->second;
+            }
+        }
+        return score;
+    };
+
+    auto lowerScore = [](const Segment& a, const Segment& b) { return a.score < b.score; };
+    std::priority_queue<Segment, std::vector<Segment>, decltype(lowerScore)> candidates(lowerScore);
+    for (int sample = 0; sample < (int)samples.size(); ++sample) {
+        int sampleSize = samples[sample].size();
+        for (int offset = 0; offset + KMER_LENGTH <= sampleSize; offset += SEGMENT_STRIDE) {
+            Segment segment { 0, sample, offset, std::min(SEGMENT_LENGTH, sampleSize - offset) };
+            segment.score = scoreSegment(segment);
+            if (segment.score > 0) {
+                candidates.push(segment);
+            }
+        }
+    }
+
+    // Take the best segment, then forget its k-mers so segments repeating it lose their value. Scores only ever go
+    // down, so a candidate whose score is still current when it reaches the top is the best one left.
+    std::vector<Segment> selected;
+    int selectedBytes = 0;
+    while (!candidates.empty() && selectedBytes < size) {
+        Segment best = candidates.top();
+        candidates.pop();
+
+        int score = scoreSegment(best);
+        if (score <= 0) {
+            continue;
+        }
+        if (score < best.score) {
+            best.score = score;
+            candidates.push(best);
+            continue;
+        }
+
+        best.length = std::min(best.length, size - selectedBytes);
+        selected.push_back(best);
+        selectedBytes += best.length;
+
+        const char* data = samples[best.sample].constData() + best.offset;
+        for (int i = 0; i + KMER_LENGTH <= best.length; ++i) {
+            frequencies.erase(kmerAt(data + i));
+        }
+    }
+
+    if (selected.empty()) {
+        return OctreeCompressionDictionaryPointer();
+    }
+
+    // the end of the dictionary is the cheapest to reference, so the most valuable segments go last
+    QByteArray data;
+    data.reserve(selectedBytes);
+    for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+        data.append(samples[it->sample].constData() + it->offset, it->length);
+    }
+    return std::make_shared<OctreeCompressionDictionary>(data);
+}
+
+void OctreeCompressionDictionary::registerDictionary(OctreeCompressionDictionaryPointer dictionary) {
+    if (!dictionary) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = findInRegistry(dictionary->getID());
+    if (it != registry().end()) {
+        registry().erase(it);
+    }
+    registry().push_front(dictionary);
+
+    // a sender that asks for an evicted dictionary falls back to plain compression, so dropping the least recently
+    // used ones is safe and keeps retrained or stale server dictionaries from piling up
+    while (registry().size() > (size_t)MAX_REGISTERED_DICTIONARIES) {
+        registry().pop_back();
+    }
+}
+
+OctreeCompressionDictionaryPointer OctreeCompressionDictionary::find(uint32_t id) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = findInRegistry(id);
+    if (it == registry().end()) {
+        return OctreeCompressionDictionaryPointer();
+    }
+    registry().splice(registry().begin(), registry(), it);
+    return registry().front();
+}
+
+int OctreeCompressionDictionary::getRegisteredCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return (int)registry().size();
+}
+
+QByteArray OctreeCompressionDictionary::toByteArray() const {
+    QByteArray buffer;
+    buffer.append(reinterpret_cast<const char*>(&_id), sizeof(_id));
+    buffer.append(_data);
+    return buffer;
+}
+
+OctreeCompressionDictionaryPointer OctreeCompressionDictionary::fromByteArray(const QByteArray& buffer) {
+    uint32_t id;
+    if (buffer.size() <= (int)sizeof(id)) {
+        return OctreeCompressionDictionaryPointer();
+    }
+    memcpy(&id, buffer.constData(), sizeof(id));
+    auto dictionary = std::make_shared<OctreeCompressionDictionary>(buffer.mid(sizeof(id)));
+    if (dictionary->getID() != id) {
+        qCWarning(octree) << "OctreeCompressionDictionary::fromByteArray -- dictionary doesn't match its ID" << id;
+        return OctreeCompressionDictionaryPointer();
+    }
+    return dictionary;
+}
@@ -0,0 +1,61 @@
+//
+//  OctreeCompressionDictionary.h
+//  libraries/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeCompressionDictionary_h
+#define hifi_OctreeCompressionDictionary_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+class OctreeCompressionDictionary;
+using OctreeCompressionDictionaryPointer = std::shared_ptr<const OctreeCompressionDictionary>;
+
+/// A zlib preset dictionary for octree packet sections. Sections compressed with a dictionary keep the qCompress()
+/// framing, and the zlib stream names its dictionary by ID, so a receiver only needs the dictionary in its registry.
+/// The ID is the adler32 of the dictionary bytes, which is what zlib writes into the stream.
+class OctreeCompressionDictionary {
+public:
+    static const int DEFAULT_SIZE = 16 * 1024;
+    static const int MAX_SIZE = 32 * 1024; // the deflate window, anything older than this is never referenced
+    static const int MAX_REGISTERED_DICTIONARIES = 8; // the least recently used ones are evicted past this
+
+    OctreeCompressionDictionary(const QByteArray& data);
+
+    uint32_t getID() const { return _id; }
+    const QByteArray& getData() const { return _data; }
+
+    /// the same framing as qCompress(): the big-endian uncompressed size followed by the zlib stream
+    QByteArray compress(const unsigned char* data, int length, int level) const;
+
+    /// decodes a compressed section, looking the dictionary up in the registry when the stream asks for one
+    static QByteArray uncompress(const unsigned char* data, int length);
+
+    /// true when the compressed section was made with a preset dictionary
+    static bool usesDictionary(const unsigned char* data, int length);
+
+    /// builds a dictionary out of the substrings that are common to many of the samples
+    static OctreeCompressionDictionaryPointer train(const std::vector<QByteArray>& samples, int size = DEFAULT_SIZE);
+
+    static void registerDictionary(OctreeCompressionDictionaryPointer dictionary);
+    static OctreeCompressionDictionaryPointer find(uint32_t id);
+    static int getRegisteredCount();
+
+    // wire format of PacketType::EntityCompressionDictionary
+    QByteArray toByteArray() const;
+    static OctreeCompressionDictionaryPointer fromByteArray(const QByteArray& buffer);
+
+private:
+    QByteArray _data;
+    uint32_t _id { 0 };
+};
+
+#endif // hifi_OctreeCompressionDictionary_h
@@ -12,6 +12,7 @@
 #include "OctreeEditPacketSender.h"
 
 #include <assert.h>
+#include <algorithm>
 
 #include <PerfStat.h>
 
@@ -20,6 +21,7 @@
 #include "OctreeLogging.h"
 
 const int OctreeEditPacketSender::DEFAULT_MAX_PENDING_MESSAGES = PacketSender::DEFAULT_PACKETS_PER_SECOND;
+const int OctreeEditPacketSender::MAX_ADDS_PER_PACKET_LIST = 100;
 
 
 OctreeEditPacketSender::OctreeEditPacketSender() :
@@ -247,6 +249,52 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
 
 }
 
+void OctreeEditPacketSender::queueOctreeEditMessages(PacketType type, std::vector<QByteArray>& editMessages) {
+    if (type != PacketType::EntityAdd || !serversExist()) {
+        // edits are already packed together into the pending edit packet
+        for (auto& editMessage : editMessages) {
+            queueOctreeEditMessage(type, editMessage);
+        }
+        return;
+    }
+
+    _packetsQueueLock.lock();
+
+    auto node = DependencyManager::get<NodeList>()->soloNodeOfType(getMyNodeType());
+    if (node && node->getActiveSocket()) {
+        QUuid nodeUUID = node->getUUID();
+        auto nodeClockSkew = node->getClockSkewUsec();
+        auto& sentPacketHistory = _sentPacketHistories[nodeUUID];
+
+        size_t numMessages = editMessages.size();
+        for (size_t i = 0; i < numMessages; i += MAX_ADDS_PER_PACKET_LIST) {
+            auto newPacket = NLPacketList::create(type, QByteArray(), true, true);
+
+            // pack sequence number
+            quint16 sequence = _outgoingSequenceNumbers[nodeUUID]++;
+            newPacket->writePrimitive(sequence);
+
+            // pack in timestamp
+            quint64 now = usecTimestampNow() + nodeClockSkew;
+            newPacket->writePrimitive(now);
+
+            // the entity-server reads edit messages until it reaches the end of the list
+            size_t end = std::min(numMessages, i + MAX_ADDS_PER_PACKET_LIST);
+            for (size_t j = i; j < end; ++j) {
+                if (nodeClockSkew != 0) {
+                    adjustEditPacketForClockSkew(type, editMessages[j], nodeClockSkew);
+                }
+                newPacket->write(editMessages[j]);
+            }
+
+            releaseQueuedPacketList(nodeUUID, std::move(newPacket));
+            sentPacketHistory.untrackedPacketSent(sequence);
+        }
+    }
+
+    _packetsQueueLock.unlock();
+}
+
 void OctreeEditPacketSender::releaseQueuedMessages() {
     // if we don't yet have servers then we can't actually release messages yet because we don't
     // know where to send them to. Instead, just remember this request and when we eventually get servers
@@ -31,6 +31,12 @@ public:
     /// MaxPendingMessages will be buffered and processed when servers are known.
     void queueOctreeEditMessage(PacketType type, QByteArray& editMessage);
 
+    /// Queues several edit messages of the same type. Adds, which otherwise go out in a reliable packet list each, share
+    /// reliable packet lists of up to MAX_ADDS_PER_PACKET_LIST messages.
+    void queueOctreeEditMessages(PacketType type, std::vector<QByteArray>& editMessages);
+
+    static const int MAX_ADDS_PER_PACKET_LIST;
+
     /// Releases all queued messages even if those messages haven't filled an MTU packet. This will move the packed message
     /// packets onto the send queue. If running in threaded mode, the caller does not need to do any further processing to
     /// have these packets get sent. If running in non-threaded mode, the caller must still call process() on a regular
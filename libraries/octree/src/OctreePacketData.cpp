@@ -590,6 +590,8 @@ bool OctreePacketData::appendRawData(QByteArray data) {
 
 AtomicUIntStat OctreePacketData::_compressContentTime { 0 };
 AtomicUIntStat OctreePacketData::_compressContentCalls { 0 };
+AtomicUIntStat OctreePacketData::_compressedInputBytes { 0 };
+AtomicUIntStat OctreePacketData::_compressedOutputBytes { 0 };
 
 bool OctreePacketData::compressContent() {
     PerformanceWarning warn(false, "OctreePacketData::compressContent()", false, &_compressContentTime, &_compressContentCalls);
@@ -605,10 +607,18 @@ bool OctreePacketData::compressContent() {
     const uchar* uncompressedData = &_uncompressed[0];
     int uncompressedSize = _bytesInUse;
 
-    QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+    QByteArray compressedData;
+    if (_compressionDictionary) {
+        compressedData = _compressionDictionary->compress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+    }
+    if (compressedData.isEmpty()) {
+        compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+    }
 
     if (compressedData.size() < _compressedByteArray.size()) {
         _compressedBytes = compressedData.size();
+        _compressedInputBytes += uncompressedSize;
+        _compressedOutputBytes += _compressedBytes;
         memcpy(_compressed, compressedData.constData(), _compressedBytes);
         _dirty = false;
         success = true;
@@ -629,11 +639,16 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
             _compressedBytes = length;
             memcpy(_compressed, data, _compressedBytes);
 
-            QByteArray compressedData;
-            compressedData.resize(_compressedBytes);
-            memcpy(compressedData.data(), data, _compressedBytes);
+            QByteArray uncompressedData;
+            if (OctreeCompressionDictionary::usesDictionary(data, length)) {
+                uncompressedData = OctreeCompressionDictionary::uncompress(data, length);
+            } else {
+                QByteArray compressedData;
+                compressedData.resize(_compressedBytes);
+                memcpy(compressedData.data(), data, _compressedBytes);
 
-            QByteArray uncompressedData = qUncompress(compressedData);
+                uncompressedData = qUncompress(compressedData);
+            }
             if (uncompressedData.size() > _bytesAvailable) {
                 int moreNeeded = uncompressedData.size() - _bytesAvailable;
                 _uncompressedByteArray.resize(_uncompressedByteArray.size() + moreNeeded);
@@ -23,6 +23,7 @@
 #define hifi_OctreePacketData_h
 
 #include <atomic>
+#include <vector>
 
 #include <QByteArray>
 #include <QString>
@@ -41,6 +42,7 @@
 #include "PulseMode.h"
 #include "GizmoType.h"
 
+#include "OctreeCompressionDictionary.h"
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
 
@@ -239,6 +241,10 @@ public:
     
     /// returns whether or not zlib compression enabled on finalization
     bool isCompressed() const { return _enableCompression; }
+
+    /// preset dictionary used when compressing, the receiver must have registered the same dictionary
+    void setCompressionDictionary(OctreeCompressionDictionaryPointer dictionary) { _compressionDictionary = dictionary; _dirty = true; }
+    OctreeCompressionDictionaryPointer getCompressionDictionary() const { return _compressionDictionary; }
     
     /// returns the target uncompressed size
     unsigned int getTargetSize() const { return _targetSize; }
@@ -248,12 +254,30 @@ public:
 
     int getBytesAvailable() { return _bytesAvailable; }
 
+    /// a byte range of the uncompressed stream, tagged by the caller (e.g. with the entity property it holds)
+    class TaggedRange {
+    public:
+        int tag;
+        int offset;
+        int length;
+    };
+
+    /// when set, every level closed through tagRange() is recorded into ranges, until cleared with nullptr
+    void setTaggedRanges(std::vector<TaggedRange>* ranges) { _taggedRanges = ranges; }
+    void tagRange(int tag, const LevelDetails& level) {
+        if (_taggedRanges) {
+            _taggedRanges->push_back({ tag, level._startIndex, _bytesInUse - level._startIndex });
+        }
+    }
+
     /// displays contents for debugging
     void debugContent();
     void debugBytes();
     
     static quint64 getCompressContentTime() { return _compressContentTime; } /// total time spent compressing content
     static quint64 getCompressContentCalls() { return _compressContentCalls; } /// total calls to compress content
+    static quint64 getCompressedInputBytes() { return _compressedInputBytes; } /// total bytes given to compress content
+    static quint64 getCompressedOutputBytes() { return _compressedOutputBytes; } /// total bytes out of compress content
     static quint64 getTotalBytesOfOctalCodes() { return _totalBytesOfOctalCodes; }  /// total bytes for octal codes
     static quint64 getTotalBytesOfBitMasks() { return _totalBytesOfBitMasks; }  /// total bytes of bitmasks
     static quint64 getTotalBytesOfColor() { return _totalBytesOfColor; } /// total bytes of color
@@ -304,6 +328,9 @@ private:
     int _bytesReserved;
     int _subTreeBytesReserved; // the number of reserved bytes at start of a subtree
 
+    std::vector<TaggedRange>* _taggedRanges { nullptr };
+    OctreeCompressionDictionaryPointer _compressionDictionary;
+
     bool compressContent();
     
     QByteArray _compressedByteArray;
@@ -326,6 +353,8 @@ private:
 
     static AtomicUIntStat _compressContentTime;
     static AtomicUIntStat _compressContentCalls;
+    static AtomicUIntStat _compressedInputBytes;
+    static AtomicUIntStat _compressedOutputBytes;
 
     static AtomicUIntStat _totalBytesOfOctalCodes;
     static AtomicUIntStat _totalBytesOfBitMasks;
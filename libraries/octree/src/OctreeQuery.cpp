@@ -83,9 +83,15 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
 
     OctreeQueryFlags queryFlags { NoFlags };
     queryFlags |= (_reportInitialCompletion ? OctreeQuery::WantInitialCompletion : 0);
+    queryFlags |= (_wantCompressionDictionary ? OctreeQuery::WantCompressionDictionary : 0);
     memcpy(destinationBuffer, &queryFlags, sizeof(queryFlags));
     destinationBuffer += sizeof(queryFlags);
 
+    // the compression dictionary we hold, if any
+    uint32_t compressionDictionaryID = _compressionDictionaryID;
+    memcpy(destinationBuffer, &compressionDictionaryID, sizeof(compressionDictionaryID));
+    destinationBuffer += sizeof(compressionDictionaryID);
+
     return destinationBuffer - bufferStart;
 }
 
@@ -165,6 +171,12 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
     sourceBuffer += sizeof(queryFlags);
 
     _reportInitialCompletion = bool(queryFlags & OctreeQueryFlags::WantInitialCompletion);
+    _wantCompressionDictionary = bool(queryFlags & OctreeQueryFlags::WantCompressionDictionary);
+
+    uint32_t compressionDictionaryID;
+    memcpy(&compressionDictionaryID, sourceBuffer, sizeof(compressionDictionaryID));
+    sourceBuffer += sizeof(compressionDictionaryID);
+    _compressionDictionaryID = compressionDictionaryID;
 
     return sourceBuffer - startPosition;
 }
@@ -12,6 +12,8 @@
 #ifndef hifi_OctreeQuery_h
 #define hifi_OctreeQuery_h
 
+#include <atomic>
+
 #include <QtCore/QJsonObject>
 #include <QtCore/QReadWriteLock>
 
@@ -56,6 +58,13 @@ public:
     bool wantReportInitialCompletion() const { return _reportInitialCompletion; }
     void setReportInitialCompletion(bool reportInitialCompletion) { _reportInitialCompletion = reportInitialCompletion; }
 
+    // Compression dictionary negotiation: the client says it can take a dictionary and which one it holds, the server
+    // sends it one and only compresses with it once the client reports having it.
+    bool wantCompressionDictionary() const { return _wantCompressionDictionary; }
+    void setWantCompressionDictionary(bool wantCompressionDictionary) { _wantCompressionDictionary = wantCompressionDictionary; }
+    uint32_t getCompressionDictionaryID() const { return _compressionDictionaryID; }
+    void setCompressionDictionaryID(uint32_t compressionDictionaryID) { _compressionDictionaryID = compressionDictionaryID; }
+
 signals:
     void incomingConnectionIDChanged();
 
@@ -78,11 +87,13 @@ protected:
     QJsonObject _jsonParameters;
     QReadWriteLock _jsonParametersLock;
     
-    enum OctreeQueryFlags : uint16_t { NoFlags = 0x0, WantInitialCompletion = 0x1 };
+    enum OctreeQueryFlags : uint16_t { NoFlags = 0x0, WantInitialCompletion = 0x1, WantCompressionDictionary = 0x2 };
     friend OctreeQuery::OctreeQueryFlags operator|=(OctreeQuery::OctreeQueryFlags& lhs, const int rhs);
 
     bool _hasReceivedFirstQuery { false };
     bool _reportInitialCompletion { false };
+    std::atomic<bool> _wantCompressionDictionary { false };
+    std::atomic<uint32_t> _compressionDictionaryID { 0 };
 };
 
 #endif // hifi_OctreeQuery_h
@@ -70,6 +70,7 @@ void PhysicalEntitySimulation::removeEntityInternal(EntityItemPointer entity) {
     if (entity->isSimulated()) {
         EntitySimulation::removeEntityInternal(entity);
         _entitiesToAddToPhysics.remove(entity);
+        _shapeRequests.remove(entity);
 
         EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
         if (motionState) {
@@ -173,6 +174,7 @@ void PhysicalEntitySimulation::changeEntityInternal(EntityItemPointer entity) {
         // The intent is for this object to be in the PhysicsEngine, but it has no MotionState yet.
         // Perhaps it's shape has changed and it can now be added?
         _entitiesToAddToPhysics.insert(entity);
+        _shapeRequests.remove(entity);
         SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
         if (itr != _simpleKinematicEntities.end()) {
             _simpleKinematicEntities.erase(itr);
@@ -214,6 +216,7 @@ void PhysicalEntitySimulation::clearEntitiesInternal() {
     // clear all other lists specific to this derived class
     _entitiesToRemoveFromPhysics.clear();
     _entitiesToAddToPhysics.clear();
+    _shapeRequests.clear();
     _incomingChanges.clear();
 }
 
@@ -265,15 +268,18 @@ void PhysicalEntitySimulation::deleteObjectsRemovedFromPhysics() {
 void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& result) {
     result.clear();
     QMutexLocker lock(&_mutex);
+    ShapeManager* shapeManager = ObjectMotionState::getShapeManager();
     SetOfEntities::iterator entityItr = _entitiesToAddToPhysics.begin();
     while (entityItr != _entitiesToAddToPhysics.end()) {
         EntityItemPointer entity = (*entityItr);
         assert(!entity->getPhysicsInfo());
         if (entity->isDead()) {
             prepareEntityForDelete(entity);
+            _shapeRequests.remove(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
         } else if (!entity->shouldBePhysical()) {
             // this entity should no longer be on the internal _entitiesToAddToPhysics
+            _shapeRequests.remove(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
             if (entity->isMovingRelativeToParent()) {
                 SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
@@ -281,23 +287,39 @@ void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& re
                     _simpleKinematicEntities.insert(entity);
                 }
             }
-        } else if (entity->isReadyToComputeShape()) {
-            ShapeInfo shapeInfo;
-            entity->computeShapeInfo(shapeInfo);
-            int numPoints = shapeInfo.getLargestSubshapePointCount();
-            if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
-                if (numPoints > MAX_HULL_POINTS) {
-                    qWarning() << "convex hull with" << numPoints
-                        << "points for entity" << entity->getName()
-                        << "at" << entity->getWorldPosition() << " will be reduced";
+        } else if (_shapeRequests.contains(entity) || entity->isReadyToComputeShape()) {
+            const btCollisionShape* shape = nullptr;
+            auto requestItr = _shapeRequests.find(entity);
+            if (requestItr != _shapeRequests.end()) {
+                // the shape is being built on a worker thread, don't compute its ShapeInfo again
+                uint64_t key = requestItr.value();
+                shape = shapeManager->getShapeByKey(key);
+                if (!shape && !shapeManager->isBuildingShape(key)) {
+                    // the build failed or the shape was collected before we got to it: start over
+                    _shapeRequests.erase(requestItr);
+                }
+            } else {
+                ShapeInfo shapeInfo;
+                entity->computeShapeInfo(shapeInfo);
+                int numPoints = shapeInfo.getLargestSubshapePointCount();
+                if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
+                    if (numPoints > MAX_HULL_POINTS) {
+                        qWarning() << "convex hull with" << numPoints
+                            << "points for entity" << entity->getName()
+                            << "at" << entity->getWorldPosition() << " will be reduced";
+                    }
+                }
+                shape = shapeManager->requestShape(shapeInfo);
+                if (!shape && shapeManager->isBuildingShape(shapeInfo.getHash())) {
+                    _shapeRequests.insert(entity, shapeInfo.getHash());
                 }
             }
-            btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
             if (shape) {
-                EntityMotionState* motionState = new EntityMotionState(shape, entity);
+                EntityMotionState* motionState = new EntityMotionState(const_cast<btCollisionShape*>(shape), entity);
                 entity->setPhysicsInfo(static_cast<void*>(motionState));
                 _physicalObjects.insert(motionState);
                 result.push_back(motionState);
+                _shapeRequests.remove(entity);
                 entityItr = _entitiesToAddToPhysics.erase(entityItr);
 
                 // make sure the motionState's region is up-to-date before it is actually added to physics
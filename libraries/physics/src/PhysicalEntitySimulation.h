@@ -99,6 +99,7 @@ public:
 
 private:
     SetOfEntities _entitiesToAddToPhysics;
+    QHash<EntityItemPointer, uint64_t> _shapeRequests; // keys of shapes being built for entities in _entitiesToAddToPhysics
     SetOfEntities _entitiesToRemoveFromPhysics;
 
     VectorOfMotionStates _objectsToDelete;
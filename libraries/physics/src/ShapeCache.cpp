@@ -0,0 +1,453 @@
+//
+//  ShapeCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ShapeCache.h"
+
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+
+#include <NumericalConstants.h>
+
+#include "PhysicsLogging.h"
+#include "ShapeFactory.h"
+
+const std::string ShapeCache::DIRNAME { "shape_cache" };
+const size_t ShapeCache::DEFAULT_SHAPE_CACHE_SIZE { MB_TO_BYTES(512) };
+
+static const std::string SHAPE_CACHE_EXTENSION = "shape";
+
+// bump this when the layout of a cached shape changes, entries with another version are treated as misses
+static const uint32_t SHAPE_CACHE_VERSION = 1;
+static const uint32_t SHAPE_CACHE_MAGIC = 0x50414853; // "SHAP", reads differently on a machine of the other endianness
+
+// vertices, triangles and the BVH are used in place, so they start on boundaries that suit Bullet's SIMD loads
+static const size_t DATA_ALIGNMENT = 16;
+
+// deeper than any shape the ShapeFactory builds, guards against recursing through a corrupted entry
+static const int MAX_SHAPE_DEPTH = 4;
+
+struct ShapeCacheHeader {
+    uint32_t magic { SHAPE_CACHE_MAGIC };
+    uint32_t version { SHAPE_CACHE_VERSION };
+    uint32_t bulletVersion { BT_BULLET_VERSION };
+    uint32_t scalarSize { sizeof(btScalar) };
+    uint64_t hash { 0 };
+    uint32_t shapeType { 0 };
+    uint32_t padding { 0 };
+};
+
+enum class ShapeNode : uint32_t {
+    Hull = 1,
+    Compound,
+    StaticMesh
+};
+
+class MappedShapeFile {
+public:
+    MappedShapeFile(const cache::FilePointer& file) : _file(file), _qFile(QString::fromStdString(file->getFilepath())) {
+        if (_qFile.open(QIODevice::ReadOnly)) {
+            _size = (size_t)_qFile.size();
+            // the BVH is fixed up when it is deserialized in place, so map the pages copy-on-write
+            _data = _qFile.map(0, _size, QFileDevice::MapPrivateOption);
+        }
+    }
+
+    ~MappedShapeFile() {
+        if (_data) {
+            _qFile.unmap(_data);
+        }
+    }
+
+    uchar* getData() const { return _data; }
+    size_t getSize() const { return _data ? _size : 0; }
+
+private:
+    // holding the cache entry keeps it from being evicted while the mapping is in use
+    cache::FilePointer _file;
+    QFile _qFile;
+    uchar* _data { nullptr };
+    size_t _size { 0 };
+};
+using MappedShapeFilePointer = std::shared_ptr<MappedShapeFile>;
+
+// a static mesh whose vertices, triangles and BVH live in a mapped cache entry
+class CachedStaticMeshShape : public btBvhTriangleMeshShape {
+public:
+    CachedStaticMeshShape(btTriangleIndexVertexArray* dataArray, btOptimizedBvh* bvh, const MappedShapeFilePointer& mappedFile) :
+        btBvhTriangleMeshShape(dataArray, true, false), _dataArray(dataArray), _mappedFile(mappedFile) {
+        setOptimizedBvh(bvh);
+    }
+
+    ~CachedStaticMeshShape() {
+        // the mesh data belongs to the mapping, only the array describing it is ours
+        delete _dataArray;
+        _dataArray = nullptr;
+    }
+
+private:
+    btTriangleIndexVertexArray* _dataArray;
+    MappedShapeFilePointer _mappedFile;
+};
+
+class ShapeWriter {
+public:
+    template <typename T>
+    void write(const T& value) { _data.append((const char*)&value, (int)sizeof(T)); }
+
+    char* allocate(size_t size) {
+        align();
+        int offset = _data.size();
+        _data.resize(offset + (int)size);
+        return _data.data() + offset;
+    }
+
+    void writeTransform(const btTransform& transform) {
+        for (int i = 0; i < 3; ++i) {
+            const btVector3& row = transform.getBasis().getRow(i);
+            write(row.x());
+            write(row.y());
+            write(row.z());
+        }
+        const btVector3& origin = transform.getOrigin();
+        write(origin.x());
+        write(origin.y());
+        write(origin.z());
+    }
+
+    const QByteArray& getData() const { return _data; }
+
+private:
+    void align() {
+        int padding = (int)((DATA_ALIGNMENT - (size_t)_data.size() % DATA_ALIGNMENT) % DATA_ALIGNMENT);
+        _data.append(padding, '\0');
+    }
+
+    QByteArray _data;
+};
+
+class ShapeReader {
+public:
+    ShapeReader(uchar* data, size_t size) : _data(data), _size(size) {}
+
+    template <typename T>
+    bool read(T& value) {
+        const uchar* source = take(sizeof(T), 1);
+        if (!source) {
+            return false;
+        }
+        memcpy(&value, source, sizeof(T));
+        return true;
+    }
+
+    uchar* take(size_t size, size_t alignment = DATA_ALIGNMENT) {
+        size_t offset = (_offset + alignment - 1) / alignment * alignment;
+        if (offset > _size || size > _size - offset) {
+            return nullptr;
+        }
+        _offset = offset + size;
+        return _data + offset;
+    }
+
+    bool readTransform(btTransform& transform) {
+        btScalar values[12];
+        for (int i = 0; i < 12; ++i) {
+            if (!read(values[i])) {
+                return false;
+            }
+        }
+        transform.setBasis(btMatrix3x3(values[0], values[1], values[2],
+                                       values[3], values[4], values[5],
+                                       values[6], values[7], values[8]));
+        transform.setOrigin(btVector3(values[9], values[10], values[11]));
+        return true;
+    }
+
+    bool atEnd() const { return _offset == _size; }
+
+private:
+    uchar* _data;
+    size_t _size;
+    size_t _offset { 0 };
+};
+
+static size_t getIndexSize(PHY_ScalarType indexType) {
+    return indexType == PHY_SHORT ? sizeof(int16_t) : sizeof(int32_t);
+}
+
+static bool writeShape(ShapeWriter& writer, const btCollisionShape* shape, int depth) {
+    if (!shape || depth > MAX_SHAPE_DEPTH) {
+        return false;
+    }
+    switch (shape->getShapeType()) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(shape);
+            uint32_t numPoints = (uint32_t)hull->getNumPoints();
+            writer.write(ShapeNode::Hull);
+            writer.write(hull->getMargin());
+            writer.write(numPoints);
+            const btVector3* points = hull->getUnscaledPoints();
+            for (uint32_t i = 0; i < numPoints; ++i) {
+                writer.write(points[i].x());
+                writer.write(points[i].y());
+                writer.write(points[i].z());
+            }
+            return true;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+            uint32_t numChildren = (uint32_t)compound->getNumChildShapes();
+            writer.write(ShapeNode::Compound);
+            writer.write(numChildren);
+            for (uint32_t i = 0; i < numChildren; ++i) {
+                writer.writeTransform(compound->getChildTransform(i));
+                if (!writeShape(writer, compound->getChildShape(i), depth + 1)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE: {
+            // getOptimizedBvh() isn't const, but serializing the BVH doesn't change it
+            btBvhTriangleMeshShape* meshShape = const_cast<btBvhTriangleMeshShape*>(static_cast<const btBvhTriangleMeshShape*>(shape));
+            btOptimizedBvh* bvh = meshShape->getOptimizedBvh();
+            const btStridingMeshInterface* meshInterface = meshShape->getMeshInterface();
+            if (!bvh || !meshInterface || meshInterface->getNumSubParts() != 1) {
+                return false;
+            }
+
+            const unsigned char* vertexBase { nullptr };
+            int numVertices { 0 };
+            PHY_ScalarType vertexType;
+            int vertexStride { 0 };
+            const unsigned char* indexBase { nullptr };
+            int indexStride { 0 };
+            int numTriangles { 0 };
+            PHY_ScalarType indexType;
+            meshInterface->getLockedReadOnlyVertexIndexBase(&vertexBase, numVertices, vertexType, vertexStride,
+                                                            &indexBase, indexStride, numTriangles, indexType, 0);
+            bool canWrite = vertexType == PHY_FLOAT && (indexType == PHY_SHORT || indexType == PHY_INTEGER);
+            if (canWrite) {
+                writer.write(ShapeNode::StaticMesh);
+                writer.write((uint32_t)numVertices);
+                writer.write((uint32_t)numTriangles);
+                writer.write((uint32_t)indexType);
+
+                const size_t VERTEX_SIZE = 3 * sizeof(float);
+                char* vertices = writer.allocate((size_t)numVertices * VERTEX_SIZE);
+                for (int i = 0; i < numVertices; ++i) {
+                    memcpy(vertices + i * VERTEX_SIZE, vertexBase + i * vertexStride, VERTEX_SIZE);
+                }
+
+                const size_t TRIANGLE_SIZE = 3 * getIndexSize(indexType);
+                char* triangles = writer.allocate((size_t)numTriangles * TRIANGLE_SIZE);
+                for (int i = 0; i < numTriangles; ++i) {
+                    memcpy(triangles + i * TRIANGLE_SIZE, indexBase + i * indexStride, TRIANGLE_SIZE);
+                }
+            }
+            meshInterface->unLockReadOnlyVertexBase(0);
+            if (!canWrite) {
+                return false;
+            }
+
+            // Bullet wants an aligned buffer to serialize into, which the writer's can't promise
+            uint32_t bvhSize = bvh->calculateSerializeBufferSize();
+            void* bvhBuffer = btAlignedAlloc(bvhSize, DATA_ALIGNMENT);
+            bool serialized = bvh->serializeInPlace(bvhBuffer, bvhSize, false);
+            if (serialized) {
+                writer.write(bvhSize);
+                memcpy(writer.allocate(bvhSize), bvhBuffer, bvhSize);
+            }
+            btAlignedFree(bvhBuffer);
+            return serialized;
+        }
+        default:
+            return false;
+    }
+}
+
+static btCollisionShape* readShape(ShapeReader& reader, const MappedShapeFilePointer& mappedFile, int depth) {
+    ShapeNode node;
+    if (depth > MAX_SHAPE_DEPTH || !reader.read(node)) {
+        return nullptr;
+    }
+    switch (node) {
+        case ShapeNode::Hull: {
+            btScalar margin;
+            uint32_t numPoints;
+            if (!reader.read(margin) || !reader.read(numPoints) || numPoints == 0) {
+                return nullptr;
+            }
+            const btScalar* points = (const btScalar*)reader.take((size_t)numPoints * 3 * sizeof(btScalar), 1);
+            if (!points) {
+                return nullptr;
+            }
+            // the points were already reduced and corrected for the margin when the hull was built
+            btConvexHullShape* hull = new btConvexHullShape();
+            hull->setMargin(margin);
+            for (uint32_t i = 0; i < numPoints; ++i) {
+                btScalar point[3];
+                memcpy(point, points + 3 * i, sizeof(point));
+                hull->addPoint(btVector3(point[0], point[1], point[2]), false);
+            }
+            hull->recalcLocalAabb();
+            return hull;
+        }
+        case ShapeNode::Compound: {
+            uint32_t numChildren;
+            if (!reader.read(numChildren)) {
+                return nullptr;
+            }
+            btCompoundShape* compound = new btCompoundShape();
+            for (uint32_t i = 0; i < numChildren; ++i) {
+                btTransform transform;
+                btCollisionShape* child = nullptr;
+                if (!reader.readTransform(transform) || !(child = readShape(reader, mappedFile, depth + 1))) {
+                    ShapeFactory::deleteShape(compound);
+                    return nullptr;
+                }
+                compound->addChildShape(transform, child);
+            }
+            return compound;
+        }
+        case ShapeNode::StaticMesh: {
+            uint32_t numVertices;
+            uint32_t numTriangles;
+            uint32_t indexType;
+            if (!reader.read(numVertices) || !reader.read(numTriangles) || !reader.read(indexType) ||
+                    (indexType != PHY_SHORT && indexType != PHY_INTEGER)) {
+                return nullptr;
+            }
+            const size_t VERTEX_SIZE = 3 * sizeof(float);
+            const size_t TRIANGLE_SIZE = 3 * getIndexSize((PHY_ScalarType)indexType);
+            uchar* vertices = reader.take((size_t)numVertices * VERTEX_SIZE);
+            uchar* triangles = reader.take((size_t)numTriangles * TRIANGLE_SIZE);
+            uint32_t bvhSize;
+            if (!vertices || !triangles || !reader.read(bvhSize)) {
+                return nullptr;
+            }
+            uchar* bvhData = reader.take(bvhSize);
+            btQuantizedBvh* bvh = bvhData ? btQuantizedBvh::deSerializeInPlace(bvhData, bvhSize, false) : nullptr;
+            if (!bvh) {
+                return nullptr;
+            }
+
+            btIndexedMesh mesh;
+            mesh.m_numTriangles = (int)numTriangles;
+            mesh.m_triangleIndexBase = triangles;
+            mesh.m_triangleIndexStride = (int)TRIANGLE_SIZE;
+            mesh.m_indexType = (PHY_ScalarType)indexType;
+            mesh.m_numVertices = (int)numVertices;
+            mesh.m_vertexBase = vertices;
+            mesh.m_vertexStride = (int)VERTEX_SIZE;
+            mesh.m_vertexType = PHY_FLOAT;
+            btTriangleIndexVertexArray* dataArray = new btTriangleIndexVertexArray();
+            dataArray->addIndexedMesh(mesh, mesh.m_indexType);
+
+            // the BVH was serialized from a btOptimizedBvh, which adds no data to btQuantizedBvh
+            return new CachedStaticMeshShape(dataArray, static_cast<btOptimizedBvh*>(bvh), mappedFile);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+// ShapeInfo::getHash() only samples the geometry (the url, extents and number of hulls), two models can share it.
+// Entries outlive the session and are used without rebuilding, so they are keyed on everything the shape is built from.
+static cache::FileCache::Key getKey(const ShapeInfo& info) {
+    QCryptographicHash hasher { QCryptographicHash::Sha1 };
+    auto addData = [&](const void* data, size_t size) {
+        hasher.addData((const char*)data, (int)size);
+    };
+    auto type = (uint32_t)info.getType();
+    addData(&type, sizeof(type));
+    addData(&info.getHalfExtents(), sizeof(glm::vec3));
+    addData(&info.getOffset(), sizeof(glm::vec3));
+
+    const auto& spheres = info.getSphereCollection();
+    auto numSpheres = (uint32_t)spheres.size();
+    addData(&numSpheres, sizeof(numSpheres));
+    addData(spheres.constData(), spheres.size() * sizeof(ShapeInfo::SphereData));
+
+    const auto& pointCollection = info.getPointCollection();
+    auto numPointLists = (uint32_t)pointCollection.size();
+    addData(&numPointLists, sizeof(numPointLists));
+    for (const auto& points : pointCollection) {
+        auto numPoints = (uint32_t)points.size();
+        addData(&numPoints, sizeof(numPoints));
+        addData(points.constData(), points.size() * sizeof(glm::vec3));
+    }
+
+    const auto& triangleIndices = info.getTriangleIndices();
+    auto numIndices = (uint32_t)triangleIndices.size();
+    addData(&numIndices, sizeof(numIndices));
+    addData(triangleIndices.constData(), triangleIndices.size() * sizeof(int32_t));
+
+    return hasher.result().toHex().toStdString();
+}
+
+ShapeCache::ShapeCache(const std::string& dir) :
+    FileCache(dir, SHAPE_CACHE_EXTENSION) { }
+
+const btCollisionShape* ShapeCache::loadShape(const ShapeInfo& info) {
+    auto key = getKey(info);
+    auto file = getFile(key);
+    if (!file) {
+        ++_numMisses;
+        return nullptr;
+    }
+
+    auto mappedFile = std::make_shared<MappedShapeFile>(file);
+    ShapeReader reader(mappedFile->getData(), mappedFile->getSize());
+    ShapeCacheHeader header;
+    ShapeCacheHeader currentHeader;
+    if (!reader.read(header) || header.magic != currentHeader.magic || header.version != currentHeader.version ||
+            header.bulletVersion != currentHeader.bulletVersion || header.scalarSize != currentHeader.scalarSize) {
+        // written by another version, storing the shape again will replace it
+        ++_numMisses;
+        return nullptr;
+    }
+
+    btCollisionShape* shape = nullptr;
+    if (header.hash == info.getHash() && header.shapeType == (uint32_t)info.getType()) {
+        shape = readShape(reader, mappedFile, 0);
+        if (shape && !reader.atEnd()) {
+            ShapeFactory::deleteShape(shape);
+            shape = nullptr;
+        }
+    }
+    if (!shape) {
+        qCWarning(physics) << "Could not load cached shape" << key.c_str();
+        ++_numMisses;
+        return nullptr;
+    }
+    ++_numHits;
+    return shape;
+}
+
+bool ShapeCache::storeShape(const ShapeInfo& info, const btCollisionShape* shape) {
+    ShapeWriter writer;
+    ShapeCacheHeader header;
+    header.hash = info.getHash();
+    header.shapeType = (uint32_t)info.getType();
+    writer.write(header);
+    if (!writeShape(writer, shape, 0)) {
+        return false;
+    }
+
+    const QByteArray& data = writer.getData();
+    auto file = writeFile(data.constData(), Metadata(getKey(info), data.size()), true);
+    if (!file) {
+        return false;
+    }
+    ++_numStored;
+    return true;
+}
@@ -0,0 +1,55 @@
+//
+//  ShapeCache.h
+//  libraries/physics/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ShapeCache_h
+#define hifi_ShapeCache_h
+
+#include <atomic>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <ShapeInfo.h>
+#include <shared/FileCache.h>
+
+class ShapeCache;
+using ShapeCachePointer = std::shared_ptr<ShapeCache>;
+
+/// A persistent cache of built collision shapes, keyed by a digest of the ShapeInfo geometry they were built from.
+/// Hulls are stored with their reduced points and static meshes with their vertices, triangles and quantized BVH,
+/// so loading a shape skips both the hull reduction and the BVH build. Static meshes are used straight from the
+/// memory-mapped entry, which stays mapped (and locked in the cache) for as long as the shape is alive.
+/// Entries written by another version of the cache or of Bullet count as misses and are replaced when stored again.
+class ShapeCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    static const std::string DIRNAME;
+    static const size_t DEFAULT_SHAPE_CACHE_SIZE;
+
+    ShapeCache(const std::string& dir);
+
+    /// \return shape built from the cached entry for this info, or nullptr on a miss
+    /// (the caller owns it and should delete it with ShapeFactory::deleteShape() like any other shape)
+    const btCollisionShape* loadShape(const ShapeInfo& info);
+
+    /// \return true if the shape could be serialized and was cached (only hulls, meshes and compounds of those can)
+    bool storeShape(const ShapeInfo& info, const btCollisionShape* shape);
+
+    size_t getNumHits() const { return _numHits; }
+    size_t getNumMisses() const { return _numMisses; }
+    size_t getNumStored() const { return _numStored; }
+
+private:
+    std::atomic<size_t> _numHits { 0 };
+    std::atomic<size_t> _numMisses { 0 };
+    std::atomic<size_t> _numStored { 0 };
+};
+
+#endif // hifi_ShapeCache_h
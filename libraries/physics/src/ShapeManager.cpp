@@ -14,16 +14,47 @@
 #include <glm/gtx/norm.hpp>
 
 #include <QDebug>
+#include <QThread>
 
 #include "ShapeFactory.h"
 
 const int MAX_RING_SIZE = 256;
 
+static bool isExpensiveToBuild(ShapeType type) {
+    return type == SHAPE_TYPE_COMPOUND || type == SHAPE_TYPE_SIMPLE_HULL || type == SHAPE_TYPE_SIMPLE_COMPOUND ||
+        type == SHAPE_TYPE_STATIC_MESH;
+}
+
+class ShapeBuilder : public QRunnable {
+public:
+    ShapeBuilder(ShapeManager* manager, const ShapeInfo& info) : _manager(manager), _info(info) {}
+
+    void run() override {
+        _manager->addBuiltShape(_info.getHash(), _manager->buildShape(_info));
+    }
+
+private:
+    ShapeManager* _manager;
+    ShapeInfo _info;
+};
+
 ShapeManager::ShapeManager() {
     _garbageRing.reserve(MAX_RING_SIZE);
+    // leave half of the cores for everything else, building shapes is never urgent enough to starve the frame
+    _shapeBuilderPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
 }
 
 ShapeManager::~ShapeManager() {
+    _shapeBuilderPool.waitForDone();
+    for (auto& builtShape : _builtShapes) {
+        ShapeFactory::deleteShape(builtShape.second);
+    }
+    _builtShapes.clear();
+    for (auto& unclaimedShape : _unclaimedShapes) {
+        ShapeFactory::deleteShape(unclaimedShape.second);
+    }
+    _unclaimedShapes.clear();
+
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
@@ -42,7 +73,11 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
-    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    const btCollisionShape* shape = claimBuiltShape(info.getHash());
+    if (shape) {
+        return shape;
+    }
+    shape = buildShape(info);
     if (shape) {
         ShapeReference newRef;
         newRef.refCount = 1;
@@ -53,6 +88,94 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     return shape;
 }
 
+const btCollisionShape* ShapeManager::requestShape(const ShapeInfo& info) {
+    if (!isExpensiveToBuild(info.getType())) {
+        return getShape(info);
+    }
+
+    uint64_t key = info.getHash();
+    const btCollisionShape* shape = getShapeByKey(key);
+    if (!shape && !isBuildingShape(key)) {
+        _buildingShapes.insert(key);
+        _shapeBuilderPool.start(new ShapeBuilder(this, info));
+    }
+    return shape;
+}
+
+const btCollisionShape* ShapeManager::getShapeByKey(uint64_t key) {
+    ShapeReference* shapeRef = _shapeMap.find(HashKey(key));
+    if (shapeRef) {
+        shapeRef->refCount++;
+        return shapeRef->shape;
+    }
+    return claimBuiltShape(key);
+}
+
+// private helper method
+const btCollisionShape* ShapeManager::claimBuiltShape(uint64_t key) {
+    takeBuiltShapes();
+    auto itr = _unclaimedShapes.find(key);
+    if (itr == _unclaimedShapes.end()) {
+        return nullptr;
+    }
+    ShapeReference newRef;
+    newRef.refCount = 1;
+    newRef.shape = itr->second;
+    newRef.key = key;
+    _shapeMap.insert(HashKey(key), newRef);
+    _unclaimedShapes.erase(itr);
+    return newRef.shape;
+}
+
+// private helper method
+const btCollisionShape* ShapeManager::buildShape(const ShapeInfo& info) const {
+    if (!_shapeCache || !isExpensiveToBuild(info.getType())) {
+        return ShapeFactory::createShapeFromInfo(info);
+    }
+    const btCollisionShape* shape = _shapeCache->loadShape(info);
+    if (!shape) {
+        shape = ShapeFactory::createShapeFromInfo(info);
+        if (shape) {
+            _shapeCache->storeShape(info, shape);
+        }
+    }
+    return shape;
+}
+
+void ShapeManager::addBuiltShape(uint64_t key, const btCollisionShape* shape) {
+    std::lock_guard<std::mutex> lock(_builtShapesMutex);
+    _builtShapes.push_back({ key, shape });
+}
+
+// private helper method
+void ShapeManager::takeBuiltShapes() {
+    std::vector<std::pair<uint64_t, const btCollisionShape*>> builtShapes;
+    {
+        std::lock_guard<std::mutex> lock(_builtShapesMutex);
+        if (_builtShapes.empty()) {
+            return;
+        }
+        builtShapes.swap(_builtShapes);
+    }
+
+    for (auto& builtShape : builtShapes) {
+        uint64_t key = builtShape.first;
+        _buildingShapes.erase(key);
+
+        if (!builtShape.second) {
+            // the build failed, a later request will try again
+            continue;
+        }
+        if (_shapeMap.find(HashKey(key)) || _unclaimedShapes.find(key) != _unclaimedShapes.end()) {
+            // somebody needed it right away and built it with getShape() in the meantime
+            ShapeFactory::deleteShape(builtShape.second);
+            continue;
+        }
+        // kept until claimed, however many builds finish at once
+        _unclaimedShapes[key] = builtShape.second;
+    }
+}
+
 // private helper method
 bool ShapeManager::releaseShapeByKey(uint64_t key) {
     HashKey hashKey(key);
@@ -61,30 +184,7 @@ bool ShapeManager::releaseShapeByKey(uint64_t key) {
         if (shapeRef->refCount > 0) {
             shapeRef->refCount--;
             if (shapeRef->refCount == 0) {
-                // look for existing entry in _garbageRing
-                int32_t ringSize = (int32_t)(_garbageRing.size());
-                for (int32_t i = 0; i < ringSize; ++i) {
-                    int32_t j = (_ringIndex + ringSize) % ringSize;
-                    if (_garbageRing[j] == key) {
-                        // already on the list, don't add it again
-                        return true;
-                    }
-                }
-                if (ringSize == MAX_RING_SIZE) {
-                    // remove one
-                    HashKey hashKeyToRemove(_garbageRing[_ringIndex]);
-                    ShapeReference* shapeRef = _shapeMap.find(hashKeyToRemove);
-                    if (shapeRef && shapeRef->refCount == 0) {
-                        ShapeFactory::deleteShape(shapeRef->shape);
-                        _shapeMap.remove(hashKeyToRemove);
-                    }
-                    // replace at _ringIndex and advance
-                    _garbageRing[_ringIndex] = key;
-                    _ringIndex = (_ringIndex + 1) % ringSize;
-                } else {
-                    // add one
-                    _garbageRing.push_back(key);
-                }
+                addToGarbageRing(key);
             }
             return true;
         } else {
@@ -98,6 +198,34 @@ bool ShapeManager::releaseShapeByKey(uint64_t key) {
     return false;
 }
 
+// private helper method
+void ShapeManager::addToGarbageRing(uint64_t key) {
+    // look for existing entry in _garbageRing
+    int32_t ringSize = (int32_t)(_garbageRing.size());
+    for (int32_t i = 0; i < ringSize; ++i) {
+        int32_t j = (_ringIndex + ringSize) % ringSize;
+        if (_garbageRing[j] == key) {
+            // already on the list, don't add it again
+            return;
+        }
+    }
+    if (ringSize == MAX_RING_SIZE) {
+        // remove one
+        HashKey hashKeyToRemove(_garbageRing[_ringIndex]);
+        ShapeReference* shapeRef = _shapeMap.find(hashKeyToRemove);
+        if (shapeRef && shapeRef->refCount == 0) {
+            ShapeFactory::deleteShape(shapeRef->shape);
+            _shapeMap.remove(hashKeyToRemove);
+        }
+        // replace at _ringIndex and advance
+        _garbageRing[_ringIndex] = key;
+        _ringIndex = (_ringIndex + 1) % ringSize;
+    } else {
+        // add one
+        _garbageRing.push_back(key);
+    }
+}
+
 bool ShapeManager::releaseShape(const btCollisionShape* shape) {
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
@@ -110,6 +238,12 @@ bool ShapeManager::releaseShape(const btCollisionShape* shape) {
 }
 
 void ShapeManager::collectGarbage() {
+    takeBuiltShapes();
+    for (auto& unclaimedShape : _unclaimedShapes) {
+        ShapeFactory::deleteShape(unclaimedShape.second);
+    }
+    _unclaimedShapes.clear();
+
     int numShapes = (int32_t)(_garbageRing.size());
     for (int i = 0; i < numShapes; ++i) {
         HashKey key(_garbageRing[i]);
@@ -144,6 +278,11 @@ int ShapeManager::getNumReferences(const btCollisionShape* shape) const {
 }
 
 bool ShapeManager::hasShape(const btCollisionShape* shape) const {
+    for (auto& unclaimedShape : _unclaimedShapes) {
+        if (shape == unclaimedShape.second) {
+            return true;
+        }
+    }
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         const ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
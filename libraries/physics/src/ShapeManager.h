@@ -12,14 +12,20 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <QtCore/QThreadPool>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
 #include <ShapeInfo.h>
 
 #include "HashKey.h"
+#include "ShapeCache.h"
 
 // The ShapeManager handles the ref-counting on shared shapes:
 //
@@ -42,6 +48,19 @@
 // doesn't delete it right away.  Instead it puts the shape's key on a list delete
 // later.  When that list grows big enough the ShapeManager will remove any matching
 // entries that still have zero ref-count.
+//
+// Hulls and meshes can take a long time to build, so they can be requested instead:
+// requestShape() starts building the shape on a worker thread and answers nullptr
+// until it is ready, the body asks again later (or claims it by its key with
+// getShapeByKey()).  A shape that is being built is tracked by its key as well, so
+// requests for the same ShapeInfo share one build.  Built shapes wait, unreferenced,
+// in a list of their own until they are claimed: a bulk load can finish more builds
+// at once than the garbage list holds, and they must not be deleted before their
+// bodies ask again.  They only join the garbage list once claimed and released, and
+// collectGarbage() deletes the ones still unclaimed.
+//
+// With a ShapeCache the expensive shapes are loaded from disk when they were built
+// in an earlier session, and stored there when they had to be built.
 
 
 class ShapeManager {
@@ -53,6 +72,23 @@ public:
     /// \return pointer to shape
     const btCollisionShape* getShape(const ShapeInfo& info);
 
+    /// \return pointer to shape, or nullptr while it is being built on a worker thread
+    const btCollisionShape* requestShape(const ShapeInfo& info);
+
+    /// \return pointer to shape with the hash of its ShapeInfo, or nullptr if it isn't built
+    const btCollisionShape* getShapeByKey(uint64_t key);
+
+    /// \return true if the shape with this key is being built on a worker thread
+    bool isBuildingShape(uint64_t key) const { return _buildingShapes.find(key) != _buildingShapes.end(); }
+    int getNumBuildingShapes() const { return (int)_buildingShapes.size(); }
+
+    /// block until the shapes being built are done
+    void waitForShapeBuilds() { _shapeBuilderPool.waitForDone(); }
+
+    /// must be set before any shapes are built
+    void setShapeCache(const ShapeCachePointer& shapeCache) { _shapeCache = shapeCache; }
+    const ShapeCachePointer& getShapeCache() const { return _shapeCache; }
+
     /// \return true if shape was found and released
     bool releaseShape(const btCollisionShape* shape);
 
@@ -60,13 +96,24 @@ public:
     void collectGarbage();
 
     // validation methods
-    int getNumShapes() const { return _shapeMap.size(); }
+    int getNumShapes() const { return _shapeMap.size() + (int)_unclaimedShapes.size(); }
     int getNumReferences(const ShapeInfo& info) const;
     int getNumReferences(const btCollisionShape* shape) const;
     bool hasShape(const btCollisionShape* shape) const;
 
 private:
+    friend class ShapeBuilder;
+
     bool releaseShapeByKey(uint64_t key);
+    void addToGarbageRing(uint64_t key);
+    const btCollisionShape* claimBuiltShape(uint64_t key);
+
+    // thread-safe
+    const btCollisionShape* buildShape(const ShapeInfo& info) const;
+
+    // called on a worker thread when a shape is built
+    void addBuiltShape(uint64_t key, const btCollisionShape* shape);
+    void takeBuiltShapes();
 
     class ShapeReference {
     public:
@@ -80,6 +127,13 @@ private:
     btHashMap<HashKey, ShapeReference> _shapeMap;
     std::vector<uint64_t> _garbageRing;
     uint32_t _ringIndex { 0 };
+
+    std::unordered_set<uint64_t> _buildingShapes;
+    std::mutex _builtShapesMutex;
+    std::vector<std::pair<uint64_t, const btCollisionShape*>> _builtShapes;
+    std::unordered_map<uint64_t, const btCollisionShape*> _unclaimedShapes;
+    QThreadPool _shapeBuilderPool;
+    ShapeCachePointer _shapeCache;
 };
 
 #endif // hifi_ShapeManager_h
@@ -13,6 +13,7 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/PackedClip.h"
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -22,7 +23,12 @@
 using namespace recording;
 
 Clip::Pointer Clip::fromFile(const QString& filePath) {
-    auto result = std::make_shared<FileClip>(filePath);
+    Clip::Pointer result;
+    if (auto packedData = PackedClipData::fromFile(filePath)) {
+        result = std::make_shared<PackedClip>(packedData);
+    } else {
+        result = std::make_shared<FileClip>(filePath);
+    }
     if (result->frameCount() == 0) {
         return Clip::Pointer();
     }
@@ -33,6 +39,10 @@ void Clip::toFile(const QString& filePath, const Clip::ConstPointer& clip) {
     FileClip::write(filePath, clip->duplicate());
 }
 
+void Clip::toPackedFile(const QString& filePath, const Clip::ConstPointer& clip) {
+    PackedClip::write(filePath, clip);
+}
+
 QByteArray Clip::toBuffer(const Clip::ConstPointer& clip) {
     QBuffer buffer;
     if (buffer.open(QFile::Truncate | QFile::WriteOnly)) {
@@ -51,6 +51,8 @@ public:
 
     static Pointer fromFile(const QString& filePath);
     static void toFile(const QString& filePath, const ConstPointer& clip);
+    // Writes the clip in the packed format, which is played in place and shared by all the clips playing it
+    static void toPackedFile(const QString& filePath, const ConstPointer& clip);
     static QByteArray toBuffer(const ConstPointer& clip);
     static Pointer newClip();
     
@@ -12,25 +12,38 @@
 
 #include <shared/QtHelpers.h>
 
-#include "impl/PointerClip.h"
 #include "Logging.h"
 
 using namespace recording;
 NetworkClipLoader::NetworkClipLoader(const QUrl& url) :
-    Resource(url),
-    _clip(std::make_shared<NetworkClip>(url)) {}
+    Resource(url) {}
 
-void NetworkClip::init(const QByteArray& clipData) {
-    _clipData = clipData;
-    PointerClip::init((uchar*)_clipData.data(), _clipData.size());
+NetworkClipLoader::NetworkClipLoader(const NetworkClipLoader& other) : Resource(other) {
+    std::unique_lock<std::mutex> lock(other._clipDataMutex);
+    _clipData = other._clipData;
 }
 
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
-    _clip->init(data);
+    auto clipData = PackedClipData::fromSharedCache(data);
+    if (!clipData) {
+        qCWarning(recordingLog) << "Invalid recording at" << _url;
+    }
+    {
+        std::unique_lock<std::mutex> lock(_clipDataMutex);
+        _clipData = clipData;
+    }
     finishedLoading(true);
     emit clipLoaded();
 }
 
+ClipPointer NetworkClipLoader::getClip() {
+    std::unique_lock<std::mutex> lock(_clipDataMutex);
+    if (!_clipData) {
+        return ClipPointer();
+    }
+    return std::make_shared<PackedClip>(_clipData, _url.toString());
+}
+
 ClipCache::ClipCache(QObject* parent) :
     ResourceCache(parent)
 {
@@ -11,39 +11,31 @@
 
 #include <ResourceCache.h>
 
+#include <mutex>
+
 #include "Forward.h"
-#include "impl/PointerClip.h"
+#include "impl/PackedClip.h"
 
 namespace recording {
 
-class NetworkClip : public PointerClip {
-public:
-    using Pointer = std::shared_ptr<NetworkClip>;
-
-    NetworkClip(const QUrl& url) : _url(url) {}
-    virtual void init(const QByteArray& clipData);
-    virtual QString getName() const override { return _url.toString(); }
-
-private:
-    QByteArray _clipData;
-    QUrl _url;
-};
-
 class NetworkClipLoader : public Resource {
     Q_OBJECT
 public:
     NetworkClipLoader(const QUrl& url);
-    NetworkClipLoader(const NetworkClipLoader& other) : Resource(other), _clip(other._clip) {}
+    NetworkClipLoader(const NetworkClipLoader& other);
 
     virtual void downloadFinished(const QByteArray& data) override;
-    ClipPointer getClip() { return _clip; }
+
+    // Each call returns a new cursor, so that the decks playing this clip share its frames but not their positions
+    ClipPointer getClip();
     bool completed() { return _failedToLoad || isLoaded(); }
 
 signals:
     void clipLoaded();
 
 private:
-    const NetworkClip::Pointer _clip;
+    mutable std::mutex _clipDataMutex;
+    PackedClipData::Pointer _clipData;
 };
 
 using NetworkClipLoaderPointer = QSharedPointer<NetworkClipLoader>;
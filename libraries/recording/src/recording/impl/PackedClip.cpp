@@ -0,0 +1,550 @@
+//
+//  PackedClip.cpp
+//  libraries/recording/src/recording/impl
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PackedClip.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDateTime>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <NumericalConstants.h>
+
+#include "../Frame.h"
+#include "../Logging.h"
+#include "PointerClip.h"
+
+using namespace recording;
+
+const uint32_t PackedClipData::VERSION = 1;
+const uint32_t PackedClipData::KEYFRAME_INTERVAL = 90;
+
+static const char PACKED_MAGIC[4] = { 'H', 'F', 'R', 'P' };
+static const size_t PACKED_HEADER_SIZE = sizeof(PACKED_MAGIC) + 3 * sizeof(uint32_t);
+static const QString SHARED_CACHE_DIRECTORY = "recordings";
+static const int SHARED_CACHE_DIGEST_SIZE = 20; // SHA-1
+// converted clips are kept across runs, the least recently played are removed when the cache grows past this
+static const qint64 MAX_SHARED_CACHE_SIZE = MB_TO_BYTES(1024);
+static const QString PACKED_EXTENSION = "hfrp";
+
+// bytes in common shorter than a run header are copied with the runs around them
+static const int MIN_DELTA_GAP = 2 * sizeof(uint32_t);
+
+// Files are mapped once per process.  The registry only holds weak pointers, so a file is unmapped when the last
+// clip playing it goes away.
+static std::mutex registryMutex;
+static QHash<QString, std::weak_ptr<const PackedClipData>> registry;
+
+static size_t alignEntries(size_t offset) {
+    return (offset + alignof(PackedFrameEntry) - 1) & ~(alignof(PackedFrameEntry) - 1);
+}
+
+template <typename T>
+static void appendValue(QByteArray& output, T value) {
+    output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Encodes data as the runs of bytes that differ from keyframe, each preceded by the number of bytes skipped since the
+// end of the previous run and its length.
+static QByteArray encodeDelta(const QByteArray& keyframe, const QByteArray& data) {
+    QByteArray result;
+    const char* keyframeBytes = keyframe.constData();
+    const char* bytes = data.constData();
+    int size = data.size();
+    int position = 0;
+    int i = 0;
+    while (i < size) {
+        if (keyframeBytes[i] == bytes[i]) {
+            i++;
+            continue;
+        }
+        int start = i;
+        int end = start + 1;
+        for (int j = end; j < size && j - end < MIN_DELTA_GAP; j++) {
+            if (keyframeBytes[j] != bytes[j]) {
+                end = j + 1;
+            }
+        }
+        appendValue<uint32_t>(result, start - position);
+        appendValue<uint32_t>(result, end - start);
+        result.append(bytes + start, end - start);
+        position = end;
+        i = end;
+    }
+    return result;
+}
+
+bool PackedClipData::isPacked(const uchar* data, size_t size) {
+    return size >= PACKED_HEADER_SIZE && memcmp(data, PACKED_MAGIC, sizeof(PACKED_MAGIC)) == 0;
+}
+
+PackedClipData::Pointer PackedClipData::fromFile(const QString& filePath) {
+    return fromFile(filePath, false);
+}
+
+PackedClipData::Pointer PackedClipData::fromFile(const QString& filePath, bool hasDigest) {
+    QString canonicalPath = QFileInfo(filePath).canonicalFilePath();
+    if (canonicalPath.isEmpty()) {
+        return Pointer();
+    }
+
+    std::unique_lock<std::mutex> lock(registryMutex);
+    auto result = registry.value(canonicalPath).lock();
+    if (result) {
+        return result;
+    }
+
+    std::shared_ptr<PackedClipData> data { new PackedClipData(canonicalPath) };
+    data->_file.setFileName(canonicalPath);
+    if (!data->_file.open(QIODevice::ReadOnly)) {
+        return Pointer();
+    }
+    auto size = data->_file.size();
+    if (hasDigest && size < (qint64)(PACKED_HEADER_SIZE + SHARED_CACHE_DIGEST_SIZE)) {
+        return Pointer();
+    }
+    uchar magic[PACKED_HEADER_SIZE];
+    if (data->_file.read(reinterpret_cast<char*>(magic), PACKED_HEADER_SIZE) != (qint64)PACKED_HEADER_SIZE ||
+        !isPacked(magic, PACKED_HEADER_SIZE)) {
+        return Pointer();
+    }
+    data->_mappedData = data->_file.map(0, size);
+    if (!data->_mappedData) {
+        qCWarning(recordingLog) << "Unable to map file" << canonicalPath;
+        return Pointer();
+    }
+    if (hasDigest) {
+        // the frames are read from the mapping, so check what is mapped
+        size -= SHARED_CACHE_DIGEST_SIZE;
+        auto content = QByteArray::fromRawData(reinterpret_cast<const char*>(data->_mappedData), size);
+        auto digest = QByteArray::fromRawData(reinterpret_cast<const char*>(data->_mappedData) + size, SHARED_CACHE_DIGEST_SIZE);
+        if (QCryptographicHash::hash(content, QCryptographicHash::Sha1) != digest) {
+            qCWarning(recordingLog) << "Corrupted packed clip" << canonicalPath;
+            return Pointer();
+        }
+    }
+    if (!data->init(data->_mappedData, size)) {
+        return Pointer();
+    }
+
+    for (auto itr = registry.begin(); itr != registry.end();) {
+        if (itr.value().expired()) {
+            itr = registry.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    registry.insert(canonicalPath, data);
+    return data;
+}
+
+PackedClipData::Pointer PackedClipData::fromBuffer(const QByteArray& clipData) {
+    std::shared_ptr<PackedClipData> result { new PackedClipData() };
+    if (isPacked(reinterpret_cast<const uchar*>(clipData.constData()), clipData.size())) {
+        result->_buffer = clipData;
+    } else {
+        PointerClip legacyClip(reinterpret_cast<uchar*>(const_cast<char*>(clipData.constData())), clipData.size());
+        QBuffer buffer(&result->_buffer);
+        if (legacyClip.frameCount() == 0 || !buffer.open(QIODevice::WriteOnly) || !write(buffer, legacyClip)) {
+            return Pointer();
+        }
+    }
+    if (!result->init(reinterpret_cast<const uchar*>(result->_buffer.constData()), result->_buffer.size())) {
+        return Pointer();
+    }
+    return result;
+}
+
+// Removes the least recently played clips until the cache fits in MAX_SHARED_CACHE_SIZE.  Clips still mapped by a
+// process stay readable by it where the file system allows removing them, and are skipped where it doesn't.
+static void trimSharedCache(const QDir& cacheDirectory, const QString& keepFilePath) {
+    auto entries = cacheDirectory.entryInfoList({ "*." + PACKED_EXTENSION }, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 totalSize = 0;
+    for (const auto& entry : entries) {
+        totalSize += entry.size();
+    }
+    for (const auto& entry : entries) {
+        if (totalSize <= MAX_SHARED_CACHE_SIZE) {
+            break;
+        }
+        if (entry.absoluteFilePath() != keepFilePath && QFile::remove(entry.absoluteFilePath())) {
+            totalSize -= entry.size();
+        }
+    }
+}
+
+bool PackedClipData::writeSharedCacheFile(const QString& filePath, const QByteArray& clipData) {
+    QByteArray packedData;
+    if (isPacked(reinterpret_cast<const uchar*>(clipData.constData()), clipData.size())) {
+        packedData = clipData;
+    } else {
+        PointerClip legacyClip(reinterpret_cast<uchar*>(const_cast<char*>(clipData.constData())), clipData.size());
+        QBuffer buffer(&packedData);
+        if (legacyClip.frameCount() == 0 || !buffer.open(QIODevice::WriteOnly) || !write(buffer, legacyClip)) {
+            return false;
+        }
+    }
+    // other processes may be writing the same file, the last one to commit wins and they are all identical
+    QSaveFile file(filePath);
+    auto digest = QCryptographicHash::hash(packedData, QCryptographicHash::Sha1);
+    return file.open(QIODevice::WriteOnly) && file.write(packedData) == packedData.size() &&
+        file.write(digest) == digest.size() && file.commit();
+}
+
+PackedClipData::Pointer PackedClipData::fromSharedCache(const QByteArray& clipData) {
+    // the converted clip only keeps the frame types registered here, so they are part of the key
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(clipData);
+    for (const auto& frameTypeName : Frame::getFrameTypes().keys()) {
+        hash.addData(frameTypeName.toUtf8());
+    }
+    // per user, so that no one else can put clips where we look for them
+    QDir cacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/" + SHARED_CACHE_DIRECTORY);
+    if (!cacheDirectory.mkpath(".")) {
+        qCWarning(recordingLog) << "Unable to create" << cacheDirectory.path() << ", playing clip from memory";
+        return fromBuffer(clipData);
+    }
+    QFile::setPermissions(cacheDirectory.path(), QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+    QString filePath = cacheDirectory.absoluteFilePath(QString(hash.result().toHex()) + "." + PACKED_EXTENSION);
+
+    Pointer result;
+    if (QFileInfo::exists(filePath)) {
+        result = fromFile(filePath, true);
+        if (result) {
+            // the modification time orders the clips for trimming
+            QFile file(filePath);
+            if (file.open(QIODevice::Append)) {
+                file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+            }
+            return result;
+        }
+    }
+
+    if (!writeSharedCacheFile(filePath, clipData)) {
+        qCWarning(recordingLog) << "Unable to write shared clip" << filePath << ", playing it from memory";
+        return fromBuffer(clipData);
+    }
+    trimSharedCache(cacheDirectory, filePath);
+
+    result = fromFile(filePath, true);
+    if (!result) {
+        return fromBuffer(clipData);
+    }
+    return result;
+}
+
+bool PackedClipData::write(QIODevice& output, Clip& clip) {
+    struct Keyframe {
+        uint32_t index;
+        uint32_t age;
+        QByteArray data;
+    };
+    std::unordered_map<FrameType, Keyframe> keyframes;
+    std::vector<PackedFrameEntry> entries;
+    entries.reserve(clip.frameCount());
+    QByteArray frameData;
+
+    clip.seek(0);
+    for (auto frame = clip.nextFrame(); frame; frame = clip.nextFrame()) {
+        if (frame->type == Frame::TYPE_INVALID) {
+            qWarning() << "Attempting to write invalid frame";
+            continue;
+        }
+
+        PackedFrameEntry entry;
+        entry.type = frame->type;
+        entry.padding = 0;
+        entry.timeOffset = frame->timeOffset;
+        entry.keyframe = (uint32_t)entries.size();
+        entry.dataOffset = (uint32_t)frameData.size();
+
+        QByteArray delta;
+        auto itr = keyframes.find(frame->type);
+        bool isDelta = itr != keyframes.end() && itr->second.age < KEYFRAME_INTERVAL &&
+            itr->second.data.size() == frame->data.size();
+        if (isDelta) {
+            delta = encodeDelta(itr->second.data, frame->data);
+            isDelta = delta.size() < frame->data.size();
+        }
+        if (isDelta) {
+            entry.keyframe = itr->second.index;
+            itr->second.age++;
+            frameData.append(delta);
+        } else {
+            keyframes[frame->type] = { entry.keyframe, 1, frame->data };
+            frameData.append(frame->data);
+        }
+        entry.dataSize = (uint32_t)(frameData.size() - entry.dataOffset);
+        entries.push_back(entry);
+    }
+
+    auto frameTypes = Frame::getFrameTypes();
+    QJsonObject frameTypeObj;
+    for (const auto& frameTypeName : frameTypes.keys()) {
+        frameTypeObj[frameTypeName] = frameTypes[frameTypeName];
+    }
+    QJsonObject rootObject;
+    rootObject.insert(Clip::FRAME_TYPE_MAP, frameTypeObj);
+    QByteArray header = QJsonDocument(rootObject).toBinaryData();
+
+    size_t entriesOffset = alignEntries(PACKED_HEADER_SIZE + header.size());
+    size_t dataOffset = entriesOffset + entries.size() * sizeof(PackedFrameEntry);
+    if (dataOffset + frameData.size() > std::numeric_limits<uint32_t>::max()) {
+        qCWarning(recordingLog) << "Clip is too large for the packed format";
+        return false;
+    }
+    for (auto& entry : entries) {
+        entry.dataOffset += (uint32_t)dataOffset;
+    }
+
+    QByteArray prefix;
+    prefix.append(PACKED_MAGIC, sizeof(PACKED_MAGIC));
+    appendValue<uint32_t>(prefix, VERSION);
+    appendValue<uint32_t>(prefix, (uint32_t)entries.size());
+    appendValue<uint32_t>(prefix, (uint32_t)header.size());
+    prefix.append(header);
+    prefix.append((int)(entriesOffset - prefix.size()), '\0');
+
+    qint64 entriesSize = entries.size() * sizeof(PackedFrameEntry);
+    return output.write(prefix) == prefix.size() &&
+        output.write(reinterpret_cast<const char*>(entries.data()), entriesSize) == entriesSize &&
+        output.write(frameData) == frameData.size();
+}
+
+PackedClipData::~PackedClipData() {
+    if (_mappedData) {
+        _file.unmap(_mappedData);
+    }
+}
+
+bool PackedClipData::init(const uchar* data, size_t size) {
+    if (!isPacked(data, size)) {
+        qCWarning(recordingLog) << "Not a packed clip" << _name;
+        return false;
+    }
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t headerSize;
+    const uchar* current = data + sizeof(PACKED_MAGIC);
+    memcpy(&version, current, sizeof(uint32_t));
+    memcpy(&numEntries, current + sizeof(uint32_t), sizeof(uint32_t));
+    memcpy(&headerSize, current + 2 * sizeof(uint32_t), sizeof(uint32_t));
+    if (version != VERSION) {
+        qCWarning(recordingLog) << "Unsupported packed clip version" << version << _name;
+        return false;
+    }
+
+    size_t entriesOffset = alignEntries(PACKED_HEADER_SIZE + (size_t)headerSize);
+    if (entriesOffset > size || (size - entriesOffset) / sizeof(PackedFrameEntry) < numEntries) {
+        qCWarning(recordingLog) << "Truncated packed clip" << _name;
+        return false;
+    }
+    _header = QJsonDocument::fromBinaryData(QByteArray::fromRawData(reinterpret_cast<const char*>(data) +
+        PACKED_HEADER_SIZE, headerSize));
+
+    // Find the type enum translation map
+    auto frameTypeObj = _header.object()[Clip::FRAME_TYPE_MAP].toObject();
+    if (frameTypeObj.isEmpty()) {
+        qCWarning(recordingLog) << "Header missing frame type map, invalid file" << _name;
+        return false;
+    }
+    auto currentFrameTypes = Frame::getFrameTypes();
+    for (const auto& frameTypeName : frameTypeObj.keys()) {
+        if (!currentFrameTypes.contains(frameTypeName)) {
+            continue;
+        }
+        FrameType storedType = static_cast<FrameType>(frameTypeObj[frameTypeName].toInt());
+        if (storedType >= _types.size()) {
+            _types.resize(storedType + 1, Frame::TYPE_INVALID);
+        }
+        _types[storedType] = currentFrameTypes[frameTypeName];
+    }
+
+    // validate the index up front so that frames can be decoded without checks
+    auto entries = reinterpret_cast<const PackedFrameEntry*>(data + entriesOffset);
+    for (uint32_t i = 0; i < numEntries; i++) {
+        const auto& entry = entries[i];
+        bool valid = entry.dataOffset <= size && entry.dataSize <= size - entry.dataOffset &&
+            (i == 0 || entry.timeOffset >= entries[i - 1].timeOffset) && entry.keyframe <= i;
+        if (valid && entry.keyframe != i) {
+            const auto& keyframe = entries[entry.keyframe];
+            valid = keyframe.keyframe == entry.keyframe && keyframe.type == entry.type;
+        }
+        if (!valid) {
+            qCWarning(recordingLog) << "Invalid frame" << i << "in packed clip" << _name;
+            return false;
+        }
+        if (entry.type < _types.size() && _types[entry.type] != Frame::TYPE_INVALID) {
+            _numPlayable++;
+            _duration = Frame::frameTimeToSeconds(entry.timeOffset);
+        }
+    }
+
+    _data = data;
+    _size = size;
+    _entries = entries;
+    _numEntries = numEntries;
+    return true;
+}
+
+size_t PackedClipData::findPlayable(size_t index) const {
+    while (index < _numEntries) {
+        FrameType type = _entries[index].type;
+        if (type < _types.size() && _types[type] != Frame::TYPE_INVALID) {
+            break;
+        }
+        index++;
+    }
+    return index;
+}
+
+void PackedClipData::readFrame(size_t index, Frame& frame) const {
+    const auto& entry = _entries[index];
+    const auto& keyframe = _entries[entry.keyframe];
+    frame.type = _types[entry.type];
+    frame.timeOffset = entry.timeOffset;
+    frame.data.resize((int)keyframe.dataSize);
+    char* output = frame.data.data();
+    memcpy(output, _data + keyframe.dataOffset, keyframe.dataSize);
+    if (entry.keyframe == index) {
+        return;
+    }
+
+    const uchar* current = _data + entry.dataOffset;
+    const uchar* end = current + entry.dataSize;
+    size_t position = 0;
+    while (end - current >= MIN_DELTA_GAP) {
+        uint32_t skip;
+        uint32_t length;
+        memcpy(&skip, current, sizeof(uint32_t));
+        memcpy(&length, current + sizeof(uint32_t), sizeof(uint32_t));
+        current += MIN_DELTA_GAP;
+        position += skip;
+        if (length > (size_t)(end - current) || position > keyframe.dataSize || length > keyframe.dataSize - position) {
+            qCWarning(recordingLog) << "Invalid delta in frame" << index << "of packed clip" << _name;
+            return;
+        }
+        memcpy(output + position, current, length);
+        current += length;
+        position += length;
+    }
+}
+
+PackedClip::PackedClip(const PackedClipData::Pointer& data, const QString& name) :
+    _data(data),
+    _name(name),
+    _frameIndex(data->findPlayable(0)) {}
+
+Clip::Pointer PackedClip::duplicate() const {
+    auto result = newClip();
+    Locker lock(_mutex);
+    for (size_t i = _data->findPlayable(0); i < _data->getNumEntries(); i = _data->findPlayable(i + 1)) {
+        auto frame = std::make_shared<Frame>();
+        _data->readFrame(i, *frame);
+        result->addFrame(frame);
+    }
+    return result;
+}
+
+QString PackedClip::getName() const {
+    return _name.isEmpty() ? _data->getName() : _name;
+}
+
+float PackedClip::duration() const {
+    return _data->duration();
+}
+
+size_t PackedClip::frameCount() const {
+    return _data->getNumPlayable();
+}
+
+void PackedClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+    const PackedFrameEntry* begin = _data->getEntries();
+    const PackedFrameEntry* end = begin + _data->getNumEntries();
+    auto itr = std::lower_bound(begin, end, offset, [](const PackedFrameEntry& a, Frame::Time b)->bool {
+        return a.timeOffset < b;
+    });
+    _frameIndex = _data->findPlayable(itr - begin);
+}
+
+Frame::Time PackedClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    Frame::Time result = Frame::INVALID_TIME;
+    if (_frameIndex < _data->getNumEntries()) {
+        result = _data->getEntry(_frameIndex).timeOffset;
+    }
+    return result;
+}
+
+FrameConstPointer PackedClip::peekFrame() const {
+    Locker lock(_mutex);
+    return readFrame(_frameIndex);
+}
+
+FrameConstPointer PackedClip::nextFrame() {
+    Locker lock(_mutex);
+    auto result = readFrame(_frameIndex);
+    if (result) {
+        _frameIndex = _data->findPlayable(_frameIndex + 1);
+    }
+    return result;
+}
+
+void PackedClip::skipFrame() {
+    Locker lock(_mutex);
+    if (_frameIndex < _data->getNumEntries()) {
+        _frameIndex = _data->findPlayable(_frameIndex + 1);
+    }
+}
+
+void PackedClip::addFrame(FrameConstPointer) {
+    throw std::runtime_error("Packed clips are read only, use duplicate to create a read/write clip");
+}
+
+void PackedClip::reset() {
+    _frameIndex = _data->findPlayable(0);
+}
+
+// Internal only function, needs no locking
+FrameConstPointer PackedClip::readFrame(size_t index) const {
+    if (index >= _data->getNumEntries()) {
+        return FrameConstPointer();
+    }
+    // reuse the last frame unless a handler kept it
+    if (!_frame || _frame.use_count() > 1) {
+        _frame = std::make_shared<Frame>();
+    }
+    _data->readFrame(index, *_frame);
+    return _frame;
+}
+
+bool PackedClip::write(const QString& filePath, const Clip::ConstPointer& clip) {
+    if (0 == clip->frameCount()) {
+        return false;
+    }
+
+    QSaveFile outputFile(filePath);
+    if (!outputFile.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    auto source = clip->duplicate();
+    return PackedClipData::write(outputFile, *source) && outputFile.commit();
+}
@@ -0,0 +1,142 @@
+//
+//  PackedClip.h
+//  libraries/recording/src/recording/impl
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_PackedClip_h
+#define hifi_Recording_Impl_PackedClip_h
+
+#include "../Clip.h"
+
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+
+class QIODevice;
+
+namespace recording {
+
+// One entry of the frame index.  A frame is a keyframe when keyframe is its own index, otherwise its data is a list
+// of byte runs that differ from the keyframe, which is always an earlier frame of the same type and size.
+struct PackedFrameEntry {
+    FrameType type;
+    uint16_t padding;
+    Frame::Time timeOffset;
+    uint32_t keyframe;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+};
+
+// The read only contents of a clip in the packed format: a header, a fixed size frame index and the frame data,
+// all read in place.  Files are mapped once per process and shared by every PackedClip that plays them, so the
+// cost of playing the same recording on many decks doesn't grow with the number of decks.
+class PackedClipData {
+public:
+    using Pointer = std::shared_ptr<const PackedClipData>;
+
+    static const uint32_t VERSION;
+
+    // a keyframe is written at least this often for each frame type, which bounds the size of the deltas
+    static const uint32_t KEYFRAME_INTERVAL;
+
+    static bool isPacked(const uchar* data, size_t size);
+
+    // \return the data of a packed file, mapped the first time it is opened by this process
+    static Pointer fromFile(const QString& filePath);
+
+    // \return the data of a clip in either format, converted if necessary
+    static Pointer fromBuffer(const QByteArray& clipData);
+
+    // \return the data of a clip in either format, through a packed copy in the user's cache directory that the other
+    // processes of this user playing the same clip will share
+    static Pointer fromSharedCache(const QByteArray& clipData);
+
+    static bool write(QIODevice& output, Clip& clip);
+
+    ~PackedClipData();
+
+    const QString& getName() const { return _name; }
+    const QJsonDocument& getHeader() const { return _header; }
+
+    // all the frames, including those of types that are not registered in this process
+    size_t getNumEntries() const { return _numEntries; }
+    const PackedFrameEntry* getEntries() const { return _entries; }
+    const PackedFrameEntry& getEntry(size_t index) const { return _entries[index]; }
+
+    // \return the first frame at or after index with a type registered in this process
+    size_t findPlayable(size_t index) const;
+    size_t getNumPlayable() const { return _numPlayable; }
+    float duration() const { return _duration; }
+
+    // Decodes a frame into frame, reusing the memory of its data when nothing else shares it
+    void readFrame(size_t index, Frame& frame) const;
+
+private:
+    PackedClipData(const QString& name = QString()) : _name(name) {}
+
+    // with hasDigest the file ends with the SHA-1 of what comes before, which is checked before the clip is used
+    static Pointer fromFile(const QString& filePath, bool hasDigest);
+    static bool writeSharedCacheFile(const QString& filePath, const QByteArray& clipData);
+
+    bool init(const uchar* data, size_t size);
+
+    QString _name;
+    QFile _file;
+    QByteArray _buffer;
+    uchar* _mappedData { nullptr };
+    const uchar* _data { nullptr };
+    size_t _size { 0 };
+    QJsonDocument _header;
+    const PackedFrameEntry* _entries { nullptr };
+    size_t _numEntries { 0 };
+    size_t _numPlayable { 0 };
+    float _duration { 0.0f };
+
+    // frame types as stored in the file, translated to those registered in this process
+    std::vector<FrameType> _types;
+};
+
+// A playback cursor over shared packed clip data.  It is cheap to create one for each deck, and steady state
+// playback doesn't allocate as long as the frame handlers don't hold on to the frames.
+class PackedClip : public Clip {
+public:
+    using Pointer = std::shared_ptr<PackedClip>;
+
+    PackedClip(const PackedClipData::Pointer& data, const QString& name = QString());
+
+    virtual Clip::Pointer duplicate() const override;
+    virtual QString getName() const override;
+
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+    virtual void addFrame(FrameConstPointer) override;
+
+    static bool write(const QString& filePath, const Clip::ConstPointer& clip);
+
+protected:
+    virtual void reset() override;
+    FrameConstPointer readFrame(size_t index) const;
+
+    const PackedClipData::Pointer _data;
+    const QString _name;
+    size_t _frameIndex { 0 };
+    mutable FramePointer _frame;
+};
+
+}
+
+#endif
@@ -8,10 +8,8 @@
 
 #include "CauterizedModel.h"
 
-#include <PerfStat.h>
 #include <DualQuaternion.h>
 
-#include "AbstractViewStateInterface.h"
 #include "MeshPartPayload.h"
 #include "CauterizedMeshPartPayload.h"
 #include "RenderUtilsLogging.h"
@@ -102,13 +100,7 @@ void CauterizedModel::createRenderItemSet() {
     }
 }
 
-void CauterizedModel::updateClusterMatrices() {
-    PerformanceTimer perfTimer("CauterizedModel::updateClusterMatrices");
-
-    if (!_needsUpdateClusterMatrices || !isLoaded()) {
-        return;
-    }
-    _needsUpdateClusterMatrices = false;
+void CauterizedModel::computeClusterMatrices() {
     const HFMModel& hfmModel = getHFMModel();
 
     for (int i = 0; i < (int)_meshStates.size(); i++) {
@@ -178,114 +170,82 @@ void CauterizedModel::updateClusterMatrices() {
             }
         }
     }
+}
 
-    // post the blender if we're not currently waiting for one to finish
-    auto modelBlender = DependencyManager::get<ModelBlender>();
-    if (_blendshapeOffsetsInitialized && modelBlender->shouldComputeBlendshapes() && hfmModel.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
-        _blendedBlendshapeCoefficients = _blendshapeCoefficients;
-        modelBlender->noteRequiresBlend(getThisPointer());
+void CauterizedModel::updateRenderItemsTransaction(render::Transaction& transaction) {
+    if (!_isCauterized) {
+        Model::updateRenderItemsTransaction(transaction);
+        return;
     }
-}
 
-void CauterizedModel::updateRenderItems() {
-    if (_isCauterized) {
-        if (!_addedToScene) {
+    auto update = std::make_shared<RenderItemsUpdate>();
+    initRenderItemsUpdate(*update);
+    update->cauterizeMeshStates.assign(_cauterizeMeshStates.begin(), _cauterizeMeshStates.end());
+    update->modelTransform = Transform();
+    update->modelTransform.setTranslation(getTranslation());
+    update->modelTransform.setRotation(getRotation());
+    update->enableCauterization = getEnableCauterization();
+
+    auto functor = std::make_shared<render::UpdateFunctor<ModelMeshPartPayload>>([update](ModelMeshPartPayload& mmppData) {
+        if (mmppData._meshIndex < 0 || mmppData._meshIndex >= (int)update->meshStates.size() ||
+            mmppData._meshIndex >= (int)update->cauterizeMeshStates.size()) {
             return;
         }
-        _needsUpdateClusterMatrices = true;
-        _renderItemsNeedUpdate = false;
-
-        // queue up this work for later processing, at the end of update and just before rendering.
-        // the application will ensure only the last lambda is actually invoked.
-        void* key = (void*)this;
-        std::weak_ptr<CauterizedModel> weakSelf = std::dynamic_pointer_cast<CauterizedModel>(shared_from_this());
-        AbstractViewStateInterface::instance()->pushPostUpdateLambda(key, [weakSelf]() {
-            // do nothing, if the model has already been destroyed.
-            auto self = weakSelf.lock();
-            if (!self || !self->isLoaded()) {
-                return;
-            }
-
-            // lazy update of cluster matrices used for rendering.  We need to update them here, so we can correctly update the bounding box.
-            self->updateClusterMatrices();
-
-            render::ScenePointer scene = AbstractViewStateInterface::instance()->getMain3DScene();
-
-            Transform modelTransform;
-            modelTransform.setTranslation(self->getTranslation());
-            modelTransform.setRotation(self->getRotation());
-
-            PrimitiveMode primitiveMode = self->getPrimitiveMode();
-            auto renderItemKeyGlobalFlags = self->getRenderItemKeyGlobalFlags();
-            bool enableCauterization = self->getEnableCauterization();
-
-            render::Transaction transaction;
-            for (int i = 0; i < (int)self->_modelMeshRenderItemIDs.size(); i++) {
-
-                auto itemID = self->_modelMeshRenderItemIDs[i];
-                auto meshIndex = self->_modelMeshRenderItemShapes[i].meshIndex;
-
-                const auto& meshState = self->getMeshState(meshIndex);
-                const auto& cauterizedMeshState = self->getCauterizeMeshState(meshIndex);
-
-                bool invalidatePayloadShapeKey = self->shouldInvalidatePayloadShapeKey(meshIndex);
-                bool useDualQuaternionSkinning = self->getUseDualQuaternionSkinning();
-
-                transaction.updateItem<ModelMeshPartPayload>(itemID, [modelTransform, meshState, useDualQuaternionSkinning, cauterizedMeshState, invalidatePayloadShapeKey,
-                        primitiveMode, renderItemKeyGlobalFlags, enableCauterization](ModelMeshPartPayload& mmppData) {
-                    CauterizedMeshPartPayload& data = static_cast<CauterizedMeshPartPayload&>(mmppData);
-                    if (useDualQuaternionSkinning) {
-                        data.updateClusterBuffer(meshState.clusterDualQuaternions,
-                                                 cauterizedMeshState.clusterDualQuaternions);
-                        data.computeAdjustedLocalBound(meshState.clusterDualQuaternions);
-                    } else {
-                        data.updateClusterBuffer(meshState.clusterMatrices,
-                                                 cauterizedMeshState.clusterMatrices);
-                        data.computeAdjustedLocalBound(meshState.clusterMatrices);
-                    }
-
-                    Transform renderTransform = modelTransform;
-                    if (useDualQuaternionSkinning) {
-                        if (meshState.clusterDualQuaternions.size() == 1 || meshState.clusterDualQuaternions.size() == 2) {
-                            const auto& dq = meshState.clusterDualQuaternions[0];
-                            Transform transform(dq.getRotation(),
-                                                dq.getScale(),
-                                                dq.getTranslation());
-                            renderTransform = modelTransform.worldTransform(transform);
-                        }
-                    } else {
-                        if (meshState.clusterMatrices.size() == 1 || meshState.clusterMatrices.size() == 2) {
-                            renderTransform = modelTransform.worldTransform(Transform(meshState.clusterMatrices[0]));
-                        }
-                    }
-                    data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
-
-                    renderTransform = modelTransform;
-                    if (useDualQuaternionSkinning) {
-                        if (cauterizedMeshState.clusterDualQuaternions.size() == 1 || cauterizedMeshState.clusterDualQuaternions.size() == 2) {
-                            const auto& dq = cauterizedMeshState.clusterDualQuaternions[0];
-                            Transform transform(dq.getRotation(),
-                                                dq.getScale(),
-                                                dq.getTranslation());
-                            renderTransform = modelTransform.worldTransform(Transform(transform));
-                        }
-                    } else {
-                        if (cauterizedMeshState.clusterMatrices.size() == 1 || cauterizedMeshState.clusterMatrices.size() == 2) {
-                            renderTransform = modelTransform.worldTransform(Transform(cauterizedMeshState.clusterMatrices[0]));
-                        }
-                    }
-                    data.updateTransformForCauterizedMesh(renderTransform);
+        CauterizedMeshPartPayload& data = static_cast<CauterizedMeshPartPayload&>(mmppData);
+        const auto& meshState = update->meshStates[data._meshIndex];
+        const auto& cauterizedMeshState = update->cauterizeMeshStates[data._meshIndex];
+        const auto& modelTransform = update->modelTransform;
+        bool useDualQuaternionSkinning = update->useDualQuaternionSkinning;
+
+        if (useDualQuaternionSkinning) {
+            data.updateClusterBuffer(meshState.clusterDualQuaternions,
+                                     cauterizedMeshState.clusterDualQuaternions);
+            data.computeAdjustedLocalBound(meshState.clusterDualQuaternions);
+        } else {
+            data.updateClusterBuffer(meshState.clusterMatrices,
+                                     cauterizedMeshState.clusterMatrices);
+            data.computeAdjustedLocalBound(meshState.clusterMatrices);
+        }
 
-                    data.setEnableCauterization(enableCauterization);
-                    data.updateKey(renderItemKeyGlobalFlags);
-                    data.setShapeKey(invalidatePayloadShapeKey, primitiveMode, useDualQuaternionSkinning);
-                });
+        Transform renderTransform = modelTransform;
+        if (useDualQuaternionSkinning) {
+            if (meshState.clusterDualQuaternions.size() == 1 || meshState.clusterDualQuaternions.size() == 2) {
+                const auto& dq = meshState.clusterDualQuaternions[0];
+                Transform transform(dq.getRotation(),
+                                    dq.getScale(),
+                                    dq.getTranslation());
+                renderTransform = modelTransform.worldTransform(transform);
+            }
+        } else {
+            if (meshState.clusterMatrices.size() == 1 || meshState.clusterMatrices.size() == 2) {
+                renderTransform = modelTransform.worldTransform(Transform(meshState.clusterMatrices[0]));
+            }
+        }
+        data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
+
+        renderTransform = modelTransform;
+        if (useDualQuaternionSkinning) {
+            if (cauterizedMeshState.clusterDualQuaternions.size() == 1 || cauterizedMeshState.clusterDualQuaternions.size() == 2) {
+                const auto& dq = cauterizedMeshState.clusterDualQuaternions[0];
+                Transform transform(dq.getRotation(),
+                                    dq.getScale(),
+                                    dq.getTranslation());
+                renderTransform = modelTransform.worldTransform(Transform(transform));
             }
+        } else {
+            if (cauterizedMeshState.clusterMatrices.size() == 1 || cauterizedMeshState.clusterMatrices.size() == 2) {
+                renderTransform = modelTransform.worldTransform(Transform(cauterizedMeshState.clusterMatrices[0]));
+            }
+        }
+        data.updateTransformForCauterizedMesh(renderTransform);
 
-            scene->enqueueTransaction(transaction);
-        });
-    } else {
-        Model::updateRenderItems();
+        data.setEnableCauterization(update->enableCauterization);
+        data.updateKey(update->renderItemKeyGlobalFlags);
+        data.setShapeKey(update->invalidatePayloadShapeKeys[data._meshIndex], update->primitiveMode, useDualQuaternionSkinning);
+    });
+
+    for (auto itemID : _modelMeshRenderItemIDs) {
+        transaction.updateItem(itemID, functor);
     }
 }
 
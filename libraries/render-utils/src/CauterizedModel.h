@@ -32,13 +32,13 @@ public:
     bool updateGeometry() override;
 
     void createRenderItemSet() override;
-    
-    virtual void updateClusterMatrices() override;
-    void updateRenderItems() override;
 
     const Model::MeshState& getCauterizeMeshState(int index) const;
 
 protected:
+    void computeClusterMatrices() override;
+    void updateRenderItemsTransaction(render::Transaction& transaction) override;
+
     std::unordered_set<int> _cauterizeBoneSet;
     QVector<Model::MeshState> _cauterizeMeshStates;
     bool _isCauterized { false };
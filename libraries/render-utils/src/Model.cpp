@@ -203,75 +203,132 @@ void Model::updateRenderItems() {
     _needsUpdateClusterMatrices = true;
     _renderItemsNeedUpdate = false;
 
-    // queue up this work for later processing, at the end of update and just before rendering.
-    // the application will ensure only the last lambda is actually invoked.
-    void* key = (void*)this;
-    std::weak_ptr<Model> weakSelf = shared_from_this();
-    AbstractViewStateInterface::instance()->pushPostUpdateLambda(key, [weakSelf]() {
-
-        // do nothing, if the model has already been destroyed.
-        auto self = weakSelf.lock();
-        if (!self || !self->isLoaded()) {
+    queueRenderItemsUpdate();
+}
+
+// the models waiting for the update of their render items, at the end of update and just before rendering
+static std::mutex renderItemsUpdateMutex;
+static std::vector<std::weak_ptr<Model>> renderItemsUpdateQueue;
+
+void Model::queueRenderItemsUpdate() {
+    {
+        std::unique_lock<std::mutex> lock(renderItemsUpdateMutex);
+        if (_renderItemsUpdateQueued) {
             return;
         }
+        _renderItemsUpdateQueued = true;
+        renderItemsUpdateQueue.push_back(shared_from_this());
+    }
 
-        // lazy update of cluster matrices used for rendering.
-        // We need to update them here so we can correctly update the bounding box.
-        self->updateClusterMatrices();
+    // the application will ensure only the last lambda is actually invoked for a key, so all the queued models
+    // share a single one that updates them together.
+    void* key = (void*)&renderItemsUpdateQueue;
+    AbstractViewStateInterface::instance()->pushPostUpdateLambda(key, []() {
+        Model::updateQueuedRenderItems();
+    });
+}
 
-        Transform modelTransform = self->getTransform();
-        modelTransform.setScale(glm::vec3(1.0f));
+void Model::updateQueuedRenderItems() {
+    std::vector<ModelPointer> models;
+    {
+        std::unique_lock<std::mutex> lock(renderItemsUpdateMutex);
+        models.reserve(renderItemsUpdateQueue.size());
+        for (const auto& weakModel : renderItemsUpdateQueue) {
+            // do nothing, if the model has already been destroyed.
+            auto model = weakModel.lock();
+            if (!model) {
+                continue;
+            }
+            model->_renderItemsUpdateQueued = false;
+            if (model->isLoaded()) {
+                models.push_back(model);
+            }
+        }
+        renderItemsUpdateQueue.clear();
+    }
+    if (models.empty()) {
+        return;
+    }
 
-        PrimitiveMode primitiveMode = self->getPrimitiveMode();
-        auto renderItemKeyGlobalFlags = self->getRenderItemKeyGlobalFlags();
-        bool cauterized = self->isCauterized();
+    // lazy update of cluster matrices used for rendering.
+    // We need to update them here so we can correctly update the bounding box.
+    updateClusterMatrices(models);
 
-        render::Transaction transaction;
-        for (int i = 0; i < (int) self->_modelMeshRenderItemIDs.size(); i++) {
+    render::Transaction transaction;
+    for (const auto& model : models) {
+        model->updateRenderItemsTransaction(transaction);
+    }
+    AbstractViewStateInterface::instance()->getMain3DScene()->enqueueTransaction(transaction);
+}
 
-            auto itemID = self->_modelMeshRenderItemIDs[i];
-            auto meshIndex = self->_modelMeshRenderItemShapes[i].meshIndex;
+void Model::initRenderItemsUpdate(RenderItemsUpdate& update) {
+    update.meshStates = _meshStates;
+    update.invalidatePayloadShapeKeys.resize(_meshStates.size());
+    for (int i = 0; i < (int)_meshStates.size(); i++) {
+        update.invalidatePayloadShapeKeys[i] = shouldInvalidatePayloadShapeKey(i);
+    }
+    for (const auto& shape : _modelMeshRenderItemShapes) {
+        // the items of unknown meshes are left as they are, but trigger a remove/add cycle
+        if (shape.meshIndex < 0 || shape.meshIndex >= (int)_meshStates.size()) {
+            shouldInvalidatePayloadShapeKey(shape.meshIndex);
+        }
+    }
 
-            const auto& meshState = self->getMeshState(meshIndex);
+    update.modelTransform = getTransform();
+    update.modelTransform.setScale(glm::vec3(1.0f));
 
-            bool invalidatePayloadShapeKey = self->shouldInvalidatePayloadShapeKey(meshIndex);
-            bool useDualQuaternionSkinning = self->getUseDualQuaternionSkinning();
+    update.primitiveMode = getPrimitiveMode();
+    update.renderItemKeyGlobalFlags = getRenderItemKeyGlobalFlags();
+    update.useDualQuaternionSkinning = getUseDualQuaternionSkinning();
+    update.cauterized = isCauterized();
+}
 
-            transaction.updateItem<ModelMeshPartPayload>(itemID, [modelTransform, meshState, useDualQuaternionSkinning,
-                                                                  invalidatePayloadShapeKey, primitiveMode, renderItemKeyGlobalFlags, cauterized](ModelMeshPartPayload& data) {
-                if (useDualQuaternionSkinning) {
-                    data.updateClusterBuffer(meshState.clusterDualQuaternions);
-                    data.computeAdjustedLocalBound(meshState.clusterDualQuaternions);
-                } else {
-                    data.updateClusterBuffer(meshState.clusterMatrices);
-                    data.computeAdjustedLocalBound(meshState.clusterMatrices);
-                }
+void Model::updateRenderItemsTransaction(render::Transaction& transaction) {
+    auto update = std::make_shared<RenderItemsUpdate>();
+    initRenderItemsUpdate(*update);
 
-                Transform renderTransform = modelTransform;
+    // one functor updates all the items of the model
+    auto functor = std::make_shared<render::UpdateFunctor<ModelMeshPartPayload>>([update](ModelMeshPartPayload& data) {
+        if (data._meshIndex < 0 || data._meshIndex >= (int)update->meshStates.size()) {
+            return;
+        }
+        const auto& meshState = update->meshStates[data._meshIndex];
+        const auto& modelTransform = update->modelTransform;
+        bool useDualQuaternionSkinning = update->useDualQuaternionSkinning;
 
-                if (useDualQuaternionSkinning) {
-                    if (meshState.clusterDualQuaternions.size() == 1 || meshState.clusterDualQuaternions.size() == 2) {
-                        const auto& dq = meshState.clusterDualQuaternions[0];
-                        Transform transform(dq.getRotation(),
-                                            dq.getScale(),
-                                            dq.getTranslation());
-                        renderTransform = modelTransform.worldTransform(Transform(transform));
-                    }
-                } else {
-                    if (meshState.clusterMatrices.size() == 1 || meshState.clusterMatrices.size() == 2) {
-                        renderTransform = modelTransform.worldTransform(Transform(meshState.clusterMatrices[0]));
-                    }
-                }
-                data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
+        if (useDualQuaternionSkinning) {
+            data.updateClusterBuffer(meshState.clusterDualQuaternions);
+            data.computeAdjustedLocalBound(meshState.clusterDualQuaternions);
+        } else {
+            data.updateClusterBuffer(meshState.clusterMatrices);
+            data.computeAdjustedLocalBound(meshState.clusterMatrices);
+        }
 
-                data.setCauterized(cauterized);
-                data.updateKey(renderItemKeyGlobalFlags);
-                data.setShapeKey(invalidatePayloadShapeKey, primitiveMode, useDualQuaternionSkinning);
-            });
+        Transform renderTransform = modelTransform;
+
+        if (useDualQuaternionSkinning) {
+            if (meshState.clusterDualQuaternions.size() == 1 || meshState.clusterDualQuaternions.size() == 2) {
+                const auto& dq = meshState.clusterDualQuaternions[0];
+                Transform transform(dq.getRotation(),
+                                    dq.getScale(),
+                                    dq.getTranslation());
+                renderTransform = modelTransform.worldTransform(Transform(transform));
+            }
+        } else {
+            if (meshState.clusterMatrices.size() == 1 || meshState.clusterMatrices.size() == 2) {
+                renderTransform = modelTransform.worldTransform(Transform(meshState.clusterMatrices[0]));
+            }
         }
+        data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
 
-        AbstractViewStateInterface::instance()->getMain3DScene()->enqueueTransaction(transaction);
+        data.setCauterized(update->cauterized);
+        data.updateKey(update->renderItemKeyGlobalFlags);
+        data.setShapeKey(update->invalidatePayloadShapeKeys[data._meshIndex], update->primitiveMode, useDualQuaternionSkinning);
     });
+
+    for (auto itemID : _modelMeshRenderItemIDs) {
+        transaction.updateItem(itemID, functor);
+    }
 }
 
 void Model::setRenderItemsNeedUpdate() {
@@ -1022,7 +1079,11 @@ void Model::removeFromScene(const render::ScenePointer& scene, render::Transacti
     _modelMeshRenderItemShapes.clear();
     _priorityMap.clear();
 
-    _blendshapeOffsets.clear();
+    {
+        std::unique_lock<std::mutex> lock(_blendshapeMutex);
+        _blendshapeOffsets.clear();
+        _blendshapeAccumulators.clear();
+    }
     _blendshapeOffsetsInitialized = false;
 
     _addedToScene = false;
@@ -1386,11 +1447,48 @@ void Model::updateRig(float deltaTime, glm::mat4 parentTransform) {
 void Model::updateClusterMatrices() {
     DETAILED_PERFORMANCE_TIMER("Model::updateClusterMatrices");
 
-    if (!_needsUpdateClusterMatrices || !isLoaded()) {
-        return;
+    if (updateClusterMatricesIfNeeded()) {
+        noteRequiresBlendIfNeeded();
     }
+}
+
+// below this many models, the cost of dispatching to the worker threads isn't worth it
+static const size_t MIN_MODELS_TO_UPDATE_IN_PARALLEL = 4;
 
+void Model::updateClusterMatrices(const std::vector<ModelPointer>& models) {
+    DETAILED_PERFORMANCE_TIMER("Model::updateClusterMatrices");
+
+    // the rigs are only read, and each model only writes its own mesh states
+    std::vector<uint8_t> updated(models.size(), 0);
+    if (models.size() < MIN_MODELS_TO_UPDATE_IN_PARALLEL) {
+        for (size_t i = 0; i < models.size(); i++) {
+            updated[i] = models[i]->updateClusterMatricesIfNeeded();
+        }
+    } else {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, models.size()), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                updated[i] = models[i]->updateClusterMatricesIfNeeded();
+            }
+        });
+    }
+
+    for (size_t i = 0; i < models.size(); i++) {
+        if (updated[i]) {
+            models[i]->noteRequiresBlendIfNeeded();
+        }
+    }
+}
+
+bool Model::updateClusterMatricesIfNeeded() {
+    if (!_needsUpdateClusterMatrices || !isLoaded()) {
+        return false;
+    }
     _needsUpdateClusterMatrices = false;
+    computeClusterMatrices();
+    return true;
+}
+
+void Model::computeClusterMatrices() {
     const HFMModel& hfmModel = getHFMModel();
     for (int i = 0; i < (int) _meshStates.size(); i++) {
         MeshState& state = _meshStates[i];
@@ -1412,10 +1510,12 @@ void Model::updateClusterMatrices() {
             }
         }
     }
+}
 
+void Model::noteRequiresBlendIfNeeded() {
     // post the blender if we're not currently waiting for one to finish
     auto modelBlender = DependencyManager::get<ModelBlender>();
-    if (_blendshapeOffsetsInitialized && modelBlender->shouldComputeBlendshapes() && hfmModel.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
+    if (_blendshapeOffsetsInitialized && modelBlender->shouldComputeBlendshapes() && getHFMModel().hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
         _blendedBlendshapeCoefficients = _blendshapeCoefficients;
         modelBlender->noteRequiresBlend(getThisPointer());
     }
@@ -1423,7 +1523,11 @@ void Model::updateClusterMatrices() {
 
 void Model::deleteGeometry() {
     _deleteGeometryCounter++;
-    _blendshapeOffsets.clear();
+    {
+        std::unique_lock<std::mutex> lock(_blendshapeMutex);
+        _blendshapeOffsets.clear();
+        _blendshapeAccumulators.clear();
+    }
     _blendshapeOffsetsInitialized = false;
     _meshStates.clear();
     _rig.destroyAnimGraph();
@@ -1719,6 +1823,15 @@ void packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(glm::uvec4& pac
     );
 }
 
+// offsets are laid out as in hfm::SparseBlendshapes
+static void packBlendshapeOffset(BlendshapeOffset& packed, const float* offsets) {
+    BlendshapeOffsetUnpacked unpacked;
+    unpacked.positionOffset = glm::vec3(offsets[0], offsets[1], offsets[2]);
+    unpacked.normalOffset = glm::vec3(offsets[4], offsets[5], offsets[6]);
+    unpacked.tangentOffset = glm::vec3(offsets[8], offsets[9], offsets[10]);
+    packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(packed.packedPosNorTan, unpacked);
+}
+
 class Blender : public QRunnable {
 public:
 
@@ -1744,66 +1857,57 @@ Blender::Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointe
 void Blender::run() {
     QVector<BlendshapeOffset> blendshapeOffsets;
     QVector<int> blendedMeshSizes;
-    if (_model && _model->isLoaded()) {
+    auto geometry = _geometry.lock();
+    if (_model && _model->isLoaded() && geometry) {
         DETAILED_PROFILE_RANGE_EX(simulation_animation, __FUNCTION__, 0xFFFF0000, 0, { { "url", _model->getURL().toString() } });
-        int offset = 0;
         const auto& meshes = _model->getHFMModel().meshes;
-        int meshIndex = 0;
-        for(const HFMMesh& mesh : meshes) {
-            auto modelMeshBlendshapeOffsets = _model->_blendshapeOffsets.find(meshIndex++);
-            if (mesh.blendshapes.isEmpty() || modelMeshBlendshapeOffsets == _model->_blendshapeOffsets.end()) {
+
+        // Blenders of the same model take turns, each picks up the offsets left by the one before
+        std::unique_lock<std::mutex> lock(_model->_blendshapeMutex);
+
+        // reserve up front so that appending copies the offsets of each mesh rather than sharing them
+        int numBlendedVertices = 0;
+        for (const auto& modelMeshBlendshapeOffsets : _model->_blendshapeOffsets) {
+            numBlendedVertices += modelMeshBlendshapeOffsets.second.size();
+        }
+        blendshapeOffsets.reserve(numBlendedVertices);
+
+        std::vector<uint32_t> changedVertices;
+        for (int meshIndex = 0; meshIndex < meshes.size(); meshIndex++) {
+            const HFMMesh& mesh = meshes.at(meshIndex);
+            auto modelMeshBlendshapeOffsets = _model->_blendshapeOffsets.find(meshIndex);
+            auto sparseBlendshapes = geometry->getBlendshapes(meshIndex);
+            if (mesh.blendshapes.isEmpty() || !sparseBlendshapes || modelMeshBlendshapeOffsets == _model->_blendshapeOffsets.end()) {
                 // Not blendshaped or not initialized
                 blendedMeshSizes.push_back(0);
                 continue;
             }
 
-            if (mesh.vertices.size() != modelMeshBlendshapeOffsets->second.size()) {
+            QVector<BlendshapeOffset>& meshBlendshapeOffsets = modelMeshBlendshapeOffsets->second;
+            int numVertices = meshBlendshapeOffsets.size();
+            if (mesh.vertices.size() != numVertices || sparseBlendshapes->getNumVertices() != numVertices) {
                 // Mesh sizes don't match.  Something has gone wrong
                 blendedMeshSizes.push_back(0);
                 continue;
             }
 
-            blendshapeOffsets += modelMeshBlendshapeOffsets->second;
-            BlendshapeOffset* meshBlendshapeOffsets = blendshapeOffsets.data() + offset;
-            int numVertices = modelMeshBlendshapeOffsets->second.size();
-            blendedMeshSizes.push_back(numVertices);
-            offset += numVertices;
-            std::vector<BlendshapeOffsetUnpacked> unpackedBlendshapeOffsets(modelMeshBlendshapeOffsets->second.size());
-
+            // Apply the coefficients that changed, then repack only the vertices they moved
             const float NORMAL_COEFFICIENT_SCALE = 0.01f;
-            for (int i = 0, n = qMin(_blendshapeCoefficients.size(), mesh.blendshapes.size()); i < n; i++) {
-                float vertexCoefficient = _blendshapeCoefficients.at(i);
-                const float EPSILON = 0.0001f;
-                if (vertexCoefficient < EPSILON) {
-                    continue;
+            auto& accumulator = _model->_blendshapeAccumulators[meshIndex];
+            if (accumulator.update(*sparseBlendshapes, _blendshapeCoefficients, NORMAL_COEFFICIENT_SCALE, changedVertices)) {
+                BlendshapeOffset* packed = meshBlendshapeOffsets.data();
+                for (int j = 0; j < numVertices; ++j) {
+                    packBlendshapeOffset(packed[j], accumulator.getOffsets(j));
                 }
-
-                float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
-                const HFMBlendshape& blendshape = mesh.blendshapes.at(i);
-                for (int j = 0; j < blendshape.indices.size(); ++j) {
-                    int index = blendshape.indices.at(j);
-
-                    auto& currentBlendshapeOffset = unpackedBlendshapeOffsets[index];
-                    currentBlendshapeOffset.positionOffset += blendshape.vertices.at(j) * vertexCoefficient;
-
-                    currentBlendshapeOffset.normalOffset += blendshape.normals.at(j) * normalCoefficient;
-                    if (j < blendshape.tangents.size()) {
-                        currentBlendshapeOffset.tangentOffset += blendshape.tangents.at(j) * normalCoefficient;
-                    }
+            } else if (!changedVertices.empty()) {
+                BlendshapeOffset* packed = meshBlendshapeOffsets.data();
+                for (uint32_t j : changedVertices) {
+                    packBlendshapeOffset(packed[j], accumulator.getOffsets(j));
                 }
             }
 
-            // Blendshape offsets are generrated, now let's pack it on its way to gpu
-            // FIXME it feels like we could be more effectively using SIMD here
-            {
-                auto unpacked = unpackedBlendshapeOffsets.data();
-                auto packed = meshBlendshapeOffsets;
-                for (int j = 0; j < (int)unpackedBlendshapeOffsets.size(); ++j) {
-                    packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10((*packed).packedPosNorTan, (*unpacked));
-                    ++unpacked;
-                    ++packed;
-                }
-            }
+            blendshapeOffsets += meshBlendshapeOffsets;
+            blendedMeshSizes.push_back(numVertices);
         }
     }
     // post the result to the ModelBlender, which will dispatch to the model if still alive
@@ -1828,6 +1932,7 @@ void Model::initializeBlendshapes(const HFMMesh& mesh, int index) {
         return;
     }
     // Mesh has blendshape, let s allocate the local buffer if not done yet
+    std::unique_lock<std::mutex> lock(_blendshapeMutex);
     if (_blendshapeOffsets.find(index) == _blendshapeOffsets.end()) {
         QVector<BlendshapeOffset> blendshapeOffset;
         blendshapeOffset.fill(BlendshapeOffset(), mesh.vertices.size());
@@ -175,7 +175,12 @@ public:
     bool getSnapModelToRegistrationPoint() { return _snapModelToRegistrationPoint; }
 
     virtual void simulate(float deltaTime, bool fullUpdate = true);
-    virtual void updateClusterMatrices();
+
+    // lazy update of the cluster matrices used for rendering, which posts the blend of the model when needed
+    void updateClusterMatrices();
+
+    // Updates the cluster matrices of many models at once over worker threads, then posts their blends from this thread
+    static void updateClusterMatrices(const std::vector<ModelPointer>& models);
 
     /// Returns a reference to the shared geometry.
     const Geometry::Pointer& getGeometry() const { return _renderGeometry; }
@@ -343,6 +348,21 @@ public:
 
     const MeshState& getMeshState(int index) { return _meshStates.at(index); }
 
+    // The state of a model that the updates of all its render items share: the items look up the cluster matrices
+    // of their mesh by index instead of each carrying a copy of them
+    class RenderItemsUpdate {
+    public:
+        std::vector<MeshState> meshStates;
+        std::vector<MeshState> cauterizeMeshStates;
+        std::vector<bool> invalidatePayloadShapeKeys;
+        Transform modelTransform;
+        PrimitiveMode primitiveMode { PrimitiveMode::SOLID };
+        render::ItemKey renderItemKeyGlobalFlags;
+        bool useDualQuaternionSkinning { false };
+        bool cauterized { false };
+        bool enableCauterization { false };
+    };
+
     uint32_t getGeometryCounter() const { return _deleteGeometryCounter; }
     const QMap<render::ItemID, render::PayloadPointer>& getRenderItems() const { return _modelMeshRenderItemsMap; }
     BlendShapeOperator getModelBlendshapeOperator() const { return _modelBlendshapeOperator; }
@@ -365,6 +385,10 @@ public:
 
     std::unordered_map<int, QVector<BlendshapeOffset>> _blendshapeOffsets;
 
+    // what the Blender has blended so far, so that the next blend only applies the coefficients that changed
+    std::unordered_map<int, hfm::BlendshapeAccumulator> _blendshapeAccumulators;
+    std::mutex _blendshapeMutex;
+
 public slots:
     void loadURLFinished(bool success);
 
@@ -430,6 +454,14 @@ protected:
 
     virtual void updateRig(float deltaTime, glm::mat4 parentTransform);
 
+    // Computes the cluster matrices of every mesh from the rig.  This may run on a worker thread, concurrently with
+    // the same call on other models, so it must only write to this model.
+    virtual void computeClusterMatrices();
+
+    // Adds the updates of the render items of this model, whose cluster matrices are up to date, to the transaction
+    virtual void updateRenderItemsTransaction(render::Transaction& transaction);
+    void initRenderItemsUpdate(RenderItemsUpdate& update);
+
     /// Allow sub classes to force invalidating the bboxes
     void invalidCalculatedMeshBoxes() {
         _triangleSetsValid = false;
@@ -514,6 +546,14 @@ protected:
 private:
     float _loadingPriority { 0.0f };
 
+    bool updateClusterMatricesIfNeeded();
+    void noteRequiresBlendIfNeeded();
+
+    // the render items of the models queued by updateRenderItems are updated together at the end of update
+    void queueRenderItemsUpdate();
+    static void updateQueuedRenderItems();
+    bool _renderItemsUpdateQueued { false };
+
     void calculateTextureInfo();
 
     std::set<unsigned int> getMeshIDsFromMaterialID(QString parentMaterialName);
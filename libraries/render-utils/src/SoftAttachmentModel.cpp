@@ -31,16 +31,7 @@ int SoftAttachmentModel::getJointIndexOverride(int i) const {
 
 // virtual
 // use the _rigOverride matrices instead of the Model::_rig
-void SoftAttachmentModel::updateClusterMatrices() {
-    if (!_needsUpdateClusterMatrices) {
-        return;
-    }
-    if (!isLoaded()) {
-        return;
-    }
-
-    _needsUpdateClusterMatrices = false;
-
+void SoftAttachmentModel::computeClusterMatrices() {
     const HFMModel& hfmModel = getHFMModel();
 
     for (int i = 0; i < (int) _meshStates.size(); i++) {
@@ -68,11 +59,4 @@ void SoftAttachmentModel::updateClusterMatrices() {
             }
         }
     }
-
-    // post the blender if we're not currently waiting for one to finish
-    auto modelBlender = DependencyManager::get<ModelBlender>();
-    if (_blendshapeOffsetsInitialized && modelBlender->shouldComputeBlendshapes() && hfmModel.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
-        _blendedBlendshapeCoefficients = _blendshapeCoefficients;
-        modelBlender->noteRequiresBlend(getThisPointer());
-    }
 }
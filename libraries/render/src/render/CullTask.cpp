@@ -16,9 +16,23 @@
 
 #include <PerfStat.h>
 #include <OctreeUtils.h>
+#include <TBBHelpers.h>
+
+// on x86 architecture, assume that SSE2 is present
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define CULL_SSE
+#endif
 
 using namespace render;
 
+// ranges of items culled by a worker, and the least number of items worth spreading over workers
+static const size_t CULL_RANGE_SIZE = 1024;
+static const size_t MIN_ITEMS_TO_CULL_IN_PARALLEL = 4096;
+
+// an item that passed the filter and has yet to be tested
+static const uint8_t UNTESTED = ItemCuller::VISIBLE + 1;
+
 CullTest::CullTest(CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item& renderDetails, ViewFrustumPointer antiFrustum) :
     _functor(functor),
     _args(pargs),
@@ -70,40 +84,146 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
     assert(renderContext->args->hasViewFrustum());
 
     RenderArgs* args = renderContext->args;
-    const ViewFrustum& frustum = args->getViewFrustum();
 
     details._considered += (int)inItems.size();
 
     // Culling / LOD
-    for (auto item : inItems) {
-        if (item.bound.isNull()) {
-            outItems.emplace_back(item); // One more Item to render
-            continue;
+    // TODO: some entity types (like lights) might want to be rendered even
+    // when they are outside of the view frustum...
+    ItemCuller culler;
+    {
+        PerformanceTimer perfTimer("cullItems");
+        culler.cull(inItems, args, cullFunctor, true, true);
+    }
+    for (size_t i = 0; i < inItems.size(); ++i) {
+        switch (culler.getResult(i)) {
+            case ItemCuller::VISIBLE:
+                outItems.emplace_back(inItems[i]); // One more Item to render
+                break;
+            case ItemCuller::OUT_OF_VIEW:
+                details._outOfView++;
+                break;
+            case ItemCuller::TOO_SMALL:
+                details._tooSmall++;
+                break;
+            default:
+                break;
         }
+    }
+    details._rendered += (int)outItems.size();
+}
 
-        // TODO: some entity types (like lights) might want to be rendered even
-        // when they are outside of the view frustum...
-        bool inView;
-        {
-            PerformanceTimer perfTimer("boxIntersectsFrustum");
-            inView = frustum.boxIntersectsFrustum(item.bound);
+void ItemCuller::cull(const PackedItems& items, const ItemFilter& filter, const RenderArgs* args,
+                      const CullFunctor& cullFunctor, bool frustumTest, bool solidAngleTest) {
+    cullRanges(items.size(), args, cullFunctor, frustumTest, solidAngleTest, [&](size_t index) {
+        if (!filter.test(items.keys[index])) {
+            return (uint8_t)FILTERED_OUT;
+        }
+        setBound(index, items.bounds[index]);
+        return UNTESTED;
+    });
+}
+
+void ItemCuller::cull(const ItemBounds& items, const RenderArgs* args, const CullFunctor& cullFunctor,
+                      bool frustumTest, bool solidAngleTest) {
+    cullRanges(items.size(), args, cullFunctor, frustumTest, solidAngleTest, [&](size_t index) {
+        const AABox& bound = items[index].bound;
+        setBound(index, bound);
+        return (uint8_t)(bound.isNull() ? VISIBLE : UNTESTED);
+    });
+}
+
+AABox ItemCuller::getBound(size_t index) const {
+    return AABox(glm::vec3(_cornerX[index], _cornerY[index], _cornerZ[index]),
+                 glm::vec3(_scaleX[index], _scaleY[index], _scaleZ[index]));
+}
+
+void ItemCuller::setBound(size_t index, const AABox& bound) {
+    const glm::vec3& corner = bound.getCorner();
+    const glm::vec3& scale = bound.getScale();
+    _cornerX[index] = corner.x;
+    _cornerY[index] = corner.y;
+    _cornerZ[index] = corner.z;
+    _scaleX[index] = scale.x;
+    _scaleY[index] = scale.y;
+    _scaleZ[index] = scale.z;
+}
+
+template <typename Fetch>
+void ItemCuller::cullRanges(size_t numItems, const RenderArgs* args, const CullFunctor& cullFunctor, bool frustumTest,
+                            bool solidAngleTest, const Fetch& fetch) {
+    // each range only writes its own part of the arrays
+    _results.resize(numItems);
+    _cornerX.resize(numItems);
+    _cornerY.resize(numItems);
+    _cornerZ.resize(numItems);
+    _scaleX.resize(numItems);
+    _scaleY.resize(numItems);
+    _scaleZ.resize(numItems);
+
+    const ViewFrustum& frustum = args->getViewFrustum();
+    auto cullRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            _results[i] = fetch(i);
+        }
+        if (frustumTest) {
+            frustumTestRange(frustum, begin, end);
         }
-        if (inView) {
-            bool bigEnoughToRender;
-            {
-                PerformanceTimer perfTimer("shouldRender");
-                bigEnoughToRender = cullFunctor(args, item.bound);
+        for (size_t i = begin; i < end; ++i) {
+            if (_results[i] == UNTESTED) {
+                _results[i] = (!solidAngleTest || cullFunctor(args, getBound(i))) ? VISIBLE : TOO_SMALL;
             }
-            if (bigEnoughToRender) {
-                outItems.emplace_back(item); // One more Item to render
-            } else {
-                details._tooSmall++;
+        }
+    };
+
+    if (numItems >= MIN_ITEMS_TO_CULL_IN_PARALLEL) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, numItems, CULL_RANGE_SIZE), [&](const tbb::blocked_range<size_t>& range) {
+            cullRange(range.begin(), range.end());
+        });
+    } else {
+        cullRange(0, numItems);
+    }
+}
+
+void ItemCuller::frustumTestRange(const ViewFrustum& frustum, size_t begin, size_t end) {
+    // Same test as ViewFrustum::boxIntersectsFrustum: a box is out of view when its vertex farthest along the normal of
+    // a plane is behind it. That vertex is picked per plane, so four boxes go through the same arithmetic.
+    const ::Plane* planes = frustum.getPlanes();
+    size_t i = begin;
+
+#ifdef CULL_SSE
+    for (; i + 4 <= end; i += 4) {
+        __m128 cornerX = _mm_loadu_ps(&_cornerX[i]);
+        __m128 cornerY = _mm_loadu_ps(&_cornerY[i]);
+        __m128 cornerZ = _mm_loadu_ps(&_cornerZ[i]);
+        __m128 scaleX = _mm_loadu_ps(&_scaleX[i]);
+        __m128 scaleY = _mm_loadu_ps(&_scaleY[i]);
+        __m128 scaleZ = _mm_loadu_ps(&_scaleZ[i]);
+        __m128 outside = _mm_setzero_ps();
+        for (int j = 0; j < NUM_FRUSTUM_PLANES; ++j) {
+            const glm::vec3& normal = planes[j].getNormal();
+            __m128 x = normal.x > 0.0f ? _mm_add_ps(cornerX, scaleX) : cornerX;
+            __m128 y = normal.y > 0.0f ? _mm_add_ps(cornerY, scaleY) : cornerY;
+            __m128 z = normal.z > 0.0f ? _mm_add_ps(cornerZ, scaleZ) : cornerZ;
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(normal.x), x), _mm_mul_ps(_mm_set1_ps(normal.y), y)),
+                                    _mm_mul_ps(_mm_set1_ps(normal.z), z));
+            __m128 distance = _mm_add_ps(_mm_set1_ps(planes[j].getDCoefficient()), dot);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+        }
+        int outsideMask = _mm_movemask_ps(outside);
+        for (size_t k = 0; k < 4; ++k) {
+            if ((outsideMask & (1 << k)) && _results[i + k] == UNTESTED) {
+                _results[i + k] = OUT_OF_VIEW;
             }
-        } else {
-            details._outOfView++;
         }
     }
-    details._rendered += (int)outItems.size();
+#endif
+
+    for (; i < end; ++i) {
+        if (_results[i] == UNTESTED && !frustum.boxIntersectsFrustum(getBound(i))) {
+            _results[i] = OUT_OF_VIEW;
+        }
+    }
 }
 
 void FetchNonspatialItems::run(const RenderContextPointer& renderContext, const ItemFilter& filter, ItemBounds& outItems) {
@@ -195,8 +315,6 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
         args->pushViewFrustum(_frozenFrustum); // replace the true view frustum by the frozen one
     }
 
-    CullTest test(_cullFunctor, args, details);
-
     // Now we have a selection of items to render
     outItems.clear();
     outItems.reserve(inSelection.numItems());
@@ -205,140 +323,57 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
     if (!srcFilter.selectsNothing()) {
         auto filter = render::ItemFilter::Builder(srcFilter).withoutSubMetaCulled().build();
 
-        // Now get the bound, and
-        // filter individually against the _filter
-        // visibility cull if partially selected ( octree cell contianing it was partial)
-        // distance cull if was a subcell item ( octree cell is way bigger than the item bound itself, so now need to test per item)
-        if (_skipCulling) {
-            // inside & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
+        // Cull one list of the selection and gather the survivors, in the order of the list
+        auto cullSelectedItems = [&](const PackedItems& items, bool frustumTest, bool solidAngleTest) {
+            _culler.cull(items, filter, args, _cullFunctor, frustumTest && !_skipCulling, solidAngleTest && !_skipCulling);
+            for (size_t i = 0; i < items.size(); ++i) {
+                switch (_culler.getResult(i)) {
+                    case ItemCuller::VISIBLE:
+                        outItems.emplace_back(ItemBound(items.ids[i], items.bounds[i]));
+                        if (items.keys[i].isMetaCullGroup()) {
+                            scene->getItem(items.ids[i]).fetchMetaSubItemBounds(outItems, (*scene));
                         }
-                    }
+                        break;
+                    case ItemCuller::OUT_OF_VIEW:
+                        details._outOfView++;
+                        break;
+                    case ItemCuller::TOO_SMALL:
+                        details._tooSmall++;
+                        break;
+                    default:
+                        break;
                 }
             }
+        };
 
-            // inside & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-        } else {
+        // Now get the bound, and
+        // filter individually against the _filter
+        // visibility cull if partially selected ( octree cell contianing it was partial)
+        // distance cull if was a subcell item ( octree cell is way bigger than the item bound itself, so now need to test per item)
+        // when _skipCulling is set, all the items are only filtered
 
-            // inside & fit items: easy, just filter
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
+        // inside & fit items: easy, just filter
+        {
+            PerformanceTimer perfTimer("insideFitItems");
+            cullSelectedItems(inSelection.insideItems, false, false);
+        }
 
-            // inside & subcell items: filter & distance cull
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.solidAngleTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
+        // inside & subcell items: filter & distance cull
+        {
+            PerformanceTimer perfTimer("insideSmallItems");
+            cullSelectedItems(inSelection.insideSubcellItems, false, true);
+        }
 
-            // partial & fit items: filter & frustum cull
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
+        // partial & fit items: filter & frustum cull
+        {
+            PerformanceTimer perfTimer("partialFitItems");
+            cullSelectedItems(inSelection.partialItems, true, false);
+        }
 
-            // partial & subcell items:: filter & frutum cull & solidangle cull
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            if (test.solidAngleTest(itemBound.bound)) {
-                                outItems.emplace_back(itemBound);
-                                if (item.getKey().isMetaCullGroup()) {
-                                    item.fetchMetaSubItemBounds(outItems, (*scene));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+        // partial & subcell items:: filter & frutum cull & solidangle cull
+        {
+            PerformanceTimer perfTimer("partialSmallItems");
+            cullSelectedItems(inSelection.partialSubcellItems, true, true);
         }
     }
 
@@ -463,7 +498,7 @@ void FilterSpatialSelection::run(const RenderContextPointer& renderContext,
         // inside & fit items: filter only
         {
             PerformanceTimer perfTimer("insideFitItems");
-            for (auto id : inSelection.insideItems) {
+            for (auto id : inSelection.insideItems.ids) {
                 auto& item = scene->getItem(id);
                 if (filter.test(item.getKey())) {
                     ItemBound itemBound(id, item.getBound());
@@ -475,7 +510,7 @@ void FilterSpatialSelection::run(const RenderContextPointer& renderContext,
         // inside & subcell items: filter only
         {
             PerformanceTimer perfTimer("insideSmallItems");
-            for (auto id : inSelection.insideSubcellItems) {
+            for (auto id : inSelection.insideSubcellItems.ids) {
                 auto& item = scene->getItem(id);
                 if (filter.test(item.getKey())) {
                     ItemBound itemBound(id, item.getBound());
@@ -488,7 +523,7 @@ void FilterSpatialSelection::run(const RenderContextPointer& renderContext,
         // partial & fit items: filter only
         {
             PerformanceTimer perfTimer("partialFitItems");
-            for (auto id : inSelection.partialItems) {
+            for (auto id : inSelection.partialItems.ids) {
                 auto& item = scene->getItem(id);
                 if (filter.test(item.getKey())) {
                     ItemBound itemBound(id, item.getBound());
@@ -500,7 +535,7 @@ void FilterSpatialSelection::run(const RenderContextPointer& renderContext,
         // partial & subcell items: filter only
         {
             PerformanceTimer perfTimer("partialSmallItems");
-            for (auto id : inSelection.partialSubcellItems) {
+            for (auto id : inSelection.partialSubcellItems.ids) {
                 auto& item = scene->getItem(id);
                 if (filter.test(item.getKey())) {
                     ItemBound itemBound(id, item.getBound());
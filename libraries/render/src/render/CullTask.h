@@ -38,6 +38,45 @@ namespace render {
         bool solidAngleTest(const AABox& bound);
     };
 
+    // Culls lists of items in ranges spread over worker threads. The bounds of a range are packed in structure of arrays
+    // form and tested against the frustum planes four at a time, then the ones in view go through the cull functor, which
+    // must be safe to call from any thread. The results are read back in the order of the list.
+    class ItemCuller {
+    public:
+        enum Result : uint8_t {
+            FILTERED_OUT = 0,
+            OUT_OF_VIEW,
+            TOO_SMALL,
+            VISIBLE,
+        };
+
+        // Culls the items that pass the filter, with the keys and bounds packed along with them by the spatial tree
+        void cull(const PackedItems& items, const ItemFilter& filter, const RenderArgs* args,
+            const CullFunctor& cullFunctor, bool frustumTest, bool solidAngleTest);
+
+        // Culls items with known bounds, the ones with a null bound are always visible
+        void cull(const ItemBounds& items, const RenderArgs* args, const CullFunctor& cullFunctor, bool frustumTest, bool solidAngleTest);
+
+        size_t size() const { return _results.size(); }
+        Result getResult(size_t index) const { return (Result)_results[index]; }
+        AABox getBound(size_t index) const;
+
+    private:
+        template <typename Fetch>
+        void cullRanges(size_t numItems, const RenderArgs* args, const CullFunctor& cullFunctor, bool frustumTest,
+            bool solidAngleTest, const Fetch& fetch);
+        void setBound(size_t index, const AABox& bound);
+        void frustumTestRange(const ViewFrustum& frustum, size_t begin, size_t end);
+
+        std::vector<uint8_t> _results;
+        std::vector<float> _cornerX;
+        std::vector<float> _cornerY;
+        std::vector<float> _cornerZ;
+        std::vector<float> _scaleX;
+        std::vector<float> _scaleY;
+        std::vector<float> _scaleZ;
+    };
+
     class FetchNonspatialItems {
     public:
         using JobModel = Job::ModelIO<FetchNonspatialItems, ItemFilter, ItemBounds>;
@@ -119,6 +158,7 @@ namespace render {
 
         CullFunctor _cullFunctor;
         RenderDetails::Type _detailType{ RenderDetails::OTHER };
+        ItemCuller _culler;
 
         void configure(const Config& config);
         void run(const RenderContextPointer& renderContext, const Inputs& inputs, ItemBounds& outItems);
@@ -208,16 +208,16 @@ void DrawItemSelection::run(const RenderContextPointer& renderContext, const Ite
         };
 
         if (_showInsideItems) {
-            drawItemBounds(inSelection.insideItems, _boundsBufferInside);
+            drawItemBounds(inSelection.insideItems.ids, _boundsBufferInside);
         }
         if (_showInsideSubcellItems) {
-            drawItemBounds(inSelection.insideSubcellItems, _boundsBufferInsideSubcell);
+            drawItemBounds(inSelection.insideSubcellItems.ids, _boundsBufferInsideSubcell);
         }
         if (_showPartialItems) {
-            drawItemBounds(inSelection.partialItems, _boundsBufferPartial);
+            drawItemBounds(inSelection.partialItems.ids, _boundsBufferPartial);
         }
         if (_showPartialSubcellItems) {
-            drawItemBounds(inSelection.partialSubcellItems, _boundsBufferPartialSubcell);
+            drawItemBounds(inSelection.partialSubcellItems.ids, _boundsBufferPartialSubcell);
         }
         batch.setResourceBuffer(0, 0);
     });
@@ -315,12 +315,80 @@ Octree::Locations ItemSpatialTree::evalLocations(const ItemBounds& bounds) const
     return locations;
 }
 
-ItemSpatialTree::Index ItemSpatialTree::insertItem(Index cellIdx, const ItemKey& key, const ItemID& item) {
+void PackedItems::clear() {
+    ids.clear();
+    keys.clear();
+    bounds.clear();
+}
+
+uint32_t PackedItems::push_back(const ItemID& id, const ItemKey& key, const AABox& bound) {
+    ids.push_back(id);
+    keys.push_back(key);
+    bounds.push_back(bound);
+    return (uint32_t)(ids.size() - 1);
+}
+
+void PackedItems::append(const PackedItems& items) {
+    ids.insert(ids.end(), items.ids.begin(), items.ids.end());
+    keys.insert(keys.end(), items.keys.begin(), items.keys.end());
+    bounds.insert(bounds.end(), items.bounds.begin(), items.bounds.end());
+}
+
+ItemID PackedItems::swapRemove(uint32_t slot) {
+    auto last = ids.size() - 1;
+    auto movedID = Item::INVALID_ITEM_ID;
+    if (slot != last) {
+        movedID = ids[last];
+        ids[slot] = ids[last];
+        keys[slot] = keys[last];
+        bounds[slot] = bounds[last];
+    }
+    ids.pop_back();
+    keys.pop_back();
+    bounds.pop_back();
+    return movedID;
+}
+
+bool PackedItems::update(uint32_t slot, const ItemKey& key, const AABox& bound) {
+    if (keys[slot] == key && bounds[slot] == bound) {
+        return false;
+    }
+    keys[slot] = key;
+    bounds[slot] = bound;
+    return true;
+}
+
+bool ItemSpatialTree::findItemSlot(const PackedItems& items, const ItemID& item, uint32_t& slot) const {
+    if (item >= _itemSlots.size()) {
+        return false;
+    }
+    slot = _itemSlots[item];
+    return slot < items.size() && items.ids[slot] == item;
+}
+
+void ItemSpatialTree::insertItemSlot(PackedItems& items, const ItemKey& key, const AABox& bound, const ItemID& item) {
+    if (item >= _itemSlots.size()) {
+        _itemSlots.resize(item + 1);
+    }
+    _itemSlots[item] = items.push_back(item, key, bound);
+}
+
+void ItemSpatialTree::removeItemSlot(PackedItems& items, const ItemID& item) {
+    uint32_t slot;
+    if (findItemSlot(items, item, slot)) {
+        auto movedID = items.swapRemove(slot);
+        if (Item::isValidID(movedID)) {
+            _itemSlots[movedID] = slot;
+        }
+    }
+}
+
+ItemSpatialTree::Index ItemSpatialTree::insertItem(Index cellIdx, const ItemKey& key, const AABox& bound, const ItemID& item) {
     // Add the item to the brick (and a brick if needed)
     accessCellBrick(cellIdx, [&](Cell& cell, Brick& brick, Octree::Index cellID) {
         auto& itemIn = (key.isSmall() ? brick.subcellItems : brick.items);
 
-        itemIn.push_back(item);
+        insertItemSlot(itemIn, key, bound, item);
 
         cell.setBrickFilled();
     }, true);
@@ -328,23 +396,29 @@ ItemSpatialTree::Index ItemSpatialTree::insertItem(Index cellIdx, const ItemKey&
     return cellIdx;
 }
 
-bool ItemSpatialTree::updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const ItemID& item) {
+bool ItemSpatialTree::updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const AABox& bound, const ItemID& item) {
     // In case we missed that one, nothing to do
     if (cellIdx == INVALID_CELL) {
         return true;
     }
     auto success = false;
 
-    // only if key changed
-    assert(oldKey != key);
-
-    // Get to the brick where the item is and update where it s stored
+    // Get to the brick where the item is and update where it s stored, and the key and bound it s stored with
     accessCellBrick(cellIdx, [&](Cell& cell, Brick& brick, Octree::Index cellID) {
         auto& itemIn = (key.isSmall() ? brick.subcellItems : brick.items);
         auto& itemOut = (oldKey.isSmall() ? brick.subcellItems : brick.items);
 
-        itemIn.push_back(item);
-        itemOut.erase(std::find(itemOut.begin(), itemOut.end(), item));
+        if (&itemIn == &itemOut) {
+            uint32_t slot;
+            if (findItemSlot(itemIn, item, slot)) {
+                itemIn.update(slot, key, bound);
+                success = true;
+            }
+        } else {
+            removeItemSlot(itemOut, item);
+            insertItemSlot(itemIn, key, bound, item);
+            success = true;
+        }
     }, false); // do not create brick!
 
     return success;
@@ -362,7 +436,7 @@ bool ItemSpatialTree::removeItem(Index cellIdx, const ItemKey& key, const ItemID
     accessCellBrick(cellIdx, [&](Cell& cell, Brick& brick, Octree::Index brickID) {
         auto& itemList = (key.isSmall() ? brick.subcellItems : brick.items);
 
-        itemList.erase(std::find(itemList.begin(), itemList.end(), item));
+        removeItemSlot(itemList, item);
 
         if (brick.items.empty() && brick.subcellItems.empty()) {
             cell.setBrickEmpty();
@@ -409,24 +483,20 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
         }
         return newCell;
     }
-    // Staying in the same cell
+    // Staying in the same cell, the key and bound culling reads from the brick may still have changed
     else if (newCell == oldCell) {
-        // Did the key changed, if yes update
-        if (newKey._flags != oldKey._flags) {
-            updateItem(newCell, oldKey, newKey, item);
-            return newCell;
-        }
+        updateItem(newCell, oldKey, newKey, bound, item);
         return newCell;
     }
     // do we know about this item ?
     else if (oldCell == INVALID_CELL) {
-        insertItem(newCell, newKey, item);
+        insertItem(newCell, newKey, bound, item);
         return newCell;
     }
     // A true update of cell is required
     else {
         // Add the item to the brick (and a brick if needed)
-        insertItem(newCell, newKey, item);
+        insertItem(newCell, newKey, bound, item);
 
         // And remove it from the previous one
         removeItem(oldCell, oldKey, item);
@@ -633,19 +703,13 @@ int ItemSpatialTree::selectCellItems(ItemSelection& selection, const ItemFilter&
 
     // Just grab the items in every selected bricks
     for (auto brickId : selection.cellSelection.insideBricks) {
-        auto& brickItems = getConcreteBrick(brickId).items;
-        selection.insideItems.insert(selection.insideItems.end(), brickItems.begin(), brickItems.end());
-
-        auto& brickSubcellItems = getConcreteBrick(brickId).subcellItems;
-        selection.insideSubcellItems.insert(selection.insideSubcellItems.end(), brickSubcellItems.begin(), brickSubcellItems.end());
+        selection.insideItems.append(getConcreteBrick(brickId).items);
+        selection.insideSubcellItems.append(getConcreteBrick(brickId).subcellItems);
     }
 
     for (auto brickId : selection.cellSelection.partialBricks) {
-        auto& brickItems = getConcreteBrick(brickId).items;
-        selection.partialItems.insert(selection.partialItems.end(), brickItems.begin(), brickItems.end());
-
-        auto& brickSubcellItems = getConcreteBrick(brickId).subcellItems;
-        selection.partialSubcellItems.insert(selection.partialSubcellItems.end(), brickSubcellItems.begin(), brickSubcellItems.end());
+        selection.partialItems.append(getConcreteBrick(brickId).items);
+        selection.partialSubcellItems.append(getConcreteBrick(brickId).subcellItems);
     }
 
     return (int) selection.numItems();
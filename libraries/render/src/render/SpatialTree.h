@@ -27,10 +27,31 @@
 
 namespace render {
 
+    // Items with the key and bound they had at their last transaction, packed by field so that culling reads them
+    // in sequence instead of visiting every item and its payload
+    class PackedItems {
+    public:
+        ItemIDs ids;
+        std::vector<ItemKey> keys;
+        std::vector<AABox> bounds;
+
+        size_t size() const { return ids.size(); }
+        bool empty() const { return ids.empty(); }
+        void clear();
+
+        // Returns the slot the item was stored at
+        uint32_t push_back(const ItemID& id, const ItemKey& key, const AABox& bound);
+        void append(const PackedItems& items);
+        // Moves the last item into the slot, returns its id or INVALID_ITEM_ID if the slot was the last one
+        ItemID swapRemove(uint32_t slot);
+        // Returns false if the item already had that key and bound
+        bool update(uint32_t slot, const ItemKey& key, const AABox& bound);
+    };
+
     class Brick {
     public:
-        std::vector<ItemID> items;
-        std::vector<ItemID> subcellItems;
+        PackedItems items;
+        PackedItems subcellItems;
 
         void free() {};
     };
@@ -375,6 +396,13 @@ namespace render {
         float _invSize { 1.0f / _size };
         glm::vec3 _origin { -16384.0f };
 
+        // Slot of each item in the PackedItems of its brick, indexed by ItemID
+        std::vector<uint32_t> _itemSlots;
+
+        bool findItemSlot(const PackedItems& items, const ItemID& item, uint32_t& slot) const;
+        void insertItemSlot(PackedItems& items, const ItemKey& key, const AABox& bound, const ItemID& item);
+        void removeItemSlot(PackedItems& items, const ItemID& item);
+
         void init(glm::vec3 origin, float size) {
             _size = size;
             _invSize = 1.0f / _size;
@@ -440,8 +468,8 @@ namespace render {
 
         // Managing itemsInserting items in cells
         // Cells need to have been allocated first calling indexCell
-        Index insertItem(Index cellIdx, const ItemKey& key, const ItemID& item);
-        bool updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const ItemID& item);
+        Index insertItem(Index cellIdx, const ItemKey& key, const AABox& bound, const ItemID& item);
+        bool updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const AABox& bound, const ItemID& item);
         bool removeItem(Index cellIdx, const ItemKey& key, const ItemID& item);
 
         Index resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey);
@@ -452,13 +480,13 @@ namespace render {
         class ItemSelection {
         public:
             CellSelection cellSelection;
-            ItemIDs insideItems;
-            ItemIDs insideSubcellItems;
-            ItemIDs partialItems;
-            ItemIDs partialSubcellItems;
+            PackedItems insideItems;
+            PackedItems insideSubcellItems;
+            PackedItems partialItems;
+            PackedItems partialSubcellItems;
 
-            ItemIDs& items(bool inside) { return (inside ? insideItems : partialItems); }
-            ItemIDs& subcellItems(bool inside) { return (inside ? insideSubcellItems : partialSubcellItems); }
+            PackedItems& items(bool inside) { return (inside ? insideItems : partialItems); }
+            PackedItems& subcellItems(bool inside) { return (inside ? insideSubcellItems : partialSubcellItems); }
 
             size_t insideNumItems() const { return insideItems.size() + insideSubcellItems.size(); }
             size_t partialNumItems() const { return partialItems.size() + partialSubcellItems.size(); }
@@ -681,6 +681,7 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, AvatarEntityMapToScriptValue, AvatarEntityMapFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<QUuid>>(this);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID>>(this);
+    qScriptRegisterSequenceMetaType<QVector<EntityItemProperties>>(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2>>(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat>>(this);
@@ -15,6 +15,7 @@
 #include "Transform.h"
 #include "Extents.h"
 #include "GeometryUtil.h"
+#include "GLMHelpers.h"
 #include "NumericalConstants.h"
 
 const glm::vec3 AABox::INFINITY_VECTOR(std::numeric_limits<float>::infinity());
@@ -546,10 +547,33 @@ void AABox::transform(const Transform& transform) {
 
 // Logic based on http://clb.demon.fi/MathGeoLib/nightly/docs/AABB.cpp_code.html#471
 void AABox::transform(const glm::mat4& matrix) {
-    // FIXME use simd operations
     auto halfSize = _scale * 0.5f;
     auto center = _corner + halfSize;
     halfSize = abs(halfSize);
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    // the new half size is the sum of the absolute columns of the matrix weighted by the half size
+    __m128 col0 = _mm_loadu_ps(&matrix[0][0]);
+    __m128 col1 = _mm_loadu_ps(&matrix[1][0]);
+    __m128 col2 = _mm_loadu_ps(&matrix[2][0]);
+    __m128 col3 = _mm_loadu_ps(&matrix[3][0]);
+    __m128 signBits = _mm_set1_ps(-0.0f);
+    __m128 newDir = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signBits, col0), _mm_set1_ps(halfSize.x)),
+                                          _mm_mul_ps(_mm_andnot_ps(signBits, col1), _mm_set1_ps(halfSize.y))),
+                               _mm_mul_ps(_mm_andnot_ps(signBits, col2), _mm_set1_ps(halfSize.z)));
+    __m128 newCenter = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(center.x)), _mm_mul_ps(col1, _mm_set1_ps(center.y))),
+                                  _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(center.z)), col3));
+
+    glm::vec4 dir;
+    glm::vec4 point;
+    _mm_storeu_ps(&dir[0], newDir);
+    _mm_storeu_ps(&point[0], newCenter);
+    if (point.w != 1.0f) {
+        point *= (1.0f / point.w);
+    }
+    _corner = glm::vec3(point) - glm::vec3(dir);
+    _scale = glm::vec3(dir) * 2.0f;
+#else
     auto mm = glm::transpose(glm::mat3(matrix));
     vec3 newDir = vec3(
         glm::dot(glm::abs(mm[0]), halfSize),
@@ -560,6 +584,7 @@ void AABox::transform(const glm::mat4& matrix) {
     auto newCenter = transformPoint(matrix, center);
     _corner = newCenter - newDir;
     _scale = newDir * 2.0f;
+#endif
 }
 
 AABox AABox::getOctreeChild(OctreeChild child) const {
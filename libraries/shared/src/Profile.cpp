@@ -39,7 +39,7 @@ Q_LOGGING_CATEGORY(trace_baker, "trace.baker")
 #endif
 
 static bool tracingEnabled() {
-    return DependencyManager::isSet<tracing::Tracer>() && DependencyManager::get<tracing::Tracer>()->isEnabled();
+    return tracing::enabled();
 }
 
 DurationBase::DurationBase(const QLoggingCategory& category, const QString& name) : _name(name), _category(category) {
@@ -52,9 +52,14 @@ Duration::Duration(const QLoggingCategory& category,
                    const QVariantMap& baseArgs) :
     DurationBase(category, name) {
     if (tracingEnabled() && category.isDebugEnabled()) {
-        QVariantMap args = baseArgs;
-        args["nv_payload"] = QVariant::fromValue(payload);
-        tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+        // most ranges have no payload, don't copy the arguments for those
+        if (payload != 0) {
+            QVariantMap args = baseArgs;
+            args["nv_payload"] = QVariant::fromValue(payload);
+            tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+        } else {
+            tracing::traceEvent(_category, _name, tracing::DurationBegin, "", baseArgs);
+        }
 
 #if defined(NSIGHT_TRACING)
         nvtxEventAttributes_t eventAttrib{ 0 };
@@ -8,7 +8,11 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
@@ -36,51 +40,325 @@
 
 using namespace tracing;
 
+const size_t Tracer::DEFAULT_EVENTS_PER_THREAD = 1 << 22;
+
+static std::atomic<uint32_t> nextTracerSerial { 1 };
+static std::atomic<int> numRecordingTracers { 0 };
+
 bool tracing::enabled() {
-    return DependencyManager::get<Tracer>()->isEnabled();
+    return numRecordingTracers.load(std::memory_order_relaxed) > 0;
 }
 
-void Tracer::startTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-    if (_enabled) {
+namespace {
+
+// Event names, categories and argument names are stored once for the whole process and referred to by index.  They
+// come from the code, so there are only so many of them; ids and argument values, which can be anything, are kept with
+// their event instead.  Index 0 is the empty string, and once the table is full every new string shares the last index.
+class StringTable {
+public:
+    static const uint32_t MAX_STRINGS = 0xffff;
+    static const uint32_t OVERFLOW_INDEX = MAX_STRINGS - 1;
+
+    StringTable() {
+        _strings.reserve(MAX_STRINGS);
+        _strings.push_back(QString());
+        _indices.insert(QString(), 0);
+    }
+
+    uint32_t intern(const QString& string) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto itr = _indices.find(string);
+        if (itr != _indices.end()) {
+            return itr.value();
+        }
+        if (_strings.size() >= OVERFLOW_INDEX) {
+            if (_strings.size() == OVERFLOW_INDEX) {
+                qWarning(shared) << "Too many distinct trace strings, later ones will be shown as (overflow)";
+                _strings.push_back("(overflow)");
+            }
+            return OVERFLOW_INDEX;
+        }
+        uint32_t index = (uint32_t)_strings.size();
+        _strings.push_back(string);
+        _indices.insert(string, index);
+        return index;
+    }
+
+    std::vector<QString> getStrings() const {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _strings;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    QHash<QString, uint32_t> _indices;
+    std::vector<QString> _strings;
+};
+
+StringTable& getStringTable() {
+    static StringTable table;
+    return table;
+}
+
+// each thread remembers the strings it interned so that tracing an event usually doesn't take the table's lock
+uint16_t intern(const QString& string) {
+    if (string.isEmpty()) {
+        return 0;
+    }
+    thread_local QHash<QString, uint16_t> cache;
+    auto itr = cache.find(string);
+    if (itr != cache.end()) {
+        return itr.value();
+    }
+    uint16_t index = (uint16_t)getStringTable().intern(string);
+    if (index != StringTable::OVERFLOW_INDEX) {
+        cache.insert(string, index);
+    }
+    return index;
+}
+
+uint16_t intern(const QLoggingCategory& category) {
+    thread_local QHash<const QLoggingCategory*, uint16_t> cache;
+    auto itr = cache.find(&category);
+    if (itr != cache.end()) {
+        return itr.value();
+    }
+    uint16_t index = intern(QString::fromLatin1(category.categoryName()));
+    cache.insert(&category, index);
+    return index;
+}
+
+enum RecordFlags : uint8_t {
+    NUMBER_ID = 1 << 0,
+    STRING_ID = 1 << 1,
+    NUMBER_ARG = 1 << 2,
+    STRING_ARG = 1 << 3,
+    // the scope of an instant event, 0 when unspecified
+    SCOPE_SHIFT = 4,
+    SCOPE_MASK = 3 << SCOPE_SHIFT
+};
+
+const char INSTANT_SCOPES[] = { 0, 'g', 'p', 't' };
+
+// the type of the records holding the string id and argument of the event before them
+const EventType TEXT_RECORD = (EventType)0;
+
+// longer ids and arguments are cut short
+const int MAX_INLINE_STRING_BYTES = 256;
+
+QByteArray toInlineString(const QString& string) {
+    QByteArray utf8 = string.toUtf8();
+    if (utf8.size() > MAX_INLINE_STRING_BYTES) {
+        int size = MAX_INLINE_STRING_BYTES;
+        // don't split a multi-byte character
+        while (size > 0 && (utf8[size] & 0xc0) == 0x80) {
+            size--;
+        }
+        utf8.truncate(size);
+    }
+    return utf8;
+}
+
+bool isNumber(const QVariant& value) {
+    switch (value.userType()) {
+        case QMetaType::Bool:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+        case QMetaType::Float:
+        case QMetaType::Double:
+            return true;
+        default:
+            return false;
+    }
+}
+
+QByteArray toJsonString(const QString& string) {
+    QByteArray utf8 = string.toUtf8();
+    QByteArray result;
+    result.reserve(utf8.size() + 2);
+    result += '"';
+    for (char c : utf8) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if ((unsigned char)c < 0x20) {
+            result += "\\u00";
+            result += QByteArray::number((int)c, 16).rightJustified(2, '0');
+        } else {
+            result += c;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+}
+
+namespace tracing {
+
+// A trace event with its names interned.  Only the first argument is kept.  A string id and string argument, in that
+// order, follow the event in TEXT_RECORDs with the same timestamp, each holding up to TEXT_BYTES of UTF-8 from arg on.
+struct TraceRecord {
+    int64_t timestamp;
+    union {
+        double number;
+        uint32_t length;
+    } arg;
+    // the number, or the length of a string id
+    uint32_t id;
+    uint16_t name;
+    uint16_t category;
+    uint16_t argName;
+    EventType type;
+    // for a TEXT_RECORD, how many bytes of text it holds
+    uint8_t flags;
+
+    char* text() { return reinterpret_cast<char*>(&arg); }
+    const char* text() const { return reinterpret_cast<const char*>(&arg); }
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord should stay small");
+
+const size_t TEXT_BYTES = offsetof(TraceRecord, type) - offsetof(TraceRecord, arg);
+
+// The events of one thread.  Only the owning thread writes, snapshots can be taken from any thread while it does.
+// The storage is allocated a chunk at a time as it is first filled, so a large capacity costs nothing up front.
+class ThreadBuffer {
+public:
+    static const size_t CHUNK_SIZE = 4096;
+
+    ThreadBuffer(size_t capacity) :
+        _mask(roundUpToPowerOfTwo(std::max(capacity, CHUNK_SIZE)) - 1),
+        _numChunks((_mask + 1) / CHUNK_SIZE),
+        _chunks(new std::atomic<TraceRecord*>[_numChunks]),
+        _threadID(int64_t(QThread::currentThreadId())) {
+        for (size_t i = 0; i < _numChunks; i++) {
+            _chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadBuffer() {
+        for (size_t i = 0; i < _numChunks; i++) {
+            delete[] _chunks[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    void push(const TraceRecord& record) {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        size_t slot = head & _mask;
+        std::atomic<TraceRecord*>& chunk = _chunks[slot / CHUNK_SIZE];
+        TraceRecord* records = chunk.load(std::memory_order_relaxed);
+        if (!records) {
+            records = new TraceRecord[CHUNK_SIZE];
+            chunk.store(records, std::memory_order_relaxed);
+        }
+        records[slot % CHUNK_SIZE] = record;
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    // appends the events recorded at or after since to records
+    void copyTo(std::vector<TraceRecord>& records, int64_t since) const {
+        const uint64_t capacity = _mask + 1;
+        uint64_t head = _head.load(std::memory_order_acquire);
+        uint64_t begin = head > capacity ? head - capacity : 0;
+        size_t first = records.size();
+        for (uint64_t i = begin; i < head; i++) {
+            size_t slot = i & _mask;
+            records.push_back(_chunks[slot / CHUNK_SIZE].load(std::memory_order_relaxed)[slot % CHUNK_SIZE]);
+        }
+
+        // the writer may have lapped us while we copied, drop anything it could have been overwriting
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t newHead = _head.load(std::memory_order_relaxed);
+        uint64_t intact = newHead + 1 > capacity ? newHead + 1 - capacity : 0;
+        if (intact > begin) {
+            records.erase(records.begin() + first, records.begin() + first + (size_t)(std::min(intact, head) - begin));
+        }
+
+        records.erase(std::remove_if(records.begin() + first, records.end(), [since](const TraceRecord& record) {
+            return record.timestamp < since;
+        }), records.end());
+    }
+
+    int64_t getThreadID() const { return _threadID; }
+
+    void finish() { _finished = true; }
+    bool isFinished() const { return _finished; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t _mask;
+    const size_t _numChunks;
+    std::unique_ptr<std::atomic<TraceRecord*>[]> _chunks;
+    std::atomic<uint64_t> _head { 0 };
+    const int64_t _threadID;
+    std::atomic<bool> _finished { false };
+};
+
+}
+
+namespace {
+
+// the buffer of the current thread, flagged when the thread exits so that the tracer can let it go
+struct ThreadBufferHolder {
+    std::shared_ptr<ThreadBuffer> buffer;
+    uint32_t tracerSerial { 0 };
+
+    ~ThreadBufferHolder() {
+        if (buffer) {
+            buffer->finish();
+        }
+    }
+};
+
+thread_local ThreadBufferHolder threadBufferHolder;
+
+// the buffers of threads that have exited are kept for a while, they may hold the events leading up to a problem
+const size_t MAX_FINISHED_THREAD_BUFFERS = 32;
+
+}
+
+Tracer::Tracer() : _serial(nextTracerSerial++) {
+}
+
+Tracer::~Tracer() {
+    if (_enabled.exchange(false)) {
+        numRecordingTracers--;
+    }
+}
+
+void Tracer::startTracing(size_t eventsPerThread) {
+    if (_enabled.exchange(true)) {
         qWarning() << "Tried to enable tracer, but already enabled";
         return;
     }
 
-    _events.clear();
-    _enabled = true;
+    _eventsPerThread = eventsPerThread;
+    _startTime = now();
+    numRecordingTracers++;
 }
 
 void Tracer::stopTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-    if (!_enabled) {
+    if (!_enabled.exchange(false)) {
         qWarning() << "Cannot stop tracing, already disabled";
         return;
     }
-    _enabled = false;
+    numRecordingTracers--;
 }
 
 void TraceEvent::writeJson(QTextStream& out) const {
-#if 0
-    // FIXME QJsonObject serialization is very slow, so we should be using manual JSON serialization
-    out << "{";
-    out << "\"name\":\"" << name << "\",";
-    out << "\"cat\":\"" << category.categoryName() << "\",";
-    out << "\"ph\":\"" << QString(type) << "\",";
-    out << "\"ts\":\"" << timestamp << "\",";
-    out << "\"pid\":\"" << processID << "\",";
-    out << "\"tid\":\"" << threadID << "\"";
-    //if (!extra.empty()) {
-    //    auto it = extra.begin();
-    //    for (; it != extra.end(); it++) {
-    //        ev[it.key()] = QJsonValue::fromVariant(it.value());
-    //    }
-    //}
-    //if (!args.empty()) {
-    //    out << ",\"args\":'
-    //}
-    out << '}';
-#else
     QJsonObject ev {
         { "name", QJsonValue(name) },
         { "cat", category.categoryName() },
@@ -102,32 +380,116 @@ void TraceEvent::writeJson(QTextStream& out) const {
         }
     }
     out << QJsonDocument(ev).toJson(QJsonDocument::Compact);
-#endif
 }
 
-void Tracer::serialize(const QString& filename) {
-    QString fullPath = FileUtils::replaceDateTimeTokens(filename);
-    fullPath = FileUtils::computeDocumentPath(fullPath);
-    if (!FileUtils::canCreateFile(fullPath)) {
-        return;
+QByteArray Tracer::toJson() {
+    std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+    {
+        std::lock_guard<std::mutex> guard(_threadBuffersMutex);
+        threadBuffers = _threadBuffers;
     }
 
-    std::list<TraceEvent> currentEvents;
+    int64_t startTime = _startTime;
+    std::vector<TraceRecord> records;
+    std::vector<std::pair<size_t, int64_t>> threads;
+    for (const auto& buffer : threadBuffers) {
+        buffer->copyTo(records, startTime);
+        threads.emplace_back(records.size(), buffer->getThreadID());
+    }
+
+    // every name the copied records refer to was interned before they were recorded
+    std::vector<QByteArray> strings;
     {
-        std::lock_guard<std::mutex> guard(_eventsMutex);
-        currentEvents.swap(_events);
-        for (auto& event : _metadataEvents) {
-            currentEvents.push_back(event);
+        std::vector<QString> table = getStringTable().getStrings();
+        strings.reserve(table.size());
+        for (const auto& string : table) {
+            strings.push_back(toJsonString(string));
         }
     }
 
-    // If we can't open a temp file for writing, fail early
     QByteArray data;
+    data.reserve((int)std::min<size_t>(records.size() * 128, INT32_MAX / 2));
+    data += "[\n";
+    bool first = true;
+
+    const QByteArray processID = QByteArray::number(QCoreApplication::applicationPid());
+    size_t index = 0;
+    for (const auto& thread : threads) {
+        const QByteArray threadID = QByteArray::number(thread.second);
+        for (; index < thread.first; index++) {
+            const TraceRecord& record = records[index];
+            if (record.type == TEXT_RECORD) {
+                // the rest of an event whose start was overwritten
+                continue;
+            }
+
+            // the text of the string id and argument, an event whose text was partly overwritten, or not yet all
+            // recorded, is dropped
+            QByteArray text;
+            size_t textLength = ((record.flags & STRING_ID) ? record.id : 0) +
+                ((record.flags & STRING_ARG) ? record.arg.length : 0);
+            while (text.size() < (int)textLength && index + 1 < thread.first && records[index + 1].type == TEXT_RECORD) {
+                index++;
+                text.append(records[index].text(), records[index].flags);
+            }
+            if (text.size() != (int)textLength) {
+                continue;
+            }
+
+            if (first) {
+                first = false;
+            } else {
+                data += ",\n";
+            }
+            data += "{\"name\":";
+            data += strings[record.name];
+            data += ",\"cat\":";
+            data += strings[record.category];
+            data += ",\"ph\":\"";
+            data += (char)record.type;
+            data += "\",\"ts\":";
+            data += QByteArray::number((qlonglong)record.timestamp);
+            data += ",\"pid\":";
+            data += processID;
+            data += ",\"tid\":";
+            data += threadID;
+            if (record.flags & NUMBER_ID) {
+                data += ",\"id\":\"";
+                data += QByteArray::number(record.id);
+                data += '"';
+            } else if (record.flags & STRING_ID) {
+                data += ",\"id\":";
+                data += toJsonString(QString::fromUtf8(text.constData(), record.id));
+            }
+            char scope = INSTANT_SCOPES[(record.flags & SCOPE_MASK) >> SCOPE_SHIFT];
+            if (scope) {
+                data += ",\"s\":\"";
+                data += scope;
+                data += '"';
+            }
+            if (record.flags & (NUMBER_ARG | STRING_ARG)) {
+                data += ",\"args\":{";
+                data += strings[record.argName];
+                data += ':';
+                if (record.flags & STRING_ARG) {
+                    data += toJsonString(QString::fromUtf8(text.constData() + (int)textLength - (int)record.arg.length,
+                                                           record.arg.length));
+                } else if (std::isfinite(record.arg.number)) {
+                    data += QByteArray::number(record.arg.number, 'g', 15);
+                } else {
+                    data += "null";
+                }
+                data += '}';
+            }
+            data += '}';
+        }
+    }
+
+    QByteArray metadata;
     {
-        QTextStream out(&data);
-        out << "[\n";
-        bool first = true;
-        for (const auto& event : currentEvents) {
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        QTextStream out(&metadata);
+        for (const auto& event : _metadataEvents) {
             if (first) {
                 first = false;
             } else {
@@ -135,9 +497,20 @@ void Tracer::serialize(const QString& filename) {
             }
             event.writeJson(out);
         }
-        out << "\n]";
+    }
+    data += metadata;
+    data += "\n]";
+    return data;
+}
+
+void Tracer::serialize(const QString& filename) {
+    QString fullPath = FileUtils::replaceDateTimeTokens(filename);
+    fullPath = FileUtils::computeDocumentPath(fullPath);
+    if (!FileUtils::canCreateFile(fullPath)) {
+        return;
     }
 
+    QByteArray data = toJson();
     if (fullPath.endsWith(".gz")) {
         QByteArray compressed;
         gzip(data, compressed);
@@ -153,74 +526,56 @@ void Tracer::serialize(const QString& filename) {
         file.write(data);
         file.close();
     }
-
-#if 0
-    QByteArray data;
-    {
-
-        // "traceEvents":[
-        // {"args":{"nv_payload":0},"cat":"hifi.render","name":"render::Scene::processTransactionQueue","ph":"B","pid":14796,"tid":21636,"ts":68795933487}
-
-        QJsonArray traceEvents;
-
-        QJsonDocument document {
-            QJsonObject {
-                { "traceEvents", traceEvents },
-                { "otherData", QJsonObject {
-                    { "version", QString { "High Fidelity Interface v1.0" } +BuildInfo::VERSION }
-                } }
-            }
-        };
-        data = document.toJson(QJsonDocument::Compact);
-    }
-#endif
 }
 
 int64_t Tracer::now() {
     return std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
 }
 
-void Tracer::traceEvent(const QLoggingCategory& category,
-    const QString& name, EventType type,
-    qint64 timestamp, qint64 processID, qint64 threadID,
-    const QString& id,
-    const QVariantMap& args, const QVariantMap& extra) {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
+ThreadBuffer& Tracer::getThreadBuffer() {
+    ThreadBufferHolder& holder = threadBufferHolder;
+    if (holder.tracerSerial != _serial) {
+        if (holder.buffer) {
+            holder.buffer->finish();
+        }
+        holder.buffer = std::make_shared<ThreadBuffer>(_eventsPerThread);
+        holder.tracerSerial = _serial;
+
+        std::lock_guard<std::mutex> guard(_threadBuffersMutex);
+        size_t numFinished = std::count_if(_threadBuffers.begin(), _threadBuffers.end(),
+            [](const std::shared_ptr<ThreadBuffer>& buffer) { return buffer->isFinished(); });
+        for (auto itr = _threadBuffers.begin(); itr != _threadBuffers.end() && numFinished > MAX_FINISHED_THREAD_BUFFERS; ) {
+            if ((*itr)->isFinished()) {
+                itr = _threadBuffers.erase(itr);
+                numFinished--;
+            } else {
+                ++itr;
+            }
+        }
+        _threadBuffers.push_back(holder.buffer);
+    }
+    return *holder.buffer;
+}
 
+void Tracer::traceMetadata(const QLoggingCategory& category, const QString& name, int64_t timestamp, const QString& id,
+                           const QVariantMap& args, const QVariantMap& extra) {
     // We always want to store metadata events even if tracing is not enabled so that when
     // tracing is enabled we will be able to associate that metadata with that trace.
     // Metadata events should be used sparingly - as of 12/30/16 the Chrome Tracing
     // spec only supports thread+process metadata, so we should only expect to see metadata
     // events created when a new thread or process is created.
-    if (!_enabled && type != Metadata) {
-        return;
-    }
-
-    if (type == Metadata) {
-        _metadataEvents.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    } else {
-        _events.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    }
+    std::lock_guard<std::mutex> guard(_eventsMutex);
+    _metadataEvents.push_back({
+        id,
+        name,
+        Metadata,
+        timestamp,
+        QCoreApplication::applicationPid(),
+        int64_t(QThread::currentThreadId()),
+        category,
+        args,
+        extra
+    });
 }
 
 void Tracer::traceEvent(const QLoggingCategory& category, 
@@ -236,11 +591,69 @@ void Tracer::traceEvent(const QLoggingCategory& category,
 void Tracer::traceEvent(const QLoggingCategory& category, 
     const QString& name, EventType type, int64_t timestamp, const QString& id, 
     const QVariantMap& args, const QVariantMap& extra) {
-    if (!_enabled && type != Metadata) {
+    if (type == Metadata) {
+        traceMetadata(category, name, timestamp, id, args, extra);
+        return;
+    }
+    if (!_enabled) {
         return;
     }
 
-    auto processID = QCoreApplication::applicationPid();
-    auto threadID = int64_t(QThread::currentThreadId());
-    traceEvent(category, name, type, timestamp, processID, threadID, id, args, extra);
+    TraceRecord record;
+    QByteArray text;
+    record.timestamp = timestamp;
+    record.arg.number = 0.0;
+    record.id = 0;
+    record.name = intern(name);
+    record.category = intern(category);
+    record.argName = 0;
+    record.type = type;
+    record.flags = 0;
+
+    if (!id.isEmpty()) {
+        bool isNumeric;
+        uint32_t number = id.toUInt(&isNumeric);
+        if (isNumeric) {
+            record.id = number;
+            record.flags |= NUMBER_ID;
+        } else {
+            text = toInlineString(id);
+            record.id = (uint32_t)text.size();
+            record.flags |= STRING_ID;
+        }
+    }
+
+    if (!args.isEmpty()) {
+        auto arg = args.constBegin();
+        record.argName = intern(arg.key());
+        if (isNumber(arg.value())) {
+            record.arg.number = arg.value().toDouble();
+            record.flags |= NUMBER_ARG;
+        } else {
+            QByteArray argText = toInlineString(arg.value().toString());
+            record.arg.length = (uint32_t)argText.size();
+            record.flags |= STRING_ARG;
+            text += argText;
+        }
+    }
+
+    if (type == Instant && !extra.isEmpty()) {
+        QString scope = extra.value("s").toString();
+        for (uint8_t i = 1; i < sizeof(INSTANT_SCOPES); i++) {
+            if (scope == QChar(INSTANT_SCOPES[i])) {
+                record.flags |= i << SCOPE_SHIFT;
+            }
+        }
+    }
+
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.push(record);
+    for (int offset = 0; offset < text.size(); offset += (int)TEXT_BYTES) {
+        TraceRecord textRecord;
+        textRecord.timestamp = timestamp;
+        textRecord.type = TEXT_RECORD;
+        textRecord.flags = (uint8_t)std::min((int)TEXT_BYTES, text.size() - offset);
+        memcpy(textRecord.text(), text.constData() + offset, textRecord.flags);
+        buffer.push(textRecord);
+    }
 }
@@ -10,8 +10,12 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <atomic>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
@@ -23,6 +27,7 @@
 
 namespace tracing {
 
+/// \return true if any Tracer is recording, cheap enough to check before building the arguments of an event
 bool enabled();
 
 using TraceTimestamp = uint64_t;
@@ -76,8 +81,20 @@ struct TraceEvent {
     void writeJson(QTextStream& out) const;
 };
 
+class ThreadBuffer;
+
+/// Records trace events as fixed-size binary records in a ring buffer per thread, so that recording doesn't take a lock
+/// and tracing can be left on.  Event names and categories are interned, string ids and arguments are copied into the
+/// buffer after their event, and only the first argument of an event is kept.  Once a thread has filled its buffer the
+/// oldest records are overwritten, so a snapshot holds the last eventsPerThread records of each thread.
 class Tracer : public Dependency {
 public:
+    /// enough for a whole capture session, buffers only grow as they are filled
+    static const size_t DEFAULT_EVENTS_PER_THREAD;
+
+    Tracer();
+    ~Tracer();
+
     static int64_t now();
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
@@ -90,26 +107,34 @@ public:
         const QString& id = "", 
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
-    void startTracing();
+    /// drops the events recorded so far, eventsPerThread applies to the buffers of threads that haven't traced yet
+    void startTracing(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
     void stopTracing();
+
+    /// \return a snapshot of the recorded events in the Chrome trace event format, tracing can carry on meanwhile
+    QByteArray toJson();
     void serialize(const QString& file);
     bool isEnabled() const { return _enabled; }
 
 private:
-    void traceEvent(const QLoggingCategory& category, 
-        const QString& name, EventType type,
-        qint64 timestamp, qint64 processID, qint64 threadID,
-        const QString& id = "",
-        const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
+    ThreadBuffer& getThreadBuffer();
+    void traceMetadata(const QLoggingCategory& category, const QString& name, int64_t timestamp, const QString& id,
+                       const QVariantMap& args, const QVariantMap& extra);
+
+    const uint32_t _serial;
+    std::atomic<bool> _enabled { false };
+    std::atomic<int64_t> _startTime { 0 };
+    std::atomic<size_t> _eventsPerThread { DEFAULT_EVENTS_PER_THREAD };
+
+    std::vector<std::shared_ptr<ThreadBuffer>> _threadBuffers;
+    std::mutex _threadBuffersMutex;
 
-    bool _enabled { false };
-    std::list<TraceEvent> _events;
     std::list<TraceEvent> _metadataEvents;
     std::mutex _eventsMutex;
 };
 
 inline void traceEvent(const QLoggingCategory& category, int64_t timestamp, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
-    if (!DependencyManager::isSet<Tracer>()) {
+    if ((type != Metadata && !enabled()) || !DependencyManager::isSet<Tracer>()) {
         return;
     }
     const auto& tracer = DependencyManager::get<Tracer>();
@@ -119,7 +144,7 @@ inline void traceEvent(const QLoggingCategory& category, int64_t timestamp, cons
 }
 
 inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
-    if (!DependencyManager::isSet<Tracer>()) {
+    if ((type != Metadata && !enabled()) || !DependencyManager::isSet<Tracer>()) {
         return;
     }
     const auto& tracer = DependencyManager::get<Tracer>();
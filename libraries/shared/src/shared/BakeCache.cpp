@@ -0,0 +1,209 @@
+//
+//  BakeCache.cpp
+//  libraries/shared/src/shared
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTemporaryDir>
+
+static const std::string BAKE_CACHE_EXTENSION = "bake";
+
+// bump this when the layout of a cached bundle changes, bundles with another version are treated as misses
+static const quint32 BUNDLE_VERSION = 1;
+
+// relative paths in a bundle must stay inside the directory the bake was stored from, and is restored to
+static bool isInsideDirectory(const QString& relativePath) {
+    QString cleanPath = QDir::cleanPath(relativePath);
+    return !cleanPath.isEmpty() && cleanPath != "." && cleanPath != ".." && !cleanPath.startsWith("../") &&
+        !QDir::isAbsolutePath(cleanPath);
+}
+
+// moves the files restored into stagingPath to the same relative paths in outputDirectory, all of them or none
+static bool moveIntoPlace(const QString& stagingPath, const QDir& outputDirectory, const std::vector<QString>& relativePaths) {
+    if (!outputDirectory.exists()) {
+        return QDir().rename(stagingPath, outputDirectory.absolutePath());
+    }
+
+    QDir stagingDir { stagingPath };
+    std::vector<QString> movedFiles;
+    for (const auto& relativePath : relativePaths) {
+        QString path = outputDirectory.absoluteFilePath(relativePath);
+        QFileInfo(path).absoluteDir().mkpath(".");
+        QFile::remove(path);
+        if (!QFile::rename(stagingDir.absoluteFilePath(relativePath), path)) {
+            for (const auto& movedFile : movedFiles) {
+                QFile::remove(movedFile);
+            }
+            return false;
+        }
+        movedFiles.push_back(path);
+    }
+    return true;
+}
+
+BakeCache::BakeCache(const std::string& dir) :
+    FileCache(dir, BAKE_CACHE_EXTENSION) { }
+
+BakeCache::Key BakeCache::computeKey(const QString& bakerType, int bakerVersion, const QByteArray& options,
+                                     const QByteArray& input) {
+    QCryptographicHash hasher(QCryptographicHash::Sha256);
+
+    // prefix each part with its length so that moving bytes from one part to the next changes the key
+    auto addPart = [&hasher](const QByteArray& part) {
+        int size = part.size();
+        hasher.addData((const char*)&size, sizeof(size));
+        hasher.addData(part);
+    };
+    addPart(bakerType.toUtf8());
+    hasher.addData((const char*)&bakerVersion, sizeof(bakerVersion));
+    addPart(options);
+    addPart(input);
+
+    return hasher.result().toHex().toStdString();
+}
+
+bool BakeCache::restore(const Key& key, const QDir& outputDirectory, std::vector<QString>& outputFiles, QJsonObject* info,
+                        const InfoValidator& isValid) {
+    auto file = getFile(key);
+    if (!file) {
+        ++_numMisses;
+        return false;
+    }
+
+    QFile bundleFile { QString::fromStdString(file->getFilepath()) };
+    if (!bundleFile.open(QIODevice::ReadOnly)) {
+        qCWarning(file_cache) << "Could not open cached bake" << key.c_str();
+        ++_numMisses;
+        return false;
+    }
+
+    QDataStream stream(&bundleFile);
+    stream.setVersion(QDataStream::Qt_5_9);
+
+    quint32 version { 0 };
+    QByteArray infoJSON;
+    quint32 numFiles { 0 };
+    stream >> version;
+    if (version != BUNDLE_VERSION) {
+        ++_numMisses;
+        return false;
+    }
+    stream >> infoJSON >> numFiles;
+
+    QJsonObject bakeInfo = QJsonDocument::fromJson(infoJSON).object();
+    if (isValid && !isValid(bakeInfo)) {
+        ++_numMisses;
+        return false;
+    }
+
+    // write the files next to the output directory first, so that a bundle which can't be restored in full leaves
+    // nothing behind, and moving them into place is a rename on the same volume
+    QFileInfo outputDirectoryInfo { outputDirectory.absolutePath() };
+    outputDirectoryInfo.absoluteDir().mkpath(".");
+    QTemporaryDir stagingDir { outputDirectoryInfo.absoluteFilePath() + ".restoring-XXXXXX" };
+    if (!stagingDir.isValid()) {
+        qCWarning(file_cache) << "Could not restore cached bake" << key.c_str() << "- no room next to"
+                              << outputDirectory.absolutePath();
+        ++_numMisses;
+        return false;
+    }
+
+    std::vector<QString> relativePaths;
+    for (quint32 i = 0; i < numFiles; ++i) {
+        QString relativePath;
+        QByteArray data;
+        stream >> relativePath >> data;
+        if (stream.status() != QDataStream::Ok) {
+            break;
+        }
+        if (!isInsideDirectory(relativePath)) {
+            qCWarning(file_cache) << "Not restoring cached bake" << key.c_str() << "-" << relativePath
+                                  << "is outside of its output directory";
+            break;
+        }
+        relativePath = QDir::cleanPath(relativePath);
+
+        QString path = stagingDir.filePath(relativePath);
+        QFileInfo(path).absoluteDir().mkpath(".");
+
+        QSaveFile outputFile { path };
+        if (!outputFile.open(QIODevice::WriteOnly) || outputFile.write(data) != data.size() || !outputFile.commit()) {
+            break;
+        }
+        relativePaths.push_back(relativePath);
+    }
+
+    if (relativePaths.size() != numFiles || !moveIntoPlace(stagingDir.path(), outputDirectory, relativePaths)) {
+        qCWarning(file_cache) << "Could not restore cached bake" << key.c_str() << "to" << outputDirectory.absolutePath();
+        ++_numMisses;
+        return false;
+    }
+
+    if (info) {
+        *info = bakeInfo;
+    }
+    for (const auto& relativePath : relativePaths) {
+        outputFiles.push_back(outputDirectory.absoluteFilePath(relativePath));
+    }
+    ++_numHits;
+    return true;
+}
+
+bool BakeCache::store(const Key& key, const QDir& outputDirectory, const std::vector<QString>& outputFiles,
+                      const QJsonObject& info) {
+    QByteArray bundle;
+    {
+        QDataStream stream(&bundle, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_9);
+        stream << BUNDLE_VERSION << QJsonDocument(info).toJson(QJsonDocument::Compact) << (quint32)outputFiles.size();
+
+        for (const auto& path : outputFiles) {
+            QString relativePath = outputDirectory.relativeFilePath(path);
+            if (!isInsideDirectory(relativePath)) {
+                qCWarning(file_cache) << "Not caching bake" << key.c_str() << "-" << path << "is outside of"
+                                      << outputDirectory.absolutePath();
+                return false;
+            }
+
+            QFile file { path };
+            if (!file.open(QIODevice::ReadOnly)) {
+                qCWarning(file_cache) << "Not caching bake" << key.c_str() << "- could not read" << path;
+                return false;
+            }
+            stream << relativePath << file.readAll();
+        }
+    }
+
+    auto file = writeFile(bundle.constData(), Metadata(key, bundle.size()), true);
+    if (!file) {
+        return false;
+    }
+    ++_numStored;
+    return true;
+}
+
+QJsonObject BakeCache::getStats() const {
+    QJsonObject stats;
+    stats["max_bytes"] = (double)getMaxSize();
+    stats["cached_bytes"] = (double)getSizeTotalFiles();
+    stats["cached_bakes"] = (double)getNumTotalFiles();
+
+    size_t hits = _numHits;
+    size_t misses = _numMisses;
+    stats["hits"] = (double)hits;
+    stats["misses"] = (double)misses;
+    stats["hit_rate"] = (hits + misses) > 0 ? (double)hits / (double)(hits + misses) : 0.0;
+    stats["stored_bakes"] = (double)_numStored;
+    return stats;
+}
@@ -0,0 +1,60 @@
+//
+//  BakeCache.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeCache_h
+#define hifi_BakeCache_h
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QJsonObject>
+
+#include "FileCache.h"
+
+class BakeCache;
+using BakeCachePointer = std::shared_ptr<BakeCache>;
+
+/// A persistent cache of bake results. An entry is keyed by a hash of everything the bake depended on (the baker type
+/// and version, its options and its input) and bundles the files the bake wrote, relative to its output directory,
+/// with whatever else the baker needs to finish as if it had baked. Entries are evicted least recently used first
+/// once the cache is over its max size.
+class BakeCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    BakeCache(const std::string& dir);
+
+    static Key computeKey(const QString& bakerType, int bakerVersion, const QByteArray& options, const QByteArray& input);
+
+    using InfoValidator = std::function<bool(const QJsonObject& info)>;
+
+    /// writes the cached bake's files into outputDirectory, all of them or none, and appends their paths to outputFiles,
+    /// a bake whose info the validator rejects (e.g. because something it depended on outside of its input changed)
+    /// or with files that would land outside of outputDirectory counts as a miss
+    bool restore(const Key& key, const QDir& outputDirectory, std::vector<QString>& outputFiles, QJsonObject* info = nullptr,
+                 const InfoValidator& isValid = InfoValidator());
+
+    /// caches the given files, all of which must be inside outputDirectory
+    bool store(const Key& key, const QDir& outputDirectory, const std::vector<QString>& outputFiles,
+               const QJsonObject& info = QJsonObject());
+
+    size_t getNumHits() const { return _numHits; }
+    size_t getNumMisses() const { return _numMisses; }
+    QJsonObject getStats() const;
+
+private:
+    std::atomic<size_t> _numHits { 0 };
+    std::atomic<size_t> _numMisses { 0 };
+    std::atomic<size_t> _numStored { 0 };
+};
+
+#endif // hifi_BakeCache_h
@@ -63,6 +63,7 @@ public:
 
     // Set the maximum amount of disk space to use on disk
     void setMaxSize(size_t maxCacheSize);
+    size_t getMaxSize() const { return _maxSize; }
 
     // Set the minumum amount of free disk space to retain.  This supercedes the max size,
     // so if the cache is consuming all but 500 MB of the drive, unused entries will be ejected 
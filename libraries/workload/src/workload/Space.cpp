@@ -13,23 +13,70 @@
 //
 
 #include "Space.h"
+#include <cmath>
 #include <cstring>
 #include <algorithm>
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <TBBHelpers.h>
+
+// on x86 architecture, assume that SSE2 is present
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define WORKLOAD_SSE
+#endif
+
 using namespace workload;
 
+const float Space::DEFAULT_BIN_SIZE = 64.0f;
+
+static const uint32_t NO_BIN = (uint32_t)-1;
+static const uint32_t PROXIES_PER_RANGE = 1024;
+static const uint32_t MIN_PROXIES_TO_CLASSIFY_IN_PARALLEL = 4096;
+
+static const int BIN_BITS = 21;
+static const int BIN_OFFSET = 1 << (BIN_BITS - 1);
+static const uint64_t BIN_MASK = (1 << BIN_BITS) - 1;
+static const int MAX_BIN = BIN_OFFSET - 1;
+
+// the cells at the edge of the grid also hold everything beyond it, as do all cells of a NaN coordinate
+static int toBinCoordinate(float position, float binSize) {
+    float cell = floorf(position / binSize);
+    if (cell >= -(float)MAX_BIN && cell <= (float)MAX_BIN) {
+        return (int)cell;
+    }
+    return cell > 0.0f ? MAX_BIN : -MAX_BIN;
+}
+
 Space::Space() : Collection() {
 }
 
+void Space::setBinSize(float binSize) {
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+    binSize = std::max(binSize, 0.0f);
+    if (binSize != _binSize) {
+        _binSize = binSize;
+        rebin();
+    }
+}
+
+float Space::getBinSize() const {
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+    return _binSize;
+}
+
 void Space::processTransactionFrame(const Transaction& transaction) {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     // Here we should be able to check the value of last ProxyID allocated
     // and allocate new proxies accordingly
     ProxyID maxID = _IDAllocator.getNumAllocatedIndices();
-    if (maxID > (Index) _proxies.size()) {
-        _proxies.resize(maxID + 100); // allocate the maxId and more
+    if (maxID > (Index) _regions.size()) {
+        // allocate the maxId and more
+        _proxyBins.resize(maxID + 100, NO_BIN);
+        _proxySlots.resize(maxID + 100, 0);
+        _regions.resize(maxID + 100, Region::INVALID);
+        _prevRegions.resize(maxID + 100, Region::INVALID);
         _owners.resize(maxID + 100);
     }
     // Now we know for sure that we have enough items in the array to
@@ -49,11 +96,13 @@ void Space::processResets(const Transaction::Resets& transactions) {
         if (!_IDAllocator.checkIndex(proxyID)) {
             continue;
         }
-        auto& item = _proxies[proxyID];
 
         // Reset the item with a new payload
-        item.sphere = (std::get<1>(reset));
-        item.prevRegion = item.region = Region::UNKNOWN;
+        if (_proxyBins[proxyID] != NO_BIN) {
+            removeProxy(proxyID);
+        }
+        insertProxy(proxyID, std::get<1>(reset));
+        _prevRegions[proxyID] = _regions[proxyID] = Region::UNKNOWN;
 
         _owners[proxyID] = (std::get<2>(reset));
     }
@@ -66,11 +115,11 @@ void Space::processRemoves(const Transaction::Removes& transactions) {
         }
         _IDAllocator.freeIndex(removedID);
 
-        // Access the true item
-        auto& item = _proxies[removedID];
-
         // Kill it
-        item.prevRegion = item.region = Region::INVALID;
+        if (_proxyBins[removedID] != NO_BIN) {
+            removeProxy(removedID);
+        }
+        _prevRegions[removedID] = _regions[removedID] = Region::INVALID;
         _owners[removedID] = Owner();
     }
 }
@@ -78,58 +127,274 @@ void Space::processRemoves(const Transaction::Removes& transactions) {
 void Space::processUpdates(const Transaction::Updates& transactions) {
     for (auto& update : transactions) {
         auto updateID = std::get<0>(update);
-        if (!_IDAllocator.checkIndex(updateID)) {
+        if (!_IDAllocator.checkIndex(updateID) || _proxyBins[updateID] == NO_BIN) {
             continue;
         }
 
-        // Access the true item
-        auto& item = _proxies[updateID];
+        // Update the item, in place unless it moved to another bin
+        const Sphere& sphere = std::get<1>(update);
+        Bin& bin = _bins[_proxyBins[updateID]];
+        if (bin.key != toBinKey(sphere)) {
+            removeProxy(updateID);
+            insertProxy(updateID, sphere);
+            continue;
+        }
+        uint32_t slot = _proxySlots[updateID];
+        bin.x[slot] = sphere.x;
+        bin.y[slot] = sphere.y;
+        bin.z[slot] = sphere.z;
+        bin.radius[slot] = sphere.w;
+        bin.maxRadius = std::max(bin.maxRadius, fabsf(sphere.w));
+        bin.settled = false;
+    }
+}
 
-        // Update the item
-        item.sphere = (std::get<1>(update));
+uint64_t Space::toBinKey(const Sphere& sphere) const {
+    if (_binSize <= 0.0f) {
+        return 0;
     }
+    return ((uint64_t)(toBinCoordinate(sphere.x, _binSize) + BIN_OFFSET) << (2 * BIN_BITS)) |
+        ((uint64_t)(toBinCoordinate(sphere.y, _binSize) + BIN_OFFSET) << BIN_BITS) |
+        (uint64_t)(toBinCoordinate(sphere.z, _binSize) + BIN_OFFSET);
 }
 
-void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
-    std::unique_lock<std::mutex> lock(_proxiesMutex);
-    uint32_t numProxies = (uint32_t)_proxies.size();
+uint32_t Space::findOrCreateBin(uint64_t key) {
+    auto itr = _binsByKey.find(key);
+    if (itr != _binsByKey.end()) {
+        return itr->second;
+    }
+    uint32_t index = (uint32_t)_bins.size();
+    _bins.emplace_back();
+    Bin& bin = _bins.back();
+    bin.key = key;
+    if (_binSize > 0.0f) {
+        glm::ivec3 cell((int)((key >> (2 * BIN_BITS)) & BIN_MASK) - BIN_OFFSET,
+                        (int)((key >> BIN_BITS) & BIN_MASK) - BIN_OFFSET,
+                        (int)(key & BIN_MASK) - BIN_OFFSET);
+        bin.minCorner = glm::vec3(cell) * _binSize;
+        bin.maxCorner = glm::vec3(cell + glm::ivec3(1)) * _binSize;
+        bin.bounded = glm::all(glm::lessThan(glm::abs(cell), glm::ivec3(MAX_BIN)));
+    }
+    _binsByKey[key] = index;
+    return index;
+}
+
+void Space::insertProxy(int32_t proxyID, const Sphere& sphere) {
+    uint32_t index = findOrCreateBin(toBinKey(sphere));
+    Bin& bin = _bins[index];
+    _proxyBins[proxyID] = index;
+    _proxySlots[proxyID] = (uint32_t)bin.ids.size();
+    bin.x.push_back(sphere.x);
+    bin.y.push_back(sphere.y);
+    bin.z.push_back(sphere.z);
+    bin.radius.push_back(sphere.w);
+    bin.ids.push_back(proxyID);
+    bin.maxRadius = std::max(bin.maxRadius, fabsf(sphere.w));
+    bin.settled = false;
+}
+
+void Space::removeProxy(int32_t proxyID) {
+    Bin& bin = _bins[_proxyBins[proxyID]];
+    uint32_t slot = _proxySlots[proxyID];
+    uint32_t last = (uint32_t)bin.ids.size() - 1;
+    if (slot != last) {
+        bin.x[slot] = bin.x[last];
+        bin.y[slot] = bin.y[last];
+        bin.z[slot] = bin.z[last];
+        bin.radius[slot] = bin.radius[last];
+        bin.ids[slot] = bin.ids[last];
+        _proxySlots[bin.ids[slot]] = slot;
+    }
+    bin.x.pop_back();
+    bin.y.pop_back();
+    bin.z.pop_back();
+    bin.radius.pop_back();
+    bin.ids.pop_back();
+    if (bin.ids.empty()) {
+        bin.maxRadius = 0.0f;
+    }
+    _proxyBins[proxyID] = NO_BIN;
+}
+
+void Space::rebin() {
+    std::vector<Bin> oldBins;
+    oldBins.swap(_bins);
+    _binsByKey.clear();
+    for (const Bin& bin : oldBins) {
+        for (size_t i = 0; i < bin.ids.size(); ++i) {
+            insertProxy(bin.ids[i], Sphere(bin.x[i], bin.y[i], bin.z[i], bin.radius[i]));
+        }
+    }
+}
+
+bool Space::isReachable(const Bin& bin) const {
+    if (!bin.bounded) {
+        return true;
+    }
+    // a proxy touches a region when the distance between their centers is less than the sum of their radii
+    for (const auto& view : _views) {
+        for (uint8_t k = 0; k < Region::NUM_VIEW_REGIONS; ++k) {
+            glm::vec3 center(view.regions[k]);
+            float reach = bin.maxRadius + fabsf(view.regions[k].w);
+            if (distance2(center, glm::clamp(center, bin.minCorner, bin.maxCorner)) < reach * reach) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Space::setRegion(int32_t proxyID, uint8_t region, std::vector<Space::Change>& changes) {
+    uint8_t prevRegion = _regions[proxyID];
+    _prevRegions[proxyID] = prevRegion;
+    _regions[proxyID] = region;
+    if (region != prevRegion) {
+        changes.emplace_back(Space::Change(proxyID, region, prevRegion));
+    }
+}
+
+void Space::classifyProxies(const BinRange& range, std::vector<Space::Change>& changes) {
+    const Bin& bin = _bins[range.bin];
+    const int32_t* ids = bin.ids.data();
+    uint32_t i = range.begin;
+    if (!range.reachable) {
+        for (; i < range.end; ++i) {
+            setRegion(ids[i], Region::UNKNOWN, changes);
+        }
+        return;
+    }
+
+    const float* xs = bin.x.data();
+    const float* ys = bin.y.data();
+    const float* zs = bin.z.data();
+    const float* radii = bin.radius.data();
     uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Region::INVALID) {
-            glm::vec3 proxyCenter = glm::vec3(proxy.sphere);
-            float proxyRadius = proxy.sphere.w;
-            uint8_t region = Region::UNKNOWN;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                auto& view = _views[j];
-                // for each 'view' we need only increment 'k' below the current value of 'region'
-                for (uint8_t k = 0; k < region; ++k) {
-                    float touchDistance = proxyRadius + view.regions[k].w;
-                    if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
-                        region = k;
-                        break;
-                    }
-                }
+
+#ifdef WORKLOAD_SSE
+    // the region of a proxy is the lowest of those it touches in any view
+    const __m128 unknown = _mm_set1_ps((float)Region::UNKNOWN);
+    for (; i + 4 <= range.end; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+        __m128 radius = _mm_loadu_ps(radii + i);
+        __m128 region = unknown;
+        for (uint32_t j = 0; j < numViews; ++j) {
+            const auto& view = _views[j];
+            for (uint8_t k = 0; k < Region::NUM_VIEW_REGIONS; ++k) {
+                const Sphere& sphere = view.regions[k];
+                __m128 dx = _mm_sub_ps(x, _mm_set1_ps(sphere.x));
+                __m128 dy = _mm_sub_ps(y, _mm_set1_ps(sphere.y));
+                __m128 dz = _mm_sub_ps(z, _mm_set1_ps(sphere.z));
+                __m128 centerDistance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                __m128 touchDistance = _mm_add_ps(radius, _mm_set1_ps(sphere.w));
+                __m128 touches = _mm_cmplt_ps(centerDistance2, _mm_mul_ps(touchDistance, touchDistance));
+                __m128 touchedRegion = _mm_or_ps(_mm_and_ps(touches, _mm_set1_ps((float)k)), _mm_andnot_ps(touches, unknown));
+                region = _mm_min_ps(region, touchedRegion);
             }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+        }
+        alignas(16) int32_t regions[4];
+        _mm_store_si128((__m128i*)regions, _mm_cvttps_epi32(region));
+        for (uint32_t l = 0; l < 4; ++l) {
+            setRegion(ids[i + l], (uint8_t)regions[l], changes);
+        }
+    }
+#endif
+
+    for (; i < range.end; ++i) {
+        glm::vec3 proxyCenter(xs[i], ys[i], zs[i]);
+        float proxyRadius = radii[i];
+        uint8_t region = Region::UNKNOWN;
+        for (uint32_t j = 0; j < numViews; ++j) {
+            auto& view = _views[j];
+            // for each 'view' we need only increment 'k' below the current value of 'region'
+            for (uint8_t k = 0; k < region; ++k) {
+                float touchDistance = proxyRadius + view.regions[k].w;
+                if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
+                    region = k;
+                    break;
+                }
             }
         }
+        setRegion(ids[i], region, changes);
+    }
+}
+
+void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+
+    // split the bins that may hold changes in ranges for the workers
+    _ranges.clear();
+    uint32_t numProxiesToClassify = 0;
+    uint32_t numBins = (uint32_t)_bins.size();
+    for (uint32_t i = 0; i < numBins; ++i) {
+        Bin& bin = _bins[i];
+        uint32_t numProxies = (uint32_t)bin.ids.size();
+        if (numProxies == 0) {
+            continue;
+        }
+        bool reachable = isReachable(bin);
+        if (!reachable && bin.settled) {
+            continue;
+        }
+        bin.settled = !reachable;
+        for (uint32_t begin = 0; begin < numProxies; begin += PROXIES_PER_RANGE) {
+            _ranges.push_back({ i, begin, std::min(begin + PROXIES_PER_RANGE, numProxies), reachable });
+        }
+        numProxiesToClassify += numProxies;
+    }
+
+    // each range only writes the regions of its own proxies and its own list of changes
+    size_t numRanges = _ranges.size();
+    if (_rangeChanges.size() < numRanges) {
+        _rangeChanges.resize(numRanges);
+    }
+    auto classifyRanges = [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            _rangeChanges[r].clear();
+            classifyProxies(_ranges[r], _rangeChanges[r]);
+        }
+    };
+    if (numProxiesToClassify >= MIN_PROXIES_TO_CLASSIFY_IN_PARALLEL) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, numRanges), [&](const tbb::blocked_range<size_t>& range) {
+            classifyRanges(range.begin(), range.end());
+        });
+    } else {
+        classifyRanges(0, numRanges);
+    }
+
+    // a bin is settled once a pass over it finds nothing to change
+    for (size_t r = 0; r < numRanges; ++r) {
+        const auto& rangeChanges = _rangeChanges[r];
+        if (!rangeChanges.empty()) {
+            _bins[_ranges[r].bin].settled = false;
+            changes.insert(changes.end(), rangeChanges.begin(), rangeChanges.end());
+        }
     }
 }
 
 uint32_t Space::copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    auto numCopied = std::min(numDestProxies, (uint32_t)_proxies.size());
-    memcpy(proxies, _proxies.data(), numCopied * sizeof(Proxy));
+    auto numCopied = std::min(numDestProxies, (uint32_t)_regions.size());
+    for (uint32_t i = 0; i < numCopied; ++i) {
+        Proxy& proxy = proxies[i];
+        uint32_t binIndex = _proxyBins[i];
+        if (binIndex != NO_BIN) {
+            const Bin& bin = _bins[binIndex];
+            uint32_t slot = _proxySlots[i];
+            proxy.sphere = Sphere(bin.x[slot], bin.y[slot], bin.z[slot], bin.radius[slot]);
+        } else {
+            proxy.sphere = Sphere(0.0f);
+        }
+        proxy.region = _regions[i];
+        proxy.prevRegion = _prevRegions[i];
+    }
     return numCopied;
 }
 
 const Owner Space::getOwner(int32_t proxyID) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    if (isAllocatedID(proxyID) && (proxyID < (Index)_proxies.size())) {
+    if (isAllocatedID(proxyID) && (proxyID < (Index)_owners.size())) {
         return _owners[proxyID];
     }
     return Owner();
@@ -137,8 +402,8 @@ const Owner Space::getOwner(int32_t proxyID) const {
 
 uint8_t Space::getRegion(int32_t proxyID) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    if (isAllocatedID(proxyID) && (proxyID < (Index)_proxies.size())) {
-        return _proxies[proxyID].region;
+    if (isAllocatedID(proxyID) && (proxyID < (Index)_regions.size())) {
+        return _regions[proxyID];
     }
     return (uint8_t)Region::INVALID;
 }
@@ -147,8 +412,15 @@ void Space::clear() {
     Collection::clear();
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     _IDAllocator.clear();
-    _proxies.clear();
+    _bins.clear();
+    _binsByKey.clear();
+    _proxyBins.clear();
+    _proxySlots.clear();
+    _regions.clear();
+    _prevRegions.clear();
     _owners.clear();
+    _ranges.clear();
+    _rangeChanges.clear();
     _views.clear();
 }
 
@@ -16,6 +16,7 @@
 #define hifi_workload_Space_h
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -35,8 +36,16 @@ public:
         uint8_t prevRegion { 0 };
     };
 
+    // proxies are binned by the cell of this size (meters) that holds their center
+    static const float DEFAULT_BIN_SIZE;
+
     Space();
 
+    // A bin out of reach of every view is skipped once its proxies are known to be outside of all regions.
+    // A size of 0 puts every proxy in one bin that is always classified.
+    void setBinSize(float binSize);
+    float getBinSize() const;
+
     void setViews(const Views& views);
 
     uint32_t getNumViews() const { return (uint32_t)(_views.size()); }
@@ -59,11 +68,55 @@ private:
     void processRemoves(const Transaction::Removes& transactions);
     void processUpdates(const Transaction::Updates& transactions);
 
+    // The spheres of the proxies in a bin, in structure of arrays form so that they are classified four at a time
+    struct Bin {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+        std::vector<int32_t> ids;
+        uint64_t key { 0 };
+        glm::vec3 minCorner { 0.0f };
+        glm::vec3 maxCorner { 0.0f };
+        float maxRadius { 0.0f }; // of the absolute radii, only reset when the bin empties
+        bool bounded { false }; // whether the centers are known to be within the corners
+        bool settled { false }; // whether the bin is out of reach and all its regions were found UNKNOWN and unchanged
+    };
+
+    // A range of proxies of a bin, classified by one worker
+    struct BinRange {
+        uint32_t bin;
+        uint32_t begin;
+        uint32_t end;
+        bool reachable;
+    };
+
+    uint64_t toBinKey(const Sphere& sphere) const;
+    uint32_t findOrCreateBin(uint64_t key);
+    void insertProxy(int32_t proxyID, const Sphere& sphere);
+    void removeProxy(int32_t proxyID);
+    void rebin();
+    bool isReachable(const Bin& bin) const;
+    void classifyProxies(const BinRange& range, std::vector<Change>& changes);
+    void setRegion(int32_t proxyID, uint8_t region, std::vector<Change>& changes);
+
     // The database of proxies is protected for editing by a mutex
     mutable std::mutex _proxiesMutex;
-    Proxy::Vector _proxies;
+    std::vector<Bin> _bins;
+    std::unordered_map<uint64_t, uint32_t> _binsByKey;
+    float _binSize { DEFAULT_BIN_SIZE };
+
+    // indexed by proxy ID
+    std::vector<uint32_t> _proxyBins;
+    std::vector<uint32_t> _proxySlots;
+    std::vector<uint8_t> _regions;
+    std::vector<uint8_t> _prevRegions;
     std::vector<Owner> _owners;
 
+    // reused by categorizeAndGetChanges
+    std::vector<BinRange> _ranges;
+    std::vector<std::vector<Change>> _rangeChanges;
+
     Views _views;
 };
 
@@ -0,0 +1,98 @@
+"use strict";
+/*jslint nomen: true, plusplus: true, vars: true*/
+/*global Entities, Script, print, Vec3, MyAvatar */
+//
+//  batchedEntitiesBenchmark.js
+//  scripts/developer/tests/performance
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Compares adding, reading and editing entities one at a time against the batched calls
+//  (Entities.addEntities, Entities.getMultipleEntityProperties and Entities.editEntities) at 1k and 10k entities.
+//  The entities are short lived and created far above the avatar.  For best results run this in an otherwise
+//  empty domain where you can rez.
+//
+
+var ENTITY_COUNTS = [1000, 10000];
+var LIFETIME = 60; // seconds
+var SEPARATION = 0.5;
+var ROW_LENGTH = 100;
+var ORIGIN = Vec3.sum(MyAvatar.position, { x: 0, y: 100, z: 0 });
+
+function makeProperties(count) {
+    var properties = [];
+    for (var i = 0; i < count; i++) {
+        properties.push({
+            type: "Box",
+            name: "batchedEntitiesBenchmark",
+            position: Vec3.sum(ORIGIN, { x: (i % ROW_LENGTH) * SEPARATION, y: 0, z: Math.floor(i / ROW_LENGTH) * SEPARATION }),
+            dimensions: { x: 0.25, y: 0.25, z: 0.25 },
+            color: { red: 255, green: 255, blue: 255 },
+            collisionless: true,
+            lifetime: LIFETIME
+        });
+    }
+    return properties;
+}
+
+function time(operation) {
+    var start = Date.now();
+    var result = operation();
+    return { ms: Date.now() - start, result: result };
+}
+
+function deleteAll(entityIDs) {
+    entityIDs.forEach(function (entityID) {
+        Entities.deleteEntity(entityID);
+    });
+}
+
+function report(name, count, single, batched) {
+    print(name + " x " + count + ": one at a time " + single + " ms, batched " + batched + " ms, speedup " +
+          (batched > 0 ? (single / batched).toFixed(1) : "inf") + "x");
+}
+
+function benchmark(count) {
+    var properties = makeProperties(count);
+    var edit = { color: { red: 255, green: 0, blue: 0 } };
+
+    var singleAdd = time(function () {
+        return properties.map(function (entityProperties) {
+            return Entities.addEntity(entityProperties);
+        });
+    });
+    var batchedAdd = time(function () {
+        return Entities.addEntities(properties);
+    });
+    report("add", count, singleAdd.ms, batchedAdd.ms);
+
+    var entityIDs = batchedAdd.result;
+    var singleRead = time(function () {
+        return entityIDs.map(function (entityID) {
+            return Entities.getEntityProperties(entityID, ["position", "color"]);
+        });
+    });
+    var batchedRead = time(function () {
+        return Entities.getMultipleEntityProperties(entityIDs, ["position", "color"]);
+    });
+    report("read", count, singleRead.ms, batchedRead.ms);
+
+    var singleEdit = time(function () {
+        entityIDs.forEach(function (entityID) {
+            Entities.editEntity(entityID, edit);
+        });
+    });
+    var batchedEdit = time(function () {
+        return Entities.editEntities(entityIDs, [edit]);
+    });
+    report("edit", count, singleEdit.ms, batchedEdit.ms);
+
+    deleteAll(singleAdd.result);
+    deleteAll(batchedAdd.result);
+}
+
+ENTITY_COUNTS.forEach(benchmark);
+Script.stop();
@@ -86,6 +86,8 @@ Q_LOGGING_CATEGORY(renderperflogging, "hifi.render_perf")
 
 static const QString LAST_SCENE_KEY = "lastSceneFile";
 static const QString LAST_LOCATION_KEY = "lastLocation";
+static const int DEFAULT_SKINNED_MODELS = 100;
+static const int SKINNING_BENCHMARK_FRAMES = 300;
 
 class ParentFinder : public SpatialParentFinder {
 public:
@@ -798,11 +800,68 @@ private:
                 return;
             }
             parsePath(commandParams[1]);
+        } else if (verb == "skin") {
+            if (commandParams.length() < 2) {
+                qDebug() << "No model specified for skin command";
+                return;
+            }
+            int count = commandParams.length() > 2 ? commandParams[2].toInt() : DEFAULT_SKINNED_MODELS;
+            startSkinning(QUrl::fromUserInput(commandParams[1]), count);
         } else {
             qDebug() << "Unknown command " << command;
         }
     }
 
+    // Loads count copies of a skinned model, then compares the update of their cluster matrices one model after the
+    // other with the update of all of them at once over the worker threads
+    void startSkinning(const QUrl& url, int count) {
+        _skinnedModels.clear();
+        for (int i = 0; i < count; i++) {
+            auto model = std::make_shared<Model>();
+            model->setURL(url);
+            _skinnedModels.push_back(model);
+        }
+        _skinnedFrames = 0;
+        _serialSkinningTime = 0;
+        _parallelSkinningTime = 0;
+    }
+
+    void updateSkinning(float deltaTime) {
+        if (_skinnedModels.empty()) {
+            return;
+        }
+
+        bool loaded = true;
+        for (const auto& model : _skinnedModels) {
+            model->simulate(deltaTime);
+            loaded = loaded && model->isLoaded();
+        }
+        if (!loaded) {
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        for (const auto& model : _skinnedModels) {
+            model->updateClusterMatrices();
+        }
+        _serialSkinningTime += timer.nsecsElapsed();
+
+        for (const auto& model : _skinnedModels) {
+            model->simulate(deltaTime);
+        }
+        timer.restart();
+        Model::updateClusterMatrices(_skinnedModels);
+        _parallelSkinningTime += timer.nsecsElapsed();
+
+        if (++_skinnedFrames == SKINNING_BENCHMARK_FRAMES) {
+            qDebug() << "Cluster matrices of" << _skinnedModels.size() << "models, average over" << _skinnedFrames << "frames";
+            qDebug() << "    serial:  " << (_serialSkinningTime / _skinnedFrames) / NSECS_PER_USEC << "usecs";
+            qDebug() << "    parallel:" << (_parallelSkinningTime / _skinnedFrames) / NSECS_PER_USEC << "usecs";
+            _skinnedModels.clear();
+        }
+    }
+
     void runNextCommand(quint64 now) {
         if (_commands.empty()) {
             return;
@@ -831,6 +890,7 @@ private:
         float delta = now - last;
         // Update the camera
         _camera.update(delta / USECS_PER_SECOND);
+        updateSkinning(delta / USECS_PER_SECOND);
         {
             _viewFrustum = ViewFrustum();
             _viewFrustum.setProjection(_camera.matrices.perspective);
@@ -1070,6 +1130,11 @@ private:
     int _commandIndex{ -1 };
     uint64_t _nextCommandTime{ 0 };
 
+    std::vector<ModelPointer> _skinnedModels;
+    int _skinnedFrames{ 0 };
+    quint64 _serialSkinningTime{ 0 };
+    quint64 _parallelSkinningTime{ 0 };
+
     //TextOverlay* _textOverlay;
     static bool _cullingEnabled;
 
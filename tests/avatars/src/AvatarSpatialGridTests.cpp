@@ -0,0 +1,104 @@
+//
+//  AvatarSpatialGridTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarSpatialGridTests.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtTest/QtTest>
+
+#include <AvatarSpatialGrid.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AvatarSpatialGridTests)
+
+static AvatarSharedPointer makeAvatar() {
+    auto avatar = std::make_shared<AvatarData>();
+    avatar->setSessionUUID(QUuid::createUuid());
+    return avatar;
+}
+
+static bool contains(const std::vector<AvatarSharedPointer>& avatars, const AvatarSharedPointer& avatar) {
+    return std::find(avatars.begin(), avatars.end(), avatar) != avatars.end();
+}
+
+void AvatarSpatialGridTests::testFindInSphere() {
+    AvatarSpatialGrid grid;
+    auto near = makeAvatar();
+    auto acrossCell = makeAvatar();
+    auto far = makeAvatar();
+    grid.update(near->getSessionUUID(), near, glm::vec3(1.0f, 0.0f, 1.0f));
+    grid.update(acrossCell->getSessionUUID(), acrossCell, glm::vec3(-AvatarSpatialGrid::CELL_SIZE + 1.0f, 0.0f, 0.0f));
+    grid.update(far->getSessionUUID(), far, glm::vec3(100.0f, 0.0f, 0.0f));
+    QCOMPARE(grid.size(), (size_t)3);
+
+    auto found = grid.findInSphere(glm::vec3(0.0f), AvatarSpatialGrid::CELL_SIZE);
+    QCOMPARE(found.size(), (size_t)2);
+    QVERIFY(contains(found, near));
+    QVERIFY(contains(found, acrossCell));
+
+    // candidates are padded by the slack, but no further
+    found = grid.findInSphere(glm::vec3(100.0f + AvatarSpatialGrid::POSITION_SLACK + 1.0f, 0.0f, 0.0f), 0.5f);
+    QVERIFY(found.empty());
+    found = grid.findInSphere(glm::vec3(100.0f + AvatarSpatialGrid::POSITION_SLACK, 0.0f, 0.0f), 0.5f);
+    QCOMPARE(found.size(), (size_t)1);
+    QVERIFY(contains(found, far));
+}
+
+void AvatarSpatialGridTests::testMoveAndRemove() {
+    AvatarSpatialGrid grid;
+    auto avatar = makeAvatar();
+    QUuid id = avatar->getSessionUUID();
+    grid.update(id, avatar, glm::vec3(0.0f));
+    grid.update(id, avatar, glm::vec3(50.0f, -20.0f, 3.0f));
+    QCOMPARE(grid.size(), (size_t)1);
+    QVERIFY(grid.findInSphere(glm::vec3(0.0f), 1.0f).empty());
+    QVERIFY(contains(grid.findInSphere(glm::vec3(50.0f, -20.0f, 3.0f), 1.0f), avatar));
+
+    grid.remove(id);
+    QCOMPARE(grid.size(), (size_t)0);
+    QVERIFY(grid.findInSphere(glm::vec3(50.0f, -20.0f, 3.0f), 1.0f).empty());
+
+    // the grid doesn't keep avatars alive
+    grid.update(id, avatar, glm::vec3(0.0f));
+    avatar.reset();
+    QVERIFY(grid.findInSphere(glm::vec3(0.0f), 1.0f).empty());
+}
+
+void AvatarSpatialGridTests::testLargeRadius() {
+    AvatarSpatialGrid grid;
+    std::vector<AvatarSharedPointer> avatars;
+    for (int i = 0; i < 10; ++i) {
+        auto avatar = makeAvatar();
+        grid.update(avatar->getSessionUUID(), avatar, glm::vec3(i * 1000.0f, 0.0f, -i * 1000.0f));
+        avatars.push_back(avatar);
+    }
+    QCOMPARE(grid.findInSphere(glm::vec3(0.0f), 20000.0f).size(), avatars.size());
+    QCOMPARE(grid.findInSphere(glm::vec3(0.0f), std::numeric_limits<float>::infinity()).size(), avatars.size());
+}
+
+void AvatarSpatialGridTests::benchmarkFindInSphere() {
+    const int NUM_AVATARS = 200;
+    const float DOMAIN_SIZE = 200.0f;
+    AvatarSpatialGrid grid;
+    std::vector<AvatarSharedPointer> avatars;
+    for (int i = 0; i < NUM_AVATARS; ++i) {
+        auto avatar = makeAvatar();
+        glm::vec3 position(randFloatInRange(0.0f, DOMAIN_SIZE), 0.0f, randFloatInRange(0.0f, DOMAIN_SIZE));
+        grid.update(avatar->getSessionUUID(), avatar, position);
+        avatars.push_back(avatar);
+    }
+    size_t numFound = 0;
+    QBENCHMARK {
+        numFound += grid.findInSphere(glm::vec3(DOMAIN_SIZE / 2.0f, 0.0f, DOMAIN_SIZE / 2.0f), 10.0f).size();
+    }
+    Q_UNUSED(numFound);
+}
@@ -0,0 +1,25 @@
+//
+//  AvatarSpatialGridTests.h
+//  tests/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSpatialGridTests_h
+#define hifi_AvatarSpatialGridTests_h
+
+#include <QtCore/QObject>
+
+class AvatarSpatialGridTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testFindInSphere();
+    void testMoveAndRemove();
+    void testLargeRadius();
+    void benchmarkFindInSphere();
+};
+
+#endif // hifi_AvatarSpatialGridTests_h
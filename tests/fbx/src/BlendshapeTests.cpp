@@ -0,0 +1,294 @@
+//
+//  BlendshapeTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlendshapeTests.h"
+
+#include <algorithm>
+#include <random>
+
+#include <QtTest/QtTest>
+#include <QtCore/QElapsedTimer>
+
+#include <FBXSerializer.h>
+#include <hfm/SparseBlendshapes.h>
+
+QTEST_GUILESS_MAIN(BlendshapeTests)
+
+using hfm::BlendshapeAccumulator;
+using hfm::SparseBlendshapes;
+
+static const int NUM_VERTICES = 8192;
+static const int NUM_BLENDSHAPES = 52;
+static const int BLENDSHAPE_SPAN = 512;
+static const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+static const float EPSILON = 0.0001f;
+
+// set to a folder of avatar FBX files to benchmark blending their blendshapes
+static const char* SAMPLE_DIRECTORY_VARIABLE = "HIFI_BLENDSHAPE_BENCHMARK_DIR";
+static const int SAMPLE_FRAMES = 600;
+
+// each blendshape moves a run of vertices, like the parts of a face do
+static QVector<hfm::Blendshape> makeBlendshapes(int numVertices, int numBlendshapes, int span) {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+    QVector<hfm::Blendshape> blendshapes(numBlendshapes);
+    for (auto& blendshape : blendshapes) {
+        int start = random() % (numVertices - span);
+        for (int i = start; i < start + span; i++) {
+            blendshape.indices.append(i);
+            blendshape.vertices.append(glm::vec3(offset(random), offset(random), offset(random)));
+            blendshape.normals.append(glm::vec3(offset(random), offset(random), offset(random)));
+            blendshape.tangents.append(glm::vec3(offset(random), offset(random), offset(random)));
+        }
+    }
+    return blendshapes;
+}
+
+// a quarter of the blendshapes moving at once, like a face talking and blinking
+static QVector<float> animateCoefficients(int numBlendshapes, int frame) {
+    const int ANIMATED_STRIDE = 4;
+    QVector<float> coefficients(numBlendshapes, 0.0f);
+    for (int i = 0; i < numBlendshapes; i += ANIMATED_STRIDE) {
+        coefficients[i] = 0.5f + 0.5f * sinf(frame * 0.1f + i);
+    }
+    return coefficients;
+}
+
+static void addOffset(float* destination, const QVector<glm::vec3>& source, int index, float coefficient) {
+    if (index < source.size()) {
+        destination[0] += source.at(index).x * coefficient;
+        destination[1] += source.at(index).y * coefficient;
+        destination[2] += source.at(index).z * coefficient;
+    }
+}
+
+// the way the Blender used to do it: every blendshape with a coefficient, every time
+static std::vector<float> blendDense(const QVector<hfm::Blendshape>& blendshapes, int numVertices,
+                                     const QVector<float>& coefficients) {
+    std::vector<float> offsets(numVertices * SparseBlendshapes::FLOATS_PER_VERTEX, 0.0f);
+    for (int i = 0, n = qMin(coefficients.size(), blendshapes.size()); i < n; i++) {
+        float vertexCoefficient = coefficients.at(i);
+        if (vertexCoefficient < BlendshapeAccumulator::MIN_COEFFICIENT) {
+            continue;
+        }
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+        const hfm::Blendshape& blendshape = blendshapes.at(i);
+        for (int j = 0; j < blendshape.indices.size(); ++j) {
+            float* offset = &offsets[blendshape.indices.at(j) * SparseBlendshapes::FLOATS_PER_VERTEX];
+            addOffset(offset, blendshape.vertices, j, vertexCoefficient);
+            addOffset(offset + 4, blendshape.normals, j, normalCoefficient);
+            addOffset(offset + 8, blendshape.tangents, j, normalCoefficient);
+        }
+    }
+    return offsets;
+}
+
+static std::vector<float> getOffsets(const BlendshapeAccumulator& accumulator, int numVertices) {
+    const float* offsets = accumulator.getOffsets(0);
+    return std::vector<float>(offsets, offsets + numVertices * SparseBlendshapes::FLOATS_PER_VERTEX);
+}
+
+static float getMaxDifference(const std::vector<float>& offsets, const std::vector<float>& expected) {
+    float maxDifference = 0.0f;
+    for (size_t i = 0; i < offsets.size(); i++) {
+        maxDifference = std::max(maxDifference, fabsf(offsets[i] - expected[i]));
+    }
+    return maxDifference;
+}
+
+void BlendshapeTests::testFullBlend() {
+    auto blendshapes = makeBlendshapes(NUM_VERTICES, NUM_BLENDSHAPES, BLENDSHAPE_SPAN);
+    SparseBlendshapes sparseBlendshapes(blendshapes, NUM_VERTICES);
+    QCOMPARE(sparseBlendshapes.getNumBlendshapes(), NUM_BLENDSHAPES);
+    QCOMPARE(sparseBlendshapes.getNumEntries(), (size_t)(NUM_BLENDSHAPES * BLENDSHAPE_SPAN));
+
+    // the first update always blends every vertex
+    QVector<float> coefficients = animateCoefficients(NUM_BLENDSHAPES, 0);
+    BlendshapeAccumulator accumulator;
+    std::vector<uint32_t> changedVertices;
+    QVERIFY(accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices));
+    QVERIFY(changedVertices.empty());
+
+    auto expected = blendDense(blendshapes, NUM_VERTICES, coefficients);
+    QVERIFY(getMaxDifference(getOffsets(accumulator, NUM_VERTICES), expected) < EPSILON);
+}
+
+void BlendshapeTests::testIncrementalBlend() {
+    auto blendshapes = makeBlendshapes(NUM_VERTICES, NUM_BLENDSHAPES, BLENDSHAPE_SPAN);
+    SparseBlendshapes sparseBlendshapes(blendshapes, NUM_VERTICES);
+    BlendshapeAccumulator accumulator;
+    std::vector<uint32_t> changedVertices;
+
+    // move a few coefficients at a time by more than the threshold
+    std::mt19937 random(2);
+    QVector<float> coefficients(NUM_BLENDSHAPES, 0.0f);
+    accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices);
+    const int NUM_STEPS = 100;
+    const int NUM_CHANGES = 3;
+    for (int step = 0; step < NUM_STEPS; step++) {
+        for (int i = 0; i < NUM_CHANGES; i++) {
+            coefficients[random() % NUM_BLENDSHAPES] = (random() % 101) * 0.01f;
+        }
+
+        auto before = getOffsets(accumulator, NUM_VERTICES);
+        bool rebuilt = accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices);
+        auto after = getOffsets(accumulator, NUM_VERTICES);
+        QVERIFY(getMaxDifference(after, blendDense(blendshapes, NUM_VERTICES, coefficients)) < EPSILON);
+
+        // vertices that weren't reported as changed must not have moved
+        if (!rebuilt) {
+            std::vector<bool> changed(NUM_VERTICES, false);
+            for (uint32_t index : changedVertices) {
+                QVERIFY(!changed[index]);
+                changed[index] = true;
+            }
+            for (int vertex = 0; vertex < NUM_VERTICES; vertex++) {
+                if (!changed[vertex]) {
+                    for (int j = 0; j < SparseBlendshapes::FLOATS_PER_VERTEX; j++) {
+                        int index = vertex * SparseBlendshapes::FLOATS_PER_VERTEX + j;
+                        QCOMPARE(after[index], before[index]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void BlendshapeTests::testSmallChanges() {
+    auto blendshapes = makeBlendshapes(NUM_VERTICES, NUM_BLENDSHAPES, BLENDSHAPE_SPAN);
+    SparseBlendshapes sparseBlendshapes(blendshapes, NUM_VERTICES);
+    BlendshapeAccumulator accumulator;
+    std::vector<uint32_t> changedVertices;
+
+    QVector<float> coefficients(NUM_BLENDSHAPES, 0.0f);
+    QVERIFY(accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices));
+
+    // coefficients below the minimum are the same as zero
+    coefficients[0] = BlendshapeAccumulator::MIN_COEFFICIENT * 0.5f;
+    QVERIFY(!accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices));
+    QVERIFY(changedVertices.empty());
+
+    // changes within the threshold are skipped
+    coefficients.fill(0.5f);
+    accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices);
+    auto before = getOffsets(accumulator, NUM_VERTICES);
+    coefficients[1] += BlendshapeAccumulator::CHANGE_THRESHOLD * 0.5f;
+    QVERIFY(!accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices));
+    QVERIFY(changedVertices.empty());
+    QVERIFY(getOffsets(accumulator, NUM_VERTICES) == before);
+
+    // switching everything off gets back to rest exactly
+    coefficients.fill(0.0f);
+    accumulator.update(sparseBlendshapes, coefficients, NORMAL_COEFFICIENT_SCALE, changedVertices);
+    auto offsets = getOffsets(accumulator, NUM_VERTICES);
+    QVERIFY(std::all_of(offsets.begin(), offsets.end(), [](float offset) { return offset == 0.0f; }));
+}
+
+void BlendshapeTests::benchmarkDenseBlend() {
+    auto blendshapes = makeBlendshapes(NUM_VERTICES, NUM_BLENDSHAPES, BLENDSHAPE_SPAN);
+    int frame = 0;
+    QBENCHMARK {
+        blendDense(blendshapes, NUM_VERTICES, animateCoefficients(NUM_BLENDSHAPES, frame++));
+    }
+}
+
+void BlendshapeTests::benchmarkSparseBlend() {
+    auto blendshapes = makeBlendshapes(NUM_VERTICES, NUM_BLENDSHAPES, BLENDSHAPE_SPAN);
+    SparseBlendshapes sparseBlendshapes(blendshapes, NUM_VERTICES);
+    std::vector<float> offsets(NUM_VERTICES * SparseBlendshapes::FLOATS_PER_VERTEX);
+    int frame = 0;
+    QBENCHMARK {
+        QVector<float> coefficients = animateCoefficients(NUM_BLENDSHAPES, frame++);
+        std::fill(offsets.begin(), offsets.end(), 0.0f);
+        for (int i = 0; i < NUM_BLENDSHAPES; i++) {
+            if (coefficients[i] >= BlendshapeAccumulator::MIN_COEFFICIENT) {
+                sparseBlendshapes.accumulate(i, coefficients[i], coefficients[i] * NORMAL_COEFFICIENT_SCALE, offsets.data());
+            }
+        }
+    }
+}
+
+void BlendshapeTests::benchmarkIncrementalBlend() {
+    auto blendshapes = makeBlendshapes(NUM_VERTICES, NUM_BLENDSHAPES, BLENDSHAPE_SPAN);
+    SparseBlendshapes sparseBlendshapes(blendshapes, NUM_VERTICES);
+    BlendshapeAccumulator accumulator;
+    std::vector<uint32_t> changedVertices;
+    int frame = 0;
+    QBENCHMARK {
+        accumulator.update(sparseBlendshapes, animateCoefficients(NUM_BLENDSHAPES, frame++), NORMAL_COEFFICIENT_SCALE,
+                           changedVertices);
+    }
+}
+
+void BlendshapeTests::benchmarkSampleFiles() {
+    QString directory = qgetenv(SAMPLE_DIRECTORY_VARIABLE);
+    if (directory.isEmpty()) {
+        QSKIP("set HIFI_BLENDSHAPE_BENCHMARK_DIR to a folder of avatar FBX files to benchmark blending them");
+    }
+
+    for (const auto& fileInfo : QDir(directory).entryInfoList({ "*.fbx" }, QDir::Files, QDir::Name)) {
+        auto source = FBXSource::fromFile(fileInfo.absoluteFilePath());
+        QVERIFY(source);
+        FBXSerializer serializer;
+        auto model = serializer.read(source, hifi::VariantHash(), QUrl::fromLocalFile(fileInfo.absoluteFilePath()));
+        QVERIFY(model);
+
+        std::vector<std::pair<const HFMMesh*, SparseBlendshapes>> meshes;
+        for (const HFMMesh& mesh : model->meshes) {
+            if (!mesh.blendshapes.isEmpty()) {
+                meshes.emplace_back(&mesh, SparseBlendshapes(mesh.blendshapes, mesh.vertices.size()));
+            }
+        }
+        if (meshes.empty()) {
+            qDebug().noquote() << fileInfo.fileName() << "has no blendshapes";
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < SAMPLE_FRAMES; frame++) {
+            for (const auto& mesh : meshes) {
+                blendDense(mesh.first->blendshapes, mesh.first->vertices.size(),
+                           animateCoefficients(mesh.first->blendshapes.size(), frame));
+            }
+        }
+        qint64 denseElapsed = timer.nsecsElapsed();
+
+        std::vector<BlendshapeAccumulator> accumulators(meshes.size());
+        std::vector<uint32_t> changedVertices;
+        size_t numChangedVertices = 0;
+        timer.restart();
+        for (int frame = 0; frame < SAMPLE_FRAMES; frame++) {
+            for (size_t i = 0; i < meshes.size(); i++) {
+                const auto& sparseBlendshapes = meshes[i].second;
+                if (accumulators[i].update(sparseBlendshapes, animateCoefficients(sparseBlendshapes.getNumBlendshapes(), frame),
+                                           NORMAL_COEFFICIENT_SCALE, changedVertices)) {
+                    numChangedVertices += sparseBlendshapes.getNumVertices();
+                } else {
+                    numChangedVertices += changedVertices.size();
+                }
+            }
+        }
+        qint64 incrementalElapsed = timer.nsecsElapsed();
+
+        size_t numEntries = 0;
+        for (const auto& mesh : meshes) {
+            numEntries += mesh.second.getNumEntries();
+        }
+        qDebug().noquote() << QString("%1: %2 blended meshes, %3 entries, dense %4 us/frame, incremental %5 us/frame, "
+                                      "%6 vertices repacked/frame")
+            .arg(fileInfo.fileName())
+            .arg(meshes.size())
+            .arg(numEntries)
+            .arg(denseElapsed / (1000.0 * SAMPLE_FRAMES), 0, 'f', 1)
+            .arg(incrementalElapsed / (1000.0 * SAMPLE_FRAMES), 0, 'f', 1)
+            .arg(numChangedVertices / SAMPLE_FRAMES);
+    }
+}
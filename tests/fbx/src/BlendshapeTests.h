@@ -0,0 +1,28 @@
+//
+//  BlendshapeTests.h
+//  tests/fbx/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlendshapeTests_h
+#define hifi_BlendshapeTests_h
+
+#include <QtCore/QObject>
+
+class BlendshapeTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testFullBlend();
+    void testIncrementalBlend();
+    void testSmallChanges();
+    void benchmarkDenseBlend();
+    void benchmarkSparseBlend();
+    void benchmarkIncrementalBlend();
+    void benchmarkSampleFiles();
+};
+
+#endif // hifi_BlendshapeTests_h
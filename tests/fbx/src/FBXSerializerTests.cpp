@@ -0,0 +1,239 @@
+//
+//  FBXSerializerTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXSerializerTests.h"
+
+#include <QtTest/QtTest>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTemporaryDir>
+
+#if !defined(Q_OS_WIN)
+#include <sys/resource.h>
+#endif
+
+#include <FBXSerializer.h>
+#include <FBXWriter.h>
+#include <SharedUtil.h>
+
+QTEST_GUILESS_MAIN(FBXSerializerTests)
+
+// large enough for FBXWriter to compress it
+static const int COMPRESSED_VERTEX_COUNT = 4096;
+static const int UNCOMPRESSED_VERTEX_COUNT = 4;
+
+// set to a folder of FBX files to benchmark parsing them
+static const char* SAMPLE_DIRECTORY_VARIABLE = "HIFI_FBX_BENCHMARK_DIR";
+
+static QVector<double> makeVertices(int count) {
+    QVector<double> vertices;
+    for (int i = 0; i < count * 3; i++) {
+        vertices.append(i * 0.5);
+    }
+    return vertices;
+}
+
+static QVector<qint32> makeIndices(int vertexCount) {
+    QVector<qint32> indices;
+    for (int i = 0; i + 2 < vertexCount; i += 3) {
+        // the last index of each polygon is stored negated and minus one
+        indices << i << i + 1 << -(i + 2) - 1;
+    }
+    return indices;
+}
+
+static FBXNode makeGeometryNode(int vertexCount) {
+    FBXNode vertices;
+    vertices.name = "Vertices";
+    vertices.properties.append(QVariant::fromValue(makeVertices(vertexCount)));
+
+    FBXNode indices;
+    indices.name = "PolygonVertexIndex";
+    indices.properties.append(QVariant::fromValue(makeIndices(vertexCount)));
+
+    FBXNode geometry;
+    geometry.name = "Geometry";
+    geometry.properties = { (qint64)1, hifi::ByteArray("Geometry::"), hifi::ByteArray("Mesh") };
+    geometry.children = { vertices, indices };
+    return geometry;
+}
+
+static hifi::ByteArray makeDocument(int vertexCount) {
+    FBXNode objects;
+    objects.name = "Objects";
+    objects.children = { makeGeometryNode(vertexCount) };
+
+    FBXNode root;
+    root.children = { objects };
+    return FBXWriter::encodeFBX(root);
+}
+
+static const FBXNode& getGeometryChild(const FBXNode& root, const hifi::ByteArray& name) {
+    const FBXNode& geometry = root.children.at(0).children.at(0);
+    for (const auto& child : geometry.children) {
+        if (child.name == name) {
+            return child;
+        }
+    }
+    throw QString("missing ") + name;
+}
+
+static size_t getPeakMemoryUsage() {
+    MemoryInfo info;
+    if (getMemoryInfo(info)) {
+        return info.processPeakUsedMemoryBytes;
+    }
+#if defined(Q_OS_WIN)
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(Q_OS_MAC)
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+void FBXSerializerTests::testLazyArrays() {
+    for (int vertexCount : { UNCOMPRESSED_VERTEX_COUNT, COMPRESSED_VERTEX_COUNT }) {
+        FBXNode root = FBXSerializer::parseFBX(FBXSource::fromData(makeDocument(vertexCount)));
+
+        const FBXNode& vertices = getGeometryChild(root, "Vertices");
+        QCOMPARE(vertices.properties.size(), 1);
+        QCOMPARE(vertices.properties.at(0).userType(), qMetaTypeId<FBXBinaryArray<double>>());
+
+        auto array = vertices.properties.at(0).value<FBXBinaryArray<double>>();
+        QCOMPARE(array.size(), vertexCount * 3);
+        QCOMPARE(array.getEncoding() == (quint32)FBX_PROPERTY_COMPRESSED_FLAG, vertexCount == COMPRESSED_VERTEX_COUNT);
+        QCOMPARE(array.decode(), makeVertices(vertexCount));
+
+        QCOMPARE(FBXSerializer::getDoubleVector(vertices), makeVertices(vertexCount));
+        QCOMPARE(FBXSerializer::getIntVector(getGeometryChild(root, "PolygonVertexIndex")), makeIndices(vertexCount));
+    }
+}
+
+void FBXSerializerTests::testVariantConversion() {
+    FBXNode root = FBXSerializer::parseFBX(FBXSource::fromData(makeDocument(COMPRESSED_VERTEX_COUNT)));
+    const QVariant& vertices = getGeometryChild(root, "Vertices").properties.at(0);
+
+    // code that only knows about QVector properties still gets the decoded array
+    QVERIFY(vertices.canConvert<QVector<double>>());
+    QVERIFY(!vertices.canConvert<QVector<float>>());
+    QCOMPARE(vertices.value<QVector<double>>(), makeVertices(COMPRESSED_VERTEX_COUNT));
+}
+
+void FBXSerializerTests::testWriteParsedArrays() {
+    FBXNode root = FBXSerializer::parseFBX(FBXSource::fromData(makeDocument(COMPRESSED_VERTEX_COUNT)));
+
+    // the arrays are written without being decoded, parsing the result again has to give the same values
+    FBXNode rewritten = FBXSerializer::parseFBX(FBXSource::fromData(FBXWriter::encodeFBX(root)));
+    QCOMPARE(FBXSerializer::getDoubleVector(getGeometryChild(rewritten, "Vertices")), makeVertices(COMPRESSED_VERTEX_COUNT));
+    QCOMPARE(FBXSerializer::getIntVector(getGeometryChild(rewritten, "PolygonVertexIndex")),
+             makeIndices(COMPRESSED_VERTEX_COUNT));
+}
+
+void FBXSerializerTests::testMappedFile() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("mapped.fbx");
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(makeDocument(COMPRESSED_VERTEX_COUNT));
+    }
+
+    FBXNode root;
+    {
+        auto source = FBXSource::fromFile(path);
+        QVERIFY(source);
+        root = FBXSerializer::parseFBX(source);
+    }
+
+    // the nodes keep the mapping alive after the source pointer is gone
+    QCOMPARE(FBXSerializer::getDoubleVector(getGeometryChild(root, "Vertices")), makeVertices(COMPRESSED_VERTEX_COUNT));
+
+    QVERIFY(!FBXSource::fromFile(dir.filePath("missing.fbx")));
+}
+
+void FBXSerializerTests::testCorruptDocument() {
+    hifi::ByteArray document = makeDocument(COMPRESSED_VERTEX_COUNT);
+
+    // a truncated document fails while parsing
+    hifi::ByteArray truncated = document.left(document.size() / 2);
+    bool threw = false;
+    try {
+        FBXSerializer::parseFBX(FBXSource::fromData(truncated));
+    } catch (const QString&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+
+    // corrupt compressed data only fails once the array is decoded
+    FBXNode root = FBXSerializer::parseFBX(FBXSource::fromData(document));
+    auto array = getGeometryChild(root, "Vertices").properties.at(0).value<FBXBinaryArray<double>>();
+    hifi::ByteArray encoded = array.getEncodedData();
+    hifi::ByteArray corrupt = document;
+    int offset = document.indexOf(encoded);
+    QVERIFY(offset > 0);
+    memset(corrupt.data() + offset, 0xff, 16);
+
+    root = FBXSerializer::parseFBX(FBXSource::fromData(corrupt));
+    const FBXNode& vertices = getGeometryChild(root, "Vertices");
+    threw = false;
+    try {
+        FBXSerializer::getDoubleVector(vertices);
+    } catch (const QString&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+    QVERIFY(vertices.properties.at(0).value<QVector<double>>().isEmpty());
+}
+
+void FBXSerializerTests::benchmarkParse() {
+    static const int BENCHMARK_VERTEX_COUNT = 1 << 20;
+    auto source = FBXSource::fromData(makeDocument(BENCHMARK_VERTEX_COUNT));
+
+    QBENCHMARK {
+        FBXNode root = FBXSerializer::parseFBX(source);
+        QCOMPARE(FBXSerializer::getDoubleVector(getGeometryChild(root, "Vertices")).size(), BENCHMARK_VERTEX_COUNT * 3);
+    }
+}
+
+void FBXSerializerTests::benchmarkSampleFiles() {
+    QString directory = qgetenv(SAMPLE_DIRECTORY_VARIABLE);
+    if (directory.isEmpty()) {
+        QSKIP("set HIFI_FBX_BENCHMARK_DIR to a folder of FBX files to benchmark them");
+    }
+
+    // smallest first, the peak only grows so its increase is down to the file being parsed
+    for (const auto& fileInfo : QDir(directory).entryInfoList({ "*.fbx" }, QDir::Files, QDir::Size | QDir::Reversed)) {
+        auto source = FBXSource::fromFile(fileInfo.absoluteFilePath());
+        QVERIFY(source);
+
+        size_t peakBefore = getPeakMemoryUsage();
+        QElapsedTimer timer;
+        timer.start();
+        FBXSerializer serializer;
+        auto model = serializer.read(source, hifi::VariantHash(), QUrl::fromLocalFile(fileInfo.absoluteFilePath()));
+        qint64 elapsed = timer.elapsed();
+        size_t peakAfter = getPeakMemoryUsage();
+
+        QVERIFY(model);
+        qDebug().noquote() << QString("%1: %2 MB parsed in %3 ms, %4 meshes, peak memory %5 MB (+%6 MB)")
+            .arg(fileInfo.fileName())
+            .arg(fileInfo.size() / (1024.0 * 1024.0), 0, 'f', 1)
+            .arg(elapsed)
+            .arg(model->meshes.size())
+            .arg(peakAfter / (1024.0 * 1024.0), 0, 'f', 1)
+            .arg((peakAfter - peakBefore) / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+}
@@ -0,0 +1,28 @@
+//
+//  FBXSerializerTests.h
+//  tests/fbx/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXSerializerTests_h
+#define hifi_FBXSerializerTests_h
+
+#include <QtCore/QObject>
+
+class FBXSerializerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testLazyArrays();
+    void testVariantConversion();
+    void testWriteParsedArrays();
+    void testMappedFile();
+    void testCorruptDocument();
+    void benchmarkParse();
+    void benchmarkSampleFiles();
+};
+
+#endif // hifi_FBXSerializerTests_h
@@ -0,0 +1,155 @@
+//
+//  CubeMapTests.cpp
+//  tests/image/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CubeMapTests.h"
+
+#include <cstring>
+#include <functional>
+
+#include <QtTest/QtTest>
+
+#include <image/CubeMap.h>
+
+QTEST_GUILESS_MAIN(CubeMapTests)
+
+using namespace image;
+
+static const int CUBE_SIZE = 32;
+static const int MIP_COUNT = 6;
+static const float TOLERANCE = 1e-4f;
+
+static std::vector<Image> makeFaces(const std::function<glm::vec4(int face, int x, int y)>& color) {
+    std::vector<Image> faces;
+    for (int face = 0; face < 6; face++) {
+        Image image(CUBE_SIZE, CUBE_SIZE, Image::Format_RGBAF);
+        const size_t lineStride = image.getBytesPerLineCount() / sizeof(glm::vec4);
+        glm::vec4* pixels = (glm::vec4*)image.editBits();
+        for (int y = 0; y < CUBE_SIZE; y++) {
+            for (int x = 0; x < CUBE_SIZE; x++) {
+                pixels[x + y * lineStride] = color(face, x, y);
+            }
+        }
+        faces.push_back(image);
+    }
+    return faces;
+}
+
+static std::vector<Image> makeGradientFaces() {
+    return makeFaces([](int face, int x, int y) {
+        return glm::vec4((float)x / CUBE_SIZE, (float)y / CUBE_SIZE, (float)face / 6.0f, 1.0f);
+    });
+}
+
+static bool fuzzyCompare(const glm::vec4& a, const glm::vec4& b) {
+    return glm::all(glm::lessThanEqual(glm::abs(a - b), glm::vec4(TOLERANCE)));
+}
+
+void CubeMapTests::testConvolveConstant() {
+    // The GGX weights are normalized, so a constant environment stays constant at every roughness
+    const glm::vec4 COLOR(0.25f, 0.5f, 0.75f, 1.0f);
+    CubeMap source(makeFaces([&](int, int, int) { return COLOR; }), MIP_COUNT);
+    CubeMap output(CUBE_SIZE, CUBE_SIZE, MIP_COUNT);
+
+    source.convolveForGGX(output, false);
+
+    for (gpu::uint16 mipLevel = 0; mipLevel < MIP_COUNT; mipLevel++) {
+        const auto dims = output.getMipDimensions(mipLevel);
+        const auto lineStride = output.getMipLineStride(mipLevel);
+        for (int face = 0; face < 6; face++) {
+            const glm::vec4* pixels = output.getFace(mipLevel, face);
+            for (int y = 0; y < dims.y; y++) {
+                for (int x = 0; x < dims.x; x++) {
+                    QVERIFY(fuzzyCompare(pixels[x + y * lineStride], COLOR));
+                }
+            }
+        }
+    }
+}
+
+void CubeMapTests::testConvolveReference() {
+    // The first mip has a roughness of nearly zero, its single sample points along the normal and reads the
+    // finest source mip, so every texel must come out as the source texel it covers
+    CubeMap source(makeGradientFaces(), MIP_COUNT);
+    CubeMap output(CUBE_SIZE, CUBE_SIZE, MIP_COUNT);
+
+    source.convolveForGGX(output, false);
+
+    const auto lineStride = output.getMipLineStride(0);
+    for (int face = 0; face < 6; face++) {
+        const glm::vec4* expected = source.getFace(0, face);
+        const glm::vec4* actual = output.getFace(0, face);
+        for (int y = 0; y < CUBE_SIZE; y++) {
+            for (int x = 0; x < CUBE_SIZE; x++) {
+                QVERIFY(fuzzyCompare(actual[x + y * lineStride], expected[x + y * lineStride]));
+            }
+        }
+    }
+}
+
+void CubeMapTests::testConvolveDeterministic() {
+    // Tiles run in whatever order the pool picks, the result must not depend on it
+    CubeMap source(makeGradientFaces(), MIP_COUNT);
+    CubeMap output0(CUBE_SIZE, CUBE_SIZE, MIP_COUNT);
+    CubeMap output1(CUBE_SIZE, CUBE_SIZE, MIP_COUNT);
+
+    source.convolveForGGX(output0, false);
+    source.convolveForGGX(output1, false);
+
+    for (gpu::uint16 mipLevel = 0; mipLevel < MIP_COUNT; mipLevel++) {
+        const auto dims = output0.getMipDimensions(mipLevel);
+        const auto lineStride = output0.getMipLineStride(mipLevel);
+        for (int face = 0; face < 6; face++) {
+            const glm::vec4* pixels0 = output0.getFace(mipLevel, face);
+            const glm::vec4* pixels1 = output1.getFace(mipLevel, face);
+            for (int y = 0; y < dims.y; y++) {
+                QVERIFY(memcmp(pixels0 + y * lineStride, pixels1 + y * lineStride, dims.x * sizeof(glm::vec4)) == 0);
+            }
+        }
+    }
+}
+
+void CubeMapTests::testConvolveAbort() {
+    CubeMap source(makeGradientFaces(), MIP_COUNT);
+    CubeMap output(CUBE_SIZE, CUBE_SIZE, MIP_COUNT);
+    std::atomic<bool> abortProcessing { true };
+
+    source.convolveForGGX(output, abortProcessing);
+
+    for (gpu::uint16 mipLevel = 0; mipLevel < MIP_COUNT; mipLevel++) {
+        const auto dims = output.getMipDimensions(mipLevel);
+        const auto lineStride = output.getMipLineStride(mipLevel);
+        for (int face = 0; face < 6; face++) {
+            const glm::vec4* pixels = output.getFace(mipLevel, face);
+            for (int y = 0; y < dims.y; y++) {
+                for (int x = 0; x < dims.x; x++) {
+                    QVERIFY(pixels[x + y * lineStride] == glm::vec4(0.0f));
+                }
+            }
+        }
+    }
+}
+
+void CubeMapTests::benchmarkConvolveForGGX() {
+    static const int BENCHMARK_SIZE = 128;
+    static const int BENCHMARK_MIP_COUNT = 8;
+
+    std::vector<Image> faces;
+    for (int face = 0; face < 6; face++) {
+        Image image(BENCHMARK_SIZE, BENCHMARK_SIZE, Image::Format_RGBAF);
+        memset(image.editBits(), 0, image.getBytesPerLineCount() * BENCHMARK_SIZE);
+        faces.push_back(image);
+    }
+    CubeMap source(faces, BENCHMARK_MIP_COUNT);
+    CubeMap output(BENCHMARK_SIZE, BENCHMARK_SIZE, BENCHMARK_MIP_COUNT);
+
+    QBENCHMARK {
+        source.convolveForGGX(output, false);
+    }
+}
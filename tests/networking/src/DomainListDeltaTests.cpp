@@ -0,0 +1,158 @@
+//
+//  DomainListDeltaTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainListDeltaTests.h"
+
+#include <DomainListDelta.h>
+
+QTEST_MAIN(DomainListDeltaTests)
+
+namespace {
+
+using NodeRevisions = QHash<QUuid, quint64>;
+
+// what the node ends up with, and what went over the wire to get there
+struct Client {
+    DomainListDeltaReceiver receiver;
+    NodeRevisions nodes;
+    int entriesReceived { 0 };
+};
+
+// One list from the domain-server to the client, the way DomainServer and NodeList exchange it.
+// With deliver false the list is lost on the way.
+quint32 exchangeList(DomainListDeltaSender& sender, Client& client, const NodeRevisions& domainNodes, bool deliver = true) {
+    sender.setAcknowledgedVersion(client.receiver.getVersion());
+
+    sender.beginList();
+    NodeRevisions added;
+    for (auto it = domainNodes.begin(); it != domainNodes.end(); ++it) {
+        if (sender.addNode(it.key(), it.value())) {
+            added[it.key()] = it.value();
+        }
+    }
+    auto removed = sender.endList();
+
+    if (deliver) {
+        client.receiver.beginPacket(sender.getListVersion(), sender.getBaseVersion(), (quint32)(added.size() + removed.size()));
+        for (auto it = added.begin(); it != added.end(); ++it) {
+            client.nodes[it.key()] = it.value();
+            client.receiver.entryRead();
+        }
+        for (const auto& nodeID : removed) {
+            client.nodes.remove(nodeID);
+            client.receiver.entryRead();
+        }
+        client.receiver.endPacket();
+        client.entriesReceived = added.size() + (int)removed.size();
+    }
+    return sender.getBaseVersion();
+}
+
+}
+
+void DomainListDeltaTests::sendsOnlyChanges() {
+    DomainListDeltaSender sender;
+    Client client;
+    NodeRevisions domainNodes { { QUuid::createUuid(), 1 }, { QUuid::createUuid(), 2 }, { QUuid::createUuid(), 3 } };
+
+    QCOMPARE(exchangeList(sender, client, domainNodes), (quint32)0);
+    QCOMPARE(client.entriesReceived, 3);
+    QCOMPARE(client.nodes, domainNodes);
+
+    // nothing changed, nothing sent
+    QVERIFY(exchangeList(sender, client, domainNodes) != 0);
+    QCOMPARE(client.entriesReceived, 0);
+
+    // one changed, one left
+    auto changedID = domainNodes.begin().key();
+    domainNodes[changedID] = 4;
+    domainNodes.remove((++domainNodes.begin()).key());
+    QVERIFY(exchangeList(sender, client, domainNodes) != 0);
+    QCOMPARE(client.entriesReceived, 2);
+    QCOMPARE(client.nodes, domainNodes);
+}
+
+void DomainListDeltaTests::resendsNodeDroppedByClient() {
+    DomainListDeltaSender sender;
+    Client client;
+    NodeRevisions domainNodes { { QUuid::createUuid(), 1 }, { QUuid::createUuid(), 2 } };
+
+    exchangeList(sender, client, domainNodes);
+    exchangeList(sender, client, domainNodes);
+    QCOMPARE(client.nodes, domainNodes);
+
+    // the client drops a node on its own (it went silent), the domain-server still has it unchanged
+    auto droppedID = domainNodes.begin().key();
+    client.nodes.remove(droppedID);
+    client.receiver.nodeDroppedLocally();
+    QCOMPARE(client.receiver.getVersion(), (quint32)0);
+
+    // it comes back with the next list
+    QCOMPARE(exchangeList(sender, client, domainNodes), (quint32)0);
+    QVERIFY(client.nodes.contains(droppedID));
+    QCOMPARE(client.nodes, domainNodes);
+
+    // and we're back to sending changes only
+    QVERIFY(exchangeList(sender, client, domainNodes) != 0);
+    QCOMPARE(client.entriesReceived, 0);
+}
+
+void DomainListDeltaTests::sendsFullListPeriodically() {
+    DomainListDeltaSender sender;
+    Client client;
+    NodeRevisions domainNodes { { QUuid::createUuid(), 1 } };
+
+    // even if the client never says it dropped something, everything is sent again within the interval
+    int fullLists = 0;
+    for (quint32 i = 0; i < 2 * DomainListDeltaSender::FULL_LIST_INTERVAL; ++i) {
+        if (exchangeList(sender, client, domainNodes) == 0) {
+            ++fullLists;
+            QCOMPARE(client.entriesReceived, 1);
+        } else {
+            QCOMPARE(client.entriesReceived, 0);
+        }
+    }
+    QVERIFY(fullLists >= 2);
+    QVERIFY(fullLists <= 3);
+}
+
+void DomainListDeltaTests::resendsAfterLostPacket() {
+    DomainListDeltaSender sender;
+    Client client;
+    NodeRevisions domainNodes { { QUuid::createUuid(), 1 } };
+
+    exchangeList(sender, client, domainNodes);
+
+    // a new node comes in with a list the client never gets
+    auto addedID = QUuid::createUuid();
+    domainNodes[addedID] = 2;
+    exchangeList(sender, client, domainNodes, false);
+    QVERIFY(!client.nodes.contains(addedID));
+
+    // the client still acknowledges the list before, so it gets everything
+    QCOMPARE(exchangeList(sender, client, domainNodes), (quint32)0);
+    QCOMPARE(client.nodes, domainNodes);
+
+    // a list split over packets only counts once all of its entries are in
+    DomainListDeltaReceiver receiver;
+    receiver.beginPacket(5, 0, 2);
+    receiver.entryRead();
+    receiver.endPacket();
+    QCOMPARE(receiver.getVersion(), (quint32)0);
+    receiver.beginPacket(5, 0, 2);
+    receiver.entryRead();
+    receiver.endPacket();
+    QCOMPARE(receiver.getVersion(), (quint32)5);
+
+    // changes on top of a list we don't have are not acknowledged
+    receiver.beginPacket(7, 6, 0);
+    receiver.endPacket();
+    QCOMPARE(receiver.getVersion(), (quint32)5);
+}
@@ -0,0 +1,25 @@
+//
+//  DomainListDeltaTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainListDeltaTests_h
+#define hifi_DomainListDeltaTests_h
+
+#include <QtTest/QtTest>
+
+class DomainListDeltaTests : public QObject {
+    Q_OBJECT
+private slots:
+    void sendsOnlyChanges();
+    void resendsNodeDroppedByClient();
+    void sendsFullListPeriodically();
+    void resendsAfterLostPacket();
+};
+
+#endif // hifi_DomainListDeltaTests_h
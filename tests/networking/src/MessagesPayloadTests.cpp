@@ -0,0 +1,79 @@
+//
+//  MessagesPayloadTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesPayloadTests.h"
+
+#include <MessagesClient.h>
+#include <ReceivedMessage.h>
+
+QTEST_MAIN(MessagesPayloadTests)
+
+namespace {
+
+QSharedPointer<ReceivedMessage> makeMessage(const QByteArray& data) {
+    return QSharedPointer<ReceivedMessage>::create(data, PacketType::MessagesData, 0, HifiSockAddr());
+}
+
+}
+
+void MessagesPayloadTests::readsEncodedPayload() {
+    auto senderID = QUuid::createUuid();
+    auto message = makeMessage(MessagesClient::encodeMessagesPayload("channel", true, "content", senderID));
+
+    QString channel;
+    bool isText { false };
+    QByteArray content;
+    QVERIFY(MessagesClient::readMessagesPayload(*message, channel, isText, content));
+    QCOMPARE(channel, QString("channel"));
+    QVERIFY(isText);
+    QCOMPARE(content, QByteArray("content"));
+    QCOMPARE(message->getBytesLeftToRead(), (qint64)NUM_BYTES_RFC4122_UUID);
+}
+
+void MessagesPayloadTests::rejectsTruncatedPayload() {
+    auto payload = MessagesClient::encodeMessagesPayload("channel", false, QByteArray(64, 'x'), QUuid());
+
+    // cut off inside the content, and inside the fixed size fields
+    for (int size : { 0, 1, 3, (int)sizeof(quint16) + 7 + 2, payload.size() - NUM_BYTES_RFC4122_UUID - 1 }) {
+        auto message = makeMessage(payload.left(size));
+        QString channel;
+        bool isText;
+        QByteArray content;
+        QVERIFY2(!MessagesClient::readMessagesPayload(*message, channel, isText, content), qPrintable(QString::number(size)));
+    }
+}
+
+void MessagesPayloadTests::rejectsOversizedChannelLength() {
+    QByteArray payload;
+    quint16 channelLength = 0xFFFF;
+    payload.append(reinterpret_cast<const char*>(&channelLength), sizeof(channelLength));
+    payload.append("channel");
+
+    auto message = makeMessage(payload);
+    QString channel;
+    bool isText;
+    QByteArray content;
+    QVERIFY(!MessagesClient::readMessagesPayload(*message, channel, isText, content));
+}
+
+void MessagesPayloadTests::rejectsOversizedContentLength() {
+    auto payload = MessagesClient::encodeMessagesPayload("channel", false, "content", QUuid());
+
+    // the content length follows the channel length, the channel and the isText flag
+    quint32 contentLength = 0x7FFFFFFF;
+    int contentLengthOffset = sizeof(quint16) + 7 + sizeof(bool);
+    memcpy(payload.data() + contentLengthOffset, &contentLength, sizeof(contentLength));
+
+    auto message = makeMessage(payload);
+    QString channel;
+    bool isText;
+    QByteArray content;
+    QVERIFY(!MessagesClient::readMessagesPayload(*message, channel, isText, content));
+}
@@ -0,0 +1,25 @@
+//
+//  MessagesPayloadTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesPayloadTests_h
+#define hifi_MessagesPayloadTests_h
+
+#include <QtTest/QtTest>
+
+class MessagesPayloadTests : public QObject {
+    Q_OBJECT
+private slots:
+    void readsEncodedPayload();
+    void rejectsTruncatedPayload();
+    void rejectsOversizedChannelLength();
+    void rejectsOversizedContentLength();
+};
+
+#endif // hifi_MessagesPayloadTests_h
@@ -0,0 +1,170 @@
+//
+//  DiffTraversalTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DiffTraversalTests.h"
+
+#include <thread>
+#include <unordered_map>
+
+#include <DiffTraversal.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <ShapeEntityItem.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(DiffTraversalTests)
+
+const int NUM_GRANDCHILDREN = NUMBER_OF_CHILDREN * NUMBER_OF_CHILDREN;
+
+// a root with every child and grandchild, and one box in each grandchild
+class TestTree {
+public:
+    TestTree() {
+        tree = std::make_shared<EntityTree>();
+        tree->createRootElement();
+        root = tree->getRoot();
+        for (int i = 0; i < NUMBER_OF_CHILDREN; ++i) {
+            auto child = std::static_pointer_cast<EntityTreeElement>(root->addChildAtIndex(i));
+            for (int j = 0; j < NUMBER_OF_CHILDREN; ++j) {
+                auto grandchild = std::static_pointer_cast<EntityTreeElement>(child->addChildAtIndex(j));
+                auto entity = ShapeEntityItem::boxFactory(EntityItemID(QUuid::createUuid()), EntityItemProperties());
+                grandchild->addEntityItem(entity);
+            }
+        }
+    }
+
+    ~TestTree() {
+        // entities hold on to their elements
+        for (int i = 0; i < NUMBER_OF_CHILDREN; ++i) {
+            auto child = root->getChildAtIndex(i);
+            for (int j = 0; child && j < NUMBER_OF_CHILDREN; ++j) {
+                auto grandchild = child->getChildAtIndex(j);
+                if (grandchild) {
+                    grandchild->cleanupEntities();
+                }
+            }
+        }
+    }
+
+    EntityTreePointer tree;
+    EntityTreeElementPointer root;
+};
+
+// a client of the traversal that "sends" whatever it doesn't know yet, the way EntityTreeSendThread does
+class TestSender {
+public:
+    DiffTraversal::Type traverse(const EntityTreeElementPointer& root) {
+        // let the clock move on, so that anything changed since the last pass is newer than it
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+        sent.clear();
+        DiffTraversal::View view;
+        DiffTraversal::Type type = traversal.prepareNewTraversal(view, root);
+        uint64_t startOfCompletedTraversal = traversal.getStartOfCompletedTraversal();
+        uint64_t now = traversal.getCurrentView().startTime;
+        traversal.setScanCallback([&](DiffTraversal::VisibleElement& next) {
+            if (type != DiffTraversal::First && next.element->getLastChangedContent() <= startOfCompletedTraversal) {
+                // we only got here because something below this element changed
+                next.complete = false;
+                return;
+            }
+            next.element->forEachEntity([&](EntityItemPointer entity) {
+                auto knownTimestamp = knownState.find(entity.get());
+                if (knownTimestamp == knownState.end() || entity->getLastEdited() > knownTimestamp->second) {
+                    sent.push_back(entity);
+                    knownState[entity.get()] = now;
+                }
+            });
+        });
+        const uint64_t TIME_BUDGET = 10 * USECS_PER_SECOND;
+        traversal.traverse(TIME_BUDGET);
+        return type;
+    }
+
+    DiffTraversal traversal;
+    std::unordered_map<EntityItem*, uint64_t> knownState;
+    std::vector<EntityItemPointer> sent;
+};
+
+// what EntityTree does to an element and its ancestors when an entity in it is edited
+static void editEntity(const EntityItemPointer& entity, const std::vector<EntityTreeElementPointer>& path) {
+    entity->setLastEdited(usecTimestampNow());
+    path.back()->bumpChangedContent();
+    for (auto& element : path) {
+        element->markWithChangedTime();
+    }
+}
+
+void DiffTraversalTests::testRepeatSkipsCompleteSubtrees() {
+    TestTree testTree;
+    TestSender sender;
+
+    QCOMPARE(sender.traverse(testTree.root), DiffTraversal::First);
+    QVERIFY(sender.traversal.finished());
+    QCOMPARE((int)sender.sent.size(), NUM_GRANDCHILDREN);
+    QCOMPARE(sender.traversal.getNumSkippedElements(), (uint32_t)0);
+
+    // nothing changed: every child of the root is complete and skipped along with its subtree
+    QCOMPARE(sender.traverse(testTree.root), DiffTraversal::Repeat);
+    QVERIFY(sender.traversal.finished());
+    QVERIFY(sender.sent.empty());
+    QCOMPARE(sender.traversal.getNumSkippedElements(), (uint32_t)NUMBER_OF_CHILDREN);
+    QCOMPARE(sender.traversal.getNumVisitedElements(), (uint32_t)0);
+}
+
+void DiffTraversalTests::testEditInSkippedSubtreeIsResent() {
+    TestTree testTree;
+    TestSender sender;
+    sender.traverse(testTree.root);
+    sender.traverse(testTree.root);
+    QVERIFY(sender.sent.empty());
+
+    // edit an entity that the last pass skipped over
+    auto child = testTree.root->getChildAtIndex(3);
+    auto grandchild = child->getChildAtIndex(5);
+    EntityItemPointer entity;
+    grandchild->forEachEntity([&](EntityItemPointer e) { entity = e; });
+    QVERIFY(entity);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    editEntity(entity, { testTree.root, child, grandchild });
+
+    QCOMPARE(sender.traverse(testTree.root), DiffTraversal::Repeat);
+    QCOMPARE((int)sender.sent.size(), 1);
+    QCOMPARE(sender.sent[0], entity);
+    // the rest of the tree is still skipped: the other children of the root and the other children of the edited one
+    QCOMPARE(sender.traversal.getNumSkippedElements(), (uint32_t)(2 * (NUMBER_OF_CHILDREN - 1)));
+
+    // once re-sent, the edited subtree is complete again
+    sender.traverse(testTree.root);
+    QVERIFY(sender.sent.empty());
+    QCOMPARE(sender.traversal.getNumSkippedElements(), (uint32_t)NUMBER_OF_CHILDREN);
+}
+
+void DiffTraversalTests::testDeletedElementsAreSwept() {
+    TestTree testTree;
+    TestSender sender;
+    sender.traverse(testTree.root);
+    const size_t NUM_ELEMENTS = 1 + NUMBER_OF_CHILDREN + NUM_GRANDCHILDREN;
+    QCOMPARE(sender.traversal.getNumCompleteSubtrees(), NUM_ELEMENTS);
+
+    // delete a child of the root and its subtree
+    const int DELETED_CHILD = 2;
+    auto child = testTree.root->getChildAtIndex(DELETED_CHILD);
+    for (int j = 0; j < NUMBER_OF_CHILDREN; ++j) {
+        child->getChildAtIndex(j)->cleanupEntities();
+    }
+    child.reset();
+    testTree.root->deleteChildAtIndex(DELETED_CHILD);
+
+    sender.traverse(testTree.root);
+    QVERIFY(sender.sent.empty());
+    // the entries of the deleted elements are gone, and so is the root's, since a Repeat pass doesn't scan it
+    QCOMPARE(sender.traversal.getNumCompleteSubtrees(), NUM_ELEMENTS - (1 + NUMBER_OF_CHILDREN) - 1);
+}
@@ -0,0 +1,224 @@
+//
+//  EncodedEntityDataTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EncodedEntityDataTests.h"
+
+#include <thread>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityItemProperties.h>
+#include <EntityTreeElement.h>
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <OctreePacketData.h>
+#include <ShapeEntityItem.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EncodedEntityDataTests)
+
+static EntityItemPointer makeEntity() {
+    EntityItemProperties properties;
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    properties.setDynamic(true);
+    return ShapeEntityItem::boxFactory(EntityItemID(QUuid::createUuid()), properties);
+}
+
+// extra carries the properties still owed to the client by a partial send, and gets those that didn't fit this time
+static QByteArray encode(const EntityItemPointer& entity,
+                         EntityTreeElementExtraEncodeDataPointer extra = std::make_shared<EntityTreeElementExtraEncodeData>(),
+                         int packetSize = MAX_OCTREE_PACKET_DATA_SIZE) {
+    OctreePacketData packetData(false, packetSize);
+    EncodeBitstreamParams params;
+    entity->appendEntityData(&packetData, params, extra);
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+// what a client would get from a server without the cache
+static QByteArray encodeUncached(const EntityItemPointer& entity,
+                                 EntityTreeElementExtraEncodeDataPointer extra = std::make_shared<EntityTreeElementExtraEncodeData>(),
+                                 int packetSize = MAX_OCTREE_PACKET_DATA_SIZE) {
+    EntityItem::setEncodedDataCacheEnabled(false);
+    QByteArray result = encode(entity, extra, packetSize);
+    EntityItem::setEncodedDataCacheEnabled(true);
+    return result;
+}
+
+static EntityTreeElementExtraEncodeDataPointer continuePartialSend(const EntityItemPointer& entity,
+                                                                   const EntityPropertyFlags& properties) {
+    auto extra = std::make_shared<EntityTreeElementExtraEncodeData>();
+    extra->entities.insert(entity->getEntityItemID(), properties);
+    return extra;
+}
+
+// a client's copy of the entity, as it was before any of the data is read
+static EntityItemPointer makeReceiver() {
+    auto receiver = ShapeEntityItem::boxFactory(EntityItemID(QUuid::createUuid()), EntityItemProperties());
+    receiver->setLastEdited(0);
+    return receiver;
+}
+
+static void decode(const EntityItemPointer& receiver, const QByteArray& data) {
+    ReadBitstreamToTreeParams args;
+    int bytesRead = receiver->readEntityDataFromBuffer((const unsigned char*)data.constData(), data.size(), args);
+    QCOMPARE(bytesRead, data.size());
+}
+
+static void compareProperties(const EntityItemPointer& receiver, const EntityItemPointer& entity) {
+    QCOMPARE(receiver->getID(), entity->getID());
+    QCOMPARE(receiver->getLocalPosition(), entity->getLocalPosition());
+    QCOMPARE(receiver->getName(), entity->getName());
+    QCOMPARE(receiver->getUserData(), entity->getUserData());
+    QCOMPARE(receiver->getDynamic(), entity->getDynamic());
+}
+
+void EncodedEntityDataTests::initTestCase() {
+    // decoding looks up the session to see who owns the simulation
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent, INVALID_PORT);
+}
+
+void EncodedEntityDataTests::cleanup() {
+    EntityItem::setEncodedDataCacheEnabled(false);
+    EntityItem::resetEncodedDataCacheStats();
+}
+
+void EncodedEntityDataTests::testEditReencodes() {
+    EntityItem::setEncodedDataCacheEnabled(true);
+    auto entity = makeEntity();
+
+    QByteArray first = encode(entity);
+    QVERIFY(!first.isEmpty());
+    quint64 hits = EntityItem::getEncodedDataCacheHits();
+    QCOMPARE(encode(entity), first);
+    QCOMPARE(EntityItem::getEncodedDataCacheHits(), hits + 1);
+
+    EntityItemProperties properties;
+    properties.setPosition(glm::vec3(4.0f, 5.0f, 6.0f));
+    entity->setProperties(properties);
+    entity->setLastEdited(usecTimestampNow());
+    QByteArray edited = encode(entity);
+    QVERIFY(edited != first);
+    QCOMPARE(edited, encodeUncached(entity));
+}
+
+void EncodedEntityDataTests::testServerVelocityChangeReencodes() {
+    EntityItem::setEncodedDataCacheEnabled(true);
+    auto entity = makeEntity();
+    QByteArray first = encode(entity);
+
+    // the simulation changes the derivatives without an edit, the timestamps don't move
+    quint64 lastEdited = entity->getLastEdited();
+    entity->setVelocity(glm::vec3(1.0f, 0.0f, 0.0f));
+    QCOMPARE(entity->getLastEdited(), lastEdited);
+    QByteArray moving = encode(entity);
+    QVERIFY(moving != first);
+    QCOMPARE(moving, encodeUncached(entity));
+
+    entity->setAngularVelocity(glm::vec3(0.0f, 1.0f, 0.0f));
+    QByteArray spinning = encode(entity);
+    QVERIFY(spinning != moving);
+    QCOMPARE(spinning, encodeUncached(entity));
+
+    entity->setAcceleration(glm::vec3(0.0f, -1.0f, 0.0f));
+    QByteArray accelerating = encode(entity);
+    QVERIFY(accelerating != spinning);
+    QCOMPARE(accelerating, encodeUncached(entity));
+}
+
+void EncodedEntityDataTests::testStopOwnerlessEntityReencodes() {
+    EntityItem::setEncodedDataCacheEnabled(true);
+    auto entity = makeEntity();
+    entity->setVelocity(glm::vec3(1.0f, 0.0f, 0.0f));
+    entity->setAngularVelocity(glm::vec3(0.0f, 1.0f, 0.0f));
+    entity->setAcceleration(glm::vec3(0.0f, -1.0f, 0.0f));
+    QByteArray moving = encode(entity);
+
+    // as SimpleEntitySimulation::stopOwnerlessEntities() does
+    entity->setVelocity(Vectors::ZERO);
+    entity->setAngularVelocity(Vectors::ZERO);
+    entity->setAcceleration(Vectors::ZERO);
+    entity->markAsChangedOnServer();
+
+    QByteArray stopped = encode(entity);
+    QVERIFY(stopped != moving);
+    QCOMPARE(stopped, encodeUncached(entity));
+
+    // marking alone drops the shared encoding too
+    quint64 misses = EntityItem::getEncodedDataCacheMisses();
+    entity->markAsChangedOnServer();
+    QCOMPARE(encode(entity), stopped);
+    QCOMPARE(EntityItem::getEncodedDataCacheMisses(), misses + 1);
+}
+
+void EncodedEntityDataTests::testSpliceRoundTrip() {
+    EntityItem::setEncodedDataCacheEnabled(true);
+    auto entity = makeEntity();
+    auto receiver = makeReceiver();
+    decode(receiver, encode(entity));
+    compareProperties(receiver, entity);
+
+    // change some of the properties, and continue a partial send that only owes the client those
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EntityItemProperties properties;
+    properties.setPosition(glm::vec3(4.0f, 5.0f, 6.0f));
+    properties.setName("spliced");
+    entity->setProperties(properties);
+    entity->setLastEdited(usecTimestampNow());
+    EntityPropertyFlags changed;
+    changed += PROP_POSITION;
+    changed += PROP_NAME;
+
+    quint64 misses = EntityItem::getEncodedDataCacheMisses();
+    QByteArray spliced = encode(entity, continuePartialSend(entity, changed));
+    QCOMPARE(EntityItem::getEncodedDataCacheMisses(), misses + 1);
+    QVERIFY(spliced.size() < encode(entity).size());
+    QCOMPARE(spliced, encodeUncached(entity, continuePartialSend(entity, changed)));
+
+    // the client ends up where a full re-encode would have taken it
+    decode(receiver, spliced);
+    auto fullReceiver = makeReceiver();
+    decode(fullReceiver, encodeUncached(entity));
+    compareProperties(receiver, entity);
+    compareProperties(fullReceiver, entity);
+}
+
+void EncodedEntityDataTests::testSpliceWhenPacketIsFull() {
+    EntityItem::setEncodedDataCacheEnabled(true);
+    auto entity = makeEntity();
+    const int USER_DATA_SIZE = 300;
+    EntityItemProperties properties;
+    properties.setUserData(QString(USER_DATA_SIZE, 'x'));
+    entity->setProperties(properties);
+    entity->setLastEdited(usecTimestampNow());
+
+    // a packet with room for everything but the user data
+    int packetSize = encode(entity).size() - USER_DATA_SIZE / 2;
+    auto extra = std::make_shared<EntityTreeElementExtraEncodeData>();
+    auto uncachedExtra = std::make_shared<EntityTreeElementExtraEncodeData>();
+    QByteArray first = encode(entity, extra, packetSize);
+    QCOMPARE(first, encodeUncached(entity, uncachedExtra, packetSize));
+    QVERIFY(extra->entities.contains(entity->getEntityItemID()));
+    EntityPropertyFlags didntFit = extra->entities.value(entity->getEntityItemID());
+    QVERIFY(didntFit.getHasProperty(PROP_USER_DATA));
+    QVERIFY(!didntFit.getHasProperty(PROP_POSITION));
+    QVERIFY(didntFit == uncachedExtra->entities.value(entity->getEntityItemID()));
+
+    // the next packet carries the rest
+    QByteArray rest = encode(entity, extra);
+    QCOMPARE(rest, encodeUncached(entity, uncachedExtra));
+
+    auto receiver = makeReceiver();
+    decode(receiver, first);
+    decode(receiver, rest);
+    compareProperties(receiver, entity);
+}
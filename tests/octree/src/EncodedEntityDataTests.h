@@ -0,0 +1,29 @@
+//
+//  EncodedEntityDataTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EncodedEntityDataTests_h
+#define hifi_EncodedEntityDataTests_h
+
+#include <QtTest/QtTest>
+
+class EncodedEntityDataTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void testEditReencodes();
+    void testServerVelocityChangeReencodes();
+    void testStopOwnerlessEntityReencodes();
+    void testSpliceRoundTrip();
+    void testSpliceWhenPacketIsFull();
+};
+
+#endif // hifi_EncodedEntityDataTests_h
@@ -0,0 +1,123 @@
+//
+//  OctreeCompressionDictionaryTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeCompressionDictionaryTests.h"
+
+#include <OctreeCompressionDictionary.h>
+
+QTEST_MAIN(OctreeCompressionDictionaryTests)
+
+// sections that share most of their bytes, the way encoded entities of one domain do
+static std::vector<QByteArray> makeSamples(const QByteArray& common, int count) {
+    std::vector<QByteArray> samples;
+    for (int i = 0; i < count; i++) {
+        QByteArray sample;
+        sample += "entity-" + QByteArray::number(i * 7919) + ";";
+        sample += common;
+        sample += "position=" + QByteArray::number(i * 0.25) + "," + QByteArray::number(i * 1.5) + ";";
+        sample += common;
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+static const QByteArray COMMON_PROPERTIES = "type=Box;color=255,128,0;dimensions=1,1,1;collisionless=false;dynamic=true;"
+    "modelURL=http://content.example.com/models/chair.fbx;script=;userData={\"grabbable\":true};";
+
+static QByteArray compress(const OctreeCompressionDictionary& dictionary, const QByteArray& data) {
+    return dictionary.compress((const unsigned char*)data.constData(), data.size(), 9);
+}
+
+static QByteArray uncompress(const QByteArray& data) {
+    return OctreeCompressionDictionary::uncompress((const unsigned char*)data.constData(), data.size());
+}
+
+void OctreeCompressionDictionaryTests::testTrain() {
+    const int SIZE = 1024;
+    auto dictionary = OctreeCompressionDictionary::train(makeSamples(COMMON_PROPERTIES, 32), SIZE);
+    QVERIFY(dictionary != nullptr);
+    QVERIFY(dictionary->getData().size() > 0);
+    QVERIFY(dictionary->getData().size() <= SIZE);
+
+    // the bytes every sample has in common make it into the dictionary
+    QVERIFY(dictionary->getData().contains("chair.fbx"));
+
+    // the same dictionary travels between servers and clients
+    auto received = OctreeCompressionDictionary::fromByteArray(dictionary->toByteArray());
+    QVERIFY(received != nullptr);
+    QCOMPARE(received->getID(), dictionary->getID());
+    QCOMPARE(received->getData(), dictionary->getData());
+
+    // too few samples to tell what is common
+    QVERIFY(OctreeCompressionDictionary::train(makeSamples(COMMON_PROPERTIES, 2), SIZE) == nullptr);
+    QVERIFY(OctreeCompressionDictionary::train(makeSamples(COMMON_PROPERTIES, 32), 0) == nullptr);
+}
+
+void OctreeCompressionDictionaryTests::testRoundTrip() {
+    auto samples = makeSamples(COMMON_PROPERTIES, 32);
+    auto dictionary = OctreeCompressionDictionary::train(samples);
+    QVERIFY(dictionary != nullptr);
+    OctreeCompressionDictionary::registerDictionary(dictionary);
+
+    QByteArray section = makeSamples(COMMON_PROPERTIES, 33).back();
+    QByteArray compressed = compress(*dictionary, section);
+    QVERIFY(!compressed.isEmpty());
+    QVERIFY(OctreeCompressionDictionary::usesDictionary((const unsigned char*)compressed.constData(), compressed.size()));
+    QVERIFY(compressed.size() < qCompress(section, 9).size());
+    QCOMPARE(uncompress(compressed), section);
+
+    // sections compressed without a dictionary still decode
+    QByteArray plain = qCompress(section, 9);
+    QVERIFY(!OctreeCompressionDictionary::usesDictionary((const unsigned char*)plain.constData(), plain.size()));
+    QCOMPARE(uncompress(plain), section);
+}
+
+void OctreeCompressionDictionaryTests::testUnknownDictionary() {
+    // a dictionary the receiver never got
+    auto dictionary = std::make_shared<OctreeCompressionDictionary>(QByteArray("never registered;") + COMMON_PROPERTIES);
+    QVERIFY(OctreeCompressionDictionary::find(dictionary->getID()) == nullptr);
+
+    QByteArray section = makeSamples(COMMON_PROPERTIES, 1).front();
+    QByteArray compressed = compress(*dictionary, section);
+    QVERIFY(!compressed.isEmpty());
+    QVERIFY(uncompress(compressed).isEmpty());
+
+    // one that was evicted by newer ones
+    OctreeCompressionDictionary::registerDictionary(dictionary);
+    QCOMPARE(uncompress(compressed), section);
+    for (int i = 0; i < OctreeCompressionDictionary::MAX_REGISTERED_DICTIONARIES; i++) {
+        OctreeCompressionDictionary::registerDictionary(
+            std::make_shared<OctreeCompressionDictionary>("evicting " + QByteArray::number(i) + COMMON_PROPERTIES));
+    }
+    QVERIFY(OctreeCompressionDictionary::find(dictionary->getID()) == nullptr);
+    QVERIFY(uncompress(compressed).isEmpty());
+    QCOMPARE(OctreeCompressionDictionary::getRegisteredCount(), OctreeCompressionDictionary::MAX_REGISTERED_DICTIONARIES);
+}
+
+void OctreeCompressionDictionaryTests::testMismatchedDictionary() {
+    auto dictionary = std::make_shared<OctreeCompressionDictionary>(QByteArray("sender's;") + COMMON_PROPERTIES);
+    QByteArray section = makeSamples(COMMON_PROPERTIES, 1).front();
+    QByteArray compressed = compress(*dictionary, section);
+
+    // the receiver has other bytes under the ID the stream asks for, they must not decode into garbage
+    QByteArray received = dictionary->toByteArray();
+    received[received.size() - 1] = received[received.size() - 1] ^ 0x01;
+    QVERIFY(OctreeCompressionDictionary::fromByteArray(received) == nullptr);
+    QVERIFY(uncompress(compressed).isEmpty());
+
+    // a section that claims more than it holds, or has been cut short
+    OctreeCompressionDictionary::registerDictionary(dictionary);
+    QCOMPARE(uncompress(compressed), section);
+    QByteArray truncated = compressed.left(compressed.size() / 2);
+    QVERIFY(uncompress(truncated).isEmpty());
+    QByteArray wrongSize = compressed;
+    wrongSize[3] = wrongSize[3] + 1;
+    QVERIFY(uncompress(wrongSize).isEmpty());
+}
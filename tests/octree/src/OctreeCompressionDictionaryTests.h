@@ -0,0 +1,26 @@
+//
+//  OctreeCompressionDictionaryTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeCompressionDictionaryTests_h
+#define hifi_OctreeCompressionDictionaryTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeCompressionDictionaryTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testTrain();
+    void testRoundTrip();
+    void testUnknownDictionary();
+    void testMismatchedDictionary();
+};
+
+#endif // hifi_OctreeCompressionDictionaryTests_h
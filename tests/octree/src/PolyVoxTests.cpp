@@ -0,0 +1,99 @@
+//
+//  PolyVoxTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PolyVoxTests.h"
+
+#include <PolyVoxEntityItem.h>
+
+QTEST_MAIN(PolyVoxTests)
+
+static QByteArray uncompressVoxelData(const QByteArray& voxelData, ivec3& size) {
+    QDataStream reader(voxelData);
+    quint16 voxelXSize, voxelYSize, voxelZSize;
+    QByteArray compressedData;
+    reader >> voxelXSize >> voxelYSize >> voxelZSize >> compressedData;
+    size = ivec3(voxelXSize, voxelYSize, voxelZSize);
+    return qUncompress(compressedData);
+}
+
+void PolyVoxTests::testApplyVoxelDataDelta() {
+    const ivec3 VOLUME_SIZE { 8, 4, 6 };
+    QByteArray voxelData = PolyVoxEntityItem::makeEmptyVoxelData(VOLUME_SIZE.x, VOLUME_SIZE.y, VOLUME_SIZE.z);
+    QVERIFY(!PolyVoxEntityItem::isVoxelDataDelta(voxelData));
+
+    const ivec3 LOW { 1, 2, 3 };
+    const ivec3 SIZE { 3, 2, 2 };
+    QByteArray region(SIZE.x * SIZE.y * SIZE.z, '\0');
+    for (int i = 0; i < region.size(); i++) {
+        region[i] = (char)(i + 1);
+    }
+    QByteArray delta = PolyVoxEntityItem::makeVoxelDataDelta(LOW, SIZE, region);
+    QVERIFY(PolyVoxEntityItem::isVoxelDataDelta(delta));
+    QVERIFY(delta.size() < voxelData.size() + region.size());
+
+    QByteArray newVoxelData;
+    QVERIFY(PolyVoxEntityItem::applyVoxelDataDelta(voxelData, delta, newVoxelData));
+
+    ivec3 size;
+    QByteArray voxels = uncompressVoxelData(newVoxelData, size);
+    QCOMPARE(size, VOLUME_SIZE);
+    QCOMPARE(voxels.size(), VOLUME_SIZE.x * VOLUME_SIZE.y * VOLUME_SIZE.z);
+
+    // voxels are stored with x varying fastest
+    int regionIndex = 0;
+    for (int z = 0; z < VOLUME_SIZE.z; z++) {
+        for (int y = 0; y < VOLUME_SIZE.y; y++) {
+            for (int x = 0; x < VOLUME_SIZE.x; x++) {
+                ivec3 v { x, y, z };
+                bool inRegion = glm::all(glm::greaterThanEqual(v, LOW)) && glm::all(glm::lessThan(v, LOW + SIZE));
+                char expected = inRegion ? region[regionIndex++] : '\0';
+                QCOMPARE(voxels[(z * VOLUME_SIZE.y + y) * VOLUME_SIZE.x + x], expected);
+            }
+        }
+    }
+    QCOMPARE(regionIndex, region.size());
+}
+
+void PolyVoxTests::testRejectVoxelDataDelta() {
+    QByteArray voxelData = PolyVoxEntityItem::makeEmptyVoxelData(4, 4, 4);
+    QByteArray newVoxelData;
+
+    // a box that runs off the edge of the volume
+    QByteArray outside = PolyVoxEntityItem::makeVoxelDataDelta(ivec3(2, 0, 0), ivec3(3, 1, 1), QByteArray(3, '\1'));
+    QVERIFY(!PolyVoxEntityItem::applyVoxelDataDelta(voxelData, outside, newVoxelData));
+
+    // voxels that don't match the size of the box
+    QByteArray shortData = PolyVoxEntityItem::makeVoxelDataDelta(ivec3(0), ivec3(2, 2, 2), QByteArray(7, '\1'));
+    QVERIFY(!PolyVoxEntityItem::applyVoxelDataDelta(voxelData, shortData, newVoxelData));
+
+    // a delta can't be applied to something that isn't a volume
+    QByteArray valid = PolyVoxEntityItem::makeVoxelDataDelta(ivec3(0), ivec3(1), QByteArray(1, '\1'));
+    QVERIFY(!PolyVoxEntityItem::applyVoxelDataDelta(valid, valid, newVoxelData));
+    QVERIFY(PolyVoxEntityItem::applyVoxelDataDelta(voxelData, valid, newVoxelData));
+
+    // a volume larger than the maximum dimension
+    QByteArray tooLarge;
+    {
+        QDataStream writer(&tooLarge, QIODevice::WriteOnly);
+        writer << (quint16)65535 << (quint16)65535 << (quint16)65535 << qCompress(QByteArray(1, '\0'));
+    }
+    QVERIFY(!PolyVoxEntityItem::applyVoxelDataDelta(tooLarge, valid, newVoxelData));
+
+    // compressed data that claims to be much larger than the volume
+    QByteArray compressedData = qCompress(QByteArray(4 * 4 * 4, '\0'));
+    compressedData[0] = (char)0x7F;
+    compressedData[1] = (char)0xFF;
+    QByteArray wrongSize;
+    {
+        QDataStream writer(&wrongSize, QIODevice::WriteOnly);
+        writer << (quint16)4 << (quint16)4 << (quint16)4 << compressedData;
+    }
+    QVERIFY(!PolyVoxEntityItem::applyVoxelDataDelta(wrongSize, valid, newVoxelData));
+}
@@ -0,0 +1,24 @@
+//
+//  PolyVoxTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PolyVoxTests_h
+#define hifi_PolyVoxTests_h
+
+#include <QtTest/QtTest>
+
+class PolyVoxTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testApplyVoxelDataDelta();
+    void testRejectVoxelDataDelta();
+};
+
+#endif // hifi_PolyVoxTests_h
@@ -0,0 +1,213 @@
+//
+//  ShapeCacheTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ShapeCacheTests.h"
+
+#include <ShapeCache.h>
+#include <ShapeFactory.h>
+
+QTEST_GUILESS_MAIN(ShapeCacheTests)
+
+static const size_t MAX_CACHE_SIZE { 1024 * 1024 * 10 };
+
+static ShapeCachePointer makeShapeCache(const QString& location) {
+    auto result = std::make_shared<ShapeCache>(location.toStdString());
+    result->initialize();
+    result->setMaxSize(MAX_CACHE_SIZE);
+    return result;
+}
+
+static ShapeInfo makeHullsInfo() {
+    ShapeInfo::PointList tetrahedron;
+    tetrahedron.push_back(glm::vec3(1.0f, 1.0f, 1.0f));
+    tetrahedron.push_back(glm::vec3(1.0f, -1.0f, -1.0f));
+    tetrahedron.push_back(glm::vec3(-1.0f, 1.0f, -1.0f));
+    tetrahedron.push_back(glm::vec3(-1.0f, -1.0f, 1.0f));
+
+    ShapeInfo::PointCollection pointCollection;
+    const int NUM_HULLS = 3;
+    for (int i = 0; i < NUM_HULLS; ++i) {
+        ShapeInfo::PointList points;
+        for (const auto& point : tetrahedron) {
+            points.push_back((float)(i + 1) * point + glm::vec3((float)i, 0.0f, 0.0f));
+        }
+        pointCollection.push_back(points);
+    }
+
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_COMPOUND, glm::vec3(4.0f));
+    info.setPointCollection(pointCollection);
+    info.setOffset(glm::vec3(0.0f, 1.0f, 0.0f));
+    return info;
+}
+
+static ShapeInfo makeMeshInfo() {
+    // a flat grid of quads in the xz-plane, centered on the origin
+    const int NUM_CELLS = 16;
+    ShapeInfo::PointList points;
+    for (int i = 0; i <= NUM_CELLS; ++i) {
+        for (int j = 0; j <= NUM_CELLS; ++j) {
+            points.push_back(glm::vec3((float)(i - NUM_CELLS / 2), 0.0f, (float)(j - NUM_CELLS / 2)));
+        }
+    }
+    ShapeInfo::PointCollection pointCollection;
+    pointCollection.push_back(points);
+
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_STATIC_MESH, glm::vec3((float)(NUM_CELLS / 2), 0.5f, (float)(NUM_CELLS / 2)));
+    info.setPointCollection(pointCollection);
+    ShapeInfo::TriangleIndices& triangles = info.getTriangleIndices();
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        for (int j = 0; j < NUM_CELLS; ++j) {
+            int32_t corner = i * (NUM_CELLS + 1) + j;
+            triangles << corner << corner + 1 << corner + NUM_CELLS + 1;
+            triangles << corner + 1 << corner + NUM_CELLS + 2 << corner + NUM_CELLS + 1;
+        }
+    }
+    return info;
+}
+
+static bool rayHits(const btCollisionShape* shape, const btVector3& from, const btVector3& to) {
+    btTransform identity;
+    identity.setIdentity();
+    btCollisionObject object;
+    object.setCollisionShape(const_cast<btCollisionShape*>(shape));
+    object.setWorldTransform(identity);
+
+    btTransform rayFrom(identity);
+    rayFrom.setOrigin(from);
+    btTransform rayTo(identity);
+    rayTo.setOrigin(to);
+    btCollisionWorld::ClosestRayResultCallback callback(from, to);
+    btCollisionWorld::rayTestSingle(rayFrom, rayTo, &object, object.getCollisionShape(), identity, callback);
+    return callback.hasHit();
+}
+
+void ShapeCacheTests::testHulls() {
+    auto cache = makeShapeCache(_testDir.filePath("hulls"));
+    ShapeInfo info = makeHullsInfo();
+    QVERIFY(cache->loadShape(info) == nullptr);
+    QCOMPARE(cache->getNumMisses(), (size_t)1);
+
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+    QVERIFY(cache->storeShape(info, shape));
+
+    // load on a fresh cache to make sure the shape was persisted
+    cache = makeShapeCache(_testDir.filePath("hulls"));
+    const btCollisionShape* cachedShape = cache->loadShape(info);
+    QVERIFY(cachedShape != nullptr);
+    QCOMPARE(cache->getNumHits(), (size_t)1);
+    QCOMPARE(cachedShape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+
+    const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+    const btCompoundShape* cachedCompound = static_cast<const btCompoundShape*>(cachedShape);
+    QCOMPARE(cachedCompound->getNumChildShapes(), compound->getNumChildShapes());
+    for (int i = 0; i < compound->getNumChildShapes(); ++i) {
+        QVERIFY(cachedCompound->getChildTransform(i).getOrigin() == compound->getChildTransform(i).getOrigin());
+
+        auto hull = static_cast<const btConvexHullShape*>(compound->getChildShape(i));
+        auto cachedHull = static_cast<const btConvexHullShape*>(cachedCompound->getChildShape(i));
+        QCOMPARE(cachedHull->getShapeType(), (int)CONVEX_HULL_SHAPE_PROXYTYPE);
+        QCOMPARE(cachedHull->getMargin(), hull->getMargin());
+        QCOMPARE(cachedHull->getNumPoints(), hull->getNumPoints());
+        for (int j = 0; j < hull->getNumPoints(); ++j) {
+            QVERIFY(cachedHull->getUnscaledPoints()[j] == hull->getUnscaledPoints()[j]);
+        }
+    }
+
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(cachedShape);
+}
+
+void ShapeCacheTests::testStaticMesh() {
+    auto cache = makeShapeCache(_testDir.filePath("mesh"));
+    ShapeInfo info = makeMeshInfo();
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+    QVERIFY(cache->storeShape(info, shape));
+
+    cache = makeShapeCache(_testDir.filePath("mesh"));
+    const btCollisionShape* cachedShape = cache->loadShape(info);
+    QVERIFY(cachedShape != nullptr);
+    QCOMPARE(cachedShape->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+    auto cachedMesh = const_cast<btBvhTriangleMeshShape*>(static_cast<const btBvhTriangleMeshShape*>(cachedShape));
+    QVERIFY(cachedMesh->getOptimizedBvh() != nullptr);
+
+    btTransform identity;
+    identity.setIdentity();
+    btVector3 minCorner, maxCorner, cachedMinCorner, cachedMaxCorner;
+    shape->getAabb(identity, minCorner, maxCorner);
+    cachedShape->getAabb(identity, cachedMinCorner, cachedMaxCorner);
+    QVERIFY(cachedMinCorner == minCorner);
+    QVERIFY(cachedMaxCorner == maxCorner);
+
+    // rays go through the deserialized BVH
+    QVERIFY(rayHits(cachedShape, btVector3(0.5f, 1.0f, 0.5f), btVector3(0.5f, -1.0f, 0.5f)));
+    QVERIFY(rayHits(cachedShape, btVector3(-7.5f, 1.0f, 7.5f), btVector3(-7.5f, -1.0f, 7.5f)));
+    QVERIFY(!rayHits(cachedShape, btVector3(9.5f, 1.0f, 0.5f), btVector3(9.5f, -1.0f, 0.5f)));
+
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(cachedShape);
+}
+
+void ShapeCacheTests::testOtherVersion() {
+    QString location = _testDir.filePath("version");
+    auto cache = makeShapeCache(location);
+    ShapeInfo info = makeHullsInfo();
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(cache->storeShape(info, shape));
+    cache.reset();
+
+    // change the version that follows the magic number
+    auto entries = QDir(location).entryInfoList({ "*.shape" }, QDir::Files);
+    QCOMPARE(entries.size(), 1);
+    QFile entry { entries[0].absoluteFilePath() };
+    QVERIFY(entry.open(QIODevice::ReadWrite));
+    entry.seek(sizeof(uint32_t));
+    uint32_t otherVersion = 0;
+    entry.write((const char*)&otherVersion, sizeof(otherVersion));
+    entry.close();
+
+    cache = makeShapeCache(location);
+    QVERIFY(cache->loadShape(info) == nullptr);
+    QCOMPARE(cache->getNumMisses(), (size_t)1);
+
+    // storing it again replaces the entry
+    QVERIFY(cache->storeShape(info, shape));
+    const btCollisionShape* cachedShape = cache->loadShape(info);
+    QVERIFY(cachedShape != nullptr);
+
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(cachedShape);
+}
+
+void ShapeCacheTests::testSameHashOtherPoints() {
+    auto cache = makeShapeCache(_testDir.filePath("collision"));
+    ShapeInfo info = makeHullsInfo();
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(cache->storeShape(info, shape));
+
+    // same url, extents and number of hulls, so the same ShapeInfo hash, but other geometry
+    ShapeInfo otherInfo = makeHullsInfo();
+    ShapeInfo::PointCollection otherPoints = otherInfo.getPointCollection();
+    otherPoints[0][0] += glm::vec3(0.0f, 0.5f, 0.0f);
+    otherInfo.setPointCollection(otherPoints);
+    QCOMPARE(otherInfo.getHash(), info.getHash());
+
+    QVERIFY(cache->loadShape(otherInfo) == nullptr);
+    QCOMPARE(cache->getNumMisses(), (size_t)1);
+
+    const btCollisionShape* cachedShape = cache->loadShape(info);
+    QVERIFY(cachedShape != nullptr);
+
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(cachedShape);
+}
@@ -0,0 +1,29 @@
+//
+//  ShapeCacheTests.h
+//  tests/physics/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ShapeCacheTests_h
+#define hifi_ShapeCacheTests_h
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+
+class ShapeCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testHulls();
+    void testStaticMesh();
+    void testOtherVersion();
+    void testSameHashOtherPoints();
+
+private:
+    QTemporaryDir _testDir;
+};
+
+#endif // hifi_ShapeCacheTests_h
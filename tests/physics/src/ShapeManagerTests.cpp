@@ -244,3 +244,92 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+void ShapeManagerTests::testRequestShape() {
+    // a single tetrahedral hull is enough to make the shape expensive to build
+    ShapeInfo::PointList tetrahedron;
+    tetrahedron.push_back(glm::vec3(1.0f, 1.0f, 1.0f));
+    tetrahedron.push_back(glm::vec3(1.0f, -1.0f, -1.0f));
+    tetrahedron.push_back(glm::vec3(-1.0f, 1.0f, -1.0f));
+    tetrahedron.push_back(glm::vec3(-1.0f, -1.0f, 1.0f));
+    ShapeInfo::PointCollection pointCollection;
+    pointCollection.push_back(tetrahedron);
+
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_COMPOUND, glm::vec3(1.0f));
+    info.setPointCollection(pointCollection);
+
+    // the request starts the build and answers nullptr until it is done
+    ShapeManager shapeManager;
+    QVERIFY(shapeManager.requestShape(info) == nullptr);
+    QVERIFY(shapeManager.isBuildingShape(info.getHash()));
+    QCOMPARE(shapeManager.getNumBuildingShapes(), 1);
+
+    // once built the shape can be claimed by its key
+    shapeManager.waitForShapeBuilds();
+    const btCollisionShape* shape = shapeManager.getShapeByKey(info.getHash());
+    QVERIFY(shape != nullptr);
+    QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(shapeManager.getNumBuildingShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shapeManager.getNumReferences(info), 1);
+
+    // later requests get the same shape right away
+    const btCollisionShape* otherShape = shapeManager.requestShape(info);
+    QCOMPARE(otherShape, shape);
+    QCOMPARE(shapeManager.getNumReferences(info), 2);
+
+    shapeManager.releaseShape(shape);
+    shapeManager.releaseShape(otherShape);
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+
+    // a shape nobody claims is collected like any other unreferenced shape
+    QVERIFY(shapeManager.requestShape(info) == nullptr);
+    shapeManager.waitForShapeBuilds();
+    QVERIFY(shapeManager.getShapeByKey(0) == nullptr);
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shapeManager.getNumReferences(info), 0);
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::testRequestManyShapes() {
+    // more builds finish at once than the garbage list holds, none of them may be lost before they are claimed
+    const int NUM_SHAPES = 300;
+    std::vector<ShapeInfo> infos(NUM_SHAPES);
+    for (int i = 0; i < NUM_SHAPES; ++i) {
+        float scale = 1.0f + 0.01f * (float)i;
+        ShapeInfo::PointList tetrahedron;
+        tetrahedron.push_back(scale * glm::vec3(1.0f, 1.0f, 1.0f));
+        tetrahedron.push_back(scale * glm::vec3(1.0f, -1.0f, -1.0f));
+        tetrahedron.push_back(scale * glm::vec3(-1.0f, 1.0f, -1.0f));
+        tetrahedron.push_back(scale * glm::vec3(-1.0f, -1.0f, 1.0f));
+        ShapeInfo::PointCollection pointCollection;
+        pointCollection.push_back(tetrahedron);
+        infos[i].setParams(SHAPE_TYPE_COMPOUND, glm::vec3(scale));
+        infos[i].setPointCollection(pointCollection);
+    }
+
+    ShapeManager shapeManager;
+    for (auto& info : infos) {
+        QVERIFY(shapeManager.requestShape(info) == nullptr);
+    }
+    QCOMPARE(shapeManager.getNumBuildingShapes(), NUM_SHAPES);
+    shapeManager.waitForShapeBuilds();
+
+    std::vector<const btCollisionShape*> shapes;
+    for (auto& info : infos) {
+        const btCollisionShape* shape = shapeManager.getShapeByKey(info.getHash());
+        QVERIFY(shape != nullptr);
+        shapes.push_back(shape);
+    }
+    QCOMPARE(shapeManager.getNumBuildingShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), NUM_SHAPES);
+
+    for (auto shape : shapes) {
+        shapeManager.releaseShape(shape);
+    }
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
@@ -25,6 +25,8 @@ private slots:
     void addCylinderShape();
     void addCapsuleShape();
     void addCompoundShape();
+    void testRequestShape();
+    void testRequestManyShapes();
 };
 
 #endif // hifi_ShapeManagerTests_h
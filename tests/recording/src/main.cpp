@@ -101,6 +101,45 @@ void testFilePersist() {
     QVERIFY(readClip->duration() == 5.0f);
 }
 
+void testPackedFilePersist() {
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+
+    // frames of the same size are stored as deltas from their keyframe
+    auto writeClip = Clip::newClip();
+    QByteArray data(256, 'a');
+    for (int i = 0; i < 200; ++i) {
+        data[i] = 'b';
+        writeClip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)i, data));
+    }
+    writeClip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, 200.0f, QByteArray()));
+    Clip::toPackedFile(fileName, writeClip);
+
+    // clips read from the same file share its data but not their position
+    auto readClip = Clip::fromFile(fileName);
+    auto otherClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == writeClip->frameCount());
+    QVERIFY(readClip->duration() == writeClip->duration());
+    otherClip->seek(writeClip->duration());
+    readClip->seek(0);
+    writeClip->seek(0);
+
+    size_t count = 0;
+    for (auto readFrame = readClip->nextFrame(), writeFrame = writeClip->nextFrame(); readFrame && writeFrame;
+        readFrame = readClip->nextFrame(), writeFrame = writeClip->nextFrame(), ++count) {
+        QVERIFY(readFrame->type == writeFrame->type);
+        QVERIFY(readFrame->timeOffset == writeFrame->timeOffset);
+        QVERIFY(readFrame->data == writeFrame->data);
+    }
+    QVERIFY(readClip->frameCount() == count);
+    QVERIFY(otherClip->positionFrameTime() == Frame::secondsToFrameTime(writeClip->duration()));
+}
+
 void testClipOrdering() {
     auto writeClip = Clip::newClip();
     // simulate our of order addition of frames
@@ -124,5 +163,6 @@ int main(int, const char**) {
 
     testFrameTypeRegistration();
     testFilePersist();
+    testPackedFilePersist();
     testClipOrdering();
 }
@@ -0,0 +1,273 @@
+//
+//  CullTests.cpp
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullTests.h"
+
+#include <unordered_set>
+
+#include <QtTest/QtTest>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <SharedUtil.h>
+#include <render/CullTask.h>
+
+QTEST_MAIN(CullTests)
+
+// a bare item that only has a bound
+class BoundItem {
+public:
+    using Pointer = std::shared_ptr<BoundItem>;
+
+    BoundItem(const AABox& bound) : bound(bound) {}
+
+    AABox bound;
+};
+
+namespace render {
+    template <> const ItemKey payloadGetKey(const BoundItem::Pointer& payload) {
+        return ItemKey::Builder::opaqueShape().build();
+    }
+    template <> const Item::Bound payloadGetBound(const BoundItem::Pointer& payload) {
+        return payload->bound;
+    }
+}
+
+const float WORLD_SIZE = 2000.0f;
+
+static AABox randomBound() {
+    glm::vec3 corner(randFloatInRange(-0.5f, 0.5f) * WORLD_SIZE, randFloatInRange(-10.0f, 50.0f),
+                     randFloatInRange(-0.5f, 0.5f) * WORLD_SIZE);
+    glm::vec3 dimensions(randFloatInRange(0.01f, 20.0f), randFloatInRange(0.01f, 20.0f), randFloatInRange(0.01f, 20.0f));
+    return AABox(corner, dimensions);
+}
+
+static render::ScenePointer makeScene(size_t numItems, render::ItemIDs& itemIDs) {
+    auto scene = std::make_shared<render::Scene>(glm::vec3(-0.5f * WORLD_SIZE), WORLD_SIZE);
+    render::Transaction transaction;
+    for (size_t i = 0; i < numItems; ++i) {
+        auto id = scene->allocateID();
+        auto item = std::make_shared<BoundItem>(randomBound());
+        transaction.resetItem(id, std::make_shared<render::Payload<BoundItem>>(item));
+        itemIDs.push_back(id);
+    }
+    scene->enqueueTransaction(transaction);
+    scene->processTransactionQueue();
+    return scene;
+}
+
+// the items as the spatial tree packs them
+static render::PackedItems packItems(const render::Scene& scene, const render::ItemIDs& itemIDs) {
+    render::PackedItems items;
+    for (auto id : itemIDs) {
+        const auto& item = scene.getItem(id);
+        items.push_back(id, item.getKey(), item.getBound());
+    }
+    return items;
+}
+
+static void setupArgs(RenderArgs& args) {
+    ViewFrustum frustum;
+    frustum.setPosition(glm::vec3(10.0f, 2.0f, -30.0f));
+    frustum.setOrientation(glm::angleAxis(0.3f, glm::vec3(0.0f, 1.0f, 0.0f)));
+    frustum.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f));
+    frustum.calculate();
+    args.setViewFrustum(frustum);
+    args._lodAngleHalfTan = 0.01f;
+    args._lodAngleHalfTanSq = args._lodAngleHalfTan * args._lodAngleHalfTan;
+}
+
+// the LODManager test, with the apparent size of the bound against the LOD angle
+static bool isBigEnough(const RenderArgs* args, const AABox& bound) {
+    auto pos = args->getViewFrustum().getPosition() - bound.calcCenter();
+    auto dim = bound.getDimensions();
+    return 0.25f * glm::dot(dim, dim) >= args->_lodAngleHalfTanSq * glm::dot(pos, pos);
+}
+
+static render::ItemCuller::Result cullOne(render::CullTest& test, const AABox& bound) {
+    if (!test.frustumTest(bound)) {
+        return render::ItemCuller::OUT_OF_VIEW;
+    }
+    if (!test.solidAngleTest(bound)) {
+        return render::ItemCuller::TOO_SMALL;
+    }
+    return render::ItemCuller::VISIBLE;
+}
+
+void CullTests::testItemCuller() {
+    const size_t NUM_ITEMS = 20000;
+    render::ItemIDs itemIDs;
+    auto scene = makeScene(NUM_ITEMS, itemIDs);
+    auto items = packItems(*scene, itemIDs);
+    RenderArgs args;
+    setupArgs(args);
+    render::CullFunctor cullFunctor = isBigEnough;
+    render::RenderDetails::Item details;
+    render::CullTest test(cullFunctor, &args, details);
+
+    render::ItemCuller culler;
+    culler.cull(items, render::ItemFilter::Builder::opaqueShape().build(), &args, cullFunctor, true, true);
+    QCOMPARE(culler.size(), itemIDs.size());
+    size_t numVisible = 0;
+    for (size_t i = 0; i < itemIDs.size(); ++i) {
+        AABox bound = scene->getItem(itemIDs[i]).getBound();
+        QCOMPARE(culler.getResult(i), cullOne(test, bound));
+        QCOMPARE(culler.getBound(i), bound);
+        numVisible += (culler.getResult(i) == render::ItemCuller::VISIBLE);
+    }
+    QVERIFY(numVisible > 0 && numVisible < NUM_ITEMS);
+
+    // items that don't pass the filter are skipped
+    culler.cull(items, render::ItemFilter::Builder::transparentShape().build(), &args, cullFunctor, true, true);
+    for (size_t i = 0; i < itemIDs.size(); ++i) {
+        QCOMPARE(culler.getResult(i), render::ItemCuller::FILTERED_OUT);
+    }
+
+    // and items are only filtered when the tests are off
+    culler.cull(items, render::ItemFilter::Builder::opaqueShape().build(), &args, cullFunctor, false, false);
+    for (size_t i = 0; i < itemIDs.size(); ++i) {
+        QCOMPARE(culler.getResult(i), render::ItemCuller::VISIBLE);
+    }
+}
+
+void CullTests::testItemBoundsCuller() {
+    RenderArgs args;
+    setupArgs(args);
+    render::CullFunctor cullFunctor = isBigEnough;
+    render::RenderDetails::Item details;
+    render::CullTest test(cullFunctor, &args, details);
+
+    render::ItemBounds items;
+    for (render::ItemID id = 0; id < 1000; ++id) {
+        items.emplace_back(id, (id % 10) ? randomBound() : AABox());
+    }
+    render::ItemCuller culler;
+    culler.cull(items, &args, cullFunctor, true, true);
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].bound.isNull()) {
+            QCOMPARE(culler.getResult(i), render::ItemCuller::VISIBLE);
+        } else {
+            QCOMPARE(culler.getResult(i), cullOne(test, items[i].bound));
+        }
+    }
+}
+
+void CullTests::testSpatialTreePackedItems() {
+    const size_t NUM_ITEMS = 2000;
+    render::ItemIDs itemIDs;
+    auto scene = makeScene(NUM_ITEMS, itemIDs);
+
+    // move some items, within their cell or to another one, and remove others
+    render::Transaction transaction;
+    std::unordered_set<render::ItemID> removedIDs;
+    for (size_t i = 0; i < NUM_ITEMS; ++i) {
+        if (i % 3 == 0) {
+            transaction.updateItem<BoundItem>(itemIDs[i], [](BoundItem& item) {
+                item.bound.translate(glm::vec3(0.01f, 0.0f, 0.0f));
+            });
+        } else if (i % 3 == 1) {
+            transaction.updateItem<BoundItem>(itemIDs[i], [](BoundItem& item) {
+                item.bound = randomBound();
+            });
+        } else if (i % 9 == 2) {
+            transaction.removeItem(itemIDs[i]);
+            removedIDs.insert(itemIDs[i]);
+        }
+    }
+    scene->enqueueTransaction(transaction);
+    scene->processTransactionQueue();
+
+    // removals moved other items into their slots, those must still be found by later updates
+    render::Transaction nextTransaction;
+    for (size_t i = 0; i < NUM_ITEMS; i += 2) {
+        if (removedIDs.count(itemIDs[i]) == 0) {
+            nextTransaction.updateItem<BoundItem>(itemIDs[i], [](BoundItem& item) {
+                item.bound.translate(glm::vec3(0.0f, 0.01f, 0.0f));
+            });
+        }
+    }
+    scene->enqueueTransaction(nextTransaction);
+    scene->processTransactionQueue();
+
+    // everything left is selected once, with its current key and bound
+    ViewFrustum frustum;
+    frustum.setPosition(glm::vec3(0.0f, 0.0f, WORLD_SIZE));
+    frustum.setProjection(glm::perspective(glm::radians(120.0f), 1.0f, 0.1f, 4.0f * WORLD_SIZE));
+    frustum.calculate();
+    render::ItemSpatialTree::ItemSelection selection;
+    scene->getSpatialTree().selectCellItems(selection, render::ItemFilter::Builder::visibleWorldItems().build(), frustum, 0.0f);
+    QCOMPARE(selection.numItems(), NUM_ITEMS - removedIDs.size());
+
+    std::unordered_set<render::ItemID> selectedIDs;
+    for (const auto* items : { &selection.insideItems, &selection.insideSubcellItems, &selection.partialItems,
+                               &selection.partialSubcellItems }) {
+        QCOMPARE(items->keys.size(), items->size());
+        QCOMPARE(items->bounds.size(), items->size());
+        for (size_t i = 0; i < items->size(); ++i) {
+            const auto& item = scene->getItem(items->ids[i]);
+            QVERIFY(removedIDs.count(items->ids[i]) == 0);
+            QVERIFY(items->keys[i] == item.getKey());
+            QCOMPARE(items->bounds[i], item.getBound());
+            selectedIDs.insert(items->ids[i]);
+        }
+    }
+    QCOMPARE(selectedIDs.size(), NUM_ITEMS - removedIDs.size());
+}
+
+const size_t NUM_BENCHMARK_ITEMS = 200000;
+
+void CullTests::benchmarkCullTest() {
+    render::ItemIDs itemIDs;
+    auto scene = makeScene(NUM_BENCHMARK_ITEMS, itemIDs);
+    RenderArgs args;
+    setupArgs(args);
+    render::CullFunctor cullFunctor = isBigEnough;
+    render::RenderDetails::Item details;
+    render::CullTest test(cullFunctor, &args, details);
+    auto filter = render::ItemFilter::Builder::opaqueShape().build();
+
+    render::ItemBounds outItems;
+    outItems.reserve(NUM_BENCHMARK_ITEMS);
+    QBENCHMARK {
+        outItems.clear();
+        for (auto id : itemIDs) {
+            auto& item = scene->getItem(id);
+            if (filter.test(item.getKey())) {
+                render::ItemBound itemBound(id, item.getBound());
+                if (test.frustumTest(itemBound.bound) && test.solidAngleTest(itemBound.bound)) {
+                    outItems.emplace_back(itemBound);
+                }
+            }
+        }
+    }
+}
+
+void CullTests::benchmarkItemCuller() {
+    render::ItemIDs itemIDs;
+    auto scene = makeScene(NUM_BENCHMARK_ITEMS, itemIDs);
+    auto items = packItems(*scene, itemIDs);
+    RenderArgs args;
+    setupArgs(args);
+    render::CullFunctor cullFunctor = isBigEnough;
+    auto filter = render::ItemFilter::Builder::opaqueShape().build();
+
+    render::ItemCuller culler;
+    render::ItemBounds outItems;
+    outItems.reserve(NUM_BENCHMARK_ITEMS);
+    QBENCHMARK {
+        outItems.clear();
+        culler.cull(items, filter, &args, cullFunctor, true, true);
+        for (size_t i = 0; i < itemIDs.size(); ++i) {
+            if (culler.getResult(i) == render::ItemCuller::VISIBLE) {
+                outItems.emplace_back(items.ids[i], items.bounds[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  CullTests.h
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CullTests_h
+#define hifi_CullTests_h
+
+#include <QtCore/QObject>
+
+class CullTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testItemCuller();
+    void testItemBoundsCuller();
+    void testSpatialTreePackedItems();
+    void benchmarkCullTest();
+    void benchmarkItemCuller();
+};
+
+#endif // hifi_CullTests_h
@@ -0,0 +1,192 @@
+//
+//  BakeCacheTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeCacheTests.h"
+
+#include <QtCore/QDataStream>
+
+#include <shared/BakeCache.h>
+
+QTEST_GUILESS_MAIN(BakeCacheTests)
+
+static const size_t MAX_CACHE_SIZE { 1024 * 1024 * 10 };
+
+static BakeCachePointer makeBakeCache(const QString& location) {
+    auto result = std::make_shared<BakeCache>(location.toStdString());
+    result->initialize();
+    result->setMaxSize(MAX_CACHE_SIZE);
+    return result;
+}
+
+static QString writeTestFile(const QDir& dir, const QString& relativePath, const QByteArray& data) {
+    auto path = dir.absoluteFilePath(relativePath);
+    QFileInfo(path).absoluteDir().mkpath(".");
+    QFile file { path };
+    file.open(QIODevice::WriteOnly);
+    file.write(data);
+    return path;
+}
+
+// writes a bundle the way BakeCache::store() does, but with whatever paths and number of files we want
+static void writeTestBundle(const BakeCachePointer& cache, const BakeCache::Key& key,
+                            const std::vector<std::pair<QString, QByteArray>>& files, quint32 numFiles) {
+    const quint32 BUNDLE_VERSION = 1;
+    QByteArray bundle;
+    {
+        QDataStream stream(&bundle, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_9);
+        stream << BUNDLE_VERSION << QByteArray("{}") << numFiles;
+        for (const auto& file : files) {
+            stream << file.first << file.second;
+        }
+    }
+    cache->writeFile(bundle.constData(), cache::FileCache::Metadata(key, bundle.size()), true);
+}
+
+static QByteArray readTestFile(const QString& path) {
+    QFile file { path };
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+void BakeCacheTests::testKeys() {
+    auto key = BakeCache::computeKey("TextureBaker", 1, "options", "input");
+    QCOMPARE(BakeCache::computeKey("TextureBaker", 1, "options", "input"), key);
+
+    // any change to what the bake depends on has to change the key
+    QVERIFY(BakeCache::computeKey("ModelBaker", 1, "options", "input") != key);
+    QVERIFY(BakeCache::computeKey("TextureBaker", 2, "options", "input") != key);
+    QVERIFY(BakeCache::computeKey("TextureBaker", 1, "option", "input") != key);
+    QVERIFY(BakeCache::computeKey("TextureBaker", 1, "options", "inputs") != key);
+
+    // moving bytes between the options and the input is a different bake too
+    QVERIFY(BakeCache::computeKey("TextureBaker", 1, "optionsi", "nput") != key);
+}
+
+void BakeCacheTests::testStoreAndRestore() {
+    auto cache = makeBakeCache(_testDir.filePath("store"));
+    auto key = BakeCache::computeKey("TestBaker", 1, QByteArray(), "testStoreAndRestore");
+
+    QDir outputDir { _testDir.filePath("storeOutput") };
+    outputDir.mkpath(".");
+    std::vector<QString> files {
+        writeTestFile(outputDir, "baked/model.fbx", QByteArray(1024, 'm')),
+        writeTestFile(outputDir, "baked/textures/diffuse.ktx", QByteArray(2048, 't'))
+    };
+    QJsonObject info;
+    info["mapping"] = "model.fst";
+
+    std::vector<QString> restoredFiles;
+    QVERIFY(!cache->restore(key, outputDir, restoredFiles));
+    QCOMPARE(cache->getNumMisses(), (size_t)1);
+
+    QVERIFY(cache->store(key, outputDir, files, info));
+
+    // restore into another directory, on a fresh cache to make sure the bake was persisted
+    cache = makeBakeCache(_testDir.filePath("store"));
+    QDir restoreDir { _testDir.filePath("restoreOutput") };
+    QJsonObject restoredInfo;
+    QVERIFY(cache->restore(key, restoreDir, restoredFiles, &restoredInfo));
+    QCOMPARE(cache->getNumHits(), (size_t)1);
+    QCOMPARE(restoredInfo, info);
+
+    QCOMPARE(restoredFiles.size(), files.size());
+    QCOMPARE(readTestFile(restoreDir.absoluteFilePath("baked/model.fbx")), QByteArray(1024, 'm'));
+    QCOMPARE(readTestFile(restoreDir.absoluteFilePath("baked/textures/diffuse.ktx")), QByteArray(2048, 't'));
+}
+
+void BakeCacheTests::testRejectedInfo() {
+    auto cache = makeBakeCache(_testDir.filePath("rejected"));
+    auto key = BakeCache::computeKey("TestBaker", 1, QByteArray(), "testRejectedInfo");
+
+    QDir outputDir { _testDir.filePath("rejectedOutput") };
+    outputDir.mkpath(".");
+    std::vector<QString> files { writeTestFile(outputDir, "script.js", "print('baked');") };
+    QJsonObject info;
+    info["dependency"] = "stale";
+    QVERIFY(cache->store(key, outputDir, files, info));
+
+    QDir restoreDir { _testDir.filePath("rejectedRestore") };
+    std::vector<QString> restoredFiles;
+    auto isValid = [](const QJsonObject& info) { return info["dependency"].toString() != "stale"; };
+    QVERIFY(!cache->restore(key, restoreDir, restoredFiles, nullptr, isValid));
+    QVERIFY(restoredFiles.empty());
+    QVERIFY(!restoreDir.exists("script.js"));
+    QCOMPARE(cache->getNumHits(), (size_t)0);
+    QCOMPARE(cache->getNumMisses(), (size_t)1);
+}
+
+void BakeCacheTests::testOutsideOfOutputDirectory() {
+    auto cache = makeBakeCache(_testDir.filePath("outside"));
+    auto key = BakeCache::computeKey("TestBaker", 1, QByteArray(), "testOutsideOfOutputDirectory");
+
+    QDir outputDir { _testDir.filePath("outsideOutput") };
+    outputDir.mkpath(".");
+    std::vector<QString> files { writeTestFile(QDir(_testDir.path()), "elsewhere.txt", "elsewhere") };
+    QVERIFY(!cache->store(key, outputDir, files));
+
+    std::vector<QString> restoredFiles;
+    QVERIFY(!cache->restore(key, outputDir, restoredFiles));
+}
+
+void BakeCacheTests::testRestoreOutsideOfOutputDirectory() {
+    auto cache = makeBakeCache(_testDir.filePath("restoreOutside"));
+    QDir restoreDir { _testDir.filePath("restoreOutsideOutput/baked") };
+    restoreDir.mkpath(".");
+
+    std::vector<QString> restoredFiles;
+    auto key = BakeCache::computeKey("TestBaker", 1, QByteArray(), "parent");
+    writeTestBundle(cache, key, { { "inside.txt", "inside" }, { "textures/../../outside.txt", "outside" } }, 2);
+    QVERIFY(!cache->restore(key, restoreDir, restoredFiles));
+    QVERIFY(!QFile::exists(_testDir.filePath("restoreOutsideOutput/outside.txt")));
+
+    key = BakeCache::computeKey("TestBaker", 1, QByteArray(), "absolute");
+    QString absolutePath = _testDir.filePath("absolute.txt");
+    writeTestBundle(cache, key, { { "inside.txt", "inside" }, { absolutePath, "absolute" } }, 2);
+    QVERIFY(!cache->restore(key, restoreDir, restoredFiles));
+    QVERIFY(!QFile::exists(absolutePath));
+
+    // nothing from the rejected bundles is left behind
+    QVERIFY(restoredFiles.empty());
+    QVERIFY(!restoreDir.exists("inside.txt"));
+    QCOMPARE(cache->getNumMisses(), (size_t)2);
+}
+
+void BakeCacheTests::testIncompleteRestore() {
+    auto cache = makeBakeCache(_testDir.filePath("incomplete"));
+    auto key = BakeCache::computeKey("TestBaker", 1, QByteArray(), "testIncompleteRestore");
+    writeTestBundle(cache, key, { { "first.txt", "first" } }, 2);
+
+    // into a new directory
+    std::vector<QString> restoredFiles;
+    QDir newDir { _testDir.filePath("incompleteNew") };
+    QVERIFY(!cache->restore(key, newDir, restoredFiles));
+    QVERIFY(!newDir.exists());
+
+    // into a directory that has other output of the bake in it
+    QDir existingDir { _testDir.filePath("incompleteExisting") };
+    existingDir.mkpath(".");
+    QString originalPath = writeTestFile(existingDir, "original.png", "original");
+    QVERIFY(!cache->restore(key, existingDir, restoredFiles));
+    QVERIFY(!existingDir.exists("first.txt"));
+    QCOMPARE(readTestFile(originalPath), QByteArray("original"));
+    QVERIFY(restoredFiles.empty());
+
+    // and nothing is left next to either of them
+    QCOMPARE(QDir(_testDir.path()).entryList({ "incomplete*.restoring-*" }, QDir::AllEntries).size(), 0);
+
+    // a complete restore next to the files that are already there
+    writeTestBundle(cache, key, { { "first.txt", "first" }, { "second/second.txt", "second" } }, 2);
+    QVERIFY(cache->restore(key, existingDir, restoredFiles));
+    QCOMPARE(restoredFiles.size(), (size_t)2);
+    QCOMPARE(readTestFile(existingDir.absoluteFilePath("first.txt")), QByteArray("first"));
+    QCOMPARE(readTestFile(existingDir.absoluteFilePath("second/second.txt")), QByteArray("second"));
+    QCOMPARE(readTestFile(originalPath), QByteArray("original"));
+}
@@ -0,0 +1,31 @@
+//
+//  BakeCacheTests.h
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeCacheTests_h
+#define hifi_BakeCacheTests_h
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+
+class BakeCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testKeys();
+    void testStoreAndRestore();
+    void testRejectedInfo();
+    void testOutsideOfOutputDirectory();
+    void testRestoreOutsideOfOutputDirectory();
+    void testIncompleteRestore();
+
+private:
+    QTemporaryDir _testDir;
+};
+
+#endif // hifi_BakeCacheTests_h
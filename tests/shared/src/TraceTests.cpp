@@ -8,8 +8,13 @@
 
 #include "TraceTests.h"
 
+#include <thread>
+
 #include <QtTest/QtTest>
 #include <QtGui/QDesktopServices>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 #include <Profile.h>
 
@@ -45,3 +50,91 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+
+void TraceTests::testTraceSnapshot() {
+    const size_t EVENTS_PER_THREAD = 4096;
+    const int NUM_EVENTS = 10000;
+
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing(EVENTS_PER_THREAD);
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        PROFILE_COUNTER(test, "TestCounter", { { "i", i } })
+    }
+    std::thread([] {
+        PROFILE_RANGE(test, "OtherThreadEvent")
+    }).join();
+
+    // a snapshot doesn't stop the recording, and the ring buffer only keeps the latest events
+    auto document = QJsonDocument::fromJson(tracer->toJson());
+    QVERIFY(tracer->isEnabled());
+    QVERIFY(document.isArray());
+
+    int numCounters = 0;
+    int lastCounter = -1;
+    int numOtherThreadEvents = 0;
+    for (const auto& value : document.array()) {
+        auto event = value.toObject();
+        if (event["name"].toString() == "TestCounter") {
+            QCOMPARE(event["cat"].toString(), QString("trace.test"));
+            QCOMPARE(event["ph"].toString(), QString("C"));
+            lastCounter = event["args"].toObject()["i"].toInt();
+            ++numCounters;
+        } else if (event["name"].toString() == "OtherThreadEvent") {
+            ++numOtherThreadEvents;
+        }
+    }
+    // less the oldest one, which a writer could have been overwriting while the snapshot was taken
+    QCOMPARE(numCounters, (int)EVENTS_PER_THREAD - 1);
+    QCOMPARE(lastCounter, NUM_EVENTS - 1);
+    QCOMPARE(numOtherThreadEvents, 2);
+
+    // restarting drops what was recorded before
+    tracer->stopTracing();
+    tracer->startTracing(EVENTS_PER_THREAD);
+    QVERIFY(QJsonDocument::fromJson(tracer->toJson()).array().isEmpty());
+    tracer->stopTracing();
+}
+
+void TraceTests::testTraceStrings() {
+    const size_t EVENTS_PER_THREAD = 1 << 14;
+    const int NUM_EVENTS = 100000;
+
+    // more distinct ids and arguments than names could ever be interned, none of them may crowd out later names
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing(EVENTS_PER_THREAD);
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        PROFILE_ASYNC_BEGIN(test, "TestResource", "resource-" + QString::number(i),
+                            { { "url", "atp:/" + QString::number(i) + "/\"quoted\".fbx" } })
+    }
+    const QString LONG_URL = "atp:/" + QString(1000, 'x');
+    PROFILE_ASYNC_BEGIN(test, "TestLastResource", "last", { { "url", LONG_URL } })
+
+    auto document = QJsonDocument::fromJson(tracer->toJson());
+    QVERIFY(document.isArray());
+
+    int numResources = 0;
+    int lastResource = -1;
+    bool foundLast = false;
+    for (const auto& value : document.array()) {
+        auto event = value.toObject();
+        QString name = event["name"].toString();
+        QString url = event["args"].toObject()["url"].toString();
+        if (name == "TestResource") {
+            int i = event["id"].toString().mid(QString("resource-").size()).toInt();
+            QCOMPARE(url, "atp:/" + QString::number(i) + "/\"quoted\".fbx");
+            QVERIFY(i > lastResource);
+            lastResource = i;
+            ++numResources;
+        } else if (name == "TestLastResource") {
+            QCOMPARE(event["id"].toString(), QString("last"));
+            QVERIFY(LONG_URL.startsWith(url));
+            QVERIFY(url.size() > 200);
+            foundLast = true;
+        }
+        QVERIFY(name != "(overflow)");
+    }
+    QVERIFY(foundLast);
+    QVERIFY(numResources > 0);
+    QCOMPARE(lastResource, NUM_EVENTS - 1);
+    tracer->stopTracing();
+}
@@ -11,39 +11,55 @@
 
 #include "SpaceTests.h"
 
-#include <iostream>
+#include <algorithm>
 
 #include <workload/Space.h>
 #include <StreamUtils.h>
 #include <SharedUtil.h>
 
+QTEST_MAIN(SpaceTests)
 
-const float INV_SQRT_3 = 1.0f / sqrtf(3.0f);
+using Changes = std::vector<workload::Space::Change>;
 
-QTEST_MAIN(SpaceTests)
+static workload::View makeView(const glm::vec3& center, float near, float mid, float far) {
+    workload::View view;
+    view.origin = center;
+    view.regions[workload::Region::R1] = workload::Sphere(center, near);
+    view.regions[workload::Region::R2] = workload::Sphere(center, mid);
+    view.regions[workload::Region::R3] = workload::Sphere(center, far);
+    return view;
+}
+
+static void applyFrame(workload::Space& space, const workload::Transaction& transaction) {
+    space.enqueueTransaction(transaction);
+    space.enqueueFrame();
+    space.processTransactionQueue();
+}
+
+static void moveProxy(workload::Space& space, int32_t proxyId, const workload::Sphere& sphere) {
+    workload::Transaction transaction;
+    transaction.update(proxyId, sphere);
+    applyFrame(space, transaction);
+}
 
 void SpaceTests::testOverlaps() {
     workload::Space space;
-    using Changes = std::vector<workload::Space::Change>;
-    using Views = std::vector<workload::Space::View>;
 
     glm::vec3 viewCenter(0.0f, 0.0f, 0.0f);
     float near = 1.0f;
     float mid = 2.0f;
     float far = 3.0f;
+    space.setViews({ makeView(viewCenter, near, mid, far) });
 
-    Views views;
-    views.push_back(workload::Space::View(viewCenter, near, mid, far));
-    space.setViews(views);
-
-    int32_t proxyId = 0;
     const float DELTA = 0.001f;
     float proxyRadius = 0.5f;
     glm::vec3 proxyPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + proxyRadius + DELTA);
-    workload::Space::Sphere proxySphere(proxyPosition, proxyRadius);
+    int32_t proxyId = space.allocateID();
 
     { // create very_far proxy
-        proxyId = space.createProxy(proxySphere);
+        workload::Transaction transaction;
+        transaction.reset(proxyId, workload::Sphere(proxyPosition, proxyRadius), workload::Owner());
+        applyFrame(space, transaction);
         QVERIFY(space.getNumObjects() == 1);
 
         Changes changes;
@@ -54,227 +70,216 @@ void SpaceTests::testOverlaps() {
     { // move proxy far
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        moveProxy(space, proxyId, workload::Sphere(newPosition, newRadius));
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_FAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_UNKNOWN);
+        QVERIFY(changes[0].region == workload::Region::R3);
+        QVERIFY(changes[0].prevRegion == workload::Region::UNKNOWN);
     }
 
     { // move proxy mid
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, mid + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        moveProxy(space, proxyId, workload::Sphere(newPosition, newRadius));
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_MIDDLE);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_FAR);
+        QVERIFY(changes[0].region == workload::Region::R2);
+        QVERIFY(changes[0].prevRegion == workload::Region::R3);
     }
 
     { // move proxy near
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, near + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        moveProxy(space, proxyId, workload::Sphere(newPosition, newRadius));
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_NEAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_MIDDLE);
+        QVERIFY(changes[0].region == workload::Region::R1);
+        QVERIFY(changes[0].prevRegion == workload::Region::R2);
+        QVERIFY(space.getRegion(proxyId) == workload::Region::R1);
+    }
+
+    { // move proxy far away, into another bin
+        glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, 10.0f * workload::Space::DEFAULT_BIN_SIZE);
+        moveProxy(space, proxyId, workload::Sphere(newPosition, proxyRadius));
+        Changes changes;
+        space.categorizeAndGetChanges(changes);
+        QVERIFY(changes.size() == 1);
+        QVERIFY(changes[0].region == workload::Region::UNKNOWN);
+        QVERIFY(changes[0].prevRegion == workload::Region::R1);
+
+        changes.clear();
+        space.categorizeAndGetChanges(changes);
+        QVERIFY(changes.size() == 0);
     }
 
     { // delete proxy
         // NOTE: atm deleting a proxy doesn't result in a "Change"
-        std::vector<int32_t> deadProxies;
-        deadProxies.push_back(proxyId);
-        space.deleteProxies(deadProxies);
+        workload::Transaction transaction;
+        transaction.remove(proxyId);
+        applyFrame(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 0);
         QVERIFY(space.getNumObjects() == 0);
+        QVERIFY(space.getRegion(proxyId) == workload::Region::INVALID);
     }
 }
 
-#ifdef MANUAL_TEST
-
-const float WORLD_WIDTH = 1000.0f;
-const float MIN_RADIUS = 1.0f;
-const float MAX_RADIUS = 100.0f;
+const uint32_t NUM_BENCHMARK_PROXIES = 100000;
+const float WORLD_WIDTH = 4000.0f;
+const float WORLD_HEIGHT = 200.0f;
+const float MIN_RADIUS = 0.5f;
+const float MAX_RADIUS = 20.0f;
 
-float randomFloat() {
-    return 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+static workload::Sphere randomSphere() {
+    return workload::Sphere(randFloatInRange(-0.5f, 0.5f) * WORLD_WIDTH, randFloatInRange(0.0f, WORLD_HEIGHT),
+                            randFloatInRange(-0.5f, 0.5f) * WORLD_WIDTH, randFloatInRange(MIN_RADIUS, MAX_RADIUS));
 }
 
-glm::vec3 randomVec3() {
-    glm::vec3 v(randomFloat(), randomFloat(), randomFloat());
-    return v;
+static workload::Views makeViews(const glm::vec3& position) {
+    // an avatar and a second view a little ahead of it
+    return { makeView(position, 25.0f, 100.0f, 400.0f), makeView(position + glm::vec3(0.0f, 0.0f, -50.0f), 25.0f, 100.0f, 400.0f) };
 }
 
-void generateSpheres(uint32_t numProxies, std::vector<workload::Space::Sphere>& spheres) {
-    spheres.reserve(numProxies);
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        workload::Space::Sphere sphere(
-                WORLD_WIDTH * randomFloat(),
-                WORLD_WIDTH * randomFloat(),
-                WORLD_WIDTH * randomFloat(),
-                (MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS)) * randomFloat());
-        spheres.push_back(sphere);
+static std::vector<int32_t> addProxies(workload::Space& space, const std::vector<workload::Sphere>& spheres) {
+    std::vector<int32_t> proxyIds;
+    proxyIds.reserve(spheres.size());
+    workload::Transaction transaction;
+    for (const auto& sphere : spheres) {
+        int32_t proxyId = space.allocateID();
+        transaction.reset(proxyId, sphere, workload::Owner());
+        proxyIds.push_back(proxyId);
     }
+    applyFrame(space, transaction);
+    return proxyIds;
 }
 
-void generatePositions(uint32_t numProxies, std::vector<glm::vec3>& positions) {
-    positions.reserve(numProxies);
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        positions.push_back(WORLD_WIDTH * randomVec3());
-    }
+static void sortChanges(Changes& changes) {
+    std::sort(changes.begin(), changes.end(), [](const workload::Space::Change& a, const workload::Space::Change& b) {
+        return a.proxyId < b.proxyId;
+    });
 }
 
-void generateRadiuses(uint32_t numRadiuses, std::vector<float>& radiuses) {
-    radiuses.reserve(numRadiuses);
-    for (uint32_t i = 0; i < numRadiuses; ++i) {
-        radiuses.push_back(MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * randomFloat());
-    }
+static bool sameChanges(const Changes& a, const Changes& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+        [](const workload::Space::Change& x, const workload::Space::Change& y) {
+            return x.proxyId == y.proxyId && x.region == y.region && x.prevRegion == y.prevRegion;
+        });
 }
 
-void SpaceTests::benchmark() {
-    uint32_t numProxies[] = { 100, 1000, 10000, 100000 };
-    uint32_t numTests = 4;
-    std::vector<uint64_t> timeToAddAll;
-    std::vector<uint64_t> timeToMoveView;
-    std::vector<uint64_t> timeToMoveProxies;
-    std::vector<uint64_t> timeToRemoveAll;
-    for (uint32_t i = 0; i < numTests; ++i) {
-
-        workload::Space space;
-
-        { // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
-
-        // build the proxies
-        uint32_t n = numProxies[i];
-        std::vector<workload::Space::Sphere> proxySpheres;
-        generateSpheres(n, proxySpheres);
-        std::vector<int32_t> proxyKeys;
-        proxyKeys.reserve(n);
-
-        // measure time to put proxies in the space
-        uint64_t startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < n; ++j) {
-            int32_t key = space.createProxy(proxySpheres[j]);
-            proxyKeys.push_back(key);
-        }
-        uint64_t usec = usecTimestampNow() - startTime;
-        timeToAddAll.push_back(usec);
-
-        {
-            // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f));
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f + 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
-
-        // measure time to categorizeAndGetChanges everything
-        std::vector<workload::Space::Change> changes;
-        startTime = usecTimestampNow();
-        space.categorizeAndGetChanges(changes);
-        usec = usecTimestampNow() - startTime;
-        timeToMoveView.push_back(usec);
-
-        // move every 10th proxy around
-        const float proxySpeed = 1.0f;
-        std::vector<workload::Space::Sphere> newSpheres;
-        uint32_t numMovingProxies = n / 10;
-        uint32_t jstep = n / numMovingProxies;
-        uint32_t maxJ = numMovingProxies * jstep - 1;
-        glm::vec3 direction;
-        for (uint32_t j = 0; j < maxJ - jstep; j += jstep) {
-            glm::vec3 position = (glm::vec3)proxySpheres[j];
-            glm::vec3 destination = (glm::vec3)proxySpheres[j + jstep];
-            direction = glm::normalize(destination - position);
-            glm::vec3 newPosition = position + proxySpeed * direction;
-            newSpheres.push_back(workload::Space::Sphere(newPosition, proxySpheres[j].w));
-        }
-        glm::vec3 position = (glm::vec3)proxySpheres[maxJ = jstep];
-        glm::vec3 destination = (glm::vec3)proxySpheres[0];
-        direction = glm::normalize(destination - position);
-        direction = position + proxySpeed * direction;
-        newSpheres.push_back(workload::Space::Sphere(direction, proxySpheres[0].w));
-        uint32_t k = 0;
-        startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < maxJ; j += jstep) {
-            space.updateProxy(proxyKeys[j], newSpheres[k++]);
+void SpaceTests::testBinning() {
+    // the binned space must find the same changes as one that classifies every proxy every time
+    const uint32_t NUM_PROXIES = 20000;
+    std::vector<workload::Sphere> spheres;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        spheres.push_back(randomSphere());
+    }
+    workload::Space binned;
+    workload::Space unbinned;
+    unbinned.setBinSize(0.0f);
+    std::vector<int32_t> proxyIds = addProxies(binned, spheres);
+    addProxies(unbinned, spheres);
+
+    const int NUM_FRAMES = 20;
+    glm::vec3 viewPosition(0.0f);
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        // teleport the views now and then, otherwise walk them
+        if (frame % 5 == 0) {
+            viewPosition = glm::vec3(randomSphere());
+        } else {
+            viewPosition += glm::vec3(30.0f, 0.0f, 0.0f);
         }
-        changes.clear();
-        space.categorizeAndGetChanges(changes);
-        usec = usecTimestampNow() - startTime;
-        timeToMoveProxies.push_back(usec);
+        binned.setViews(makeViews(viewPosition));
+        unbinned.setViews(makeViews(viewPosition));
 
-        // measure time to remove proxies from space
-        startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < n; ++j) {
-            space.deleteProxy(proxyKeys[j]);
+        workload::Transaction transaction;
+        for (uint32_t i = frame; i < NUM_PROXIES; i += 100) {
+            transaction.update(proxyIds[i], randomSphere());
         }
-        usec = usecTimestampNow() - startTime;
-        timeToRemoveAll.push_back(usec);
+        applyFrame(binned, transaction);
+        applyFrame(unbinned, transaction);
+
+        Changes binnedChanges;
+        Changes unbinnedChanges;
+        binned.categorizeAndGetChanges(binnedChanges);
+        unbinned.categorizeAndGetChanges(unbinnedChanges);
+        sortChanges(binnedChanges);
+        sortChanges(unbinnedChanges);
+        QVERIFY(sameChanges(binnedChanges, unbinnedChanges));
     }
 
-    std::cout << "[numProxies, timeToAddAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToAddAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToAddAll[i] << std::endl;
+    std::vector<workload::Proxy> binnedProxies(binned.getNumAllocatedProxies());
+    std::vector<workload::Proxy> unbinnedProxies(unbinned.getNumAllocatedProxies());
+    QCOMPARE(binned.copyProxyValues(binnedProxies.data(), (uint32_t)binnedProxies.size()),
+             unbinned.copyProxyValues(unbinnedProxies.data(), (uint32_t)unbinnedProxies.size()));
+    for (size_t i = 0; i < binnedProxies.size(); ++i) {
+        QVERIFY(binnedProxies[i].sphere == unbinnedProxies[i].sphere);
+        QCOMPARE(binnedProxies[i].region, unbinnedProxies[i].region);
     }
-    std::cout << "];" << std::endl;
+}
 
-    std::cout << "[numProxies, timeToMoveView] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveView.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToMoveView[i] << std::endl;
+static void runMoveViewBenchmark(float binSize) {
+    workload::Space space;
+    space.setBinSize(binSize);
+    std::vector<workload::Sphere> spheres;
+    for (uint32_t i = 0; i < NUM_BENCHMARK_PROXIES; ++i) {
+        spheres.push_back(randomSphere());
     }
-    std::cout << "];" << std::endl;
+    addProxies(space, spheres);
 
-    std::cout << "[numProxies, timeToMoveProxies] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveProxies.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << "/10, " << timeToMoveProxies[i] << std::endl;
+    Changes changes;
+    glm::vec3 viewPosition(0.0f);
+    QBENCHMARK {
+        viewPosition.x += 1.0f;
+        space.setViews(makeViews(viewPosition));
+        changes.clear();
+        space.categorizeAndGetChanges(changes);
     }
-    std::cout << "];" << std::endl;
+}
 
-    std::cout << "[numProxies, timeToRemoveAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToRemoveAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToRemoveAll[i] << std::endl;
+static void runMoveProxiesBenchmark(float binSize) {
+    workload::Space space;
+    space.setBinSize(binSize);
+    space.setViews(makeViews(glm::vec3(0.0f)));
+    std::vector<workload::Sphere> spheres;
+    for (uint32_t i = 0; i < NUM_BENCHMARK_PROXIES; ++i) {
+        spheres.push_back(randomSphere());
     }
-    std::cout << "];" << std::endl;
+    std::vector<int32_t> proxyIds = addProxies(space, spheres);
+
+    // move every 10th proxy around
+    const glm::vec4 STEP(1.0f, 0.0f, 0.0f, 0.0f);
+    Changes changes;
+    QBENCHMARK {
+        workload::Transaction transaction;
+        for (uint32_t i = 0; i < NUM_BENCHMARK_PROXIES; i += 10) {
+            spheres[i] += STEP;
+            transaction.update(proxyIds[i], spheres[i]);
+        }
+        applyFrame(space, transaction);
+        changes.clear();
+        space.categorizeAndGetChanges(changes);
+    }
+}
+
+void SpaceTests::benchmarkMoveView() {
+    runMoveViewBenchmark(workload::Space::DEFAULT_BIN_SIZE);
 }
 
-#endif // MANUAL_TEST
+void SpaceTests::benchmarkMoveViewUnbinned() {
+    runMoveViewBenchmark(0.0f);
+}
+
+void SpaceTests::benchmarkMoveProxies() {
+    runMoveProxiesBenchmark(workload::Space::DEFAULT_BIN_SIZE);
+}
+
+void SpaceTests::benchmarkMoveProxiesUnbinned() {
+    runMoveProxiesBenchmark(0.0f);
+}
@@ -14,16 +14,16 @@
 
 #include <QtTest/QtTest>
 
-//#define MANUAL_TEST
-
 class SpaceTests : public QObject {
     Q_OBJECT
 
 private slots:
     void testOverlaps();
-#ifdef MANUAL_TEST
-    void benchmark();
-#endif // MANUAL_TEST
+    void testBinning();
+    void benchmarkMoveView();
+    void benchmarkMoveViewUnbinned();
+    void benchmarkMoveProxies();
+    void benchmarkMoveProxiesUnbinned();
 };
 
 #endif // hifi_workload_SpaceTests_h
@@ -0,0 +1,179 @@
+//
+//  HeartbeatLoadGenerator.cpp
+//  tools/ice-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HeartbeatLoadGenerator.h"
+
+#include <memory>
+
+#include <openssl/err.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QUuid>
+
+#include <NLPacket.h>
+#include <NumericalConstants.h>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+const int SEND_INTERVAL_MSECS = 5;
+const int REPORT_INTERVAL_MSECS = 1000;
+
+// the first port handed out as a synthetic domain's public port
+const quint16 FIRST_SYNTHETIC_PORT = 20000;
+
+HeartbeatLoadGenerator::HeartbeatLoadGenerator(const HifiSockAddr& iceServerAddr, int numDomains,
+                                               int heartbeatsPerSecond, int durationSeconds, QObject* parent) :
+    QObject(parent),
+    _iceServerAddr(iceServerAddr),
+    _numDomains(std::max(numDomains, 1)),
+    _heartbeatsPerSecond(std::max(heartbeatsPerSecond, 1)),
+    _durationSeconds(durationSeconds)
+{
+    _socket.bind(QHostAddress::AnyIPv4, 0);
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) { processPacket(std::move(packet)); });
+
+    connect(&_sendTimer, &QTimer::timeout, this, &HeartbeatLoadGenerator::sendHeartbeats);
+    connect(&_reportTimer, &QTimer::timeout, this, &HeartbeatLoadGenerator::report);
+}
+
+bool HeartbeatLoadGenerator::start(const QString& publicKeyPath) {
+    if (!createHeartbeats(publicKeyPath)) {
+        return false;
+    }
+
+    qDebug() << "Sending" << _heartbeatsPerSecond << "heartbeats per second for" << _numDomains << "domains to"
+        << _iceServerAddr;
+
+    _runTimer.start();
+    _reportIntervalTimer.start();
+    _sendTimer.start(SEND_INTERVAL_MSECS);
+    _reportTimer.start(REPORT_INTERVAL_MSECS);
+    return true;
+}
+
+bool HeartbeatLoadGenerator::createHeartbeats(const QString& publicKeyPath) {
+    std::unique_ptr<RSA, decltype(&RSA_free)> keyPair { RSA_new(), RSA_free };
+    std::unique_ptr<BIGNUM, decltype(&BN_free)> exponent { BN_new(), BN_free };
+
+    const unsigned long RSA_KEY_EXPONENT = 65537;
+    const int RSA_KEY_BITS = 2048;
+    BN_set_word(exponent.get(), RSA_KEY_EXPONENT);
+
+    if (!RSA_generate_key_ex(keyPair.get(), RSA_KEY_BITS, exponent.get(), NULL)) {
+        qCritical() << "Error generating 2048-bit RSA Keypair -" << ERR_get_error();
+        return false;
+    }
+
+    // the ice-server reads the same format the metaverse API hands out: a base64 SubjectPublicKeyInfo
+    unsigned char* publicKeyDER = NULL;
+    int publicKeyLength = i2d_RSA_PUBKEY(keyPair.get(), &publicKeyDER);
+    if (publicKeyLength <= 0) {
+        qCritical() << "Error getting DER public key from RSA struct -" << ERR_get_error();
+        return false;
+    }
+    QByteArray publicKey { reinterpret_cast<char*>(publicKeyDER), publicKeyLength };
+    OPENSSL_free(publicKeyDER);
+
+    QFile publicKeyFile(publicKeyPath);
+    if (!publicKeyFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical() << "Could not write the public key to" << publicKeyPath;
+        return false;
+    }
+    publicKeyFile.write(publicKey.toBase64());
+    publicKeyFile.close();
+    qDebug() << "Wrote the public key for the synthetic domains to" << publicKeyPath;
+
+    // each domain signs its heartbeat once, exactly like a domain-server whose sockets don't change
+    HifiSockAddr localSocket(QHostAddress::LocalHost, _socket.localPort());
+    _heartbeatPayloads.reserve(_numDomains);
+    for (int i = 0; i < _numDomains; ++i) {
+        HifiSockAddr publicSocket(QHostAddress::LocalHost, (quint16)(FIRST_SYNTHETIC_PORT + (i % 40000)));
+
+        QByteArray payload;
+        QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+        payloadStream << QUuid::createUuid() << publicSocket << localSocket;
+
+        QByteArray hashedPlaintext = QCryptographicHash::hash(payload, QCryptographicHash::Sha256);
+        QByteArray signature(RSA_size(keyPair.get()), 0);
+        unsigned int signatureBytes = 0;
+        if (RSA_sign(NID_sha256,
+                     reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
+                     hashedPlaintext.size(),
+                     reinterpret_cast<unsigned char*>(signature.data()),
+                     &signatureBytes,
+                     keyPair.get()) != 1) {
+            qCritical() << "Error signing heartbeat -" << ERR_get_error();
+            return false;
+        }
+
+        payloadStream << signature;
+        _heartbeatPayloads.push_back(payload);
+    }
+
+    return true;
+}
+
+void HeartbeatLoadGenerator::sendHeartbeats() {
+    quint64 elapsedMsecs = (quint64)_runTimer.elapsed();
+    if (_durationSeconds > 0 && elapsedMsecs >= (quint64)_durationSeconds * MSECS_PER_SECOND) {
+        _sendTimer.stop();
+        _reportTimer.stop();
+        report();
+
+        qDebug() << "Done -" << _sent << "heartbeats sent," << _acked << "acknowledged," << _denied << "denied,"
+            << (_sent - _acked - _denied) << "unanswered";
+        emit finished();
+        return;
+    }
+
+    // catch up to where the rate says we should be, timer ticks are not exact
+    quint64 target = (quint64)_heartbeatsPerSecond * elapsedMsecs / MSECS_PER_SECOND;
+    static auto heartbeatPacket = NLPacket::create(PacketType::ICEServerHeartbeat);
+    while (_sent < target) {
+        heartbeatPacket->reset();
+        heartbeatPacket->write(_heartbeatPayloads[_nextHeartbeat]);
+        _socket.writePacket(*heartbeatPacket, _iceServerAddr);
+
+        _nextHeartbeat = (_nextHeartbeat + 1) % _heartbeatPayloads.size();
+        ++_sent;
+    }
+}
+
+void HeartbeatLoadGenerator::report() {
+    float intervalSeconds = (float)_reportIntervalTimer.restart() / MSECS_PER_SECOND;
+    if (intervalSeconds <= 0.0f) {
+        return;
+    }
+
+    qDebug().nospace() << "sent " << (int)((_sent - _lastReportSent) / intervalSeconds) << "/s, "
+        << "acked " << (int)((_acked - _lastReportAcked) / intervalSeconds) << "/s, "
+        << "denied " << (int)((_denied - _lastReportDenied) / intervalSeconds) << "/s, "
+        << "unanswered " << (qint64)(_sent - _acked - _denied);
+
+    _lastReportSent = _sent;
+    _lastReportAcked = _acked;
+    _lastReportDenied = _denied;
+}
+
+void HeartbeatLoadGenerator::processPacket(std::unique_ptr<udt::Packet> packet) {
+    auto type = NLPacket::typeInHeader(*packet);
+    if (type == PacketType::ICEServerHeartbeatACK) {
+        ++_acked;
+    } else if (type == PacketType::ICEServerHeartbeatDenied) {
+        ++_denied;
+    }
+}
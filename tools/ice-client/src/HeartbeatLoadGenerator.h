@@ -0,0 +1,68 @@
+//
+//  HeartbeatLoadGenerator.h
+//  tools/ice-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HeartbeatLoadGenerator_h
+#define hifi_HeartbeatLoadGenerator_h
+
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <HifiSockAddr.h>
+#include <udt/Socket.h>
+
+/// Sends signed heartbeats for a set of synthetic domains to an ice-server and reports how many it answers.
+/// The domains share one keypair, its public key is written out for the ice-server's --local-public-key option.
+/// Domains heartbeat in turn, so a domain repeats its heartbeat every (domains / rate) seconds.
+class HeartbeatLoadGenerator : public QObject {
+    Q_OBJECT
+public:
+    HeartbeatLoadGenerator(const HifiSockAddr& iceServerAddr, int numDomains, int heartbeatsPerSecond,
+                           int durationSeconds, QObject* parent = nullptr);
+
+    bool start(const QString& publicKeyPath);
+
+signals:
+    void finished();
+
+private slots:
+    void sendHeartbeats();
+    void report();
+
+private:
+    bool createHeartbeats(const QString& publicKeyPath);
+    void processPacket(std::unique_ptr<udt::Packet> packet);
+
+    HifiSockAddr _iceServerAddr;
+    int _numDomains;
+    int _heartbeatsPerSecond;
+    int _durationSeconds;
+
+    udt::Socket _socket;
+    std::vector<QByteArray> _heartbeatPayloads;
+    size_t _nextHeartbeat { 0 };
+
+    QTimer _sendTimer;
+    QTimer _reportTimer;
+    QElapsedTimer _runTimer;
+    QElapsedTimer _reportIntervalTimer;
+
+    quint64 _sent { 0 };
+    quint64 _acked { 0 };
+    quint64 _denied { 0 };
+
+    quint64 _lastReportSent { 0 };
+    quint64 _lastReportAcked { 0 };
+    quint64 _lastReportDenied { 0 };
+};
+
+#endif // hifi_HeartbeatLoadGenerator_h
@@ -19,6 +19,8 @@
 #include <LimitedNodeList.h>
 #include <NetworkLogging.h>
 
+#include "HeartbeatLoadGenerator.h"
+
 ICEClientApp::ICEClientApp(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
 {
@@ -44,6 +46,20 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
     const QCommandLineOption cacheSTUNOption("s", "cache stun-server response");
     parser.addOption(cacheSTUNOption);
 
+    const QCommandLineOption loadTestOption("load-test",
+        "send signed heartbeats for this many synthetic domains instead of querying", "domains");
+    parser.addOption(loadTestOption);
+
+    const QCommandLineOption heartbeatRateOption("heartbeat-rate", "heartbeats per second for --load-test", "1000");
+    parser.addOption(heartbeatRateOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run --load-test for, 0 runs until killed", "30");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption publicKeyOutOption("public-key-out",
+        "where --load-test writes the public key for the ice-server's --local-public-key", "ice-load-test-key.txt");
+    parser.addOption(publicKeyOutOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -104,6 +120,21 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
         qDebug() << "ICE-server address is" << _iceServerAddr;
     }
 
+    if (parser.isSet(loadTestOption)) {
+        int heartbeatRate = parser.isSet(heartbeatRateOption) ? parser.value(heartbeatRateOption).toInt() : 1000;
+        int duration = parser.isSet(durationOption) ? parser.value(durationOption).toInt() : 30;
+        QString publicKeyPath = parser.isSet(publicKeyOutOption) ?
+            parser.value(publicKeyOutOption) : QString("ice-load-test-key.txt");
+
+        auto loadGenerator = new HeartbeatLoadGenerator(_iceServerAddr, parser.value(loadTestOption).toInt(),
+                                                         heartbeatRate, duration, this);
+        connect(loadGenerator, &HeartbeatLoadGenerator::finished, this, &QCoreApplication::quit);
+        if (!loadGenerator->start(publicKeyPath)) {
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+        return;
+    }
+
     setState(lookUpStunServer);
 
     QTimer* doTimer = new QTimer(this);
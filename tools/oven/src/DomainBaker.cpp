@@ -167,10 +167,8 @@ void DomainBaker::addModelBaker(const QString& property, const QString& url, con
                 _modelBakers.insert(bakeableModelURL, baker);
                 haveBaker = true;
 
-                // move the baker to the baker thread
-                // and kickoff the bake
-                baker->moveToThread(Oven::instance().getNextWorkerThread());
-                QMetaObject::invokeMethod(baker.data(), "bake", Qt::QueuedConnection);
+                // queue the bake, the oven kicks it off once a worker thread is free
+                Oven::instance().queueBake(baker.data());
 
                 // keep track of the total number of baking entities
                 ++_totalNumberOfSubBakes;
@@ -211,9 +209,8 @@ void DomainBaker::addTextureBaker(const QString& property, const QString& url, i
             // insert it into our bakers hash so we hold a strong pointer to it
             _textureBakers.insert(key, textureBaker);
 
-            // move the baker to a worker thread and kickoff the bake
-            textureBaker->moveToThread(Oven::instance().getNextWorkerThread());
-            QMetaObject::invokeMethod(textureBaker.data(), "bake", Qt::QueuedConnection);
+            // queue the bake, the oven kicks it off once a worker thread is free
+            Oven::instance().queueBake(textureBaker.data());
 
             // keep track of the total number of baking entities
             ++_totalNumberOfSubBakes;
@@ -247,9 +244,8 @@ void DomainBaker::addScriptBaker(const QString& property, const QString& url, co
         // insert it into our bakers hash so we hold a strong pointer to it
         _scriptBakers.insert(scriptURL, scriptBaker);
 
-        // move the baker to a worker thread and kickoff the bake
-        scriptBaker->moveToThread(Oven::instance().getNextWorkerThread());
-        QMetaObject::invokeMethod(scriptBaker.data(), "bake", Qt::QueuedConnection);
+        // queue the bake, the oven kicks it off once a worker thread is free
+        Oven::instance().queueBake(scriptBaker.data());
 
         // keep track of the total number of baking entities
         ++_totalNumberOfSubBakes;
@@ -284,9 +280,8 @@ void DomainBaker::addMaterialBaker(const QString& property, const QString& data,
         // insert it into our bakers hash so we hold a strong pointer to it
         _materialBakers.insert(materialData, materialBaker);
 
-        // move the baker to a worker thread and kickoff the bake
-        materialBaker->moveToThread(Oven::instance().getNextWorkerThread());
-        QMetaObject::invokeMethod(materialBaker.data(), "bake", Qt::QueuedConnection);
+        // queue the bake, the oven kicks it off once a worker thread is free
+        Oven::instance().queueBake(materialBaker.data());
 
         // keep track of the total number of baking entities
         ++_totalNumberOfSubBakes;
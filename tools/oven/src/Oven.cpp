@@ -11,12 +11,15 @@
 
 #include "Oven.h"
 
+#include <algorithm>
+
 #include <QtCore/QDebug>
 #include <QtCore/QThread>
 
 #include <image/TextureProcessing.h>
 
 #include <DependencyManager.h>
+#include <NumericalConstants.h>
 #include <StatTracker.h>
 #include <ResourceManager.h>
 #include <ResourceRequestObserver.h>
@@ -26,10 +29,15 @@
 #include <FBXSerializer.h>
 #include <OBJSerializer.h>
 
+#include "Baker.h"
 #include "MaterialBaker.h"
+#include "TextureBaker.h"
 
 Oven* Oven::_staticInstance { nullptr };
 
+// bakers spend part of their time waiting on downloads, so a thread takes a second bake to stay busy meanwhile
+static const int MAX_ACTIVE_BAKES_PER_THREAD = 2;
+
 Oven::Oven() {
     _staticInstance = this;
 
@@ -43,8 +51,8 @@ Oven::Oven() {
     DependencyManager::set<ResourceCacheSharedItems>();
     DependencyManager::set<TextureCache>();
 
-    MaterialBaker::setNextOvenWorkerThreadOperator([] {
-        return Oven::instance().getNextWorkerThread();
+    MaterialBaker::setQueueOvenBakeOperator([](Baker* baker) {
+        Oven::instance().queueBake(baker, true);
     });
 
     {
@@ -66,11 +74,14 @@ Oven::~Oven() {
         thread->wait();
     }
 
+    Baker::setBakeCache(nullptr);
+
     _staticInstance = nullptr;
 }
 
 void Oven::setupWorkerThreads(int numWorkerThreads) {
     _workerThreads.reserve(numWorkerThreads);
+    _activeBakesPerThread.resize(numWorkerThreads, 0);
 
     for (auto i = 0; i < numWorkerThreads; ++i) {
         // setup a worker thread yet and add it to our concurrent vector
@@ -82,10 +93,6 @@ void Oven::setupWorkerThreads(int numWorkerThreads) {
 }
 
 QThread* Oven::getNextWorkerThread() {
-    // FIXME: we assign these threads when we make the bakers, but if certain bakers finish quickly, we could end up
-    // in a situation where threads have finished and others have tons of work queued.  Instead of assigning them at initialization,
-    // we should build a queue of bakers, and when threads finish, they can take the next available baker.
-
     // Here we replicate some of the functionality of QThreadPool by giving callers an available worker thread to use.
     // We can't use QThreadPool because we want to put QObjects with signals/slots on these threads.
     // So instead we setup our own list of threads, up to one less than the ideal thread count
@@ -102,3 +109,132 @@ QThread* Oven::getNextWorkerThread() {
     return nextThread.get();
 }
 
+void Oven::queueBake(Baker* baker, bool isDependency) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+
+    QueuedBake queuedBake { baker, Clock::now() };
+    if (_firstBakeQueuedTime == Clock::time_point()) {
+        _firstBakeQueuedTime = queuedBake.queuedTime;
+    }
+
+    if (isDependency) {
+        auto leastBusy = std::min_element(_activeBakesPerThread.begin(), _activeBakesPerThread.end());
+        startBake(queuedBake, std::distance(_activeBakesPerThread.begin(), leastBusy));
+    } else {
+        _bakeQueue.push_back(queuedBake);
+        dispatchBakes();
+    }
+}
+
+void Oven::dispatchBakes() {
+    while (!_bakeQueue.empty()) {
+        auto leastBusy = std::min_element(_activeBakesPerThread.begin(), _activeBakesPerThread.end());
+        if (*leastBusy >= MAX_ACTIVE_BAKES_PER_THREAD) {
+            return;
+        }
+
+        QueuedBake next = _bakeQueue.front();
+        _bakeQueue.pop_front();
+
+        // the owner may have given up on this bake while it was waiting
+        if (next.baker) {
+            startBake(next, std::distance(_activeBakesPerThread.begin(), leastBusy));
+        }
+    }
+}
+
+void Oven::startBake(const QueuedBake& queuedBake, size_t threadIndex) {
+    Baker* baker = queuedBake.baker.data();
+    QThread* thread = _workerThreads[threadIndex].get();
+    if (!thread->isRunning()) {
+        thread->start();
+    }
+    ++_activeBakesPerThread[threadIndex];
+
+    auto startTime = Clock::now();
+    double queuedSeconds = std::chrono::duration<double>(startTime - queuedBake.queuedTime).count();
+    QString bakeType = baker->metaObject()->className();
+
+    // a baker can report errors more than once, and may be destroyed without finishing, only count it the first time
+    auto isDone = std::make_shared<std::atomic<bool>>(false);
+    auto bakeDone = [this, threadIndex, startTime, queuedSeconds, bakeType, isDone](bool failed) {
+        if (isDone->exchange(true)) {
+            return;
+        }
+        double bakeSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        auto& timings = _bakeTimings[bakeType];
+        ++timings.count;
+        timings.failed += failed ? 1 : 0;
+        timings.totalQueuedSeconds += queuedSeconds;
+        timings.totalBakeSeconds += bakeSeconds;
+        timings.maxBakeSeconds = std::max(timings.maxBakeSeconds, bakeSeconds);
+
+        --_activeBakesPerThread[threadIndex];
+        dispatchBakes();
+    };
+
+    QObject::connect(baker, &Baker::finished, baker, [baker, bakeDone] {
+        bakeDone(baker->hasErrors());
+    }, Qt::DirectConnection);
+    QObject::connect(baker, &Baker::aborted, baker, [bakeDone] {
+        bakeDone(true);
+    }, Qt::DirectConnection);
+    QObject::connect(baker, &QObject::destroyed, [bakeDone] {
+        bakeDone(true);
+    });
+
+    // moveToThread has to be called from the thread the baker currently lives on
+    QMetaObject::invokeMethod(baker, [baker, thread] {
+        baker->moveToThread(thread);
+        QMetaObject::invokeMethod(baker, "bake", Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void Oven::printBakeReport() {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+
+    if (_bakeTimings.empty()) {
+        return;
+    }
+
+    double totalSeconds = std::chrono::duration<double>(Clock::now() - _firstBakeQueuedTime).count();
+    qDebug().noquote() << QString("Baked in %1s on %2 worker threads").arg(totalSeconds, 0, 'f', 2).arg(_workerThreads.size());
+
+    for (const auto& entry : _bakeTimings) {
+        const BakeTimings& timings = entry.second;
+        qDebug().noquote() << QString("  %1: %2 bakes (%3 failed), %4s baking (avg %5s, max %6s), avg %7s queued")
+            .arg(entry.first)
+            .arg(timings.count)
+            .arg(timings.failed)
+            .arg(timings.totalBakeSeconds, 0, 'f', 2)
+            .arg(timings.totalBakeSeconds / timings.count, 0, 'f', 2)
+            .arg(timings.maxBakeSeconds, 0, 'f', 2)
+            .arg(timings.totalQueuedSeconds / timings.count, 0, 'f', 2);
+    }
+
+    auto dedupedTextures = TextureBaker::getNumDedupedBakes();
+    if (dedupedTextures > 0) {
+        qDebug().noquote() << QString("  %1 textures shared between bakes were only processed once").arg(dedupedTextures);
+    }
+
+    auto bakeCache = Baker::getBakeCache();
+    if (bakeCache) {
+        auto hits = bakeCache->getNumHits();
+        auto lookups = hits + bakeCache->getNumMisses();
+        qDebug().noquote() << QString("  bake cache: %1 of %2 bakes restored (%3%), %4 MB in %5 cached bakes")
+            .arg(hits)
+            .arg(lookups)
+            .arg(lookups > 0 ? 100.0 * hits / lookups : 0.0, 0, 'f', 1)
+            .arg(BYTES_TO_MB(bakeCache->getSizeTotalFiles()))
+            .arg(bakeCache->getNumTotalFiles());
+    }
+}
+
+void Oven::setupBakeCache(const QString& directory, size_t maxSize) {
+    auto bakeCache = std::make_shared<BakeCache>(directory.toStdString());
+    bakeCache->initialize();
+    bakeCache->setMaxSize(maxSize);
+    Baker::setBakeCache(bakeCache);
+}
@@ -13,11 +13,22 @@
 #define hifi_Oven_h
 
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+
+class Baker;
 class QThread;
 
+static const QString DEFAULT_BAKE_CACHE_DIRECTORY = "bake_cache";
+static const int DEFAULT_BAKE_CACHE_SIZE_MB = 2048;
+
 class Oven {
 
 public:
@@ -26,17 +37,55 @@ public:
 
     static Oven& instance() { return *_staticInstance; }
 
+    // for bakers that only coordinate other bakes (e.g. DomainBaker), everything else should be queued
     QThread* getNextWorkerThread();
 
+    // Queues a baker to be moved to a worker thread and baked once a thread is free. Dependencies (bakers queued by
+    // a bake that is already running) skip the queue and start right away on the least busy thread, so a parent
+    // waiting on its children can never hold them up.
+    void queueBake(Baker* baker, bool isDependency = false);
+
+    // prints how long each type of bake took and waited in the queue
+    void printBakeReport();
+
+    // Bakes that were already done with the same input and options are restored from this cache instead of being
+    // baked again. A relative directory is under the application's local data.
+    void setupBakeCache(const QString& directory, size_t maxSize);
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct QueuedBake {
+        QPointer<Baker> baker;
+        Clock::time_point queuedTime;
+    };
+
+    struct BakeTimings {
+        int count { 0 };
+        int failed { 0 };
+        double totalQueuedSeconds { 0.0 };
+        double totalBakeSeconds { 0.0 };
+        double maxBakeSeconds { 0.0 };
+    };
+
     void setupWorkerThreads(int numWorkerThreads);
     void setupFBXBakerThread();
 
+    // called with _queueMutex held
+    void dispatchBakes();
+    void startBake(const QueuedBake& queuedBake, size_t threadIndex);
+
     std::vector<std::unique_ptr<QThread>> _workerThreads;
 
     std::atomic<uint32_t> _nextWorkerThreadIndex;
     int _numWorkerThreads;
 
+    std::mutex _queueMutex;
+    std::deque<QueuedBake> _bakeQueue;
+    std::vector<int> _activeBakesPerThread;
+    std::map<QString, BakeTimings> _bakeTimings;
+    Clock::time_point _firstBakeQueuedTime;
+
     static Oven* _staticInstance;
 };
 
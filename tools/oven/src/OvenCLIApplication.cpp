@@ -14,7 +14,10 @@
 #include <QtCore/QCommandLineParser>
 #include <QtCore/QUrl>
 
+#include <algorithm>
+
 #include <image/TextureProcessing.h>
+#include <NumericalConstants.h>
 #include <TextureBaker.h>
 
 #include "BakerCLI.h"
@@ -23,6 +26,8 @@ static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
 static const QString CLI_TYPE_PARAMETER = "t";
 static const QString CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER = "disable-texture-compression";
+static const QString CLI_BAKE_CACHE_PARAMETER = "bake-cache";
+static const QString CLI_BAKE_CACHE_SIZE_PARAMETER = "bake-cache-size";
 
 OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
@@ -34,7 +39,10 @@ OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
         { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
         { CLI_TYPE_PARAMETER, "Type of asset. [model|material]"/*|js]"*/, "type" },
-        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." }
+        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." },
+        { CLI_BAKE_CACHE_PARAMETER, "Reuse bakes with unchanged inputs from this cache folder.", "path" },
+        { CLI_BAKE_CACHE_SIZE_PARAMETER, "Maximum size of the bake cache in MB.", "size",
+          QString::number(DEFAULT_BAKE_CACHE_SIZE_MB) }
     });
 
     parser.addHelpOption();
@@ -51,6 +59,11 @@ OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
             TextureBaker::setCompressionEnabled(false);
         }
 
+        if (parser.isSet(CLI_BAKE_CACHE_PARAMETER)) {
+            size_t maxSizeMB = std::max(parser.value(CLI_BAKE_CACHE_SIZE_PARAMETER).toInt(), 0);
+            setupBakeCache(parser.value(CLI_BAKE_CACHE_PARAMETER), MB_TO_BYTES(maxSizeMB));
+        }
+
         QMetaObject::invokeMethod(cli, "bakeFile", Qt::QueuedConnection, Q_ARG(QUrl, inputUrl),
                                     Q_ARG(QString, outputUrl.toString()), Q_ARG(QString, type));
     } else {
@@ -11,9 +11,13 @@
 
 #include "OvenGUIApplication.h"
 
+#include <NumericalConstants.h>
+
 OvenGUIApplication::OvenGUIApplication(int argc, char* argv[]) :
     QApplication(argc, argv)
 {
+    setupBakeCache(DEFAULT_BAKE_CACHE_DIRECTORY, MB_TO_BYTES(DEFAULT_BAKE_CACHE_SIZE_MB));
+
     // setup the GUI
     _mainWindow.show();
 }
@@ -184,15 +184,12 @@ void ModelBakeWidget::bakeButtonClicked() {
             if (baker) {
                 // everything seems to be in place, kick off a bake for this model now
 
-                // move the baker to the FBX baker thread
-                baker->moveToThread(Oven::instance().getNextWorkerThread());
-
-                // invoke the bake method on the baker thread
-                QMetaObject::invokeMethod(baker.get(), "bake");
-
                 // make sure we hear about the results of this baker when it is done
                 connect(baker.get(), &Baker::finished, this, &ModelBakeWidget::handleFinishedBaker);
 
+                // the oven moves the baker to a worker thread and invokes bake there once one is free
+                Oven::instance().queueBake(baker.get());
+
                 // add a pending row to the results window to show that this bake is in process
                 auto resultsWindow = OvenGUIApplication::instance()->getMainWindow()->showResultsWindow();
                 auto resultsRow = resultsWindow->addPendingResultRow(modelToBakeURL.fileName(), outputDirectory);
@@ -211,14 +211,11 @@ void SkyboxBakeWidget::bakeButtonClicked() {
 void SkyboxBakeWidget::addBaker(TextureBaker* baker, const QDir& outputDirectory) {
     auto textureBaker = std::unique_ptr<TextureBaker>{ baker };
 
-    // move the textureBaker to a worker thread
-    textureBaker->moveToThread(Oven::instance().getNextWorkerThread());
-
     // make sure we hear about the results of this textureBaker when it is done
     connect(textureBaker.get(), &TextureBaker::finished, this, &SkyboxBakeWidget::handleFinishedBaker);
 
-    // invoke the bake method on the textureBaker thread
-    QMetaObject::invokeMethod(textureBaker.get(), "bake");
+    // the oven moves the textureBaker to a worker thread and invokes bake there once one is free
+    Oven::instance().queueBake(textureBaker.get());
 
     // add a pending row to the results window to show that this bake is in process
     auto resultsWindow = OvenGUIApplication::instance()->getMainWindow()->showResultsWindow();